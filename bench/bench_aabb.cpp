@@ -0,0 +1,359 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+
+/**
+ * Ray-box throughput and robustness.
+ *
+ * Fires random rays at random wide BVH nodes (8 child boxes each) and prints
+ * millions of ray-box tests per second for the scalar AABB test and for the
+ * AABBxW kernels at widths 1, 4 and 8. Every width must report the same hits
+ * and entry distances (bit for bit) and the same front-to-back order as the
+ * scalar test.
+ *
+ * A fixed list of edge cases follows, each checked against its expected
+ * answer at every width: axis-parallel rays (inside, outside, and lying in a
+ * face plane, with +0 and -0 directions), flat and infinite boxes, empty
+ * boxes, NaN bounds and NaN directions, and the tmin/tmax limits:
+ *
+ *   bench_aabb [--tests N]
+ *
+ * Build with -ffp-contract=off, like the other maths benchmarks.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "accel/aabb.h"
+#include "utils/aligned_allocator.h"
+
+#define BENCH_CHILDREN 8
+
+typedef std::chrono::steady_clock bench_clock;
+
+static uint32_t g_state = 0x12345678u;
+static size_t g_mismatches = 0;
+static size_t g_failures = 0;
+
+static float uniform(float lo, float hi)
+{
+    g_state = g_state * 1664525u + 1013904223u;
+    return (lo + (hi - lo) * static_cast<float>(g_state >> 8) * (1.0F / 16777216.0F));
+}
+
+// Per ray: one bit per child of every node, and the entry distances of the hits.
+struct Result
+{
+    std::vector<uint32_t> bits;
+    std::vector<float> t;
+    std::vector<int> order;
+};
+
+static void record(Result *r, int child, bool hit, float t)
+{
+    if (child % 32 == 0)
+        r->bits.push_back(0u);
+    if (!hit)
+        return;
+    r->bits.back() |= 1u << (child % 32);
+    r->t.push_back(t);
+}
+
+static void compare(const Result& ref, const Result& r)
+{
+    g_mismatches += ref.bits != r.bits || ref.t.size() != r.t.size() || ref.order != r.order
+        || (!ref.t.empty() && memcmp(&ref.t[0], &r.t[0], ref.t.size() * sizeof(float)) != 0);
+}
+
+// Front-to-back order of one node's hits, from the scalar results.
+static void scalarOrder(const bool *hit, const float *t, std::vector<int> *order)
+{
+    int lanes[BENCH_CHILDREN];
+    int count = 0;
+    for (int i = 0; i < BENCH_CHILDREN; i++)
+        if (hit[i])
+            lanes[count++] = i;
+    std::stable_sort(lanes, lanes + count, [t](int a, int b) { return (t[a] < t[b]); });
+    order->insert(order->end(), lanes, lanes + count);
+}
+
+static double runScalar(const std::vector<AABB>& boxes, const std::vector<AABBRay>& rays, std::vector<Result> *out)
+{
+    bench_clock::time_point start = bench_clock::now();
+    for (size_t r = 0; r < rays.size(); r++)
+    {
+        Result& res = (*out)[r];
+        for (size_t n = 0; n < boxes.size(); n += BENCH_CHILDREN)
+        {
+            bool hit[BENCH_CHILDREN];
+            float t[BENCH_CHILDREN];
+            for (int c = 0; c < BENCH_CHILDREN; c++)
+            {
+                hit[c] = RayAABB::Intersect(rays[r], boxes[n + c], &t[c]);
+                record(&res, static_cast<int>((n + c) % 32), hit[c], t[c]);
+            }
+            scalarOrder(hit, t, &res.order);
+        }
+    }
+    return (std::chrono::duration<double>(bench_clock::now() - start).count());
+}
+
+// Every node is BENCH_CHILDREN / W blocks; the order is merged across them.
+template <int W>
+static double runWide(const AlignedVector<AABBxW<W> >& blocks, const std::vector<AABBRay>& rays, std::vector<Result> *out)
+{
+    const int per_node = BENCH_CHILDREN / W;
+    bench_clock::time_point start = bench_clock::now();
+    for (size_t r = 0; r < rays.size(); r++)
+    {
+        Result& res = (*out)[r];
+        for (size_t b = 0; b < blocks.size(); b += per_node)
+        {
+            bool hit[BENCH_CHILDREN];
+            float t[BENCH_CHILDREN];
+            for (int k = 0; k < per_node; k++)
+            {
+                FloatxW<W> entry;
+                MaskxW<W> mask = RayAABB::Intersect(rays[r], blocks[b + k], &entry);
+                for (int i = 0; i < W; i++)
+                {
+                    hit[k * W + i] = mask[i];
+                    t[k * W + i] = entry.v[i];
+                    record(&res, static_cast<int>((b * W + k * W + i) % 32), mask[i], entry.v[i]);
+                }
+            }
+            if (per_node == 1)
+            {
+                int lanes[W];
+                FloatxW<W> entry = FloatxW<W>::Load(t);
+                MaskxW<W> mask;
+                for (int i = 0; i < W; i++)
+                    mask.Set(i, hit[i]);
+                int count = RayAABB::Order(mask, entry, lanes);
+                res.order.insert(res.order.end(), lanes, lanes + count);
+            }
+            else
+                scalarOrder(hit, t, &res.order);
+        }
+    }
+    return (std::chrono::duration<double>(bench_clock::now() - start).count());
+}
+
+// Kernel only, without the bookkeeping above, for the throughput figures;
+// with `order` the hits are also sorted front to back.
+template <int W>
+static double runKernel(const AlignedVector<AABBxW<W> >& blocks, const std::vector<AABBRay>& rays, bool order, size_t *hits)
+{
+    bench_clock::time_point start = bench_clock::now();
+    for (size_t r = 0; r < rays.size(); r++)
+    {
+        for (size_t b = 0; b < blocks.size(); b++)
+        {
+            FloatxW<W> entry;
+            int lanes[W];
+            MaskxW<W> mask = RayAABB::Intersect(rays[r], blocks[b], &entry);
+            *hits += static_cast<size_t>(order ? RayAABB::Order(mask, entry, lanes) : mask.Count());
+        }
+    }
+    return (std::chrono::duration<double>(bench_clock::now() - start).count());
+}
+
+static double runKernelScalar(const std::vector<AABB>& boxes, const std::vector<AABBRay>& rays, size_t *hits)
+{
+    bench_clock::time_point start = bench_clock::now();
+    for (size_t r = 0; r < rays.size(); r++)
+    {
+        for (size_t b = 0; b < boxes.size(); b++)
+        {
+            float t;
+            *hits += RayAABB::Intersect(rays[r], boxes[b], &t) ? 1 : 0;
+        }
+    }
+    return (std::chrono::duration<double>(bench_clock::now() - start).count());
+}
+
+template <int W>
+static void pack(const std::vector<AABB>& boxes, AlignedVector<AABBxW<W> > *blocks)
+{
+    blocks->resize(boxes.size() / W);
+    for (size_t i = 0; i < boxes.size(); i++)
+        (*blocks)[i / W].Set(static_cast<int>(i % W), boxes[i]);
+}
+
+// One edge case, checked in lane `lane % W` of otherwise empty blocks.
+template <int W>
+static bool checkWide(const AABBRay& ray, const AABB& box, int lane, bool expected, float *t)
+{
+    AABBxW<W> block;
+    FloatxW<W> entry;
+    block.Set(lane % W, box);
+    MaskxW<W> mask = RayAABB::Intersect(ray, block, &entry);
+    MaskxW<W> want;
+    want.Set(lane % W, expected);
+    *t = entry.v[lane % W];
+    return (mask.Bits() == want.Bits());
+}
+
+static void check(const char *name, const Vec3& org, const Vec3& dir, float tmin, float tmax,
+    const AABB& box, bool expected, float expected_t = NAN)
+{
+    static int lane = 0;
+    AABBRay ray(org, dir, tmin, tmax);
+    float t[4];
+    bool ok = (RayAABB::Intersect(ray, box, &t[0]) == expected);
+    ok = checkWide<1>(ray, box, lane, expected, &t[1]) && ok;
+    ok = checkWide<4>(ray, box, lane, expected, &t[2]) && ok;
+    ok = checkWide<8>(ray, box, lane, expected, &t[3]) && ok;
+    lane++;
+    for (int i = 0; expected && i < 4; i++)
+        ok = ok && (std::isnan(expected_t) || t[i] == expected_t);
+    printf("  %-34s %-4s %s\n", name, expected ? "hit" : "miss", ok ? "ok" : "FAILED");
+    g_failures += ok ? 0 : 1;
+}
+
+static void robustness(void)
+{
+    const AABB unit(Vec3(0.0F), Vec3(1.0F));
+    const float inf = HUGE_VALF;
+    const float nan = NAN;
+
+    printf("edge cases\n");
+    check("axis-parallel through", Vec3(0.5F, 0.5F, -1.0F), Vec3(0.0F, 0.0F, 1.0F), 0.0F, inf, unit, true, 1.0F);
+    check("axis-parallel beside", Vec3(0.5F, 2.0F, -1.0F), Vec3(0.0F, 0.0F, 1.0F), 0.0F, inf, unit, false);
+    check("axis-parallel behind", Vec3(0.5F, 0.5F, -1.0F), Vec3(0.0F, 0.0F, -1.0F), 0.0F, inf, unit, false);
+    check("axis-parallel from inside", Vec3(0.5F, 0.5F, 0.5F), Vec3(1.0F, 0.0F, 0.0F), 0.0F, inf, unit, true, 0.0F);
+    check("in lo face plane, +0", Vec3(0.0F, 0.5F, -1.0F), Vec3(0.0F, 0.0F, 1.0F), 0.0F, inf, unit, true, 1.0F);
+    check("in hi face plane, +0", Vec3(1.0F, 0.5F, -1.0F), Vec3(0.0F, 0.0F, 1.0F), 0.0F, inf, unit, true, 1.0F);
+    check("in lo face plane, -0", Vec3(0.0F, 0.5F, -1.0F), Vec3(-0.0F, -0.0F, 1.0F), 0.0F, inf, unit, true, 1.0F);
+    check("in hi face plane, -0", Vec3(1.0F, 0.5F, -1.0F), Vec3(-0.0F, -0.0F, 1.0F), 0.0F, inf, unit, true, 1.0F);
+    check("along an edge", Vec3(1.0F, 1.0F, 2.0F), Vec3(0.0F, 0.0F, -1.0F), 0.0F, inf, unit, true, 1.0F);
+    check("just outside a face", Vec3(nextafterf(1.0F, 2.0F), 0.5F, -1.0F), Vec3(0.0F, 0.0F, 1.0F), 0.0F, inf, unit, false);
+    check("flat box", Vec3(0.5F, 0.5F, -1.0F), Vec3(0.0F, 0.0F, 1.0F), 0.0F, inf,
+        AABB(Vec3(0.0F, 0.0F, 0.5F), Vec3(1.0F, 1.0F, 0.5F)), true, 1.5F);
+    check("infinite box", Vec3(0.5F, 0.5F, 0.5F), Vec3(0.0F, 1.0F, 0.0F), 0.0F, inf,
+        AABB(Vec3(-inf), Vec3(inf)), true, 0.0F);
+    check("empty box", Vec3(0.5F, 0.5F, -1.0F), Vec3(0.0F, 0.0F, 1.0F), 0.0F, inf, AABB(), false);
+    check("empty box, zero direction", Vec3(0.0F), Vec3(0.0F), 0.0F, inf, AABB(), false);
+    check("NaN bound (conservative)", Vec3(0.5F, 0.5F, -1.0F), Vec3(0.0F, 0.0F, 1.0F), 0.0F, inf,
+        AABB(Vec3(nan, 0.0F, 0.0F), Vec3(1.0F)), true, 1.0F);
+    check("NaN direction (conservative)", Vec3(5.0F, 0.5F, -1.0F), Vec3(nan, 0.0F, 1.0F), 0.0F, inf, unit, true, 1.0F);
+    check("diagonal through corner", Vec3(-1.0F), Vec3(1.0F), 0.0F, inf, unit, true, 1.0F);
+    check("beyond tmax", Vec3(0.5F, 0.5F, -1.0F), Vec3(0.0F, 0.0F, 1.0F), 0.0F, 0.5F, unit, false);
+    check("entry at tmax", Vec3(0.5F, 0.5F, -1.0F), Vec3(0.0F, 0.0F, 1.0F), 0.0F, 1.0F, unit, true, 1.0F);
+    check("before tmin", Vec3(0.5F, 0.5F, -1.0F), Vec3(0.0F, 0.0F, 1.0F), 2.5F, inf, unit, false);
+
+    // Three boxes along +x at distances 3, 1 and 2, and one off the ray.
+    AABBRay ray(Vec3(0.0F, 0.5F, 0.5F), Vec3(1.0F, 0.0F, 0.0F), 0.0F, HUGE_VALF);
+    AABBxW<4> node;
+    FloatxW<4> entry;
+    int lanes[4];
+    node.Set(0, AABB(Vec3(3.0F, 0.0F, 0.0F), Vec3(4.0F, 1.0F, 1.0F)));
+    node.Set(1, AABB(Vec3(1.0F, 0.0F, 0.0F), Vec3(2.0F, 1.0F, 1.0F)));
+    node.Set(2, AABB(Vec3(2.0F, 0.0F, 0.0F), Vec3(3.0F, 1.0F, 1.0F)));
+    node.Set(3, AABB(Vec3(1.0F, 5.0F, 0.0F), Vec3(2.0F, 6.0F, 1.0F)));
+    int count = RayAABB::Order(RayAABB::Intersect(ray, node, &entry), entry, lanes);
+    bool ok = count == 3 && lanes[0] == 1 && lanes[1] == 2 && lanes[2] == 0;
+    printf("  %-34s %-4s %s\n", "front-to-back order", "1 2 0", ok ? "ok" : "FAILED");
+    g_failures += ok ? 0 : 1;
+}
+
+int main(int argc, char **argv)
+{
+    double budget = 5e7;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--tests") == 0 && i + 1 < argc)
+            budget = std::max(1e4, atof(argv[++i]));
+    }
+
+    // Boxes of random size scattered in [-1, 1]^3, rays from around it aimed into it.
+    const size_t nodes = 1024;
+    std::vector<AABB> boxes(nodes * BENCH_CHILDREN);
+    for (size_t i = 0; i < boxes.size(); i++)
+    {
+        Vec3 c(uniform(-1.0F, 1.0F), uniform(-1.0F, 1.0F), uniform(-1.0F, 1.0F));
+        Vec3 h(uniform(0.05F, 0.5F), uniform(0.05F, 0.5F), uniform(0.05F, 0.5F));
+        boxes[i] = AABB(c - h, c + h);
+    }
+    size_t count = static_cast<size_t>(std::max(16.0, budget / static_cast<double>(boxes.size())));
+    std::vector<AABBRay> rays(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        Vec3 org(uniform(-2.0F, 2.0F), uniform(-2.0F, 2.0F), uniform(-2.0F, 2.0F));
+        Vec3 dir = Vec3(uniform(-1.0F, 1.0F), uniform(-1.0F, 1.0F), uniform(-1.0F, 1.0F)) - org;
+        // Every eighth ray is axis-parallel, to cover the infinite inverses.
+        if (i % 8 == 0)
+        {
+            dir = Vec3(0.0F);
+            dir[static_cast<int>(i / 8 % 3)] = (i & 8) ? -1.0F : 1.0F;
+        }
+        rays[i] = AABBRay(org, dir, 0.0F, HUGE_VALF);
+    }
+    AlignedVector<AABBxW<1> > b1;
+    AlignedVector<AABBxW<4> > b4;
+    AlignedVector<AABBxW<8> > b8;
+    pack(boxes, &b1);
+    pack(boxes, &b4);
+    pack(boxes, &b8);
+
+    printf("simd width      %d lanes\n", RT_SIMD_WIDTH);
+    printf("%zu nodes of %d boxes, %zu rays\n", nodes, BENCH_CHILDREN, count);
+    std::vector<Result> ref(count), r(count);
+    runScalar(boxes, rays, &ref);
+    runWide<1>(b1, rays, &r);
+    for (size_t i = 0; i < count; i++)
+        compare(ref[i], r[i]);
+    r.assign(count, Result());
+    runWide<4>(b4, rays, &r);
+    for (size_t i = 0; i < count; i++)
+        compare(ref[i], r[i]);
+    r.assign(count, Result());
+    runWide<8>(b8, rays, &r);
+    for (size_t i = 0; i < count; i++)
+        compare(ref[i], r[i]);
+
+    size_t hits[6] = { 0, 0, 0, 0, 0, 0 };
+    double tests = static_cast<double>(count) * static_cast<double>(boxes.size()) * 1e-6;
+    double s0 = runKernelScalar(boxes, rays, &hits[0]);
+    double s1 = runKernel<1>(b1, rays, false, &hits[1]);
+    double s4 = runKernel<4>(b4, rays, false, &hits[2]);
+    double s8 = runKernel<8>(b8, rays, false, &hits[3]);
+    double o4 = runKernel<4>(b4, rays, true, &hits[4]);
+    double o8 = runKernel<8>(b8, rays, true, &hits[5]);
+    for (int i = 1; i < 6; i++)
+        g_mismatches += hits[i] != hits[0];
+    printf("  test   scalar %7.1f  x1 %7.1f  x4 %7.1f  x8 %7.1f  Mtests/s (%.1f%% hit)\n",
+        tests / s0, tests / s1, tests / s4, tests / s8, 100.0 * static_cast<double>(hits[0]) / (tests * 1e6));
+    printf("  +order                          x4 %7.1f  x8 %7.1f  Mtests/s\n", tests / o4, tests / o8);
+
+    robustness();
+    printf("hit mismatches  %zu\n", g_mismatches);
+    printf("edge failures   %zu\n", g_failures);
+    return (g_mismatches || g_failures ? 1 : 0);
+}
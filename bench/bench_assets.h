@@ -0,0 +1,83 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * Asset discovery shared by the benchmarks that walk assets/models.
+ *
+ * collectObjFiles appends every .obj file (any case) found under a file or
+ * directory, walking directories in sorted order and skipping hidden entries
+ * and Git LFS pointers that were never fetched.
+ */
+
+#pragma once
+
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <dirent.h>
+#include <sys/stat.h>
+
+static inline bool endsWithObj(const std::string &name)
+{
+    if (name.size() < 4) return (false);
+    std::string ext = name.substr(name.size() - 4);
+    for (size_t i = 0; i < ext.size(); i++) ext[i] = static_cast<char>(tolower(ext[i]));
+    return (ext == ".obj");
+}
+
+static inline bool isLfsPointer(const std::string &path)
+{
+    char head[32] = {0};
+    FILE *fp = fopen(path.c_str(), "rb");
+    if (!fp) return (false);
+    size_t n = fread(head, 1, sizeof(head) - 1, fp);
+    fclose(fp);
+    return (n > 0 && strncmp(head, "version https://git-lfs", 23) == 0);
+}
+
+static inline void collectObjFiles(const std::string &path, std::vector<std::string> *files)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return;
+    if (!S_ISDIR(st.st_mode)) {
+        if (endsWithObj(path) && !isLfsPointer(path)) files->push_back(path);
+        return;
+    }
+    DIR *dir = opendir(path.c_str());
+    if (!dir) return;
+    std::vector<std::string> entries;
+    for (struct dirent *e = readdir(dir); e; e = readdir(dir)) {
+        if (e->d_name[0] == '.') continue;
+        entries.push_back(path + "/" + e->d_name);
+    }
+    closedir(dir);
+    std::sort(entries.begin(), entries.end());
+    for (size_t i = 0; i < entries.size(); i++) {
+        collectObjFiles(entries[i], files);
+    }
+}
+
@@ -0,0 +1,213 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+/**
+ * BVH build time, tree quality and traversal.
+ *
+ * Loads each mesh and builds its BVH twice, on the calling thread alone and
+ * with a ThreadPool, printing both build times, the SAH cost and the tree
+ * shape. Both builds must give the same tree. The tree is then checked: every
+ * triangle in exactly one leaf, every box inside its parent, every triangle
+ * inside its leaf box. Finally random rays are traced through the tree and by
+ * brute force over every triangle; both must find the same closest hit
+ * (prim and t, bit for bit) for both intersection tests:
+ *
+ *   bench_bvh [--threads N] [--rays N] [obj ...]
+ *
+ * Meshes that are missing (e.g. sponza without its LFS object) are skipped.
+ * Build with -ffp-contract=off, like the other maths benchmarks.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+#include "accel/bvh_obj.h"
+
+#define BENCH_WIDTH RT_SIMD_WIDTH
+
+typedef std::chrono::steady_clock bench_clock;
+
+static uint32_t g_state = 0x12345678u;
+static size_t g_failures = 0;
+
+static float uniform(float lo, float hi)
+{
+    g_state = g_state * 1664525u + 1013904223u;
+    return (lo + (hi - lo) * static_cast<float>(g_state >> 8) * (1.0F / 16777216.0F));
+}
+
+static bool inside(const AABB& inner, const AABB& outer)
+{
+    return (inner.lo.x >= outer.lo.x && inner.lo.y >= outer.lo.y && inner.lo.z >= outer.lo.z &&
+        inner.hi.x <= outer.hi.x && inner.hi.y <= outer.hi.y && inner.hi.z <= outer.hi.z);
+}
+
+// Every prim in one leaf lane, boxes nested; returns the failures.
+template <int W>
+static size_t checkTree(const BVH<W>& bvh, size_t triangles)
+{
+    std::vector<int> seen(triangles, 0);
+    size_t failures = 0;
+
+    for (size_t n = 0; n < bvh.nodes.size(); n++)
+    {
+        const BVHNode& node = bvh.nodes[n];
+        if (node.count == 0)
+        {
+            failures += !inside(bvh.nodes[n + 1].bounds, node.bounds) || !inside(bvh.nodes[node.first].bounds, node.bounds);
+            continue;
+        }
+        for (uint32_t b = node.first; b < node.first + node.count; b++)
+        {
+            const TriangleBlock<W>& block = bvh.blocks[b];
+            for (int i = 0; i < W; i++)
+            {
+                if (block.prim[i] == TRIANGLE_NO_PRIM)
+                    continue;
+                AABB box;
+                box.Expand(Vec3(block.v0.x.v[i], block.v0.y.v[i], block.v0.z.v[i]));
+                box.Expand(Vec3(block.v1.x.v[i], block.v1.y.v[i], block.v1.z.v[i]));
+                box.Expand(Vec3(block.v2.x.v[i], block.v2.y.v[i], block.v2.z.v[i]));
+                failures += !inside(box, node.bounds) || block.prim[i] >= triangles;
+                if (block.prim[i] < triangles)
+                    seen[block.prim[i]]++;
+            }
+        }
+    }
+    for (size_t i = 0; i < triangles; i++)
+        failures += seen[i] != 1;
+    return (failures);
+}
+
+template <int W>
+static bool sameTree(const BVH<W>& a, const BVH<W>& b)
+{
+    return (a.nodes.size() == b.nodes.size() && a.blocks.size() == b.blocks.size() &&
+        (a.nodes.empty() || memcmp(&a.nodes[0], &b.nodes[0], a.nodes.size() * sizeof(BVHNode)) == 0) &&
+        (a.blocks.empty() || memcmp(&a.blocks[0], &b.blocks[0], a.blocks.size() * sizeof(TriangleBlock<W>)) == 0));
+}
+
+// BVH against brute force over the first bruteRays rays, and both throughputs.
+template <RayTriangle::Test T, int W>
+static void traceTest(const char *name, const BVH<W>& bvh, const AlignedVector<TriangleBlock<W> >& all,
+    const std::vector<Vec3>& orgs, const std::vector<Vec3>& dirs, size_t bruteRays)
+{
+    std::vector<TriangleHit> ref(bruteRays), hits(orgs.size());
+    size_t hitCount = 0;
+
+    bench_clock::time_point start = bench_clock::now();
+    for (size_t r = 0; r < bruteRays; r++)
+        RayTriangle::Closest<T, W>(all, orgs[r], dirs[r], 0.0F, HUGE_VALF, &ref[r]);
+    double brute = std::chrono::duration<double>(bench_clock::now() - start).count();
+    start = bench_clock::now();
+    for (size_t r = 0; r < orgs.size(); r++)
+        hitCount += bvh.template Closest<T>(orgs[r], dirs[r], 0.0F, HUGE_VALF, &hits[r]);
+    double traced = std::chrono::duration<double>(bench_clock::now() - start).count();
+    for (size_t r = 0; r < bruteRays; r++)
+        g_failures += ref[r].prim != hits[r].prim || memcmp(&ref[r].t, &hits[r].t, sizeof(float)) != 0;
+    printf("  %-11s bvh %9.3f  brute force %9.3f  Mrays/s  (%.1f%% hit)\n", name,
+        static_cast<double>(orgs.size()) * 1e-6 / traced, static_cast<double>(bruteRays) * 1e-6 / brute,
+        100.0 * static_cast<double>(hitCount) / static_cast<double>(orgs.size()));
+}
+
+int main(int argc, char **argv)
+{
+    unsigned int threads = std::max(1u, std::thread::hardware_concurrency());
+    size_t rays = 100000;
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc)
+            threads = static_cast<unsigned int>(std::max(1, atoi(argv[++i])));
+        else if (strcmp(argv[i], "--rays") == 0 && i + 1 < argc)
+            rays = static_cast<size_t>(std::max(1, atoi(argv[++i])));
+        else
+            paths.push_back(argv[i]);
+    }
+    if (paths.empty())
+    {
+        paths.push_back("assets/models/cornell-box/CornellBox-Original.obj");
+        paths.push_back("assets/models/geodesic/geodesic_classII_20_20.obj");
+        paths.push_back("assets/models/mori-knob/testObj.obj");
+        paths.push_back("assets/models/white-oak/white_oak.obj");
+        paths.push_back("assets/models/sponza/sponza.obj");
+    }
+
+    ThreadPool pool(threads);
+    printf("simd width      %d lanes, %u threads\n", BENCH_WIDTH, threads);
+    for (size_t p = 0; p < paths.size(); p++)
+    {
+        attrib_t attrib;
+        std::vector<shape_t> shapes;
+        std::vector<material_t> materials;
+        std::string err;
+        std::string basedir(paths[p], strrchr(paths[p], '/') ? strrchr(paths[p], '/') + 1 - paths[p] : 0);
+        if (!LoadObj(&attrib, &shapes, &materials, &err, paths[p], basedir.c_str(), true))
+        {
+            printf("%s: skipped (not loaded)\n", paths[p]);
+            continue;
+        }
+
+        BVH<BENCH_WIDTH> serial, parallel;
+        BVHBuildStats s1, sN;
+        size_t triangles = buildBVH<BENCH_WIDTH>(attrib, shapes, NULL, &serial, &s1);
+        buildBVH<BENCH_WIDTH>(attrib, shapes, &pool, &parallel, &sN);
+        if (triangles == 0)
+        {
+            printf("%s: skipped (no triangles)\n", paths[p]);
+            continue;
+        }
+        g_failures += !sameTree(serial, parallel);
+        g_failures += checkTree(parallel, triangles);
+        printf("%s: %zu triangles\n", paths[p], triangles);
+        printf("  build       1 thread %8.2f ms  %u threads %8.2f ms  x%.2f  (%zu tasks)\n",
+            s1.seconds * 1e3, threads, sN.seconds * 1e3, s1.seconds / sN.seconds, sN.tasks);
+        printf("  tree        sah %.2f  %zu nodes  %zu leaves  depth %d  %zu blocks (%.0f%% full)\n",
+            sN.sahCost, sN.nodes, sN.leaves, sN.depth, sN.blocks,
+            100.0 * static_cast<double>(triangles) / static_cast<double>(sN.blocks * BENCH_WIDTH));
+
+        Vec3 lo = parallel.nodes[0].bounds.lo, extent = parallel.nodes[0].bounds.hi - lo;
+        std::vector<Vec3> orgs(rays), dirs(rays);
+        for (size_t i = 0; i < rays; i++)
+        {
+            orgs[i] = lo + extent * Vec3(uniform(0.0F, 1.0F), uniform(0.0F, 1.0F), uniform(0.0F, 1.0F));
+            dirs[i] = Vec3(uniform(-1.0F, 1.0F), uniform(-1.0F, 1.0F), uniform(-1.0F, 1.0F));
+        }
+        // Brute force gets about as many ray-triangle tests as a few million per mesh.
+        size_t bruteRays = std::min(rays, std::max(static_cast<size_t>(64), static_cast<size_t>(2e8 / static_cast<double>(triangles))));
+        AlignedVector<TriangleBlock<BENCH_WIDTH> > all;
+        packTriangles<BENCH_WIDTH>(attrib, shapes, &all);
+        traceTest<RayTriangle::MollerTrumboreTest>("moller", parallel, all, orgs, dirs, bruteRays);
+        traceTest<RayTriangle::WatertightTest>("watertight", parallel, all, orgs, dirs, bruteRays);
+    }
+    printf("failures        %zu\n", g_failures);
+    return (g_failures ? 1 : 0);
+}
@@ -0,0 +1,356 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+/**
+ * Run-time dispatch.
+ *
+ * Forces every dispatch path this CPU supports in turn, runs each dispatched
+ * kernel (transforms, FastMath, half conversions, closest ray-triangle hits)
+ * on the same inputs, and checks that every path returns the bits of the
+ * scalar path, and the scalar path those of the headers built into this
+ * program. Paths the CPU cannot run are reported and skipped. Then
+ * prints millions of elements per second for each kernel and path:
+ *
+ *   bench_dispatch [--count N]
+ *
+ * RT_DISPATCH=<path> changes the startup path; the checks force all of them
+ * anyway.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "accel/triangle_obj.h"
+#include "dispatch/dispatch.h"
+#include "maths/transform.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+static size_t g_failures = 0;
+static uint32_t g_state = 0x12345678u;
+
+static void report(const char *name, size_t errors)
+{
+    printf("  %-52s %s", name, errors ? "FAILED" : "ok");
+    if (errors)
+        printf(" (%zu)", errors);
+    printf("\n");
+    g_failures += errors;
+}
+
+static float uniform(float lo, float hi)
+{
+    g_state = g_state * 1664525u + 1013904223u;
+    return (lo + (hi - lo) * static_cast<float>(g_state >> 8) * (1.0F / 16777216.0F));
+}
+
+template <typename T>
+static size_t differences(const std::vector<T>& a, const std::vector<T>& b)
+{
+    size_t n = 0;
+    for (size_t i = 0; i < a.size(); i++)
+        n += memcmp(&a[i], &b[i], sizeof(T)) != 0;
+    return (n);
+}
+
+/*** @brief Inputs shared by every path. */
+struct Inputs
+{
+    float m[4][4];
+    std::vector<float> xyz, xyzw;
+    std::vector<float> angle, expArg, logArg, powX, powY;
+    std::vector<float> floats;
+    AlignedVector<TriangleBlock<DISPATCH_BLOCK_WIDTH> > blocks;
+    std::vector<Vec3> org, dir;
+};
+
+/*** @brief What one path computes from the Inputs. */
+struct Outputs
+{
+    std::vector<float> points, points3x4, vectors, stridedPoints;
+    std::vector<float> sin, cos, sinCosS, sinCosC, exp, log, pow, atan, atan2, sinFast, expFast;
+    std::vector<Half> halves;
+    std::vector<float> decoded;
+    std::vector<TriangleHit> mt, wt;
+    size_t mtHits, wtHits;
+};
+
+static void makeInputs(size_t count, Inputs *in)
+{
+    const float m[4][4] = {
+        { 0.8F, -0.3F, 0.1F, 4.0F },
+        { 0.2F, 0.9F, -0.4F, -2.0F },
+        { -0.1F, 0.5F, 1.1F, 0.5F },
+        { 0.01F, -0.02F, 0.03F, 1.0F }
+    };
+    memcpy(in->m, m, sizeof(m));
+    in->xyz.resize(3 * count);
+    in->xyzw.resize(4 * count);
+    for (size_t i = 0; i < in->xyz.size(); i++)
+        in->xyz[i] = uniform(-50.0F, 50.0F);
+    for (size_t i = 0; i < in->xyzw.size(); i++)
+        in->xyzw[i] = uniform(-50.0F, 50.0F);
+    in->angle.resize(count);
+    in->expArg.resize(count);
+    in->logArg.resize(count);
+    in->powX.resize(count);
+    in->powY.resize(count);
+    in->floats.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        in->angle[i] = uniform(-100.0F, 100.0F);
+        in->expArg[i] = uniform(-90.0F, 90.0F);
+        in->logArg[i] = uniform(0.0F, 1e6F);
+        in->powX[i] = uniform(0.0F, 10.0F);
+        in->powY[i] = uniform(-10.0F, 10.0F);
+        in->floats[i] = uniform(-1.0F, 1.0F) * powf(2.0F, uniform(-30.0F, 20.0F));
+    }
+    const float specials[] = { 0.0F, -0.0F, HUGE_VALF, -HUGE_VALF, NAN, 65504.0F, 65520.0F, 6e-8F, 1e-40F };
+    for (size_t i = 0; i < sizeof(specials) / sizeof(specials[0]) && i < count; i++)
+        in->floats[i] = specials[i];
+
+    // Small random triangles in a box, with a few rays per triangle.
+    attrib_t attrib;
+    shape_t shape;
+    const size_t triangles = std::max(static_cast<size_t>(8), count / 64);
+    for (size_t t = 0; t < triangles; t++)
+    {
+        const Vec3 c(uniform(-10.0F, 10.0F), uniform(-10.0F, 10.0F), uniform(-10.0F, 10.0F));
+        for (int k = 0; k < 3; k++)
+        {
+            attrib.vertices.push_back(c.x + uniform(-1.0F, 1.0F));
+            attrib.vertices.push_back(c.y + uniform(-1.0F, 1.0F));
+            attrib.vertices.push_back(c.z + uniform(-1.0F, 1.0F));
+            index_t idx;
+            idx.vertex_index = static_cast<int>(3 * t + k);
+            idx.normal_index = idx.texcoord_index = -1;
+            shape.mesh.indices.push_back(idx);
+        }
+    }
+    packTriangles<DISPATCH_BLOCK_WIDTH>(attrib, std::vector<shape_t>(1, shape), &in->blocks);
+    const size_t rays = std::max(static_cast<size_t>(16), count / 64);
+    for (size_t r = 0; r < rays; r++)
+    {
+        in->org.push_back(Vec3(uniform(-15.0F, 15.0F), uniform(-15.0F, 15.0F), -20.0F));
+        in->dir.push_back(Vec3(uniform(-0.5F, 0.5F), uniform(-0.5F, 0.5F), 1.0F));
+    }
+}
+
+static void run(const Inputs& in, Outputs *out)
+{
+    const size_t count = in.angle.size();
+    out->points.resize(3 * count);
+    out->points3x4.resize(3 * count);
+    out->vectors.resize(3 * count);
+    out->stridedPoints.resize(4 * count);
+    Dispatch::Points(in.m, in.xyz.data(), 3, out->points.data(), 3, count);
+    Dispatch::Points3x4(in.m, in.xyz.data(), 3, out->points3x4.data(), 3, count);
+    Dispatch::Vectors(in.m, in.xyz.data(), 3, out->vectors.data(), 3, count);
+    Dispatch::Points(in.m, in.xyzw.data(), 4, out->stridedPoints.data(), 4, count);
+
+    std::vector<float>* const unary[] = { &out->sin, &out->cos, &out->sinCosS, &out->sinCosC, &out->exp, &out->log,
+        &out->pow, &out->atan, &out->atan2, &out->sinFast, &out->expFast };
+    for (size_t i = 0; i < sizeof(unary) / sizeof(unary[0]); i++)
+        unary[i]->resize(count);
+    Dispatch::Sin(in.angle.data(), out->sin.data(), count);
+    Dispatch::Cos(in.angle.data(), out->cos.data(), count);
+    Dispatch::SinCos(in.angle.data(), out->sinCosS.data(), out->sinCosC.data(), count);
+    Dispatch::Exp(in.expArg.data(), out->exp.data(), count);
+    Dispatch::Log(in.logArg.data(), out->log.data(), count);
+    Dispatch::Pow(in.powX.data(), in.powY.data(), out->pow.data(), count);
+    Dispatch::Atan(in.angle.data(), out->atan.data(), count);
+    Dispatch::Atan2(in.angle.data(), in.powY.data(), out->atan2.data(), count);
+    Dispatch::Sin<FastMath::Fast>(in.angle.data(), out->sinFast.data(), count);
+    Dispatch::Exp<FastMath::Fast>(in.expArg.data(), out->expFast.data(), count);
+
+    out->halves.resize(count);
+    out->decoded.resize(count);
+    Dispatch::Encode(in.floats.data(), out->halves.data(), count);
+    Dispatch::Decode(out->halves.data(), out->decoded.data(), count);
+
+    out->mt.resize(in.org.size());
+    out->wt.resize(in.org.size());
+    out->mtHits = Dispatch::Closest<RayTriangle::MollerTrumboreTest>(in.blocks, in.org.data(), in.dir.data(), in.org.size(), 0.0F, HUGE_VALF, out->mt.data());
+    out->wtHits = Dispatch::Closest<RayTriangle::WatertightTest>(in.blocks, in.org.data(), in.dir.data(), in.org.size(), 0.0F, HUGE_VALF, out->wt.data());
+}
+
+static void compare(const char *path, const Outputs& ref, const Outputs& out)
+{
+    char name[128];
+#define CHECK(label, errors) \
+    snprintf(name, sizeof(name), "%-7s %s matches scalar", path, label); \
+    report(name, errors);
+    CHECK("transform", differences(ref.points, out.points) + differences(ref.points3x4, out.points3x4)
+        + differences(ref.vectors, out.vectors) + differences(ref.stridedPoints, out.stridedPoints));
+    CHECK("fastmath precise", differences(ref.sin, out.sin) + differences(ref.cos, out.cos) + differences(ref.sinCosS, out.sinCosS)
+        + differences(ref.sinCosC, out.sinCosC) + differences(ref.exp, out.exp) + differences(ref.log, out.log)
+        + differences(ref.pow, out.pow) + differences(ref.atan, out.atan) + differences(ref.atan2, out.atan2));
+    CHECK("fastmath fast", differences(ref.sinFast, out.sinFast) + differences(ref.expFast, out.expFast));
+    CHECK("half encode/decode", differences(ref.halves, out.halves) + differences(ref.decoded, out.decoded));
+    CHECK("closest hits", differences(ref.mt, out.mt) + differences(ref.wt, out.wt)
+        + (ref.mtHits != out.mtHits) + (ref.wtHits != out.wtHits));
+#undef CHECK
+}
+
+static void checkHeaders(const Inputs& in, const Outputs& ref)
+{
+    const size_t count = in.angle.size();
+    std::vector<float> points(3 * count), sin(count);
+    std::vector<Half> halves(count);
+    std::vector<TriangleHit> hits(in.org.size());
+    Transform::Points(in.m, in.xyz.data(), 3, points.data(), 3, count);
+    FastMath::Sin(in.angle.data(), sin.data(), count);
+    Half::Encode(in.floats.data(), halves.data(), count);
+    for (size_t i = 0; i < in.org.size(); i++)
+        RayTriangle::Closest<RayTriangle::WatertightTest>(in.blocks, in.org[i], in.dir[i], 0.0F, HUGE_VALF, &hits[i]);
+    report("scalar  path matches the headers", differences(ref.points, points) + differences(ref.sin, sin)
+        + differences(ref.halves, halves) + differences(ref.wt, hits));
+}
+
+static void checkSelection(void)
+{
+    const Dispatch::Path startup = Dispatch::Active();
+    size_t errors = 0;
+    for (int p = 0; p < Dispatch::PathCount; p++)
+    {
+        Dispatch::Path path = static_cast<Dispatch::Path>(p);
+        Dispatch::Path parsed;
+        errors += !Dispatch::Parse(Dispatch::Name(path), &parsed) || parsed != path;
+        errors += Dispatch::Supported(path) && p > Dispatch::Best();
+        if (!Dispatch::Supported(path))
+            errors += Dispatch::Force(path) || Dispatch::Active() != startup;
+    }
+    Dispatch::Path parsed;
+    errors += Dispatch::Parse("avx512", &parsed) || Dispatch::Parse(NULL, &parsed);
+    errors += !Dispatch::Supported(Dispatch::ScalarPath) || !Dispatch::Supported(Dispatch::Best());
+    report("parse, supported and refused paths", errors);
+    errors = 0;
+    Dispatch::Force(Dispatch::ScalarPath);
+    errors += Dispatch::Active() != Dispatch::ScalarPath || strcmp(Dispatch::Kernels().name, "scalar") != 0;
+    Dispatch::Reset();
+    errors += Dispatch::Active() != startup;
+    report("force and reset", errors);
+}
+
+static double seconds(bench_clock::time_point start)
+{
+    return (std::chrono::duration<double>(bench_clock::now() - start).count());
+}
+
+static void throughput(const Inputs& in)
+{
+    const size_t count = in.angle.size();
+    const int rounds = 10;
+    std::vector<float> a(3 * count), b(count);
+    std::vector<Half> h(count);
+    std::vector<TriangleHit> hits(in.org.size());
+    double tests = static_cast<double>(in.org.size()) * static_cast<double>(in.blocks.size() * DISPATCH_BLOCK_WIDTH) * rounds * 1e-6;
+    double values = static_cast<double>(count) * rounds * 1e-6;
+
+    printf("throughput (M/s)     ");
+    for (int p = 0; p < Dispatch::PathCount; p++)
+        printf(" %9s", Dispatch::Name(static_cast<Dispatch::Path>(p)));
+    printf("\n");
+    const char *names[] = { "points3x4", "sin", "exp", "log", "pow", "half encode", "half decode", "ray-tri watertight" };
+    for (int k = 0; k < 8; k++)
+    {
+        printf("  %-19s", names[k]);
+        for (int p = 0; p < Dispatch::PathCount; p++)
+        {
+            if (!Dispatch::Force(static_cast<Dispatch::Path>(p)))
+            {
+                printf(" %9s", "-");
+                continue;
+            }
+            bench_clock::time_point start = bench_clock::now();
+            for (int r = 0; r < rounds; r++)
+            {
+                switch (k)
+                {
+                    case 0: Dispatch::Points3x4(in.m, in.xyz.data(), 3, a.data(), 3, count); break;
+                    case 1: Dispatch::Sin(in.angle.data(), b.data(), count); break;
+                    case 2: Dispatch::Exp(in.expArg.data(), b.data(), count); break;
+                    case 3: Dispatch::Log(in.logArg.data(), b.data(), count); break;
+                    case 4: Dispatch::Pow(in.powX.data(), in.powY.data(), b.data(), count); break;
+                    case 5: Dispatch::Encode(in.floats.data(), h.data(), count); break;
+                    case 6: Dispatch::Decode(h.data(), b.data(), count); break;
+                    default: Dispatch::Closest<RayTriangle::WatertightTest>(in.blocks, in.org.data(), in.dir.data(), in.org.size(), 0.0F, HUGE_VALF, hits.data()); break;
+                }
+            }
+            printf(" %9.1f", (k == 7 ? tests : values) / seconds(start));
+        }
+        printf("\n");
+    }
+    Dispatch::Reset();
+}
+
+int main(int argc, char **argv)
+{
+    size_t count = 1 << 18;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--count") == 0 && i + 1 < argc)
+            count = static_cast<size_t>(std::max(16, atoi(argv[++i])));
+    }
+
+    const cpu_features_t& f = GetCpuFeatures();
+    printf("cpu            ");
+#define FEATURE(n) if (f.n) printf(" " #n);
+    FEATURE(sse2) FEATURE(sse3) FEATURE(ssse3) FEATURE(sse41) FEATURE(sse42) FEATURE(popcnt) FEATURE(avx) FEATURE(avx2)
+    FEATURE(fma) FEATURE(f16c) FEATURE(bmi2) FEATURE(avx512f) FEATURE(avx512dq) FEATURE(avx512bw) FEATURE(avx512vl)
+#undef FEATURE
+    printf("\n");
+    printf("startup path    %s (best %s)\n", Dispatch::Name(Dispatch::Active()), Dispatch::Name(Dispatch::Best()));
+
+    Inputs in;
+    makeInputs(count, &in);
+    printf("checks\n");
+    checkSelection();
+    Outputs ref;
+    Dispatch::Force(Dispatch::ScalarPath);
+    run(in, &ref);
+    checkHeaders(in, ref);
+    for (int p = Dispatch::ScalarPath + 1; p < Dispatch::PathCount; p++)
+    {
+        Dispatch::Path path = static_cast<Dispatch::Path>(p);
+        if (!Dispatch::Force(path))
+        {
+            printf("  %-7s not supported here, skipped\n", Dispatch::Name(path));
+            continue;
+        }
+        Outputs out;
+        run(in, &out);
+        compare(Dispatch::Name(path), ref, out);
+    }
+    Dispatch::Reset();
+    printf("  %zu of %zu rays hit\n", ref.wtHits, in.org.size());
+    throughput(in);
+    printf("failures        %zu\n", g_failures);
+    return (g_failures ? 1 : 0);
+}
@@ -0,0 +1,213 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * FastMath accuracy and throughput against libm.
+ *
+ * For each function and tier, evaluates a fixed pseudo-random sample of its
+ * domain, compares against the double-precision libm result and prints the
+ * worst error in ulp, the worst relative and absolute errors, and the time
+ * per element of libm (float), the scalar entry point and the batch entry
+ * point. The batch results must match the scalar ones bit for bit:
+ *
+ *   bench_fastmath [--count N] [--iterations N]
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "maths/fastmath.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+static uint32_t g_state = 0x12345678u;
+
+static float uniform(float lo, float hi)
+{
+    g_state = g_state * 1664525u + 1013904223u;
+    return (lo + (hi - lo) * static_cast<float>(g_state >> 8) * (1.0F / 16777216.0F));
+}
+
+static double ulpOf(double r)
+{
+    float f = static_cast<float>(fabs(r));
+    if (!(f < HUGE_VALF)) f = 3.40282347e38F;
+    return (std::max(nextafterf(f, HUGE_VALF) - f, 1.4e-45F));
+}
+
+typedef struct {
+    double max_ulp;
+    double max_rel;
+    double max_abs;
+} error_t;
+
+static error_t measure(const std::vector<float>& got, const std::vector<double>& ref)
+{
+    error_t e = { 0.0, 0.0, 0.0 };
+    for (size_t i = 0; i < got.size(); i++)
+    {
+        double r = ref[i];
+        double g = got[i];
+        if (std::isnan(r) || std::isnan(g))
+        {
+            if (std::isnan(r) != std::isnan(g)) e.max_ulp = e.max_rel = e.max_abs = HUGE_VAL;
+            continue;
+        }
+        // Results that overflow float compare equal when both are infinite.
+        if (static_cast<float>(r) == g)
+            continue;
+        double d = fabs(g - r);
+        e.max_ulp = std::max(e.max_ulp, d / ulpOf(r));
+        e.max_abs = std::max(e.max_abs, d);
+        if (r != 0.0) e.max_rel = std::max(e.max_rel, d / fabs(r));
+    }
+    return (e);
+}
+
+template <typename F>
+static double timeNs(F f, size_t count, int iterations)
+{
+    bench_clock::time_point start = bench_clock::now();
+    for (int it = 0; it < iterations; it++)
+        f();
+    return (std::chrono::duration<double, std::nano>(bench_clock::now() - start).count() / (static_cast<double>(count) * iterations));
+}
+
+static size_t g_mismatches = 0;
+static volatile float g_sink;
+
+static void report(const char* name, const char* tier, const error_t& e, double libm, double scalar, double batch)
+{
+    printf("%-6s %-7s %10.1f %10.2e %10.2e %8.2f %8.2f %8.2f %6.1fx\n",
+        name, tier, e.max_ulp, e.max_rel, e.max_abs, libm, scalar, batch, libm / batch);
+}
+
+// One-argument function: libm double reference, libm float, both FastMath tiers.
+template <typename Ref, typename Libm, typename Scalar, typename Batch>
+static void run1(const char* name, const char* tier, const std::vector<float>& x, Ref ref, Libm libm,
+    Scalar scalar, Batch batch, int iterations)
+{
+    size_t n = x.size();
+    std::vector<double> r(n);
+    std::vector<float> s(n), b(n);
+    for (size_t i = 0; i < n; i++)
+        r[i] = ref(static_cast<double>(x[i]));
+    double t_libm = timeNs([&] { for (size_t i = 0; i < n; i++) s[i] = libm(x[i]); }, n, iterations);
+    double t_scalar = timeNs([&] { for (size_t i = 0; i < n; i++) s[i] = scalar(x[i]); }, n, iterations);
+    double t_batch = timeNs([&] { batch(&x[0], &b[0], n); }, n, iterations);
+    g_mismatches += memcmp(&s[0], &b[0], n * sizeof(float)) != 0;
+    report(name, tier, measure(b, r), t_libm, t_scalar, t_batch);
+}
+
+template <typename Ref, typename Libm, typename Scalar, typename Batch>
+static void run2(const char* name, const char* tier, const std::vector<float>& x, const std::vector<float>& y,
+    Ref ref, Libm libm, Scalar scalar, Batch batch, int iterations)
+{
+    size_t n = x.size();
+    std::vector<double> r(n);
+    std::vector<float> s(n), b(n);
+    for (size_t i = 0; i < n; i++)
+        r[i] = ref(static_cast<double>(x[i]), static_cast<double>(y[i]));
+    double t_libm = timeNs([&] { for (size_t i = 0; i < n; i++) s[i] = libm(x[i], y[i]); }, n, iterations);
+    double t_scalar = timeNs([&] { for (size_t i = 0; i < n; i++) s[i] = scalar(x[i], y[i]); }, n, iterations);
+    double t_batch = timeNs([&] { batch(&x[0], &y[0], &b[0], n); }, n, iterations);
+    g_mismatches += memcmp(&s[0], &b[0], n * sizeof(float)) != 0;
+    report(name, tier, measure(b, r), t_libm, t_scalar, t_batch);
+}
+
+#define RUN1(NAME, X, REF, LIBM, FN) \
+    run1(NAME, "precise", X, [](double v) { return (REF(v)); }, [](float v) { return (LIBM(v)); }, \
+        [](float v) { return (FastMath::FN<FastMath::Precise>(v)); }, \
+        [](const float* a, float* o, size_t n) { FastMath::FN<FastMath::Precise>(a, o, n); }, iterations); \
+    run1(NAME, "fast", X, [](double v) { return (REF(v)); }, [](float v) { return (LIBM(v)); }, \
+        [](float v) { return (FastMath::FN<FastMath::Fast>(v)); }, \
+        [](const float* a, float* o, size_t n) { FastMath::FN<FastMath::Fast>(a, o, n); }, iterations)
+
+#define RUN2(NAME, X, Y, REF, LIBM, FN) \
+    run2(NAME, "precise", X, Y, [](double a, double b) { return (REF(a, b)); }, [](float a, float b) { return (LIBM(a, b)); }, \
+        [](float a, float b) { return (FastMath::FN<FastMath::Precise>(a, b)); }, \
+        [](const float* a, const float* b, float* o, size_t n) { FastMath::FN<FastMath::Precise>(a, b, o, n); }, iterations); \
+    run2(NAME, "fast", X, Y, [](double a, double b) { return (REF(a, b)); }, [](float a, float b) { return (LIBM(a, b)); }, \
+        [](float a, float b) { return (FastMath::FN<FastMath::Fast>(a, b)); }, \
+        [](const float* a, const float* b, float* o, size_t n) { FastMath::FN<FastMath::Fast>(a, b, o, n); }, iterations)
+
+int main(int argc, char **argv)
+{
+    size_t count = 1 << 20;
+    int iterations = 10;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--count") == 0 && i + 1 < argc)
+            count = static_cast<size_t>(std::max(16, atoi(argv[++i])));
+        else if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+            iterations = std::max(1, atoi(argv[++i]));
+    }
+
+    std::vector<float> angles(count), exps(count), logs(count), bases(count), powers(count), tans(count), ys(count), xs(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        // Half of the angles in one turn either way, half over the full domain.
+        angles[i] = (i & 1) ? uniform(-8192.0F, 8192.0F) : uniform(-6.2831853F, 6.2831853F);
+        exps[i] = uniform(-87.0F, 88.5F);
+        logs[i] = (i % 64) ? expf(uniform(-87.0F, 88.5F)) : uniform(0.0F, 1.1e-38F);
+        // sRGB-style exponents on [0, 1] half of the time, general ones otherwise.
+        bases[i] = (i & 1) ? uniform(0.0F, 1.0F) : uniform(0.01F, 100.0F);
+        powers[i] = (i & 1) ? uniform(0.4F, 2.4F) : uniform(-4.0F, 4.0F);
+        tans[i] = tanf(uniform(-1.5707F, 1.5707F));
+        ys[i] = uniform(-1.0F, 1.0F);
+        xs[i] = uniform(-1.0F, 1.0F);
+    }
+
+    printf("%-6s %-7s %10s %10s %10s %8s %8s %8s %7s\n", "func", "tier", "max ulp", "max rel", "max abs", "libm ns", "scalar", "batch", "speedup");
+    RUN1("sin", angles, sin, sinf, Sin);
+    RUN1("cos", angles, cos, cosf, Cos);
+    RUN1("exp", exps, exp, expf, Exp);
+    RUN1("log", logs, log, logf, Log);
+    RUN1("atan", tans, atan, atanf, Atan);
+    RUN2("pow", bases, powers, pow, powf, Pow);
+    RUN2("atan2", ys, xs, atan2, atan2f, Atan2);
+
+    // Special values.
+    const float inf = HUGE_VALF;
+    const float specials[][3] = {
+        { FastMath::Exp(inf), inf, 0 }, { FastMath::Exp(-inf), 0.0F, 0 }, { FastMath::Exp(100.0F), inf, 0 },
+        { FastMath::Log(0.0F), -inf, 0 }, { FastMath::Log(inf), inf, 0 }, { FastMath::Pow(0.0F, 2.0F), 0.0F, 0 },
+        { FastMath::Pow(0.0F, -1.0F), inf, 0 }, { FastMath::Pow(5.0F, 0.0F), 1.0F, 0 }, { FastMath::Atan(inf), 1.57079637F, 0 },
+        { FastMath::Atan2(0.0F, -1.0F), 3.14159274F, 0 }, { FastMath::Atan2(-0.0F, -0.0F), -3.14159274F, 0 },
+        { FastMath::Atan2(inf, inf), 0.785398185F, 0 }, { FastMath::Sin(-0.0F), -0.0F, 0 }, { FastMath::Cos(0.0F), 1.0F, 0 }
+    };
+    size_t bad_specials = 0;
+    for (size_t i = 0; i < sizeof(specials) / sizeof(specials[0]); i++)
+        bad_specials += memcmp(&specials[i][0], &specials[i][1], sizeof(float)) != 0;
+    bad_specials += !std::isnan(FastMath::Log(-1.0F)) + !std::isnan(FastMath::Sin(NAN)) + !std::isnan(FastMath::Exp(NAN)) + !std::isnan(FastMath::Atan2(NAN, 1.0F));
+
+    printf("simd width      %d lanes\n", RT_SIMD_WIDTH);
+    printf("batch mismatches %zu\n", g_mismatches);
+    printf("special values  %zu wrong\n", bad_specials);
+    return ((g_mismatches || bad_specials) ? 1 : 0);
+}
@@ -0,0 +1,258 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * Float parsing benchmark.
+ *
+ * Collects the `v` lines of every OBJ under the given directories
+ * (assets/models by default) and parses their x y z fields three ways: with
+ * the tryParseDouble path the loader used before fast_float.h, with one
+ * parseReal per field and with the batched parseReal3. Prints the time per
+ * float of each, keeping the fastest of N runs:
+ *
+ *   bench_float_parse [--iterations N] [dir-or-obj ...]
+ *
+ * parseReal and parseReal3 must return the same bits, every field must match
+ * strtof, and every parsed value printed with %.9g must parse back to the
+ * same bits; the exit status is non-zero otherwise. The baseline is not
+ * correctly rounded, so the fields where it differs are only counted.
+ * Git LFS pointers that were never fetched are skipped.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include "loaders/obj.h"
+#include "bench_assets.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+// The loader's float parser before fast_float.h, kept as the baseline.
+static bool baselineTryParseDouble(const char *s, const char *s_end, double *result)
+{
+    if (s >= s_end) return (false);
+    double mantissa = 0.0;
+    int exponent = 0;
+    char sign = '+';
+    char exp_sign = '+';
+    char const *curr = s;
+    int read = 0;
+    bool end_not_reached = false;
+    if (*curr == '+' || *curr == '-') {
+        sign = *curr;
+        curr++;
+    } else if (IS_DIGIT(*curr)) {} else { goto fail; }
+    end_not_reached = (curr != s_end);
+    while (end_not_reached && IS_DIGIT(*curr)) {
+        mantissa *= 10;
+        mantissa += static_cast<int>(*curr - 0x30);
+        curr++;
+        read++;
+        end_not_reached = (curr != s_end);
+    }
+    if (read == 0) goto fail;
+    if (!end_not_reached) goto assemble;
+    if (*curr == '.') {
+        curr++;
+        read = 1;
+        end_not_reached = (curr != s_end);
+        while (end_not_reached && IS_DIGIT(*curr)) {
+            static const double pow_lut[] = {
+                1.0, 0.1, 0.01, 0.001, 0.0001, 0.00001, 0.000001, 0.0000001,
+            };
+            const int lut_entries = sizeof pow_lut / sizeof pow_lut[0];
+            mantissa += static_cast<int>(*curr - 0x30) * (read < lut_entries ? pow_lut[read] : std::pow(10.0, -read));
+            read++;
+            curr++;
+            end_not_reached = (curr != s_end);
+        }
+    } else if (*curr == 'e' || *curr == 'E') {} else { goto assemble; }
+    if (!end_not_reached) goto assemble;
+    if (*curr == 'e' || *curr == 'E') {
+        curr++;
+        end_not_reached = (curr != s_end);
+        if (end_not_reached && (*curr == '+' || *curr == '-')) {
+            exp_sign = *curr;
+            curr++;
+        } else if (IS_DIGIT(*curr)) {} else { goto fail; }
+        read = 0;
+        end_not_reached = (curr != s_end);
+        while (end_not_reached && IS_DIGIT(*curr)) {
+            exponent *= 10;
+            exponent += static_cast<int>(*curr - 0x30);
+            curr++;
+            read++;
+            end_not_reached = (curr != s_end);
+        }
+        exponent *= (exp_sign == '+' ? 1 : -1);
+        if (read == 0) goto fail;
+    }
+assemble:
+    *result = (sign == '+' ? 1 : -1) *
+        (exponent ? std::ldexp(mantissa * std::pow(5.0, exponent), exponent) : mantissa);
+    return (true);
+fail:
+    return (false);
+}
+
+static inline float baselineParseReal(const char **token, double default_value = 0.0)
+{
+    (*token) += strspn((*token), " \t");
+    const char *end = (*token) + strcspn((*token), " \t\r");
+    double val = default_value;
+    baselineTryParseDouble((*token), end, &val);
+    float f = static_cast<float>(val);
+    (*token) = end;
+    return f;
+}
+
+// Appends the fields of every `v` line, each line NUL-terminated as the
+// loader sees it after its line split.
+static void collectVertexLines(const std::string &path, std::vector<char> *text, std::vector<size_t> *lines)
+{
+    MappedFile file;
+    if (!file.open(path.c_str())) return;
+    const char *p = file.data();
+    const char *end = p + file.size();
+    while (p < end) {
+        const char *eol = static_cast<const char *>(memchr(p, '\n', static_cast<size_t>(end - p)));
+        if (!eol) eol = end;
+        const char *s = p;
+        while (s < eol && IS_SPACE((*s))) s++;
+        if (eol - s > 2 && s[0] == 'v' && IS_SPACE(s[1])) {
+            lines->push_back(text->size());
+            text->insert(text->end(), s + 2, eol);
+            text->push_back('\0');
+        }
+        p = eol + 1;
+    }
+}
+
+static bool sameBits(float a, float b)
+{
+    return (memcmp(&a, &b, sizeof(float)) == 0);
+}
+
+static double elapsedNs(bench_clock::time_point start, size_t count)
+{
+    return (std::chrono::duration<double, std::nano>(bench_clock::now() - start).count() / static_cast<double>(count));
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: bench_float_parse [--iterations N] [dir-or-obj ...]\n");
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 20;
+    std::vector<std::string> roots;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::max(1, atoi(argv[++i]));
+        } else if (arg.compare(0, 1, "-") == 0) {
+            usage();
+            return (2);
+        } else {
+            roots.push_back(arg);
+        }
+    }
+    if (roots.empty()) {
+        roots.push_back("assets/models");
+    }
+    std::vector<std::string> files;
+    for (size_t i = 0; i < roots.size(); i++) {
+        collectObjFiles(roots[i], &files);
+    }
+    std::vector<char> text;
+    std::vector<size_t> lines;
+    for (size_t i = 0; i < files.size(); i++) {
+        collectVertexLines(files[i], &text, &lines);
+    }
+    if (lines.empty()) {
+        fprintf(stderr, "no v lines found\n");
+        return (1);
+    }
+    const size_t count = lines.size();
+    std::vector<float> baseline(count * 3), single(count * 3), batched(count * 3);
+    double best[3] = { HUGE_VAL, HUGE_VAL, HUGE_VAL };
+    for (int it = 0; it < iterations; it++) {
+        bench_clock::time_point start = bench_clock::now();
+        for (size_t i = 0; i < count; i++) {
+            const char *token = &text[lines[i]];
+            baseline[i * 3 + 0] = baselineParseReal(&token);
+            baseline[i * 3 + 1] = baselineParseReal(&token);
+            baseline[i * 3 + 2] = baselineParseReal(&token);
+        }
+        best[0] = std::min(best[0], elapsedNs(start, count * 3));
+        start = bench_clock::now();
+        for (size_t i = 0; i < count; i++) {
+            const char *token = &text[lines[i]];
+            single[i * 3 + 0] = parseReal(&token);
+            single[i * 3 + 1] = parseReal(&token);
+            single[i * 3 + 2] = parseReal(&token);
+        }
+        best[1] = std::min(best[1], elapsedNs(start, count * 3));
+        start = bench_clock::now();
+        for (size_t i = 0; i < count; i++) {
+            const char *token = &text[lines[i]];
+            parseReal3(&batched[i * 3 + 0], &batched[i * 3 + 1], &batched[i * 3 + 2], &token);
+        }
+        best[2] = std::min(best[2], elapsedNs(start, count * 3));
+    }
+
+    size_t failures = 0, baseline_diffs = 0;
+    for (size_t i = 0; i < count; i++) {
+        const char *p = &text[lines[i]];
+        for (int k = 0; k < 3; k++) {
+            float got = single[i * 3 + k];
+            p += strspn(p, " \t");
+            const char *end = p + strcspn(p, " \t\r");
+            std::string field(p, end);
+            p = end;
+            float ref = field.empty() ? 0.0F : strtof(field.c_str(), NULL);
+            char printed[32];
+            snprintf(printed, sizeof(printed), "%.9g", got);
+            float back = 0.0F;
+            parseFloatFast(printed, printed + strlen(printed), &back);
+            if (!sameBits(got, batched[i * 3 + k]) || !sameBits(got, ref) || !sameBits(got, back)) {
+                if (failures < 10) fprintf(stderr, "mismatch: \"%s\" -> %.9g, parseReal3 %.9g, strtof %.9g, %.9g\n", field.c_str(), got, batched[i * 3 + k], ref, back);
+                failures++;
+            }
+            baseline_diffs += !sameBits(got, baseline[i * 3 + k]);
+        }
+    }
+
+    printf("files           %zu\n", files.size());
+    printf("floats          %zu\n", count * 3);
+    printf("tryParseDouble  %6.2f ns/float\n", best[0]);
+    printf("parseReal       %6.2f ns/float  x%.2f\n", best[1], best[0] / best[1]);
+    printf("parseReal3      %6.2f ns/float  x%.2f\n", best[2], best[0] / best[2]);
+    printf("baseline diffs  %zu\n", baseline_diffs);
+    printf("failures        %zu\n", failures);
+    return (failures ? 1 : 0);
+}
@@ -0,0 +1,211 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+
+/**
+ * Half-float conversions.
+ *
+ * Checks every one of the 65536 halves (decoding, and encoding back to the
+ * same bits), then every 17th float (`--stride 1` for all of them) against a
+ * double-precision reference rounding and against the batch conversion,
+ * which must give the same bits. Then prints millions of values converted
+ * per second, scalar and batched:
+ *
+ *   bench_half [--stride N]
+ *
+ * Build with -mf16c (or -march=native) to exercise the F16C batch path.
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "maths/half.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+static size_t g_failures = 0;
+static volatile float g_sink = 0.0F;
+
+static void report(const char *name, size_t errors)
+{
+    printf("  %-44s %s", name, errors ? "FAILED" : "ok");
+    if (errors)
+        printf(" (%zu)", errors);
+    printf("\n");
+    g_failures += errors;
+}
+
+static float fromBits(uint32_t u)
+{
+    float f;
+    memcpy(&f, &u, sizeof(f));
+    return (f);
+}
+
+// Straightforward rounding through double: scale to units of the half ulp, round to even.
+static uint16_t reference(float f)
+{
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    uint16_t sign = static_cast<uint16_t>((u >> 16) & 0x8000u);
+    if (std::isnan(f))
+        return (static_cast<uint16_t>(sign | 0x7e00u | ((u >> 13) & 0x3ffu)));
+    double a = fabs(static_cast<double>(f));
+    if (a == 0.0)
+        return (sign);
+    int e;
+    frexp(a, &e);
+    // Exponent of the leading bit, clamped to the subnormal range.
+    int lead = std::max(e - 1, -14);
+    double ulp = ldexp(1.0, lead - 10);
+    double q = nearbyint(a / ulp);
+    double r = q * ulp;
+    if (r >= 65536.0)
+        return (static_cast<uint16_t>(sign | 0x7c00u));
+    if (r < ldexp(1.0, -14))
+        return (static_cast<uint16_t>(sign | static_cast<uint16_t>(q)));
+    frexp(r, &e);
+    uint32_t exp = static_cast<uint32_t>(e - 1 + 15);
+    uint32_t mant = static_cast<uint32_t>(ldexp(r, -(e - 1)) * 1024.0) - 1024u;
+    return (static_cast<uint16_t>(sign | (exp << 10) | mant));
+}
+
+static void checkHalves(void)
+{
+    std::vector<Half> halves(65536);
+    std::vector<float> floats(65536);
+    std::vector<Half> back(65536);
+    for (uint32_t h = 0; h < 65536; h++)
+        halves[h] = Half::FromBits(static_cast<uint16_t>(h));
+    Half::Decode(&halves[0], &floats[0], halves.size());
+    Half::Encode(&floats[0], &back[0], floats.size());
+    size_t decode = 0, roundtrip = 0, batch = 0;
+    for (uint32_t h = 0; h < 65536; h++)
+    {
+        float f = Half::Decode(static_cast<uint16_t>(h));
+        batch += memcmp(&f, &floats[h], sizeof(f)) != 0;
+        bool nan = (h & 0x7c00u) == 0x7c00u && (h & 0x3ffu);
+        if (nan)
+        {
+            // Quieted on the way back; the payload bits that fit survive.
+            decode += !std::isnan(f);
+            roundtrip += back[h].bits != (h | 0x200u) || Half::Encode(f) != (h | 0x200u);
+            continue;
+        }
+        int e = static_cast<int>((h >> 10) & 0x1fu);
+        double m = static_cast<double>(h & 0x3ffu);
+        double v = e == 0 ? ldexp(m, -24) : (e == 31 ? HUGE_VAL : ldexp(1024.0 + m, e - 25));
+        decode += static_cast<double>(fabsf(f)) != v || (std::signbit(f) != ((h & 0x8000u) != 0));
+        roundtrip += back[h].bits != h || Half::Encode(f) != h;
+    }
+    report("every half decodes to its value", decode);
+    report("every half encodes back to its bits", roundtrip);
+    report("batch decode matches scalar", batch);
+}
+
+static void checkFloats(uint32_t stride)
+{
+    const size_t block = 1 << 16;
+    std::vector<float> src(block);
+    std::vector<Half> dst(block);
+    size_t rounding = 0, batch = 0, count = 0;
+    uint64_t u = 0;
+    while (u < (1ULL << 32))
+    {
+        size_t n = 0;
+        for (; n < block && u < (1ULL << 32); n++, u += stride)
+            src[n] = fromBits(static_cast<uint32_t>(u));
+        Half::Encode(&src[0], &dst[0], n);
+        for (size_t i = 0; i < n; i++)
+        {
+            uint16_t h = Half::Encode(src[i]);
+            rounding += h != reference(src[i]);
+            batch += h != dst[i].bits;
+        }
+        count += n;
+    }
+    printf("  %zu floats (stride %u)\n", count, stride);
+    report("scalar encode rounds to nearest even", rounding);
+    report("batch encode matches scalar", batch);
+}
+
+static void throughput(size_t n)
+{
+    std::vector<float> src(n), back(n);
+    std::vector<Half> dst(n);
+    for (size_t i = 0; i < n; i++)
+        src[i] = static_cast<float>(i % 4093) * 0.37F - 700.0F;
+    const int rounds = 20;
+    double mvalues = static_cast<double>(n) * rounds * 1e-6;
+
+    bench_clock::time_point start = bench_clock::now();
+    for (int r = 0; r < rounds; r++)
+        for (size_t i = 0; i < n; i++)
+            dst[i].bits = Half::Encode(src[i]);
+    double encodeScalar = std::chrono::duration<double>(bench_clock::now() - start).count();
+    start = bench_clock::now();
+    for (int r = 0; r < rounds; r++)
+        Half::Encode(&src[0], &dst[0], n);
+    double encodeBatch = std::chrono::duration<double>(bench_clock::now() - start).count();
+    start = bench_clock::now();
+    for (int r = 0; r < rounds; r++)
+        for (size_t i = 0; i < n; i++)
+            back[i] = Half::Decode(dst[i].bits);
+    double decodeScalar = std::chrono::duration<double>(bench_clock::now() - start).count();
+    start = bench_clock::now();
+    for (int r = 0; r < rounds; r++)
+        Half::Decode(&dst[0], &back[0], n);
+    double decodeBatch = std::chrono::duration<double>(bench_clock::now() - start).count();
+    g_sink = back[n / 2];
+
+    printf("  encode  scalar %8.1f  batch %8.1f  Mvalues/s\n", mvalues / encodeScalar, mvalues / encodeBatch);
+    printf("  decode  scalar %8.1f  batch %8.1f  Mvalues/s\n", mvalues / decodeScalar, mvalues / decodeBatch);
+}
+
+int main(int argc, char **argv)
+{
+    uint32_t stride = 17;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--stride") == 0 && i + 1 < argc)
+            stride = static_cast<uint32_t>(std::max(1, atoi(argv[++i])));
+    }
+
+#if defined(RT_SIMD_F16C)
+    printf("batch path      f16c\n");
+#else
+    printf("batch path      scalar\n");
+#endif
+    printf("checks\n");
+    checkHalves();
+    checkFloats(stride);
+    printf("throughput\n");
+    throughput(1 << 20);
+    printf("failures        %zu\n", g_failures);
+    return (g_failures ? 1 : 0);
+}
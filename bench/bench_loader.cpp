@@ -0,0 +1,505 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * Loader benchmark.
+ *
+ * Loads every OBJ under the given directories (assets/models by default)
+ * with the memory-mapped LoadObj, keeps the fastest of N runs per asset and
+ * prints one JSON document:
+ *
+ *   bench_loader [--iterations N] [--prescan] [--threads N] [--weld] [--output file.json] [dir-or-obj ...]
+ *
+ * --prescan enables the counting pass that reserves every buffer up front.
+ * Run it in its own process to compare peak RSS against a run without it.
+ * --threads also times LoadObjParallel with N workers and marks the asset
+ * failed if its attrib, shapes or materials differ in any way from LoadObj.
+ * --weld welds every asset with WeldMeshes in both layouts, reports the
+ * bytes before and after, and marks the asset failed unless every corner
+ * reads back the position, normal and texcoord its index_t refers to.
+ * Unknown options print this usage and exit with status 2.
+ *
+ * A generated regression case is loaded first: one shape of
+ * BENCH_USEMTL_FACES triangles whose material alternates on every face. Each
+ * usemtl appends to the same shape, so its bytes allocated must stay linear
+ * in the mesh size; the asset is marked failed otherwise.
+ *
+ * Git LFS pointers that were never fetched are skipped. Allocation counts
+ * come from the global operator new below and cover one load;
+ * face_group_allocations is load_stats_t's count of face buffer growths.
+ * Peak RSS is the process high-water mark, so it is only reported for the
+ * whole run.
+ */
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+#include <sys/resource.h>
+#include "loaders/obj_parallel.h"
+#include "loaders/weld.h"
+#include "bench_assets.h"
+
+// The replacement operators below pair malloc with free on purpose.
+#if defined(__GNUC__) && !defined(__clang__) && __GNUC__ >= 11
+    #pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+
+#define BENCH_USEMTL_OBJ "bench_loader_usemtl.obj"
+#define BENCH_USEMTL_MTL "bench_loader_usemtl.mtl"
+#define BENCH_USEMTL_FACES 60000
+
+// Atomic since LoadObjParallel allocates from its worker threads.
+static std::atomic<size_t> g_allocations(0);
+static std::atomic<size_t> g_allocated_bytes(0);
+
+void *operator new(size_t size)
+{
+    g_allocations.fetch_add(1, std::memory_order_relaxed);
+    g_allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+    void *p = malloc(size ? size : 1);
+    if (!p) throw std::bad_alloc();
+    return (p);
+}
+
+void operator delete(void *p) noexcept { free(p); }
+void operator delete(void *p, size_t) noexcept { free(p); }
+
+typedef struct {
+    std::string path;
+    size_t bytes;
+    size_t shapes;
+    size_t materials;
+    size_t triangles;
+    double seconds;
+    double prescan_seconds;
+    double parallel_seconds;
+    double weld_seconds;
+    weld_stats_t weld;
+    size_t weld_interleaved_bytes;
+    size_t allocations;
+    size_t allocated_bytes;
+    size_t face_group_allocations;
+    bool ok;
+    std::string error;
+} bench_result_t;
+
+// A triangle strip, one usemtl line before each face, alternating m0 and m1.
+static bool writeUsemtlCase()
+{
+    FILE *mtl = fopen(BENCH_USEMTL_MTL, "w");
+    if (!mtl) return (false);
+    fprintf(mtl, "newmtl m0\nKd 1 0 0\nnewmtl m1\nKd 0 1 0\n");
+    fclose(mtl);
+    FILE *obj = fopen(BENCH_USEMTL_OBJ, "w");
+    if (!obj) return (false);
+    fprintf(obj, "mtllib " BENCH_USEMTL_MTL "\no strip\n");
+    for (int i = 0; i < BENCH_USEMTL_FACES + 2; i++) {
+        fprintf(obj, "v %d %d 0\n", i / 2, i % 2);
+    }
+    for (int i = 0; i < BENCH_USEMTL_FACES; i++) {
+        fprintf(obj, "usemtl m%d\nf %d %d %d\n", i % 2, i + 1, i + 2, i + 3);
+    }
+    fclose(obj);
+    return (true);
+}
+
+// Final size of the mesh arrays; a load that allocates many times that is quadratic.
+static bool checkUsemtlCase(bench_result_t *result)
+{
+    size_t mesh_bytes = result->triangles * (3 * sizeof(index_t) + sizeof(unsigned char) + sizeof(int));
+    if (result->ok && result->triangles != BENCH_USEMTL_FACES) {
+        result->ok = false;
+        result->error = "wrong triangle count";
+    } else if (result->ok && result->allocated_bytes > 16 * mesh_bytes + result->bytes) {
+        result->ok = false;
+        result->error = "allocations grow faster than the mesh (quadratic usemtl flushes)";
+    }
+    return (result->ok);
+}
+
+static bool sameFloats(const std::vector<float> &a, const std::vector<float> &b)
+{
+    // Bitwise, so that both loaders must also agree on NaNs and signed zeros.
+    return (a.size() == b.size() && (a.empty() || memcmp(&a[0], &b[0], a.size() * sizeof(float)) == 0));
+}
+
+static bool sameTag(const tag_t &a, const tag_t &b)
+{
+    return (a.name == b.name && a.intValues == b.intValues && sameFloats(a.floatValues, b.floatValues)
+        && a.stringValues == b.stringValues);
+}
+
+static bool sameShape(const shape_t &a, const shape_t &b)
+{
+    const mesh_t &ma = a.mesh, &mb = b.mesh;
+    if (a.name != b.name || ma.indices.size() != mb.indices.size() || ma.num_face_vertices != mb.num_face_vertices
+        || ma.material_ids != mb.material_ids || ma.tags.size() != mb.tags.size()) {
+        return (false);
+    }
+    for (size_t i = 0; i < ma.indices.size(); i++) {
+        if (ma.indices[i].vertex_index != mb.indices[i].vertex_index || ma.indices[i].normal_index != mb.indices[i].normal_index
+            || ma.indices[i].texcoord_index != mb.indices[i].texcoord_index) {
+            return (false);
+        }
+    }
+    for (size_t i = 0; i < ma.tags.size(); i++) {
+        if (!sameTag(ma.tags[i], mb.tags[i])) return (false);
+    }
+    return (true);
+}
+
+static bool sameFloatArray(const float *a, const float *b, size_t n)
+{
+    return (memcmp(a, b, n * sizeof(float)) == 0);
+}
+
+static bool sameTextureOption(const texture_option_t &a, const texture_option_t &b)
+{
+    return (a.type == b.type && sameFloatArray(&a.sharpness, &b.sharpness, 1) && sameFloatArray(&a.brightness, &b.brightness, 1)
+        && sameFloatArray(&a.contrast, &b.contrast, 1) && sameFloatArray(a.origin_offset, b.origin_offset, 3)
+        && sameFloatArray(a.scale, b.scale, 3) && sameFloatArray(a.turbulence, b.turbulence, 3)
+        && a.clamp == b.clamp && a.imfchan == b.imfchan && a.blendu == b.blendu && a.blendv == b.blendv
+        && sameFloatArray(&a.bump_multiplier, &b.bump_multiplier, 1));
+}
+
+static bool sameMaterial(const material_t &a, const material_t &b)
+{
+    if (a.name != b.name || !sameFloatArray(a.ambient, b.ambient, 3) || !sameFloatArray(a.diffuse, b.diffuse, 3)
+        || !sameFloatArray(a.specular, b.specular, 3) || !sameFloatArray(a.transmittance, b.transmittance, 3)
+        || !sameFloatArray(a.emission, b.emission, 3) || !sameFloatArray(&a.shininess, &b.shininess, 1)
+        || !sameFloatArray(&a.ior, &b.ior, 1) || !sameFloatArray(&a.dissolve, &b.dissolve, 1) || a.illum != b.illum
+        || !sameFloatArray(&a.roughness, &b.roughness, 1) || !sameFloatArray(&a.metallic, &b.metallic, 1)
+        || !sameFloatArray(&a.sheen, &b.sheen, 1) || !sameFloatArray(&a.clearcoat_thickness, &b.clearcoat_thickness, 1)
+        || !sameFloatArray(&a.clearcoat_roughness, &b.clearcoat_roughness, 1) || !sameFloatArray(&a.anisotropy, &b.anisotropy, 1)
+        || !sameFloatArray(&a.anisotropy_rotation, &b.anisotropy_rotation, 1) || a.unknown_parameter != b.unknown_parameter) {
+        return (false);
+    }
+    // InitMaterial leaves a texture option unset until its texture line is parsed.
+#define X(n) \
+    if (a.n##_texname != b.n##_texname || (!a.n##_texname.empty() && !sameTextureOption(a.n##_texopt, b.n##_texopt))) return (false);
+    OBJ_MATERIAL_TEXTURES(X)
+#undef X
+    return (true);
+}
+
+// Names the first part of a parallel load that differs from the serial one, or returns "".
+static std::string compareLoads(const attrib_t &attrib, const std::vector<shape_t> &shapes, const std::vector<material_t> &materials,
+    const attrib_t &pattrib, const std::vector<shape_t> &pshapes, const std::vector<material_t> &pmaterials)
+{
+    if (!sameFloats(attrib.vertices, pattrib.vertices)) return ("vertices");
+    if (!sameFloats(attrib.normals, pattrib.normals)) return ("normals");
+    if (!sameFloats(attrib.texcoords, pattrib.texcoords)) return ("texcoords");
+    if (shapes.size() != pshapes.size()) return ("shape count");
+    for (size_t i = 0; i < shapes.size(); i++) {
+        if (!sameShape(shapes[i], pshapes[i])) return ("shape [" + shapes[i].name + "]");
+    }
+    if (materials.size() != pmaterials.size()) return ("material count");
+    for (size_t i = 0; i < materials.size(); i++) {
+        if (!sameMaterial(materials[i], pmaterials[i])) return ("material [" + materials[i].name + "]");
+    }
+    return ("");
+}
+
+// Attribute a corner refers to; missing and out-of-range indices read as 0.
+static void cornerAttribute(const std::vector<float> &src, int index, int components, float *dst)
+{
+    bool valid = index >= 0 && static_cast<size_t>(index) < src.size() / components;
+    for (int c = 0; c < components; c++) {
+        dst[c] = valid ? src[static_cast<size_t>(index) * components + c] : 0.0f;
+    }
+}
+
+// Names the first welded shape whose vertices do not reproduce its corners, or returns "".
+static std::string checkWeld(const attrib_t &attrib, const std::vector<shape_t> &shapes, const std::vector<welded_mesh_t> &welded)
+{
+    if (welded.size() != shapes.size()) return ("shape count");
+    for (size_t s = 0; s < shapes.size(); s++) {
+        const std::vector<index_t> &corners = shapes[s].mesh.indices;
+        const welded_mesh_t &m = welded[s];
+        if (m.indices.size() != corners.size() || m.num_vertices > corners.size()
+            || m.num_face_vertices != shapes[s].mesh.num_face_vertices || m.material_ids != shapes[s].mesh.material_ids) {
+            return ("shape [" + shapes[s].name + "] faces");
+        }
+        for (size_t i = 0; i < corners.size(); i++) {
+            const uint32_t v = m.indices[i];
+            if (v >= m.num_vertices) return ("shape [" + shapes[s].name + "] indices");
+            float expected[WELD_INTERLEAVED_STRIDE], actual[WELD_INTERLEAVED_STRIDE] = {0};
+            cornerAttribute(attrib.vertices, corners[i].vertex_index, 3, expected);
+            cornerAttribute(attrib.normals, corners[i].normal_index, 3, expected + 3);
+            cornerAttribute(attrib.texcoords, corners[i].texcoord_index, 2, expected + 6);
+            if (m.layout == WELD_LAYOUT_INTERLEAVED) {
+                memcpy(actual, &m.interleaved[static_cast<size_t>(v) * WELD_INTERLEAVED_STRIDE], sizeof(actual));
+            } else {
+                memcpy(actual, &m.positions[static_cast<size_t>(v) * 3], 3 * sizeof(float));
+                if (!m.normals.empty()) memcpy(actual + 3, &m.normals[static_cast<size_t>(v) * 3], 3 * sizeof(float));
+                if (!m.texcoords.empty()) memcpy(actual + 6, &m.texcoords[static_cast<size_t>(v) * 2], 2 * sizeof(float));
+            }
+            if (memcmp(expected, actual, sizeof(actual)) != 0) {
+                return ("shape [" + shapes[s].name + "] attributes");
+            }
+        }
+    }
+    return ("");
+}
+
+static void benchWeld(const attrib_t &attrib, const std::vector<shape_t> &shapes, bench_result_t *result)
+{
+    std::vector<welded_mesh_t> welded;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    WeldMeshes(attrib, shapes, &welded, WELD_LAYOUT_SOA, &result->weld);
+    result->weld_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    std::string diff = checkWeld(attrib, shapes, welded);
+    weld_stats_t interleaved;
+    if (diff.empty()) {
+        WeldMeshes(attrib, shapes, &welded, WELD_LAYOUT_INTERLEAVED, &interleaved);
+        result->weld_interleaved_bytes = interleaved.bytes_after;
+        diff = checkWeld(attrib, shapes, welded);
+    }
+    if (!diff.empty()) {
+        result->ok = false;
+        result->error = "welded mesh differs from the corners in " + diff;
+    }
+}
+
+static long peakRssKb()
+{
+    struct rusage usage;
+    getrusage(RUSAGE_SELF, &usage);
+    return (usage.ru_maxrss);
+}
+
+static bench_result_t benchAsset(const std::string &path, int iterations, bool prescan, unsigned int threads, bool weld)
+{
+    bench_result_t result;
+    result.path = path;
+    result.bytes = result.shapes = result.materials = result.triangles = 0;
+    result.seconds = result.prescan_seconds = result.parallel_seconds = result.weld_seconds = 0.0;
+    memset(&result.weld, 0, sizeof(result.weld));
+    result.weld_interleaved_bytes = 0;
+    result.allocations = result.allocated_bytes = result.face_group_allocations = 0;
+    result.ok = true;
+    std::string basedir = path.substr(0, path.find_last_of('/') + 1);
+    // Output of the last serial load, the reference for --threads and --weld.
+    attrib_t attrib;
+    std::vector<shape_t> shapes;
+    std::vector<material_t> materials;
+    for (int it = 0; it < iterations && result.ok; it++) {
+        // Fresh outputs every time, so that each load allocates from scratch.
+        attrib_t load_attrib;
+        std::vector<shape_t> load_shapes;
+        std::vector<material_t> load_materials;
+        std::string err;
+        load_stats_t stats;
+        size_t allocations = g_allocations;
+        size_t allocated_bytes = g_allocated_bytes;
+        result.ok = LoadObj(&load_attrib, &load_shapes, &load_materials, &err, path.c_str(), basedir.c_str(), true, &stats, prescan);
+        allocations = g_allocations - allocations;
+        allocated_bytes = g_allocated_bytes - allocated_bytes;
+        if (!result.ok) {
+            result.error = err;
+            break;
+        }
+        std::swap(attrib, load_attrib);
+        shapes.swap(load_shapes);
+        materials.swap(load_materials);
+        if (it == 0 || stats.seconds < result.seconds) {
+            result.seconds = stats.seconds;
+            result.prescan_seconds = stats.prescan_seconds;
+        }
+        result.bytes = stats.bytes;
+        result.allocations = allocations;
+        result.allocated_bytes = allocated_bytes;
+        result.face_group_allocations = stats.face_group_allocations;
+        result.shapes = shapes.size();
+        result.materials = materials.size();
+        result.triangles = 0;
+        for (size_t s = 0; s < shapes.size(); s++) {
+            result.triangles += shapes[s].mesh.num_face_vertices.size();
+        }
+    }
+    for (int it = 0; threads > 0 && it < iterations && result.ok; it++) {
+        attrib_t pattrib;
+        std::vector<shape_t> pshapes;
+        std::vector<material_t> pmaterials;
+        std::string err;
+        load_stats_t stats;
+        result.ok = LoadObjParallel(&pattrib, &pshapes, &pmaterials, &err, path.c_str(), basedir.c_str(), true, threads, &stats);
+        if (!result.ok) {
+            result.error = "LoadObjParallel: " + err;
+            break;
+        }
+        if (it == 0 || stats.seconds < result.parallel_seconds) {
+            result.parallel_seconds = stats.seconds;
+        }
+        std::string diff = compareLoads(attrib, shapes, materials, pattrib, pshapes, pmaterials);
+        if (!diff.empty()) {
+            result.ok = false;
+            result.error = "LoadObjParallel differs from LoadObj in " + diff;
+        }
+    }
+    if (weld && result.ok) {
+        benchWeld(attrib, shapes, &result);
+    }
+    return (result);
+}
+
+static std::string jsonEscape(const std::string &s)
+{
+    std::string out;
+    for (size_t i = 0; i < s.size(); i++) {
+        char c = s[i];
+        if (c == '"' || c == '\\') {
+            out += '\\';
+            out += c;
+        } else if (static_cast<unsigned char>(c) < 0x20) {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", c);
+            out += buf;
+        } else {
+            out += c;
+        }
+    }
+    return (out);
+}
+
+static void writeJson(FILE *out, const std::vector<bench_result_t> &results, int iterations, bool prescan, unsigned int threads, bool weld)
+{
+    double total_seconds = 0.0, total_parallel_seconds = 0.0;
+    size_t total_bytes = 0, total_triangles = 0, total_weld_before = 0, total_weld_after = 0;
+    fprintf(out, "{\n  \"iterations\": %d,\n  \"prescan\": %s,\n  \"threads\": %u,\n  \"weld\": %s,\n  \"assets\": [\n",
+        iterations, prescan ? "true" : "false", threads, weld ? "true" : "false");
+    for (size_t i = 0; i < results.size(); i++) {
+        const bench_result_t &r = results[i];
+        double mb_s = r.seconds > 0.0 ? (static_cast<double>(r.bytes) / (1024.0 * 1024.0)) / r.seconds : 0.0;
+        double tri_s = r.seconds > 0.0 ? static_cast<double>(r.triangles) / r.seconds : 0.0;
+        fprintf(out, "    {\"path\": \"%s\", \"ok\": %s", jsonEscape(r.path).c_str(), r.ok ? "true" : "false");
+        if (!r.ok) {
+            fprintf(out, ", \"error\": \"%s\"", jsonEscape(r.error).c_str());
+        }
+        fprintf(out, ", \"bytes\": %zu, \"shapes\": %zu, \"materials\": %zu, \"triangles\": %zu"
+            ", \"seconds\": %.6f, \"prescan_seconds\": %.6f, \"megabytes_per_second\": %.2f, \"triangles_per_second\": %.0f"
+            ", \"allocations\": %zu, \"allocated_bytes\": %zu, \"face_group_allocations\": %zu",
+            r.bytes, r.shapes, r.materials, r.triangles, r.seconds, r.prescan_seconds, mb_s, tri_s,
+            r.allocations, r.allocated_bytes, r.face_group_allocations);
+        if (threads > 0) {
+            fprintf(out, ", \"parallel_seconds\": %.6f, \"parallel_speedup\": %.2f",
+                r.parallel_seconds, r.parallel_seconds > 0.0 ? r.seconds / r.parallel_seconds : 0.0);
+        }
+        if (weld) {
+            fprintf(out, ", \"weld_corners\": %zu, \"weld_vertices\": %zu, \"weld_bytes_before\": %zu"
+                ", \"weld_bytes_after\": %zu, \"weld_interleaved_bytes_after\": %zu, \"weld_bad_indices\": %zu, \"weld_seconds\": %.6f",
+                r.weld.corners, r.weld.unique_vertices, r.weld.bytes_before, r.weld.bytes_after,
+                r.weld_interleaved_bytes, r.weld.bad_indices, r.weld_seconds);
+        }
+        fprintf(out, "}%s\n", i + 1 < results.size() ? "," : "");
+        if (r.ok) {
+            total_seconds += r.seconds;
+            total_parallel_seconds += r.parallel_seconds;
+            total_weld_before += r.weld.bytes_before;
+            total_weld_after += r.weld.bytes_after;
+            total_bytes += r.bytes;
+            total_triangles += r.triangles;
+        }
+    }
+    fprintf(out, "  ],\n  \"total\": {\"bytes\": %zu, \"triangles\": %zu, \"seconds\": %.6f"
+        ", \"megabytes_per_second\": %.2f",
+        total_bytes, total_triangles, total_seconds,
+        total_seconds > 0.0 ? (static_cast<double>(total_bytes) / (1024.0 * 1024.0)) / total_seconds : 0.0);
+    if (threads > 0) {
+        fprintf(out, ", \"parallel_seconds\": %.6f", total_parallel_seconds);
+    }
+    if (weld) {
+        fprintf(out, ", \"weld_bytes_before\": %zu, \"weld_bytes_after\": %zu", total_weld_before, total_weld_after);
+    }
+    fprintf(out, ", \"peak_rss_kb\": %ld}\n}\n", peakRssKb());
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: bench_loader [--iterations N] [--prescan] [--threads N] [--weld] [--output file.json] [dir-or-obj ...]\n");
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 3;
+    bool prescan = false;
+    unsigned int threads = 0;
+    bool weld = false;
+    const char *output = NULL;
+    std::vector<std::string> roots;
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--iterations" && i + 1 < argc) {
+            iterations = std::max(1, atoi(argv[++i]));
+        } else if (arg == "--prescan") {
+            prescan = true;
+        } else if (arg == "--threads" && i + 1 < argc) {
+            threads = static_cast<unsigned int>(std::max(1, atoi(argv[++i])));
+        } else if (arg == "--weld") {
+            weld = true;
+        } else if (arg == "--output" && i + 1 < argc) {
+            output = argv[++i];
+        } else if (arg.compare(0, 1, "-") == 0) {
+            usage();
+            return (2);
+        } else {
+            roots.push_back(arg);
+        }
+    }
+    if (roots.empty()) {
+        roots.push_back("assets/models");
+    }
+    std::vector<std::string> files;
+    bool usemtl_case = writeUsemtlCase();
+    if (usemtl_case) {
+        files.push_back(BENCH_USEMTL_OBJ);
+    }
+    for (size_t i = 0; i < roots.size(); i++) {
+        collectObjFiles(roots[i], &files);
+    }
+    std::vector<bench_result_t> results;
+    for (size_t i = 0; i < files.size(); i++) {
+        results.push_back(benchAsset(files[i], iterations, prescan, threads, weld));
+        if (usemtl_case && i == 0) {
+            checkUsemtlCase(&results.back());
+            remove(BENCH_USEMTL_OBJ);
+            remove(BENCH_USEMTL_MTL);
+        }
+        fprintf(stderr, "[%zu/%zu] %s %.2f ms\n", i + 1, files.size(), files[i].c_str(), results.back().seconds * 1e3);
+    }
+    FILE *out = output ? fopen(output, "w") : stdout;
+    if (!out) {
+        fprintf(stderr, "Cannot open [%s]\n", output);
+        return (1);
+    }
+    writeJson(out, results, iterations, prescan, threads, weld);
+    if (output) fclose(out);
+    for (size_t i = 0; i < results.size(); i++) {
+        if (!results[i].ok) return (1);
+    }
+    return (0);
+}
@@ -0,0 +1,168 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * Material table benchmark.
+ *
+ * Loads an MTL file (assets/models/sponza/sponza.mtl by default) and builds a
+ * MaterialTable from it. Prints the memory held by the material_t list
+ * (MaterialListBytes) next to MaterialTable::bytes(), and the time per name
+ * lookup through the std::map filled by LoadMtl and through
+ * MaterialTable::find:
+ *
+ *   bench_materials [--rounds N] [file.mtl]
+ *
+ * Also checks that the table agrees with the list: shading values, names,
+ * texture paths and options, lookups of every name and of unknown ones, and
+ * MATERIAL_NO_TEXTURE or out-of-range texture handles. Prints what failed
+ * and exits non-zero if anything did.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include "loaders/material_table.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+static size_t g_failures = 0;
+static volatile long g_sink = 0;
+
+#define CHECK(cond) checkThat(static_cast<bool>(cond), #cond, __LINE__)
+
+static void checkThat(bool ok, const char *what, int line)
+{
+    if (!ok) {
+        fprintf(stderr, "line %d: %s\n", line, what);
+        g_failures++;
+    }
+}
+
+static void checkTable(const std::vector<material_t> &materials, const std::map<std::string, int> &material_map, const MaterialTable &table)
+{
+    CHECK(table.size() == materials.size());
+    for (size_t i = 0; i < materials.size() && i < table.size(); i++) {
+        const material_t &m = materials[i];
+        const material_shading_t &s = table[i];
+        CHECK(strcmp(table.name(i), m.name.c_str()) == 0);
+        CHECK(memcmp(s.diffuse, m.diffuse, sizeof(s.diffuse)) == 0);
+        CHECK(s.shininess == m.shininess && s.dissolve == m.dissolve && s.illum == m.illum);
+        int texture = 0;
+#define X(n) \
+        CHECK(strcmp(table.texturePath(s.textures[texture]), m.n##_texname.c_str()) == 0); \
+        CHECK(m.n##_texname.empty() || table.textureOption(s.textures[texture]).imfchan == m.n##_texopt.imfchan); \
+        texture++;
+        OBJ_MATERIAL_TEXTURES(X)
+#undef X
+    }
+    for (std::map<std::string, int>::const_iterator it = material_map.begin(); it != material_map.end(); ++it) {
+        CHECK(table.find(it->first) == it->second);
+    }
+    CHECK(table.find("no such material") == -1);
+
+    const int32_t invalid[] = { MATERIAL_NO_TEXTURE, static_cast<int32_t>(table.textures().size()), 1 << 30, -7 };
+    for (size_t i = 0; i < sizeof(invalid) / sizeof(invalid[0]); i++) {
+        CHECK(strcmp(table.texturePath(invalid[i]), "") == 0);
+        const texture_option_t &option = table.textureOption(invalid[i]);
+        CHECK(option.type == TEXTURE_TYPE_NONE && option.imfchan == 'm' && option.bump_multiplier == 1.0f
+            && option.scale[0] == 1.0f && option.blendu && !option.clamp);
+    }
+
+    MaterialTable empty;
+    empty.build(std::vector<material_t>());
+    CHECK(empty.size() == 0 && empty.find("leaf") == -1);
+    CHECK(strcmp(empty.texturePath(0), "") == 0);
+}
+
+static void usage(void)
+{
+    fprintf(stderr, "usage: bench_materials [--rounds N] [file.mtl]\n");
+}
+
+int main(int argc, char **argv)
+{
+    int rounds = 200000;
+    const char *path = "assets/models/sponza/sponza.mtl";
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--rounds" && i + 1 < argc) {
+            rounds = std::max(1, atoi(argv[++i]));
+        } else if (arg.compare(0, 1, "-") == 0) {
+            usage();
+            return (2);
+        } else {
+            path = argv[i];
+        }
+    }
+    std::ifstream stream(path);
+    if (!stream) {
+        fprintf(stderr, "Cannot open [%s]\n", path);
+        return (1);
+    }
+    std::map<std::string, int> material_map;
+    std::vector<material_t> materials;
+    std::string warning;
+    LoadMtl(&material_map, &materials, &stream, &warning);
+    MaterialTable table;
+    table.build(materials);
+    checkTable(materials, material_map, table);
+
+    std::vector<std::string> names;
+    for (size_t i = 0; i < materials.size(); i++) names.push_back(materials[i].name);
+    size_t lookups = static_cast<size_t>(rounds) * names.size();
+
+    long sum = 0;
+    bench_clock::time_point start = bench_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < names.size(); i++) {
+            std::map<std::string, int>::const_iterator it = material_map.find(names[i]);
+            sum += it == material_map.end() ? -1 : it->second;
+        }
+    }
+    double map_seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+    long expected = sum;
+    sum = 0;
+    start = bench_clock::now();
+    for (int r = 0; r < rounds; r++) {
+        for (size_t i = 0; i < names.size(); i++) {
+            sum += table.find(names[i]);
+        }
+    }
+    double table_seconds = std::chrono::duration<double>(bench_clock::now() - start).count();
+    CHECK(sum == expected);
+    g_sink = sum;
+
+    printf("file            %s\n", path);
+    printf("materials       %zu\n", materials.size());
+    printf("textures        %zu unique\n", table.textures().size());
+    printf("material_t list %zu bytes\n", MaterialListBytes(materials));
+    printf("MaterialTable   %zu bytes\n", table.bytes());
+    printf("map lookup      %.1f ns\n", lookups ? map_seconds * 1e9 / lookups : 0.0);
+    printf("table lookup    %.1f ns\n", lookups ? table_seconds * 1e9 / lookups : 0.0);
+    printf("failures        %zu\n", g_failures);
+    return (g_failures ? 1 : 0);
+}
@@ -0,0 +1,481 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * Maths micro-benchmark.
+ *
+ * Runs transform-heavy loops once through the SIMD kernels selected by
+ * config.h and once through the scalar formulas of Vec3/Mat4, checks that
+ * both produce bit-identical results, and prints the timings. Matrix
+ * inverses are compared against a naive cofactor expansion instead, by
+ * time and by worst residual |M * inverse(M) - I|. Then checks that the
+ * Mat4 and Affine3x4 constructors and inverses agree on the translation, and
+ * that every Vec3xW operation gives, lane by lane, the bits of the matching
+ * Vec3 operation for W = 4, 8 and 16, with NaNs, infinities and signed zeros
+ * among the inputs:
+ *
+ *   bench_maths [--iterations N]
+ *
+ * Build with the target flags to measure (e.g. CXXFLAGS+=-mavx2) and with
+ * -ffp-contract=off, so that the compiler does not fuse the scalar
+ * reference into FMAs behind our back.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "maths/affine3x4.h"
+#include "maths/mat4.h"
+#include "maths/packet.h"
+#include "maths/simd.h"
+#include "maths/vec3a.h"
+#include "maths/vec4a.h"
+#include "maths/vecn.h"
+
+struct ScalarVec3
+{
+    float x, y, z;
+};
+
+// Scalar reference: the expressions of Mat4::operator* before the SIMD
+// backend, written into a local like the by-value result of operator*.
+static void scalarMat4Multiply(const float a[4][4], const float b[4][4], float out[4][4])
+{
+    float r[4][4];
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            r[i][j] = (a[i][0] * b[0][j]) + (a[i][1] * b[1][j]) +(a[i][2] * b[2][j]) + (a[i][3] * b[3][j]);
+    memcpy(out, r, sizeof(r));
+}
+
+static ScalarVec3 scalarNormalize(const ScalarVec3& a)
+{
+    float l = sqrtf((a.x * a.x) + (a.y * a.y) + (a.z * a.z));
+    ScalarVec3 out = { a.x / l, a.y / l, a.z / l };
+    return (out);
+}
+
+static ScalarVec3 scalarCross(const ScalarVec3& a, const ScalarVec3& b)
+{
+    ScalarVec3 out = {
+        (a.y * b.z) - (a.z * b.y),
+        (a.z * b.x) - (a.x * b.z),
+        (a.x * b.y) - (a.y * b.x)
+    };
+    return (out);
+}
+
+static float scalarDot(const ScalarVec3& a, const ScalarVec3& b)
+{
+    return ((a.x * b.x) + (a.y * b.y) + (a.z * b.z));
+}
+
+static float minor3(const float m[4][4], int row, int col)
+{
+    float s[3][3];
+    for (int i = 0, si = 0; i < 4; i++)
+    {
+        if (i == row) continue;
+        for (int j = 0, sj = 0; j < 4; j++)
+        {
+            if (j == col) continue;
+            s[si][sj++] = m[i][j];
+        }
+        si++;
+    }
+    return (s[0][0] * (s[1][1] * s[2][2] - s[1][2] * s[2][1])
+        - s[0][1] * (s[1][0] * s[2][2] - s[1][2] * s[2][0])
+        + s[0][2] * (s[1][0] * s[2][1] - s[1][1] * s[2][0]));
+}
+
+// Naive reference: adjugate from the sixteen 3x3 minors, Laplace determinant.
+static bool naiveMat4Inverse(const float m[4][4], float out[4][4])
+{
+    float cof[4][4];
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            cof[i][j] = ((i + j) & 1 ? -1.0F : 1.0F) * minor3(m, i, j);
+    float det = m[0][0] * cof[0][0] + m[0][1] * cof[0][1] + m[0][2] * cof[0][2] + m[0][3] * cof[0][3];
+    if (det == 0.0F)
+        return (false);
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            out[i][j] = cof[j][i] / det;
+    return (true);
+}
+
+static float residual(const float m[4][4], const float inv[4][4])
+{
+    float p[4][4], worst = 0.0F;
+    scalarMat4Multiply(m, inv, p);
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            worst = std::max(worst, fabsf(p[i][j] - (i == j ? 1.0F : 0.0F)));
+    return (worst);
+}
+
+static float randomFloat(void)
+{
+    return ((static_cast<float>(rand()) / RAND_MAX) * 4.0F - 2.0F);
+}
+
+static bool sameBits(const void *a, const void *b, size_t n)
+{
+    return (memcmp(a, b, n) == 0);
+}
+
+static bool near3(const Vec3& a, float x, float y, float z)
+{
+    return (fabsf(a.x - x) < 1e-5F && fabsf(a.y - y) < 1e-5F && fabsf(a.z - z) < 1e-5F);
+}
+
+// Translate, QuatToMatrix, GetPosition, Inverse3DAffine and Affine3x4 must
+// all agree on where the translation lives. Returns the number of failures.
+static size_t checkAffineConventions(void)
+{
+    size_t failures = 0;
+    const Vec3 t(1.0F, 2.0F, 3.0F);
+    const Mat4 translate = Mat4::Translate(t);
+    // Quarter turn about +z: x goes to y.
+    const float h = sqrtf(0.5F);
+    const Mat4 rotate = Mat4::QuatToMatrix(0.0F, 0.0F, h, h);
+    const Mat4 both = translate * rotate;
+    Mat4 inverse;
+
+    failures += !near3(translate.GetPosition(), 1.0F, 2.0F, 3.0F);
+    failures += !near3(rotate.MultiplyVector(Vec3(1.0F, 0.0F, 0.0F)), 0.0F, 1.0F, 0.0F);
+    failures += !near3(both.MultiplyPoint3x4(Vec3(1.0F, 0.0F, 0.0F)), 1.0F, 3.0F, 3.0F);
+    failures += !near3(Affine3x4(translate).MultiplyPoint(Vec3(0.0F, 0.0F, 0.0F)), 1.0F, 2.0F, 3.0F);
+    failures += !near3(Affine3x4(both).MultiplyPoint(Vec3(1.0F, 0.0F, 0.0F)), 1.0F, 3.0F, 3.0F);
+
+    failures += !Mat4::Inverse3DAffine(translate, inverse);
+    failures += !near3(inverse.GetPosition(), -1.0F, -2.0F, -3.0F);
+    failures += !Mat4::Inverse3DAffine(rotate, inverse);
+    failures += !near3(inverse.MultiplyVector(Vec3(0.0F, 1.0F, 0.0F)), 1.0F, 0.0F, 0.0F);
+    failures += !Mat4::Inverse3DAffine(both, inverse);
+    failures += !near3(inverse.MultiplyPoint3x4(Vec3(1.0F, 3.0F, 3.0F)), 1.0F, 0.0F, 0.0F);
+    failures += !near3(Affine3x4(both).Inverse().MultiplyPoint(Vec3(1.0F, 3.0F, 3.0F)), 1.0F, 0.0F, 0.0F);
+
+    // Single and batched transforms of a point by Translate.
+    float points[2][3] = { { 0.0F, 0.0F, 0.0F }, { 4.0F, 5.0F, 6.0F } };
+    float moved[2][3], vectors[2][3];
+    failures += !near3(translate.MultiplyPoint(Vec3(0.0F, 0.0F, 0.0F)), 1.0F, 2.0F, 3.0F);
+    failures += !near3(translate.MultiplyPoint3x4(Vec3(4.0F, 5.0F, 6.0F)), 5.0F, 7.0F, 9.0F);
+    failures += !near3(translate.MultiplyVector(Vec3(4.0F, 5.0F, 6.0F)), 4.0F, 5.0F, 6.0F);
+    translate.MultiplyPoints(points[0], 3, moved[0], 3, 2);
+    failures += !near3(Vec3(moved[0][0], moved[0][1], moved[0][2]), 1.0F, 2.0F, 3.0F);
+    failures += !near3(Vec3(moved[1][0], moved[1][1], moved[1][2]), 5.0F, 7.0F, 9.0F);
+    translate.MultiplyPoints3x4(points[0], 3, moved[0], 3, 2);
+    failures += !near3(Vec3(moved[1][0], moved[1][1], moved[1][2]), 5.0F, 7.0F, 9.0F);
+    translate.MultiplyVectors(points[0], 3, vectors[0], 3, 2);
+    failures += !near3(Vec3(vectors[1][0], vectors[1][1], vectors[1][2]), 4.0F, 5.0F, 6.0F);
+
+    const Mat4 columns(Vec4(1.0F, 0.0F, 0.0F, 0.0F), Vec4(0.0F, 1.0F, 0.0F, 0.0F), Vec4(0.0F, 0.0F, 1.0F, 0.0F), Vec4(1.0F, 2.0F, 3.0F, 1.0F));
+    failures += columns != translate;
+
+    // A translation left in row 3 is not affine and must be refused.
+    Mat4 projective;
+    projective[3][0] = 1.0F;
+    failures += Mat4::Inverse3DAffine(projective, inverse);
+    return (failures);
+}
+
+typedef std::chrono::steady_clock bench_clock;
+
+// Equal bits, or NaN on both sides: NaN payloads are not part of the contract.
+static bool sameLane(float a, float b)
+{
+    return (sameBits(&a, &b, sizeof(float)) || (std::isnan(a) && std::isnan(b)));
+}
+
+template <int W>
+static size_t compareLane(const Vec3xW<W>& packet, int lane, const Vec3& v)
+{
+    return (!sameLane(packet.x[lane], v.x) || !sameLane(packet.y[lane], v.y) || !sameLane(packet.z[lane], v.z));
+}
+
+static float specialFloat(size_t i)
+{
+    static const float specials[] = { NAN, -NAN, 0.0F, -0.0F, INFINITY, -INFINITY, 1e-40F, -1.0F };
+    // Roughly one component in eight is special, the rest random.
+    return ((i % 8) == 5 ? specials[(i / 8) % 8] : randomFloat());
+}
+
+// Runs every Vec3xW<W> operation over the inputs and compares each lane with Vec3.
+template <int W>
+static size_t checkPacketLanes(const std::vector<Vec3>& a, const std::vector<Vec3>& b, const std::vector<float>& f, const std::vector<bool>& active)
+{
+    enum { ADD, SUB, MUL, DIV, SCALE, CROSS, MIN, MAX, NORMALIZE, BLEND, MASKED_ADD, MASKED_SUB, MASKED_MUL, MASKED_SCALE, MASKED_NORMALIZE, OPS };
+    size_t mismatches = 0;
+    for (size_t base = 0; base + W <= a.size(); base += W)
+    {
+        Vec3xW<W> pa = Vec3xW<W>::Gather(&a[base]);
+        Vec3xW<W> pb = Vec3xW<W>::Gather(&b[base]);
+        FloatxW<W> pf = FloatxW<W>::Load(&f[base]);
+        MaskxW<W> m;
+        for (int i = 0; i < W; i++)
+            m.Set(i, active[base + i]);
+        Vec3xW<W> results[OPS] = {
+            pa + pb, pa - pb, pa * pb, pa / pb, pa * pf,
+            Vec3xW<W>::Cross(pa, pb), Vec3xW<W>::Min(pa, pb), Vec3xW<W>::Max(pa, pb), Vec3xW<W>::Normalize(pa),
+            Vec3xW<W>::Blend(m, pa, pb), Vec3xW<W>::MaskedAdd(m, pa, pb), Vec3xW<W>::MaskedSub(m, pa, pb),
+            Vec3xW<W>::MaskedMul(m, pa, pb), Vec3xW<W>::MaskedMul(m, pa, pf), Vec3xW<W>::MaskedNormalize(m, pa)
+        };
+        FloatxW<W> dot = Vec3xW<W>::Dot(pa, pb);
+        FloatxW<W> length = Vec3xW<W>::Length(pa);
+        for (int i = 0; i < W; i++)
+        {
+            const Vec3& va = a[base + i];
+            const Vec3& vb = b[base + i];
+            const bool on = active[base + i];
+            const Vec3 expected[OPS] = {
+                va + vb, va - vb, va * vb, va / vb, va * f[base + i],
+                Vec3::Cross(va, vb), Vec3::Min(va, vb), Vec3::Max(va, vb), Vec3::Normalize(va),
+                on ? va : vb, on ? va + vb : va, on ? va - vb : va,
+                on ? va * vb : va, on ? va * f[base + i] : va, on ? Vec3::Normalize(va) : va
+            };
+            for (int op = 0; op < OPS; op++)
+                mismatches += compareLane(results[op], i, expected[op]);
+            mismatches += !sameLane(dot[i], Vec3::Dot(va, vb));
+            mismatches += !sameLane(length[i], Vec3::Length(va));
+        }
+    }
+    return (mismatches);
+}
+
+static size_t checkPackets(void)
+{
+    const size_t count = 4096;
+    std::vector<Vec3> a(count), b(count);
+    std::vector<float> f(count);
+    std::vector<bool> active(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        a[i] = Vec3(specialFloat(3 * i), specialFloat(3 * i + 1), specialFloat(3 * i + 2));
+        b[i] = Vec3(specialFloat(3 * i + 7), specialFloat(3 * i + 11), specialFloat(3 * i + 13));
+        f[i] = specialFloat(i + 3);
+        active[i] = (rand() & 3) != 0;
+    }
+    // Zero vectors, where Normalize gives NaN and MaskedNormalize must not touch inactive lanes.
+    for (size_t i = 0; i < count; i += 37)
+        a[i] = (i & 1) ? Vec3(0.0F, 0.0F, 0.0F) : Vec3(-0.0F, 0.0F, -0.0F);
+    return (checkPacketLanes<4>(a, b, f, active) + checkPacketLanes<8>(a, b, f, active) + checkPacketLanes<16>(a, b, f, active));
+}
+
+static double elapsedNs(bench_clock::time_point start, size_t count)
+{
+    return (std::chrono::duration<double, std::nano>(bench_clock::now() - start).count() / static_cast<double>(count));
+}
+
+int main(int argc, char **argv)
+{
+    int iterations = 200;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc)
+            iterations = std::max(1, atoi(argv[++i]));
+    }
+    const size_t count = 4096;
+    std::vector<float> matrices(count * 16);
+    std::vector<ScalarVec3> va(count), vb(count);
+    std::vector<Vec3A> aa(count), ab(count);
+    for (size_t i = 0; i < matrices.size(); i++)
+        matrices[i] = randomFloat();
+    for (size_t i = 0; i < count; i++)
+    {
+        ScalarVec3 a = { randomFloat(), randomFloat(), randomFloat() };
+        ScalarVec3 b = { randomFloat(), randomFloat(), randomFloat() };
+        va[i] = a;
+        vb[i] = b;
+        aa[i] = Vec3A(a);
+        ab[i] = Vec3A(b);
+    }
+
+    size_t mismatches = 0;
+    float scalar_acc[4][4], simd_acc[4][4];
+
+    // Chains of matrix products, as when composing a transform hierarchy.
+    bench_clock::time_point start = bench_clock::now();
+    for (int it = 0; it < iterations; it++)
+    {
+        memcpy(scalar_acc, &matrices[0], sizeof(scalar_acc));
+        for (size_t i = 1; i < count; i++)
+        {
+            float tmp[4][4];
+            scalarMat4Multiply(reinterpret_cast<const float (*)[4]>(&matrices[i * 16]), scalar_acc, tmp);
+            memcpy(scalar_acc, tmp, sizeof(tmp));
+            // Keep magnitudes bounded without changing the operation under test.
+            if ((i & 7) == 0) memcpy(scalar_acc, &matrices[i * 16], sizeof(scalar_acc));
+        }
+    }
+    double scalar_mat = elapsedNs(start, static_cast<size_t>(iterations) * (count - 1));
+    start = bench_clock::now();
+    for (int it = 0; it < iterations; it++)
+    {
+        memcpy(simd_acc, &matrices[0], sizeof(simd_acc));
+        for (size_t i = 1; i < count; i++)
+        {
+            float tmp[4][4];
+            Simd::Mat4Multiply(reinterpret_cast<const float (*)[4]>(&matrices[i * 16]), simd_acc, tmp);
+            memcpy(simd_acc, tmp, sizeof(tmp));
+            if ((i & 7) == 0) memcpy(simd_acc, &matrices[i * 16], sizeof(simd_acc));
+        }
+    }
+    double simd_mat = elapsedNs(start, static_cast<size_t>(iterations) * (count - 1));
+    mismatches += !sameBits(scalar_acc, simd_acc, sizeof(scalar_acc));
+    for (size_t i = 0; i + 1 < count; i++)
+    {
+        float s[4][4], v[4][4];
+        scalarMat4Multiply(reinterpret_cast<const float (*)[4]>(&matrices[i * 16]), reinterpret_cast<const float (*)[4]>(&matrices[i * 16 + 16]), s);
+        Simd::Mat4Multiply(reinterpret_cast<const float (*)[4]>(&matrices[i * 16]), reinterpret_cast<const float (*)[4]>(&matrices[i * 16 + 16]), v);
+        mismatches += !sameBits(s, v, sizeof(s));
+    }
+
+    // Shading-style vector work: normalize, cross and dot per element.
+    std::vector<ScalarVec3> scalar_out(count);
+    std::vector<float> scalar_dot(count);
+    start = bench_clock::now();
+    for (int it = 0; it < iterations; it++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            ScalarVec3 n = scalarNormalize(scalarCross(va[i], vb[i]));
+            scalar_out[i] = n;
+            scalar_dot[i] = scalarDot(n, va[i]);
+        }
+    }
+    double scalar_vec = elapsedNs(start, static_cast<size_t>(iterations) * count);
+    std::vector<Vec3A> simd_out(count);
+    std::vector<float> simd_dot(count);
+    start = bench_clock::now();
+    for (int it = 0; it < iterations; it++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            Vec3A n = Vec3A::Normalize(Vec3A::Cross(aa[i], ab[i]));
+            simd_out[i] = n;
+            simd_dot[i] = Vec3A::Dot(n, aa[i]);
+        }
+    }
+    double simd_vec = elapsedNs(start, static_cast<size_t>(iterations) * count);
+    for (size_t i = 0; i < count; i++)
+    {
+        mismatches += !sameBits(&scalar_out[i], &simd_out[i].x, sizeof(ScalarVec3));
+        mismatches += !sameBits(&scalar_dot[i], &simd_dot[i], sizeof(float));
+    }
+
+    // Bounds work: component-wise Clamp on Vec4 and Vec4i, against Mathf::Clamp
+    // per component (the former Vec4::Clamp), with signed zeros and NaNs among the inputs.
+    std::vector<Vec4> vc(count), vlo(count), vhi(count);
+    std::vector<Vec4i> ic(count), ilo(count), ihi(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        vc[i] = Vec4(randomFloat(), randomFloat(), (i & 15) ? randomFloat() : -0.0F, (i & 31) ? randomFloat() : NAN);
+        vlo[i] = Vec4(-0.5F, (i & 7) ? -0.5F : 0.0F, -0.25F, -0.5F);
+        vhi[i] = Vec4(0.5F, 0.25F, (i & 3) ? 0.5F : -0.0F, 0.5F);
+        ic[i] = Vec4i(Vec4(vc[i].x, vc[i].y, vc[i].z, 0.0F) * 1000.0F);
+        ilo[i] = Vec4i(-500, -250, -500, 0);
+        ihi[i] = Vec4i(500, 250, 0, 500);
+    }
+    std::vector<Vec4> scalar_clamp(count), simd_clamp(count);
+    start = bench_clock::now();
+    for (int it = 0; it < iterations; it++)
+    {
+        for (size_t i = 0; i < count; i++)
+        {
+            const Vec4& c = vc[(i + static_cast<size_t>(it)) % count];
+            scalar_clamp[i] = Vec4(Mathf::Clamp(c.x, vlo[i].x, vhi[i].x), Mathf::Clamp(c.y, vlo[i].y, vhi[i].y),
+                Mathf::Clamp(c.z, vlo[i].z, vhi[i].z), Mathf::Clamp(c.w, vlo[i].w, vhi[i].w));
+        }
+    }
+    double scalar_bounds = elapsedNs(start, static_cast<size_t>(iterations) * count);
+    start = bench_clock::now();
+    for (int it = 0; it < iterations; it++)
+        for (size_t i = 0; i < count; i++)
+            simd_clamp[i] = Vec4::Clamp(vc[(i + static_cast<size_t>(it)) % count], vlo[i], vhi[i]);
+    double simd_bounds = elapsedNs(start, static_cast<size_t>(iterations) * count);
+    for (size_t i = 0; i < count; i++)
+    {
+        mismatches += !sameBits(&scalar_clamp[i], &simd_clamp[i], sizeof(Vec4));
+        Vec4i clamped = Vec4i::Clamp(ic[i], ilo[i], ihi[i]);
+        for (int k = 0; k < 4; k++)
+            mismatches += clamped[k] != std::min(ihi[i][k], std::max(ic[i][k], ilo[i][k]));
+    }
+
+    // Inverses: general matrices, then affine ones (bottom row 0 0 0 1).
+    std::vector<float> affine(matrices);
+    for (size_t i = 0; i < count; i++)
+    {
+        float *row3 = &affine[i * 16 + 12];
+        row3[0] = row3[1] = row3[2] = 0.0F;
+        row3[3] = 1.0F;
+    }
+    std::vector<float> inverses(count * 16);
+    float naive_err = 0.0F, simd_err = 0.0F, affine_err = 0.0F;
+    start = bench_clock::now();
+    for (int it = 0; it < iterations; it++)
+        for (size_t i = 0; i < count; i++)
+            naiveMat4Inverse(reinterpret_cast<const float (*)[4]>(&matrices[i * 16]), reinterpret_cast<float (*)[4]>(&inverses[i * 16]));
+    double naive_inv = elapsedNs(start, static_cast<size_t>(iterations) * count);
+    for (size_t i = 0; i < count; i++)
+        naive_err = std::max(naive_err, residual(reinterpret_cast<const float (*)[4]>(&matrices[i * 16]), reinterpret_cast<const float (*)[4]>(&inverses[i * 16])));
+    start = bench_clock::now();
+    for (int it = 0; it < iterations; it++)
+        for (size_t i = 0; i < count; i++)
+            Simd::Mat4Inverse(reinterpret_cast<const float (*)[4]>(&matrices[i * 16]), reinterpret_cast<float (*)[4]>(&inverses[i * 16]));
+    double simd_inv = elapsedNs(start, static_cast<size_t>(iterations) * count);
+    for (size_t i = 0; i < count; i++)
+        simd_err = std::max(simd_err, residual(reinterpret_cast<const float (*)[4]>(&matrices[i * 16]), reinterpret_cast<const float (*)[4]>(&inverses[i * 16])));
+    for (size_t i = 0; i < count; i++)
+    {
+        float *row3 = &inverses[i * 16 + 12];
+        row3[0] = row3[1] = row3[2] = 0.0F;
+        row3[3] = 1.0F;
+    }
+    start = bench_clock::now();
+    for (int it = 0; it < iterations; it++)
+        for (size_t i = 0; i < count; i++)
+            Simd::AffineInverse(reinterpret_cast<const float (*)[4]>(&affine[i * 16]), reinterpret_cast<float (*)[4]>(&inverses[i * 16]));
+    double affine_inv = elapsedNs(start, static_cast<size_t>(iterations) * count);
+    for (size_t i = 0; i < count; i++)
+        affine_err = std::max(affine_err, residual(reinterpret_cast<const float (*)[4]>(&affine[i * 16]), reinterpret_cast<const float (*)[4]>(&inverses[i * 16])));
+
+    printf("simd width      %d lanes\n", RT_SIMD_WIDTH);
+    printf("mat4 * mat4     scalar %6.2f ns  simd %6.2f ns  x%.2f\n", scalar_mat, simd_mat, scalar_mat / simd_mat);
+    printf("cross/norm/dot  scalar %6.2f ns  simd %6.2f ns  x%.2f\n", scalar_vec, simd_vec, scalar_vec / simd_vec);
+    printf("vec4 clamp      scalar %6.2f ns  vecn %6.2f ns  x%.2f\n", scalar_bounds, simd_bounds, scalar_bounds / simd_bounds);
+    printf("inverse         naive  %6.2f ns  simd %6.2f ns  x%.2f\n", naive_inv, simd_inv, naive_inv / simd_inv);
+    printf("affine inverse  naive  %6.2f ns  3x4  %6.2f ns  x%.2f\n", naive_inv, affine_inv, naive_inv / affine_inv);
+    printf("inverse error   naive  %.3g  simd %.3g  affine %.3g\n", naive_err, simd_err, affine_err);
+    size_t convention_failures = checkAffineConventions();
+    size_t packet_mismatches = checkPackets();
+    printf("bit mismatches  %zu\n", mismatches);
+    printf("affine checks   %zu failures\n", convention_failures);
+    printf("packet lanes    %zu mismatches\n", packet_mismatches);
+    return ((mismatches || convention_failures || packet_mismatches) ? 1 : 0);
+}
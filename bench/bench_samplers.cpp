@@ -0,0 +1,331 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+
+/**
+ * Sampler throughput, correctness and convergence.
+ *
+ * Checks PCG32 against the reference output of the PCG paper, its jump
+ * ahead and back, and that every PCG32xW lane replays the matching scalar
+ * generator. Checks that every Sobol dimension is a (0, 1)-sequence and
+ * that the scrambled 2D samples of a pixel form (0, m, 2)-nets for every
+ * power-of-two prefix.
+ *
+ * Then prints millions of samples per second for each sampler, and the RMS
+ * error over many pixels of the estimate of two integrals over the unit
+ * square (a quarter disk, discontinuous, and a Gaussian, smooth) against
+ * the number of samples per pixel:
+ *
+ *   bench_samplers [--samples N]
+ */
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "samplers/pcg32.h"
+#include "samplers/r2.h"
+#include "samplers/sobol.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+static size_t g_failures = 0;
+static volatile float g_sink = 0.0F;
+
+static void report(const char *name, bool ok)
+{
+    printf("  %-44s %s\n", name, ok ? "ok" : "FAILED");
+    g_failures += ok ? 0 : 1;
+}
+
+static bool checkReference(void)
+{
+    // pcg32-demo, seeded with (42, 54).
+    static const uint32_t expected[6] = { 0xa15c02b7u, 0x7b47f409u, 0xba1d3330u, 0x83d2f293u, 0xbfa4784bu, 0xcbed606eu };
+    PCG32 rng(42u, 54u);
+    bool ok = true;
+    for (int i = 0; i < 6; i++)
+        ok = rng.NextUInt() == expected[i] && ok;
+    return (ok);
+}
+
+static bool checkAdvance(void)
+{
+    PCG32 a = PCG32::ForPixel(3, 7, 11);
+    PCG32 start = a, b = a;
+    for (int i = 0; i < 1000; i++)
+        a.NextUInt();
+    b.Advance(1000);
+    bool ok = a.state == b.state;
+    b.Advance(-1000);
+    return (ok && b.state == start.state);
+}
+
+static bool checkBound(void)
+{
+    PCG32 rng;
+    uint32_t counts[3] = { 0, 0, 0 };
+    for (int i = 0; i < 30000; i++)
+    {
+        uint32_t r = rng.NextUInt(3u);
+        if (r >= 3u)
+            return (false);
+        counts[r]++;
+    }
+    return (counts[0] > 9500 && counts[1] > 9500 && counts[2] > 9500);
+}
+
+template <int W>
+static bool checkLanes(void)
+{
+    PCG32xW<W> rngs = PCG32xW<W>::ForPixel(5, 9, 100, 2);
+    std::vector<PCG32> ref;
+    for (int i = 0; i < W; i++)
+        ref.push_back(PCG32::ForPixel(5, 9, 100 + static_cast<uint32_t>(i), 2));
+    bool ok = true;
+    for (int n = 0; n < 1000; n++)
+    {
+        FloatxW<W> f = rngs.NextFloat();
+        for (int i = 0; i < W; i++)
+            ok = f.v[i] == ref[i].NextFloat() && ok;
+    }
+    rngs.Advance(-500);
+    for (int i = 0; i < W; i++)
+    {
+        ref[i].Advance(-500);
+        ok = rngs.Get(i).state == ref[i].state && ok;
+    }
+    return (ok);
+}
+
+// Every aligned block of 2^m consecutive points hits each of the 2^m intervals once.
+static bool checkSobol1D(int dim, int log2n)
+{
+    uint32_t n = 1u << log2n;
+    std::vector<uint32_t> pts(n);
+    for (uint32_t i = 0; i < n; i++)
+        pts[i] = Sobol::Sample(i, dim);
+    for (int m = 0; m <= log2n; m++)
+    {
+        uint32_t size = 1u << m;
+        for (uint32_t first = 0; first < n; first += size)
+        {
+            std::vector<bool> seen(size, false);
+            for (uint32_t i = first; i < first + size; i++)
+            {
+                uint32_t cell = m ? pts[i] >> (32 - m) : 0u;
+                if (seen[cell])
+                    return (false);
+                seen[cell] = true;
+            }
+        }
+    }
+    return (true);
+}
+
+// Every prefix of 2^m samples of a pixel puts one point in every 2^a x 2^(m-a) box.
+static bool checkNets(uint32_t x, uint32_t y, int log2n)
+{
+    uint32_t n = 1u << log2n;
+    SobolSampler sampler(x, y, 1);
+    std::vector<Vec2> pts(n);
+    for (int d = 0; d < 3; d++)
+    {
+        for (uint32_t i = 0; i < n; i++)
+        {
+            sampler.StartSample(i);
+            for (int k = 0; k < d; k++)
+                sampler.Next2D();
+            pts[i] = sampler.Next2D();
+        }
+        for (int m = 0; m <= log2n; m++)
+        {
+            for (int a = 0; a <= m; a++)
+            {
+                std::vector<bool> seen(1u << m, false);
+                for (uint32_t i = 0; i < (1u << m); i++)
+                {
+                    uint32_t cx = static_cast<uint32_t>(pts[i].x * static_cast<float>(1u << a));
+                    uint32_t cy = static_cast<uint32_t>(pts[i].y * static_cast<float>(1u << (m - a)));
+                    uint32_t cell = (cx << (m - a)) | cy;
+                    if (seen[cell])
+                        return (false);
+                    seen[cell] = true;
+                }
+            }
+        }
+    }
+    return (true);
+}
+
+static double throughput(const char *name, size_t count, double seconds)
+{
+    printf("  %-14s %8.1f Msamples/s\n", name, static_cast<double>(count) * 1e-6 / seconds);
+    return (seconds);
+}
+
+static void runThroughput(size_t count)
+{
+    printf("throughput\n");
+    float acc = 0.0F;
+    bench_clock::time_point start = bench_clock::now();
+    PCG32 rng = PCG32::ForPixel(1, 2, 3);
+    for (size_t i = 0; i < count; i++)
+        acc += rng.NextFloat();
+    throughput("pcg32", count, std::chrono::duration<double>(bench_clock::now() - start).count());
+
+    start = bench_clock::now();
+    PCG32xW<4> rng4 = PCG32xW<4>::ForPixel(1, 2, 3);
+    FloatxW<4> acc4;
+    for (size_t i = 0; i < count; i += 4)
+        acc4 += rng4.NextFloat();
+    throughput("pcg32 x4", count, std::chrono::duration<double>(bench_clock::now() - start).count());
+
+    start = bench_clock::now();
+    PCG32xW<8> rng8 = PCG32xW<8>::ForPixel(1, 2, 3);
+    FloatxW<8> acc8;
+    for (size_t i = 0; i < count; i += 8)
+        acc8 += rng8.NextFloat();
+    throughput("pcg32 x8", count, std::chrono::duration<double>(bench_clock::now() - start).count());
+
+    start = bench_clock::now();
+    SobolSampler sobol(1, 2);
+    for (size_t i = 0; i < count; i += 2)
+    {
+        sobol.StartSample(static_cast<uint32_t>(i));
+        Vec2 p = sobol.Next2D();
+        acc += p.x + p.y;
+    }
+    throughput("sobol 2D", count, std::chrono::duration<double>(bench_clock::now() - start).count());
+
+    start = bench_clock::now();
+    R2Sampler r2(1, 2);
+    for (size_t i = 0; i < count; i += 2)
+    {
+        Vec2 p = r2.Get2D(static_cast<uint32_t>(i));
+        acc += p.x + p.y;
+    }
+    throughput("r2 2D", count, std::chrono::duration<double>(bench_clock::now() - start).count());
+    for (int i = 0; i < 4; i++)
+        acc += acc4.v[i];
+    for (int i = 0; i < 8; i++)
+        acc += acc8.v[i];
+    g_sink = acc;
+}
+
+static double disk(const Vec2& p)
+{
+    return (p.x * p.x + p.y * p.y < 1.0F ? 1.0 : 0.0);
+}
+
+static double gaussian(const Vec2& p)
+{
+    return (exp(-(static_cast<double>(p.x) * p.x + static_cast<double>(p.y) * p.y)));
+}
+
+// RMS error of the per-pixel estimates of f over `pixels` pixels.
+template <int S>
+static double rmse(double (*f)(const Vec2&), double reference, uint32_t spp, uint32_t pixels)
+{
+    double sum = 0.0;
+    for (uint32_t px = 0; px < pixels; px++)
+    {
+        uint32_t x = px % 64, y = px / 64;
+        PCG32 rng = PCG32::ForPixel(x, y, 0);
+        SobolSampler sobol(x, y);
+        R2Sampler r2(x, y);
+        double estimate = 0.0;
+        for (uint32_t i = 0; i < spp; i++)
+        {
+            Vec2 p;
+            if (S == 0)
+            {
+                float u = rng.NextFloat();
+                p = Vec2(u, rng.NextFloat());
+            }
+            else if (S == 1)
+            {
+                sobol.StartSample(i);
+                p = sobol.Next2D();
+            }
+            else
+                p = r2.Get2D(i);
+            estimate += f(p);
+        }
+        double err = estimate / spp - reference;
+        sum += err * err;
+    }
+    return (sqrt(sum / pixels));
+}
+
+int main(int argc, char **argv)
+{
+    size_t count = 50000000;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--samples") == 0 && i + 1 < argc)
+            count = static_cast<size_t>(std::max(1e4, atof(argv[++i])));
+    }
+    count &= ~static_cast<size_t>(7);
+
+    printf("checks\n");
+    report("pcg32 reference output", checkReference());
+    report("pcg32 advance forward and back", checkAdvance());
+    report("pcg32 bounded draws", checkBound());
+    report("pcg32 x4 lanes match scalar streams", checkLanes<4>());
+    report("pcg32 x8 lanes match scalar streams", checkLanes<8>());
+    bool ok = true;
+    for (int d = 0; d < SOBOL_DIMENSIONS; d++)
+        ok = checkSobol1D(d, 12) && ok;
+    report("sobol dimensions are (0, 1)-sequences", ok);
+    report("scrambled 2D prefixes are (0, m, 2)-nets", checkNets(0, 0, 10) && checkNets(17, 3, 10) && checkNets(250, 999, 8));
+
+    runThroughput(count);
+
+    const double quarterDisk = 0.78539816339744831;
+    const double gaussianRef = 0.74682413281242702 * 0.74682413281242702;
+    const uint32_t pixels = 4096;
+    printf("rms error over %u pixels\n", pixels);
+    printf("  %-10s %5s %11s %11s %11s\n", "integrand", "spp", "random", "sobol", "r2");
+    double last[2][3];
+    for (int f = 0; f < 2; f++)
+    {
+        double (*fn)(const Vec2&) = f ? gaussian : disk;
+        double ref = f ? gaussianRef : quarterDisk;
+        for (uint32_t spp = 4; spp <= 256; spp *= 4)
+        {
+            last[f][0] = rmse<0>(fn, ref, spp, pixels);
+            last[f][1] = rmse<1>(fn, ref, spp, pixels);
+            last[f][2] = rmse<2>(fn, ref, spp, pixels);
+            printf("  %-10s %5u %11.3e %11.3e %11.3e\n", f ? "gaussian" : "disk", spp, last[f][0], last[f][1], last[f][2]);
+        }
+    }
+    report("low discrepancy beats random at 256 spp", last[0][1] < last[0][0] && last[0][2] < last[0][0]
+        && last[1][1] < last[1][0] && last[1][2] < last[1][0]);
+    printf("failures        %zu\n", g_failures);
+    return (g_failures ? 1 : 0);
+}
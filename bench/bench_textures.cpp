@@ -0,0 +1,383 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * Texture cache checks.
+ *
+ * Drives a TextureCache with a fake TextureDecoder that makes up images from
+ * their path ("<w>x<h>x<c>..." decodes to that size, "fail..." fails), then
+ * checks request deduplication, the hit/miss/decode counters, decode
+ * failures, LRU eviction under a byte budget, the handling of
+ * TEXTURE_NO_HANDLE, and concurrent gets from a ThreadPool. Also builds,
+ * saves, reloads and samples small mipmap pyramids. Prints what failed and
+ * exits non-zero if anything did:
+ *
+ *   bench_textures
+ */
+
+#include <atomic>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "textures/mipmap.h"
+#include "textures/texture_cache_obj.h"
+
+static size_t g_failures = 0;
+
+#define CHECK(cond) checkThat(static_cast<bool>(cond), #cond, __LINE__)
+
+static void checkThat(bool ok, const char *what, int line)
+{
+    if (!ok) {
+        fprintf(stderr, "line %d: %s\n", line, what);
+        g_failures++;
+    }
+}
+
+class FakeDecoder : public TextureDecoder {
+public:
+    FakeDecoder() : calls(0) {}
+    virtual bool operator()(const std::string &path, texture_image_t *image, std::string *err)
+    {
+        calls++;
+        const char *name = path.c_str() + path.rfind('/') + 1;
+        if (strncmp(name, "fail", 4) == 0 || sscanf(name, "%dx%dx%d", &image->width, &image->height, &image->channels) != 3) {
+            if (err) (*err) = "cannot decode [" + path + "]";
+            return (false);
+        }
+        image->pixels.assign(static_cast<size_t>(image->width) * image->height * image->channels, 0x80);
+        image->pixels.shrink_to_fit();
+        return (true);
+    }
+    std::atomic<size_t> calls;
+};
+
+// Bytes the cache accounts for a w x h x c image from FakeDecoder.
+static size_t imageBytes(int w, int h, int c)
+{
+    return (static_cast<size_t>(w) * h * c + sizeof(texture_image_t));
+}
+
+static void checkRequests(ThreadPool *pool)
+{
+    FakeDecoder decoder;
+    TextureCache cache(&decoder, pool);
+    texture_handle_t a = cache.request("dir\\4x4x4.png");
+    CHECK(a == cache.request("dir/4x4x4.png"));
+    CHECK(cache.path(a) == "dir/4x4x4.png");
+    CHECK(cache.request("dir/8x8x4.png") != a);
+    CHECK(cache.size() == 2);
+
+    // Invalid handles, TEXTURE_NO_HANDLE first: no access, no decode.
+    const texture_handle_t invalid[3] = { TEXTURE_NO_HANDLE, 2, 1 << 20 };
+    for (int i = 0; i < 3; i++) {
+        CHECK(!cache.get(invalid[i]));
+        CHECK(!cache.tryGet(invalid[i]));
+        cache.prefetch(invalid[i]);
+        CHECK(cache.path(invalid[i]).empty());
+        CHECK(cache.error(invalid[i]).empty());
+    }
+    pool->wait();
+    CHECK(decoder.calls == 0);
+
+    // One miss and one decode, then hits.
+    std::shared_ptr<const texture_image_t> image = cache.get(a);
+    CHECK(image && image->width == 4 && image->height == 4 && image->channels == 4);
+    CHECK(cache.get(a) == image);
+    CHECK(cache.tryGet(a) == image);
+    texture_cache_stats_t stats = cache.stats();
+    CHECK(decoder.calls == 1 && stats.decodes == 1);
+    CHECK(stats.misses == 1 && stats.hits == 2);
+    CHECK(stats.resident_bytes == imageBytes(4, 4, 4) && stats.peak_bytes == stats.resident_bytes);
+
+    // A non-blocking miss schedules the decode; get then waits for it.
+    texture_handle_t b = cache.request("dir/8x8x4.png");
+    CHECK(!cache.tryGet(b));
+    CHECK(cache.get(b) && decoder.calls == 2);
+
+    // Failures are remembered and not retried.
+    texture_handle_t bad = cache.request("fail.png");
+    CHECK(!cache.get(bad));
+    CHECK(!cache.get(bad));
+    CHECK(!cache.error(bad).empty());
+    stats = cache.stats();
+    CHECK(stats.decode_failures == 1 && stats.decodes == 3 && decoder.calls == 3);
+}
+
+static void checkEviction(ThreadPool *pool)
+{
+    FakeDecoder decoder;
+    const size_t one = imageBytes(16, 16, 4);
+    TextureCache cache(&decoder, pool, 2 * one + one / 2);
+    texture_handle_t a = cache.request("a/16x16x4.png");
+    texture_handle_t b = cache.request("b/16x16x4.png");
+    texture_handle_t c = cache.request("c/16x16x4.png");
+
+    std::shared_ptr<const texture_image_t> held = cache.get(b);
+    CHECK(cache.get(a) && held);
+    CHECK(cache.get(a));
+    // b is now the least recently used and goes first.
+    CHECK(cache.get(c));
+    texture_cache_stats_t stats = cache.stats();
+    CHECK(stats.evictions == 1 && stats.resident_bytes == 2 * one && stats.peak_bytes == 3 * one);
+    CHECK(held && held->pixels.size() == 16 * 16 * 4);
+    CHECK(cache.tryGet(a) && cache.tryGet(c));
+    size_t calls = decoder.calls;
+    CHECK(cache.get(b));
+    CHECK(decoder.calls == calls + 1);
+
+    cache.setBudget(one);
+    stats = cache.stats();
+    CHECK(stats.resident_bytes <= one);
+    cache.setBudget(0);
+    CHECK(cache.get(a) && cache.get(b) && cache.get(c));
+    CHECK(cache.stats().resident_bytes == 3 * one);
+}
+
+static void checkConcurrentGets(ThreadPool *pool)
+{
+    FakeDecoder decoder;
+    TextureCache cache(&decoder, pool);
+    const int textures = 8;
+    std::vector<texture_handle_t> handles;
+    for (int i = 0; i < textures; i++) {
+        char path[64];
+        snprintf(path, sizeof(path), "t%d/%dx8x4.png", i, 8 + i);
+        handles.push_back(cache.request(path));
+    }
+    std::vector<std::thread> threads;
+    std::atomic<size_t> missing(0);
+    for (int t = 0; t < 4; t++) {
+        threads.push_back(std::thread([&cache, &handles, &missing, t] {
+            for (int k = 0; k < 200; k++) {
+                std::shared_ptr<const texture_image_t> image = cache.get(handles[(k + t) % handles.size()]);
+                if (!image) missing++;
+            }
+        }));
+    }
+    for (size_t t = 0; t < threads.size(); t++) {
+        threads[t].join();
+    }
+    CHECK(missing == 0);
+    CHECK(decoder.calls == static_cast<size_t>(textures));
+    CHECK(cache.stats().decodes == static_cast<size_t>(textures));
+}
+
+static void checkMaterials(ThreadPool *pool)
+{
+    FakeDecoder decoder;
+    TextureCache cache(&decoder, pool);
+    std::vector<material_t> materials(2);
+    InitMaterial(&materials[0]);
+    InitMaterial(&materials[1]);
+    materials[0].diffuse_texname = "4x4x3.png";
+    materials[1].diffuse_texname = "4x4x3.png";
+    materials[1].bump_texname = "2x2x1.png";
+    std::vector<texture_handle_t> handles = requestMaterialTextures(&cache, materials, "tex/");
+    const size_t slots = handles.size() / 2;
+    size_t used = 0;
+    for (size_t i = 0; i < handles.size(); i++) {
+        used += handles[i] != TEXTURE_NO_HANDLE;
+        CHECK(handles[i] == TEXTURE_NO_HANDLE || cache.get(handles[i]));
+        CHECK(handles[i] != TEXTURE_NO_HANDLE || !cache.get(handles[i]));
+    }
+    CHECK(handles.size() % 2 == 0 && used == 3);
+    CHECK(handles[1] == handles[slots + 1] && cache.path(handles[1]) == "tex/4x4x3.png");
+    CHECK(cache.size() == 2 && decoder.calls == 2);
+}
+
+static texture_image_t makeImage(int w, int h, int c)
+{
+    texture_image_t image;
+    image.width = w;
+    image.height = h;
+    image.channels = c;
+    image.pixels.resize(static_cast<size_t>(w) * h * c);
+    for (size_t i = 0; i < image.pixels.size(); i++) image.pixels[i] = static_cast<unsigned char>(i * 37 + 11);
+    return (image);
+}
+
+static bool sameMipmap(const mipmap_t &a, const mipmap_t &b)
+{
+    if (a.channels != b.channels || a.data != b.data || a.levels.size() != b.levels.size()) return (false);
+    for (size_t i = 0; i < a.levels.size(); i++) {
+        if (a.levels[i].width != b.levels[i].width || a.levels[i].height != b.levels[i].height
+            || a.levels[i].offset != b.levels[i].offset) {
+            return (false);
+        }
+    }
+    return (true);
+}
+
+static bool writeFile(const char *path, const std::vector<char> &bytes)
+{
+    FILE *fp = fopen(path, "wb");
+    if (!fp) return (false);
+    bool ok = bytes.empty() || fwrite(&bytes[0], 1, bytes.size(), fp) == bytes.size();
+    return ((fclose(fp) == 0) && ok);
+}
+
+static std::vector<char> readFile(const char *path)
+{
+    std::vector<char> bytes;
+    FILE *fp = fopen(path, "rb");
+    if (!fp) return (bytes);
+    char buf[4096];
+    size_t n;
+    while ((n = fread(buf, 1, sizeof(buf), fp)) > 0) bytes.insert(bytes.end(), buf, buf + n);
+    fclose(fp);
+    return (bytes);
+}
+
+static void checkMipmapBuild(void)
+{
+    // 5x3 -> 2x1 -> 1x1, each level a 2x2 box of the previous one.
+    texture_image_t image = makeImage(5, 3, 2);
+    mipmap_t mipmap;
+    CHECK(BuildMipmap(image, &mipmap));
+    CHECK(mipmap.channels == 2);
+    CHECK(mipmap.levels.size() == 3);
+    if (mipmap.levels.size() == 3) {
+        CHECK(mipmap.levels[1].width == 2 && mipmap.levels[1].height == 1 && mipmap.levels[1].offset == 30);
+        CHECK(mipmap.levels[2].width == 1 && mipmap.levels[2].height == 1 && mipmap.levels[2].offset == 34);
+        CHECK(mipmap.data.size() == 36);
+        CHECK(memcmp(&mipmap.data[0], &image.pixels[0], image.pixels.size()) == 0);
+        const unsigned char *p = &image.pixels[0];
+        for (int c = 0; c < 2; c++) {
+            int sum = p[(0 * 5 + 2) * 2 + c] + p[(0 * 5 + 3) * 2 + c] + p[(1 * 5 + 2) * 2 + c] + p[(1 * 5 + 3) * 2 + c];
+            CHECK(mipmap.data[30 + 1 * 2 + c] == (sum + 2) >> 2);
+        }
+    }
+
+    // The Kaiser kernel is normalised, so a flat image stays flat.
+    texture_image_t flat = makeImage(16, 4, 3);
+    flat.pixels.assign(flat.pixels.size(), 200);
+    CHECK(BuildMipmap(flat, &mipmap, MIP_FILTER_KAISER));
+    CHECK(mipmap.levels.size() == 5);
+    size_t off_flat = 0;
+    for (size_t i = 0; i < mipmap.data.size(); i++) off_flat += mipmap.data[i] != 200;
+    CHECK(off_flat == 0);
+
+    texture_image_t empty;
+    empty.width = 0;
+    empty.height = 0;
+    empty.channels = 0;
+    CHECK(!BuildMipmap(empty, &mipmap));
+    CHECK(mipmap.levels.empty() && mipmap.data.empty());
+
+    std::vector<std::shared_ptr<const texture_image_t> > images;
+    images.push_back(std::make_shared<texture_image_t>(makeImage(4, 4, 1)));
+    images.push_back(std::shared_ptr<const texture_image_t>());
+    std::vector<mipmap_t> mipmaps;
+    ThreadPool pool(2);
+    BuildMipmaps(images, &mipmaps, &pool);
+    CHECK(mipmaps.size() == 2 && mipmaps[0].levels.size() == 3 && mipmaps[1].levels.empty());
+}
+
+static void checkMipmapFiles(void)
+{
+    const char *path = "bench_textures.mip";
+    mipmap_t saved, loaded;
+    CHECK(BuildMipmap(makeImage(7, 6, 4), &saved, MIP_FILTER_KAISER));
+    CHECK(SaveMipmap(path, saved));
+    CHECK(LoadMipmap(path, &loaded));
+    CHECK(sameMipmap(saved, loaded));
+
+    // A file that fails to load leaves the previous pyramid alone.
+    std::vector<char> bytes = readFile(path);
+    CHECK(bytes.size() > 32);
+    mipmap_t before = loaded;
+    CHECK(writeFile(path, std::vector<char>(bytes.begin(), bytes.end() - 1)));
+    CHECK(!LoadMipmap(path, &loaded));
+    CHECK(sameMipmap(before, loaded));
+    // The first level's width follows the magic, version, channels and level count.
+    std::vector<char> forged = bytes;
+    const int32_t huge = 0x7fffffff;
+    memcpy(&forged[sizeof(MIPMAP_MAGIC) + 4 + 4 + 8], &huge, sizeof(huge));
+    CHECK(writeFile(path, forged));
+    CHECK(!LoadMipmap(path, &loaded));
+    CHECK(sameMipmap(before, loaded));
+    forged = bytes;
+    forged[0] = 'X';
+    CHECK(writeFile(path, forged));
+    CHECK(!LoadMipmap(path, &loaded));
+    CHECK(sameMipmap(before, loaded));
+    remove(path);
+    CHECK(!LoadMipmap(path, &loaded));
+    CHECK(sameMipmap(before, loaded));
+}
+
+static void checkMipmapSampling(void)
+{
+    // 2x2 checkerboard: texel centres at level 0, the mean at level 1.
+    texture_image_t image = makeImage(2, 2, 1);
+    image.pixels[0] = 0;
+    image.pixels[1] = 255;
+    image.pixels[2] = 255;
+    image.pixels[3] = 0;
+    mipmap_t mipmap;
+    CHECK(BuildMipmap(image, &mipmap));
+    float out[4] = { -1.0f, -1.0f, -1.0f, -1.0f };
+    SampleMipmap(mipmap, 0.25f, 0.25f, 0.0f, out);
+    CHECK(out[0] == 0.0f && out[1] == -1.0f);
+    SampleMipmap(mipmap, 0.75f, 0.25f, 0.0f, out);
+    CHECK(out[0] == 1.0f);
+    // Repeat wrapping: u = 1.25 is u = 0.25.
+    SampleMipmap(mipmap, 1.25f, -0.75f, 0.0f, out);
+    CHECK(out[0] == 0.0f);
+    // Halfway between two texels, and between the two levels.
+    SampleMipmap(mipmap, 0.5f, 0.25f, 0.0f, out);
+    CHECK(std::fabs(out[0] - 0.5f) < 1e-6f);
+    const float mean = mipmap.data[4] / 255.0f;
+    SampleMipmap(mipmap, 0.25f, 0.25f, 1.0f, out);
+    CHECK(out[0] == mean);
+    SampleMipmap(mipmap, 0.25f, 0.25f, 0.5f, out);
+    CHECK(std::fabs(out[0] - 0.5f * mean) < 1e-6f);
+    SampleMipmap(mipmap, 0.25f, 0.25f, 9.0f, out);
+    CHECK(out[0] == mean);
+
+    CHECK(BuildMipmap(makeImage(8, 8, 3), &mipmap));
+    CHECK(SelectMipLevel(mipmap, 1.0f / 8, 0.0f, 0.0f, 1.0f / 8) == 0.0f);
+    CHECK(std::fabs(SelectMipLevel(mipmap, 0.0f, 0.0f, 0.0f, 4.0f / 8) - 2.0f) < 1e-6f);
+    CHECK(SelectMipLevel(mipmap, 100.0f, 0.0f, 0.0f, 0.0f) == 3.0f);
+    CHECK(SelectMipLevel(mipmap, 0.0f, 0.0f, 0.0f, 0.0f) == 0.0f);
+    CHECK(SelectMipLevel(mipmap_t(), 1.0f, 1.0f, 1.0f, 1.0f) == 0.0f);
+}
+
+int main(void)
+{
+    ThreadPool pool(4);
+    checkRequests(&pool);
+    checkEviction(&pool);
+    checkConcurrentGets(&pool);
+    checkMaterials(&pool);
+    checkMipmapBuild();
+    checkMipmapFiles();
+    checkMipmapSampling();
+    printf("failures        %zu\n", g_failures);
+    return (g_failures ? 1 : 0);
+}
@@ -0,0 +1,253 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+/**
+ * Ray-triangle throughput.
+ *
+ * Loads each mesh, packs its triangles into blocks of 1, 4 and 8, and fires
+ * random rays at them by brute force: every ray against every triangle, one
+ * ray against a block at a time (1xN), then packets of rays against one
+ * triangle at a time (Nx1). Prints millions of ray-triangle tests per second
+ * for both tests. Every width must find the same closest hit (prim and t,
+ * bit for bit) as the scalar W = 1 path.
+ *
+ * A second pass aims rays from the mesh centre at the midpoint of edges,
+ * where a non-watertight test can slip between two triangles, and counts the
+ * rays that find nothing. On a closed mesh around its centre (the geodesic
+ * spheres) the watertight test must miss none:
+ *
+ *   bench_triangle [--tests N] [obj ...]
+ *
+ * Build with -ffp-contract=off, like the other maths benchmarks.
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "accel/triangle_obj.h"
+
+typedef std::chrono::steady_clock bench_clock;
+
+static uint32_t g_state = 0x12345678u;
+static size_t g_mismatches = 0;
+
+static float uniform(float lo, float hi)
+{
+    g_state = g_state * 1664525u + 1013904223u;
+    return (lo + (hi - lo) * static_cast<float>(g_state >> 8) * (1.0F / 16777216.0F));
+}
+
+struct Mesh
+{
+    size_t triangles;
+    Vec3 lo, hi;
+    AlignedVector<TriangleBlock<1> > b1;
+    AlignedVector<TriangleBlock<4> > b4;
+    AlignedVector<TriangleBlock<8> > b8;
+    std::vector<Vec3> v0, v1, v2;
+};
+
+struct Result
+{
+    uint32_t prim;
+    float t;
+};
+
+static bool loadMesh(const char *path, Mesh *mesh)
+{
+    attrib_t attrib;
+    std::vector<shape_t> shapes;
+    std::vector<material_t> materials;
+    std::string err;
+    std::string basedir(path, strrchr(path, '/') ? strrchr(path, '/') + 1 - path : 0);
+
+    if (!LoadObj(&attrib, &shapes, &materials, &err, path, basedir.c_str(), true))
+        return (false);
+    mesh->triangles = packTriangles<1>(attrib, shapes, &mesh->b1);
+    packTriangles<4>(attrib, shapes, &mesh->b4);
+    packTriangles<8>(attrib, shapes, &mesh->b8);
+    if (mesh->triangles == 0)
+        return (false);
+    mesh->lo = Vec3(HUGE_VALF);
+    mesh->hi = Vec3(-HUGE_VALF);
+    for (size_t i = 0; i < mesh->triangles; i++)
+    {
+        const TriangleBlock<1>& b = mesh->b1[i];
+        mesh->v0.push_back(Vec3(b.v0.x.v[0], b.v0.y.v[0], b.v0.z.v[0]));
+        mesh->v1.push_back(Vec3(b.v1.x.v[0], b.v1.y.v[0], b.v1.z.v[0]));
+        mesh->v2.push_back(Vec3(b.v2.x.v[0], b.v2.y.v[0], b.v2.z.v[0]));
+        mesh->lo = Vec3::Min(mesh->lo, Vec3::Min(mesh->v0[i], Vec3::Min(mesh->v1[i], mesh->v2[i])));
+        mesh->hi = Vec3::Max(mesh->hi, Vec3::Max(mesh->v0[i], Vec3::Max(mesh->v1[i], mesh->v2[i])));
+    }
+    return (true);
+}
+
+static void compare(const std::vector<Result>& ref, const std::vector<Result>& r)
+{
+    for (size_t i = 0; i < ref.size(); i++)
+        g_mismatches += ref[i].prim != r[i].prim || memcmp(&ref[i].t, &r[i].t, sizeof(float)) != 0;
+}
+
+// One ray against every block.
+template <RayTriangle::Test T, int W>
+static double run1xN(const AlignedVector<TriangleBlock<W> >& blocks, const std::vector<Vec3>& orgs,
+    const std::vector<Vec3>& dirs, std::vector<Result>* out)
+{
+    bench_clock::time_point start = bench_clock::now();
+    for (size_t r = 0; r < orgs.size(); r++)
+    {
+        TriangleHit hit;
+        RayTriangle::Closest<T, W>(blocks, orgs[r], dirs[r], 0.0F, HUGE_VALF, &hit);
+        (*out)[r].prim = hit.prim;
+        (*out)[r].t = hit.prim == TRIANGLE_NO_PRIM ? HUGE_VALF : hit.t;
+    }
+    return (std::chrono::duration<double>(bench_clock::now() - start).count());
+}
+
+// W rays against every triangle; orgs.size() must be a multiple of W.
+template <RayTriangle::Test T, int W>
+static double runNx1(const Mesh& mesh, const std::vector<Vec3>& orgs, const std::vector<Vec3>& dirs, std::vector<Result>* out)
+{
+    bench_clock::time_point start = bench_clock::now();
+    for (size_t r = 0; r < orgs.size(); r += W)
+    {
+        RayxW<W> rays;
+        uint32_t prim[W];
+
+        rays.org = Vec3xW<W>::Gather(&orgs[r]);
+        rays.dir = Vec3xW<W>::Gather(&dirs[r]);
+        rays.tmax = FloatxW<W>(HUGE_VALF);
+        std::fill(prim, prim + W, TRIANGLE_NO_PRIM);
+        WatertightRayxW<W> wrays(rays);
+        for (size_t i = 0; i < mesh.triangles; i++)
+        {
+            TriangleHitxW<W> h;
+            if (T == RayTriangle::MollerTrumboreTest)
+                RayTriangle::MollerTrumbore(rays, mesh.v0[i], mesh.v1[i], mesh.v2[i], &h);
+            else
+                RayTriangle::Watertight(wrays, mesh.v0[i], mesh.v1[i], mesh.v2[i], &h);
+            if (h.mask.None())
+                continue;
+            rays.tmax = FloatxW<W>::Blend(h.mask, h.t, rays.tmax);
+            wrays.tmax = rays.tmax;
+            for (int k = 0; k < W; k++)
+                if (h.mask[k])
+                    prim[k] = static_cast<uint32_t>(i);
+        }
+        for (int k = 0; k < W; k++)
+        {
+            (*out)[r + k].prim = prim[k];
+            (*out)[r + k].t = rays.tmax.v[k];
+        }
+    }
+    return (std::chrono::duration<double>(bench_clock::now() - start).count());
+}
+
+template <RayTriangle::Test T>
+static void runTest(const char *name, const Mesh& mesh, const std::vector<Vec3>& orgs, const std::vector<Vec3>& dirs)
+{
+    std::vector<Result> ref(orgs.size()), r(orgs.size());
+    double tests = static_cast<double>(orgs.size()) * static_cast<double>(mesh.triangles) * 1e-6;
+    double s1 = run1xN<T, 1>(mesh.b1, orgs, dirs, &ref);
+    double s4 = run1xN<T, 4>(mesh.b4, orgs, dirs, &r);
+    compare(ref, r);
+    double s8 = run1xN<T, 8>(mesh.b8, orgs, dirs, &r);
+    compare(ref, r);
+    double p4 = runNx1<T, 4>(mesh, orgs, dirs, &r);
+    compare(ref, r);
+    double p8 = runNx1<T, 8>(mesh, orgs, dirs, &r);
+    compare(ref, r);
+    printf("  %-11s scalar %7.1f  1x4 %7.1f  1x8 %7.1f  4x1 %7.1f  8x1 %7.1f  Mtests/s\n", name,
+        tests / s1, tests / s4, tests / s8, tests / p4, tests / p8);
+}
+
+// Rays from the mesh centre through edge midpoints; returns the misses.
+template <RayTriangle::Test T>
+static size_t edgeMisses(const Mesh& mesh, size_t rays)
+{
+    Vec3 centre = (mesh.lo + mesh.hi) * 0.5F;
+    size_t stride = std::max(static_cast<size_t>(1), mesh.triangles / rays);
+    size_t misses = 0;
+    for (size_t i = 0; i < mesh.triangles; i += stride)
+    {
+        TriangleHit hit;
+        Vec3 mid = (mesh.v0[i] + mesh.v1[i]) * 0.5F;
+        misses += !RayTriangle::Closest<T, 8>(mesh.b8, centre, mid - centre, 0.0F, HUGE_VALF, &hit);
+    }
+    return (misses);
+}
+
+int main(int argc, char **argv)
+{
+    double budget = 2e7;
+    std::vector<const char*> paths;
+    for (int i = 1; i < argc; i++)
+    {
+        if (strcmp(argv[i], "--tests") == 0 && i + 1 < argc)
+            budget = std::max(1e4, atof(argv[++i]));
+        else
+            paths.push_back(argv[i]);
+    }
+    if (paths.empty())
+    {
+        paths.push_back("assets/models/cornell-box/CornellBox-Original.obj");
+        paths.push_back("assets/models/geodesic/geodesic_classII_20_20.obj");
+        paths.push_back("assets/models/mori-knob/testObj.obj");
+    }
+
+    printf("simd width      %d lanes\n", RT_SIMD_WIDTH);
+    for (size_t p = 0; p < paths.size(); p++)
+    {
+        Mesh mesh;
+        if (!loadMesh(paths[p], &mesh))
+        {
+            printf("%s: skipped (not loaded or no triangles)\n", paths[p]);
+            continue;
+        }
+        size_t count = static_cast<size_t>(std::min(65536.0, std::max(64.0, budget / static_cast<double>(mesh.triangles))));
+        count = (count + 7) & ~static_cast<size_t>(7);
+        std::vector<Vec3> orgs(count), dirs(count);
+        Vec3 extent = mesh.hi - mesh.lo;
+        for (size_t i = 0; i < count; i++)
+        {
+            orgs[i] = mesh.lo + extent * Vec3(uniform(0.0F, 1.0F), uniform(0.0F, 1.0F), uniform(0.0F, 1.0F));
+            dirs[i] = Vec3(uniform(-1.0F, 1.0F), uniform(-1.0F, 1.0F), uniform(-1.0F, 1.0F));
+        }
+
+        printf("%s: %zu triangles, %zu rays\n", paths[p], mesh.triangles, count);
+        runTest<RayTriangle::MollerTrumboreTest>("moller", mesh, orgs, dirs);
+        runTest<RayTriangle::WatertightTest>("watertight", mesh, orgs, dirs);
+        size_t edges = std::min(mesh.triangles, static_cast<size_t>(std::max(1.0, budget / static_cast<double>(mesh.triangles))));
+        printf("  edge rays   %zu: moller %zu missed, watertight %zu missed\n", edges,
+            edgeMisses<RayTriangle::MollerTrumboreTest>(mesh, edges), edgeMisses<RayTriangle::WatertightTest>(mesh, edges));
+    }
+    printf("hit mismatches  %zu\n", g_mismatches);
+    return (g_mismatches ? 1 : 0);
+}
@@ -0,0 +1,328 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include "maths/packet.h"
+#include "maths/vec3.h"
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+/**
+ * Ray-box intersection.
+ *
+ * The slab test of Kay and Kajiya, with the near and far planes of each axis
+ * picked from the sign of the ray direction (Williams et al., JGT 2005), so
+ * that no per-axis min/max is needed. One ray is tested against the W child
+ * boxes of a wide BVH node, stored SoA in an AABBxW.
+ *
+ * Robustness:
+ *
+ * - A zero direction component gives an infinite inverse. A ray lying in a
+ *   slab plane then computes 0 * inf = NaN for that plane. The reductions
+ *   are ordered so that NaN distances are dropped (FloatxW::Max(acc, t)
+ *   keeps acc when t is NaN), which leaves that plane unconstrained: rays
+ *   running along a face hit the box, on either face and for +0 and -0.
+ * - For the same reason, a box with NaN bounds is hit (conservative: a
+ *   traversal never skips it), and so is every box for a ray with a NaN
+ *   direction. Empty boxes (lo = +inf, hi = -inf) are never hit.
+ * - The exit distance is scaled by 1 + 2 gamma(3) (Ize, JCGT 2013), so the
+ *   rounding of the three operations per plane never turns a grazing hit
+ *   into a miss.
+ *
+ * A box is hit when max(tmin, entries) <= min(tmax, exits). Every lane
+ * computes exactly what the scalar AABB test computes.
+ */
+
+/*** @brief 1 + 2 gamma(3) = 1 + 3 ulp(1), applied to exit distances. */
+#define AABB_EXIT_SCALE 1.00000036F
+
+/*** @brief Axis-aligned bounding box. */
+struct AABB
+{
+    public:
+        /*** @brief Default constructor. Empty box: lo is +inf and hi is -inf. */
+        AABB(void);
+
+        /**
+         * @brief Constructor.
+         *
+         * @param lo The minimum corner.
+         * @param hi The maximum corner.
+         */
+        AABB(const Vec3& lo, const Vec3& hi);
+
+        /*** @brief Grows the box to contain a point. */
+        void Expand(const Vec3& p);
+
+        /*** @brief Grows the box to contain another box. */
+        void Expand(const AABB& b);
+
+        /*** @brief Whether lo > hi on some axis. */
+        bool Empty(void) const;
+
+        /*** @brief Centre of the box. */
+        Vec3 Centroid(void) const;
+
+        /*** @brief Area of the six faces, 0 for an empty box. */
+        float SurfaceArea(void) const;
+
+        /*** @brief Smallest box containing both. */
+        static AABB Union(const AABB& a, const AABB& b);
+
+        /*** @brief Corners */
+        Vec3 lo, hi;
+};
+
+/*** @brief W boxes in SoA layout, e.g. the children of a wide BVH node. */
+template <int W>
+struct AABBxW
+{
+    public:
+        /*** @brief Default constructor. Empty boxes, which are never hit. */
+        AABBxW(void);
+
+        /*** @brief Stores a box in a lane. */
+        void Set(int lane, const AABB& box);
+
+        /*** @brief Reads the box of a lane. */
+        AABB Get(int lane) const;
+
+        /*** @brief Corners */
+        Vec3xW<W> lo, hi;
+};
+
+/*** @brief One ray prepared for the slab test. */
+struct AABBRay
+{
+    public:
+        /*** @brief Default constructor. Ray along +z from the origin. */
+        AABBRay(void);
+
+        /**
+         * @brief Prepares a ray.
+         *
+         * @param org The origin.
+         * @param dir The direction, need not be normalized; zero components are allowed.
+         * @param tmin Start of the valid interval.
+         * @param tmax End of the valid interval.
+         */
+        AABBRay(const Vec3& org, const Vec3& dir, float tmin, float tmax);
+
+        /*** @brief Origin */
+        Vec3 org;
+        /*** @brief 1 / dir, +-inf for zero components */
+        Vec3 invDir;
+        /*** @brief 1 where invDir is negative (including -0 directions): the near plane is hi */
+        int sign[3];
+        /*** @brief Valid interval, inclusive */
+        float tmin, tmax;
+};
+
+struct RayAABB
+{
+    public:
+        /**
+         * @brief One ray against one box.
+         *
+         * @param ray The ray.
+         * @param box The box.
+         * @param tEntry Receives the entry distance, clamped to tmin.
+         *
+         * @return True on a hit.
+         */
+        static bool Intersect(const AABBRay& ray, const AABB& box, float* tEntry);
+
+        /**
+         * @brief One ray against W boxes.
+         *
+         * @param ray The ray, broadcast to every lane.
+         * @param boxes The boxes.
+         * @param tEntry Receives the entry distances, clamped to tmin; lanes
+         *               outside the returned mask are unspecified.
+         *
+         * @return The lanes that hit.
+         */
+        template <int W>
+        static MaskxW<W> Intersect(const AABBRay& ray, const AABBxW<W>& boxes, FloatxW<W>* tEntry);
+
+        /**
+         * @brief Hit lanes sorted front to back, for the traversal order.
+         *
+         * @param mask Lanes that hit.
+         * @param tEntry Their entry distances.
+         * @param lanes Receives the hit lanes by increasing distance; equal
+         *              distances keep the lane order. Room for W entries.
+         *
+         * @return The number of hit lanes.
+         */
+        template <int W>
+        static int Order(const MaskxW<W>& mask, const FloatxW<W>& tEntry, int* lanes);
+
+    private:
+        static int LowestBit(uint64_t bits);
+};
+
+inline AABB::AABB(void) : lo(HUGE_VALF), hi(-HUGE_VALF) {};
+
+inline AABB::AABB(const Vec3& lo, const Vec3& hi) : lo(lo), hi(hi) {};
+
+inline void AABB::Expand(const Vec3& p)
+{
+    lo = Vec3::Min(lo, p);
+    hi = Vec3::Max(hi, p);
+};
+
+inline void AABB::Expand(const AABB& b)
+{
+    lo = Vec3::Min(lo, b.lo);
+    hi = Vec3::Max(hi, b.hi);
+};
+
+inline bool AABB::Empty(void) const
+{
+    return (lo.x > hi.x || lo.y > hi.y || lo.z > hi.z);
+};
+
+inline Vec3 AABB::Centroid(void) const
+{
+    return ((lo + hi) * 0.5F);
+};
+
+inline float AABB::SurfaceArea(void) const
+{
+    if (Empty())
+        return (0.0F);
+    Vec3 d = hi - lo;
+    return (2.0F * (d.x * d.y + d.y * d.z + d.z * d.x));
+};
+
+inline AABB AABB::Union(const AABB& a, const AABB& b)
+{
+    return (AABB(Vec3::Min(a.lo, b.lo), Vec3::Max(a.hi, b.hi)));
+};
+
+template <int W>
+inline AABBxW<W>::AABBxW(void)
+    : lo(Vec3xW<W>::Broadcast(Vec3(HUGE_VALF))), hi(Vec3xW<W>::Broadcast(Vec3(-HUGE_VALF))) {};
+
+template <int W>
+inline void AABBxW<W>::Set(int lane, const AABB& box)
+{
+    lo.x.v[lane] = box.lo.x; lo.y.v[lane] = box.lo.y; lo.z.v[lane] = box.lo.z;
+    hi.x.v[lane] = box.hi.x; hi.y.v[lane] = box.hi.y; hi.z.v[lane] = box.hi.z;
+};
+
+template <int W>
+inline AABB AABBxW<W>::Get(int lane) const
+{
+    return (AABB(Vec3(lo.x.v[lane], lo.y.v[lane], lo.z.v[lane]), Vec3(hi.x.v[lane], hi.y.v[lane], hi.z.v[lane])));
+};
+
+inline AABBRay::AABBRay(void)
+    : org(0.0F), invDir(HUGE_VALF, HUGE_VALF, 1.0F), tmin(0.0F), tmax(HUGE_VALF)
+{
+    sign[0] = sign[1] = sign[2] = 0;
+};
+
+inline AABBRay::AABBRay(const Vec3& org, const Vec3& dir, float tmin, float tmax)
+    : org(org), invDir(1.0F / dir.x, 1.0F / dir.y, 1.0F / dir.z), tmin(tmin), tmax(tmax)
+{
+    // From invDir rather than dir, so -0 goes with its -inf.
+    sign[0] = std::signbit(invDir.x) ? 1 : 0;
+    sign[1] = std::signbit(invDir.y) ? 1 : 0;
+    sign[2] = std::signbit(invDir.z) ? 1 : 0;
+};
+
+inline bool RayAABB::Intersect(const AABBRay& ray, const AABB& box, float* tEntry)
+{
+    const Vec3* corners[2] = { &box.lo, &box.hi };
+    Vec3 front(corners[ray.sign[0]]->x, corners[ray.sign[1]]->y, corners[ray.sign[2]]->z);
+    Vec3 back(corners[1 - ray.sign[0]]->x, corners[1 - ray.sign[1]]->y, corners[1 - ray.sign[2]]->z);
+    Vec3 t0 = (front - ray.org) * ray.invDir;
+    Vec3 t1 = (back - ray.org) * ray.invDir;
+    // The accumulator goes first: std::max and std::min keep it against a NaN.
+    float entry = std::max(std::max(std::max(ray.tmin, t0.x), t0.y), t0.z);
+    float exit = std::min(std::min(std::min(ray.tmax, t1.x), t1.y), t1.z) * AABB_EXIT_SCALE;
+
+    *tEntry = entry;
+    return (entry <= exit);
+};
+
+template <int W>
+RT_INLINE MaskxW<W> RayAABB::Intersect(const AABBRay& ray, const AABBxW<W>& boxes, FloatxW<W>* tEntry)
+{
+    const FloatxW<W> ox(ray.org.x), oy(ray.org.y), oz(ray.org.z);
+    const FloatxW<W> ix(ray.invDir.x), iy(ray.invDir.y), iz(ray.invDir.z);
+    FloatxW<W> t0x = ((ray.sign[0] ? boxes.hi.x : boxes.lo.x) - ox) * ix;
+    FloatxW<W> t0y = ((ray.sign[1] ? boxes.hi.y : boxes.lo.y) - oy) * iy;
+    FloatxW<W> t0z = ((ray.sign[2] ? boxes.hi.z : boxes.lo.z) - oz) * iz;
+    FloatxW<W> t1x = ((ray.sign[0] ? boxes.lo.x : boxes.hi.x) - ox) * ix;
+    FloatxW<W> t1y = ((ray.sign[1] ? boxes.lo.y : boxes.hi.y) - oy) * iy;
+    FloatxW<W> t1z = ((ray.sign[2] ? boxes.lo.z : boxes.hi.z) - oz) * iz;
+    FloatxW<W> entry = FloatxW<W>::Max(FloatxW<W>::Max(FloatxW<W>::Max(FloatxW<W>(ray.tmin), t0x), t0y), t0z);
+    FloatxW<W> exit = FloatxW<W>::Min(FloatxW<W>::Min(FloatxW<W>::Min(FloatxW<W>(ray.tmax), t1x), t1y), t1z) * FloatxW<W>(AABB_EXIT_SCALE);
+
+    *tEntry = entry;
+    return (entry <= exit);
+};
+
+RT_INLINE int RayAABB::LowestBit(uint64_t bits)
+{
+#if defined(__GNUC__)
+    return (__builtin_ctzll(bits));
+#elif defined(_MSC_VER) && defined(_M_X64)
+    unsigned long i;
+    _BitScanForward64(&i, bits);
+    return (static_cast<int>(i));
+#else
+    int i = 0;
+    for (; !(bits & 1u); bits >>= 1)
+        i++;
+    return (i);
+#endif
+};
+
+template <int W>
+inline int RayAABB::Order(const MaskxW<W>& mask, const FloatxW<W>& tEntry, int* lanes)
+{
+    uint64_t bits = mask.Bits();
+    int count = 0;
+
+    for (; bits; bits &= bits - 1)
+    {
+        int i = LowestBit(bits);
+        // Insertion sort; W is at most a handful of lanes.
+        int k = count++;
+        for (; k > 0 && tEntry.v[lanes[k - 1]] > tEntry.v[i]; k--)
+            lanes[k] = lanes[k - 1];
+        lanes[k] = i;
+    }
+    return (count);
+};
@@ -0,0 +1,581 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <vector>
+#include "accel/aabb.h"
+#include "accel/triangle.h"
+#include "utils/thread_pool.h"
+
+/**
+ * Bounding volume hierarchy over triangles. accel/bvh_obj.h builds one from
+ * loaded meshes.
+ *
+ * Top-down binned SAH build (Wald, "On fast construction of SAH-based
+ * bounding volume hierarchies", 2007): the triangle centroids of a node are
+ * dropped into a fixed number of bins along each axis, and the node is split
+ * at the bin boundary minimizing the surface area heuristic. Leaves are
+ * costed in TriangleBlocks of W triangles, which is what they cost to
+ * intersect, so the heuristic fills leaves to the block width.
+ *
+ * When both children of a node are large, the right one is handed to the
+ * ThreadPool as a task and the current thread goes on with the left one, so
+ * the top-level splits fan out across the workers. Tasks own disjoint ranges
+ * of the triangle index array and build into their own node arrays, which
+ * are stitched together depth first at the end: the tree does not depend on
+ * the number of threads or on scheduling.
+ *
+ * Nodes are stored depth first. The left child of an interior node follows
+ * it and `first` is the index of the right child; a leaf covers `count`
+ * blocks from `first`, its triangles in increasing prim order.
+ */
+
+/*** @brief Depth limit; deeper nodes become leaves whatever their size. Also the traversal stack size. */
+#define BVH_MAX_DEPTH 64
+/*** @brief Upper bound of BVHBuildOptions::bins */
+#define BVH_MAX_BINS 64
+/*** @brief count of the placeholder left in a task's nodes for a subtree built by another task */
+#define BVH_TASK_NODE 0xFFFFFFFFu
+
+/*** @brief Build parameters. */
+struct BVHBuildOptions
+{
+    public:
+        /*** @brief Default constructor. 16 bins, unit costs, leaves of up to 4 blocks, tasks of 4096 triangles and more. */
+        BVHBuildOptions(void);
+
+        /*** @brief Bins per axis, 2 to BVH_MAX_BINS */
+        int bins;
+        /*** @brief Cost of visiting a node, relative to intersectCost */
+        float traversalCost;
+        /*** @brief Cost of intersecting one TriangleBlock */
+        float intersectCost;
+        /*** @brief Larger nodes are always split, unless they are at BVH_MAX_DEPTH */
+        size_t maxLeafBlocks;
+        /*** @brief Smallest subtree, in triangles, built as a separate task */
+        size_t taskSize;
+};
+
+/*** @brief Summary of a build. */
+struct BVHBuildStats
+{
+    /*** @brief Wall-clock time of Build (of buildBVH: packing included) */
+    double seconds;
+    /*** @brief SAH cost of the tree, for a ray hitting the root box */
+    float sahCost;
+    /*** @brief Sizes */
+    size_t triangles, nodes, leaves, blocks;
+    /*** @brief Subtrees built as separate tasks, the root one included */
+    size_t tasks;
+    /*** @brief Levels below the root */
+    int depth;
+};
+
+/*** @brief One node, 32 bytes. */
+struct BVHNode
+{
+    /*** @brief Bounds of the triangles below */
+    AABB bounds;
+    /*** @brief Interior node: index of the right child. Leaf: first block */
+    uint32_t first;
+    /*** @brief Number of blocks, 0 for an interior node */
+    uint32_t count;
+};
+
+/**
+ * @brief Binary BVH whose leaves are TriangleBlocks.
+ *
+ * @tparam W Triangles per block, as for TriangleBlock.
+ */
+template <int W>
+struct BVH
+{
+    public:
+        /**
+         * @brief Builds the tree of the given triangles.
+         *
+         * The prim of each triangle is kept and becomes the prim of its
+         * hits.
+         *
+         * @param triangles One triangle per block, prims increasing, as
+         *                  packed by packTriangles<1>.
+         * @param pool Workers for the subtrees, NULL to build on the calling
+         *             thread only. Must not be the pool running the caller.
+         * @param bvh Receives the tree.
+         * @param stats Receives the build summary, may be NULL.
+         * @param options The build parameters.
+         *
+         * @return The number of triangles.
+         */
+        static size_t Build(const AlignedVector<TriangleBlock<1> >& triangles, ThreadPool* pool, BVH* bvh,
+            BVHBuildStats* stats = NULL, const BVHBuildOptions& options = BVHBuildOptions());
+
+        /**
+         * @brief Surface area heuristic of the tree: the expected cost of a
+         *        ray through the root box, in the units of the options.
+         */
+        float SahCost(const BVHBuildOptions& options = BVHBuildOptions()) const;
+
+        /**
+         * @brief Closest hit of one ray.
+         *
+         * Same result as RayTriangle::Closest over every triangle, ties
+         * included: the lowest prim wins among hits at the same distance.
+         *
+         * @param org The ray origin.
+         * @param dir The ray direction.
+         * @param tmin Hits must be beyond this distance.
+         * @param tmax Hits must be closer than this distance.
+         * @param hit Receives the closest hit; on a miss prim is TRIANGLE_NO_PRIM and t is tmax.
+         *
+         * @return True on a hit.
+         */
+        template <RayTriangle::Test T>
+        bool Closest(const Vec3& org, const Vec3& dir, float tmin, float tmax, TriangleHit* hit) const;
+
+        /*** @brief Nodes, the root first */
+        std::vector<BVHNode> nodes;
+        /*** @brief Triangles of the leaves */
+        AlignedVector<TriangleBlock<W> > blocks;
+
+    private:
+        struct Task
+        {
+            uint32_t begin, end;
+            int depth;
+            std::vector<BVHNode> nodes;
+        };
+
+        struct Builder
+        {
+            const BVHBuildOptions* options;
+            std::vector<AABB> boxes;
+            std::vector<Vec3> centroids;
+            std::vector<uint32_t> prims;
+            ThreadPool* pool;
+            std::deque<Task> tasks;
+            size_t pending;
+            std::mutex mutex;
+            std::condition_variable done;
+        };
+
+        static size_t Blocks(size_t triangles);
+        static int Bin(float c, float lo, float scale, int bins);
+        static bool FindSplit(const Builder* b, uint32_t begin, uint32_t end, const AABB& bounds, const AABB& centroids, int* axis, int* split);
+        static uint32_t Subtree(Builder* b, Task* task, uint32_t begin, uint32_t end, int depth);
+        static void RunTask(Builder* b, Task* task);
+        static uint32_t Emit(Builder* b, const Task* task, uint32_t local, std::vector<BVHNode>* out);
+};
+
+inline BVHBuildOptions::BVHBuildOptions(void)
+    : bins(16), traversalCost(1.0F), intersectCost(1.0F), maxLeafBlocks(4), taskSize(4096) {};
+
+template <int W>
+inline size_t BVH<W>::Blocks(size_t triangles)
+{
+    return ((triangles + W - 1) / W);
+};
+
+// NaN centroids go to the first bin rather than through an undefined conversion.
+template <int W>
+RT_INLINE int BVH<W>::Bin(float c, float lo, float scale, int bins)
+{
+    float f = (c - lo) * scale;
+
+    return ((f > 0.0F) ? static_cast<int>(std::min(f, static_cast<float>(bins - 1))) : 0);
+};
+
+template <int W>
+inline size_t BVH<W>::Build(const AlignedVector<TriangleBlock<1> >& triangles, ThreadPool* pool, BVH* bvh,
+    BVHBuildStats* stats, const BVHBuildOptions& options)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    size_t count = triangles.size();
+    Builder b;
+
+    bvh->nodes.clear();
+    bvh->blocks.clear();
+    b.options = &options;
+    b.pool = pool;
+    b.pending = 0;
+    b.boxes.resize(count);
+    b.centroids.resize(count);
+    b.prims.resize(count);
+    for (size_t i = 0; i < count; i++)
+    {
+        const TriangleBlock<1>& t = triangles[i];
+        AABB box;
+
+        box.Expand(Vec3(t.v0.x.v[0], t.v0.y.v[0], t.v0.z.v[0]));
+        box.Expand(Vec3(t.v1.x.v[0], t.v1.y.v[0], t.v1.z.v[0]));
+        box.Expand(Vec3(t.v2.x.v[0], t.v2.y.v[0], t.v2.z.v[0]));
+        b.boxes[i] = box;
+        b.centroids[i] = box.Centroid();
+        b.prims[i] = static_cast<uint32_t>(i);
+    }
+
+    if (count)
+    {
+        b.tasks.push_back(Task());
+        b.tasks[0].begin = 0;
+        b.tasks[0].end = static_cast<uint32_t>(count);
+        b.tasks[0].depth = 0;
+        Subtree(&b, &b.tasks[0], 0, static_cast<uint32_t>(count), 0);
+        std::unique_lock<std::mutex> lock(b.mutex);
+        b.done.wait(lock, [&b] { return (b.pending == 0); });
+        bvh->nodes.reserve(2 * Blocks(count));
+        Emit(&b, &b.tasks[0], 0, &bvh->nodes);
+    }
+
+    // Leaves still hold ranges of b.prims; pack them into blocks.
+    bvh->blocks.reserve(bvh->nodes.size());
+    for (size_t n = 0; n < bvh->nodes.size(); n++)
+    {
+        BVHNode& node = bvh->nodes[n];
+        if (node.count == 0)
+            continue;
+        uint32_t* prims = &b.prims[node.first];
+        size_t size = node.count;
+
+        std::sort(prims, prims + size);
+        node.first = static_cast<uint32_t>(bvh->blocks.size());
+        node.count = static_cast<uint32_t>(Blocks(size));
+        for (size_t k = 0; k < size; k++)
+        {
+            if (k % W == 0)
+                bvh->blocks.push_back(TriangleBlock<W>());
+            TriangleBlock<W>& block = bvh->blocks.back();
+            const TriangleBlock<1>& t = triangles[prims[k]];
+            int lane = static_cast<int>(k % W);
+
+            block.v0.x.v[lane] = t.v0.x.v[0]; block.v0.y.v[lane] = t.v0.y.v[0]; block.v0.z.v[lane] = t.v0.z.v[0];
+            block.v1.x.v[lane] = t.v1.x.v[0]; block.v1.y.v[lane] = t.v1.y.v[0]; block.v1.z.v[lane] = t.v1.z.v[0];
+            block.v2.x.v[lane] = t.v2.x.v[0]; block.v2.y.v[lane] = t.v2.y.v[0]; block.v2.z.v[lane] = t.v2.z.v[0];
+            block.prim[lane] = t.prim[0];
+        }
+    }
+
+    if (stats)
+    {
+        std::vector<std::pair<uint32_t, int> > stack;
+
+        stats->triangles = count;
+        stats->nodes = bvh->nodes.size();
+        stats->blocks = bvh->blocks.size();
+        stats->tasks = b.tasks.size();
+        stats->leaves = 0;
+        stats->depth = 0;
+        if (!bvh->nodes.empty())
+            stack.push_back(std::make_pair(0u, 0));
+        while (!stack.empty())
+        {
+            uint32_t n = stack.back().first;
+            int depth = stack.back().second;
+
+            stack.pop_back();
+            stats->depth = std::max(stats->depth, depth);
+            if (bvh->nodes[n].count)
+            {
+                stats->leaves++;
+                continue;
+            }
+            stack.push_back(std::make_pair(n + 1, depth + 1));
+            stack.push_back(std::make_pair(bvh->nodes[n].first, depth + 1));
+        }
+        stats->sahCost = bvh->SahCost(options);
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    }
+    return (count);
+};
+
+template <int W>
+inline bool BVH<W>::FindSplit(const Builder* b, uint32_t begin, uint32_t end, const AABB& bounds, const AABB& centroids, int* axis, int* split)
+{
+    const BVHBuildOptions& options = *b->options;
+    const int bins = std::max(2, std::min(options.bins, BVH_MAX_BINS));
+    AABB binBounds[3][BVH_MAX_BINS];
+    uint32_t binCount[3][BVH_MAX_BINS];
+    float scale[3];
+    float best = HUGE_VALF;
+
+    for (int a = 0; a < 3; a++)
+    {
+        float extent = centroids.hi[a] - centroids.lo[a];
+        // Zero, infinite or NaN extents leave everything in the first bin: no split on that axis.
+        scale[a] = (extent > 0.0F && extent < HUGE_VALF) ? static_cast<float>(bins) / extent : 0.0F;
+        std::fill(binCount[a], binCount[a] + bins, 0u);
+    }
+    for (uint32_t i = begin; i < end; i++)
+    {
+        uint32_t p = b->prims[i];
+
+        for (int a = 0; a < 3; a++)
+        {
+            int bin = Bin(b->centroids[p][a], centroids.lo[a], scale[a], bins);
+            binBounds[a][bin].Expand(b->boxes[p]);
+            binCount[a][bin]++;
+        }
+    }
+
+    // Sweep from the right for the areas and counts of the right sides, then from the left.
+    // Costs are scaled by the node area, which spares a division and copes with flat nodes.
+    const float area = bounds.SurfaceArea();
+    const size_t blocks = Blocks(end - begin);
+    for (int a = 0; a < 3; a++)
+    {
+        if (scale[a] == 0.0F)
+            continue;
+        float rightArea[BVH_MAX_BINS];
+        uint32_t rightCount[BVH_MAX_BINS];
+        AABB right, left;
+        uint32_t count = 0;
+
+        for (int i = bins - 1; i > 0; i--)
+        {
+            right.Expand(binBounds[a][i]);
+            count += binCount[a][i];
+            rightArea[i] = right.SurfaceArea();
+            rightCount[i] = count;
+        }
+        count = 0;
+        for (int i = 1; i < bins; i++)
+        {
+            left.Expand(binBounds[a][i - 1]);
+            count += binCount[a][i - 1];
+            if (count == 0 || rightCount[i] == 0)
+                continue;
+            float cost = options.traversalCost * area + options.intersectCost *
+                (left.SurfaceArea() * static_cast<float>(Blocks(count)) + rightArea[i] * static_cast<float>(Blocks(rightCount[i])));
+            if (cost < best)
+            {
+                best = cost;
+                *axis = a;
+                *split = i;
+            }
+        }
+    }
+    if (!(best < HUGE_VALF))
+        return (false);
+    return (best < options.intersectCost * area * static_cast<float>(blocks) || blocks > options.maxLeafBlocks);
+};
+
+template <int W>
+inline uint32_t BVH<W>::Subtree(Builder* b, Task* task, uint32_t begin, uint32_t end, int depth)
+{
+    const uint32_t index = static_cast<uint32_t>(task->nodes.size());
+    AABB bounds, centroids;
+    int axis = -1, split = 0;
+    uint32_t mid;
+
+    for (uint32_t i = begin; i < end; i++)
+    {
+        bounds.Expand(b->boxes[b->prims[i]]);
+        centroids.Expand(b->centroids[b->prims[i]]);
+    }
+    task->nodes.push_back(BVHNode());
+    task->nodes[index].bounds = bounds;
+
+    bool leaf = (end - begin == 1) || depth + 1 >= BVH_MAX_DEPTH;
+    if (!leaf && FindSplit(b, begin, end, bounds, centroids, &axis, &split))
+    {
+        const int bins = std::max(2, std::min(b->options->bins, BVH_MAX_BINS));
+        const float lo = centroids.lo[axis];
+        const float scale = static_cast<float>(bins) / (centroids.hi[axis] - lo);
+        const std::vector<Vec3>& c = b->centroids;
+
+        // Same binning as FindSplit, so both sides get the counts it costed.
+        mid = static_cast<uint32_t>(std::partition(&b->prims[0] + begin, &b->prims[0] + end,
+            [&](uint32_t p) { return (Bin(c[p][axis], lo, scale, bins) < split); }) - &b->prims[0]);
+    }
+    else if (!leaf && Blocks(end - begin) > b->options->maxLeafBlocks)
+    {
+        // No usable split (all centroids on one point, or non-finite ones): halve, block aligned.
+        mid = begin + static_cast<uint32_t>(Blocks(end - begin) / 2 * W);
+    }
+    else
+    {
+        task->nodes[index].first = begin;
+        task->nodes[index].count = end - begin;
+        return (index);
+    }
+
+    task->nodes[index].count = 0;
+    if (b->pool && std::min(mid - begin, end - mid) >= b->options->taskSize)
+    {
+        Task* child;
+        uint32_t id;
+        {
+            std::unique_lock<std::mutex> lock(b->mutex);
+            id = static_cast<uint32_t>(b->tasks.size());
+            b->tasks.push_back(Task());
+            child = &b->tasks.back();
+            b->pending++;
+        }
+        child->begin = mid;
+        child->end = end;
+        child->depth = depth + 1;
+        b->pool->submit(std::bind(&BVH::RunTask, b, child));
+        Subtree(b, task, begin, mid, depth + 1);
+        task->nodes[index].first = static_cast<uint32_t>(task->nodes.size());
+        task->nodes.push_back(BVHNode());
+        task->nodes.back().first = id;
+        task->nodes.back().count = BVH_TASK_NODE;
+        return (index);
+    }
+    Subtree(b, task, begin, mid, depth + 1);
+    uint32_t right = Subtree(b, task, mid, end, depth + 1);
+    task->nodes[index].first = right;
+    return (index);
+};
+
+template <int W>
+inline void BVH<W>::RunTask(Builder* b, Task* task)
+{
+    Subtree(b, task, task->begin, task->end, task->depth);
+    std::unique_lock<std::mutex> lock(b->mutex);
+    if (--b->pending == 0)
+        b->done.notify_all();
+};
+
+template <int W>
+inline uint32_t BVH<W>::Emit(Builder* b, const Task* task, uint32_t local, std::vector<BVHNode>* out)
+{
+    const BVHNode& node = task->nodes[local];
+
+    if (node.count == BVH_TASK_NODE)
+        return (Emit(b, &b->tasks[node.first], 0, out));
+
+    uint32_t index = static_cast<uint32_t>(out->size());
+    out->push_back(node);
+    if (node.count == 0)
+    {
+        Emit(b, task, local + 1, out);
+        uint32_t right = Emit(b, task, node.first, out);
+        (*out)[index].first = right;
+    }
+    return (index);
+};
+
+template <int W>
+inline float BVH<W>::SahCost(const BVHBuildOptions& options) const
+{
+    if (nodes.empty())
+        return (0.0F);
+
+    double rootArea = nodes[0].bounds.SurfaceArea();
+    double cost = 0.0;
+
+    for (size_t n = 0; n < nodes.size(); n++)
+    {
+        double area = nodes[n].bounds.SurfaceArea();
+
+        if (nodes[n].count)
+            cost += options.intersectCost * nodes[n].count * area;
+        else
+            cost += options.traversalCost * area;
+    }
+    return (rootArea > 0.0 ? static_cast<float>(cost / rootArea) : 0.0F);
+};
+
+template <int W>
+template <RayTriangle::Test T>
+inline bool BVH<W>::Closest(const Vec3& org, const Vec3& dir, float tmin, float tmax, TriangleHit* hit) const
+{
+    uint32_t stack[BVH_MAX_DEPTH];
+    float stackEntry[BVH_MAX_DEPTH];
+    int top = 0;
+    AABBRay ray(org, dir, tmin, tmax);
+    TriangleHit h;
+    uint32_t current = 0;
+    float entry;
+
+    hit->t = tmax;
+    hit->u = hit->v = 0.0F;
+    hit->prim = TRIANGLE_NO_PRIM;
+    if (nodes.empty() || !RayAABB::Intersect(ray, nodes[0].bounds, &entry))
+        return (false);
+    for (;;)
+    {
+        const BVHNode& node = nodes[current];
+
+        if (node.count)
+        {
+            // Past the first hit, let hits at the same distance through, so that ties
+            // go to the lowest prim across leaves as they do within one.
+            float limit = (hit->prim == TRIANGLE_NO_PRIM) ? tmax : std::nextafter(hit->t, HUGE_VALF);
+            if (RayTriangle::Closest<T, W>(&blocks[node.first], node.count, org, dir, tmin, limit, &h) &&
+                (h.t < hit->t || h.prim < hit->prim))
+            {
+                *hit = h;
+                ray.tmax = h.t;
+            }
+        }
+        else
+        {
+            uint32_t near = current + 1, far = node.first;
+            float tNear, tFar;
+            bool hitNear = RayAABB::Intersect(ray, nodes[near].bounds, &tNear);
+            bool hitFar = RayAABB::Intersect(ray, nodes[far].bounds, &tFar);
+
+            if (hitNear && hitFar)
+            {
+                if (tFar < tNear)
+                {
+                    std::swap(near, far);
+                    std::swap(tNear, tFar);
+                }
+                stack[top] = far;
+                stackEntry[top] = tFar;
+                top++;
+                current = near;
+                continue;
+            }
+            if (hitNear || hitFar)
+            {
+                current = hitNear ? near : far;
+                continue;
+            }
+        }
+        // Pop the next subtree that may still hold a closer hit, or one at the same distance.
+        for (;;)
+        {
+            if (top == 0)
+                return (hit->prim != TRIANGLE_NO_PRIM);
+            top--;
+            if (stackEntry[top] <= ray.tmax)
+                break;
+        }
+        current = stack[top];
+    }
+};
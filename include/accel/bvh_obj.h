@@ -0,0 +1,61 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#pragma once
+
+#include <chrono>
+#include <vector>
+#include "accel/bvh.h"
+#include "accel/triangle_obj.h"
+
+/**
+ * @brief Builds the BVH of every triangle of the given shapes.
+ *
+ * Packs the shapes with packTriangles<1>, so the prim of a hit is the
+ * triangle number given there, then runs BVH<W>::Build. Kept out of
+ * accel/bvh.h for the same reason as accel/triangle_obj.h.
+ *
+ * @param attrib The vertices.
+ * @param shapes The shapes, indexing into attrib.vertices.
+ * @param pool Workers for the subtrees, see BVH<W>::Build.
+ * @param bvh Receives the tree.
+ * @param stats Receives the build summary, packing included; may be NULL.
+ * @param options The build parameters.
+ *
+ * @return The number of triangles.
+ */
+template <int W>
+inline size_t buildBVH(const attrib_t& attrib, const std::vector<shape_t>& shapes, ThreadPool* pool, BVH<W>* bvh,
+    BVHBuildStats* stats = NULL, const BVHBuildOptions& options = BVHBuildOptions())
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    AlignedVector<TriangleBlock<1> > triangles;
+    size_t count;
+
+    packTriangles<1>(attrib, shapes, &triangles);
+    count = BVH<W>::Build(triangles, pool, bvh, stats, options);
+    if (stats)
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return (count);
+};
@@ -0,0 +1,445 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include "maths/packet.h"
+#include "maths/vec3.h"
+#include "utils/aligned_allocator.h"
+
+/**
+ * Ray-triangle intersection.
+ *
+ * Triangles are packed W at a time into SoA TriangleBlocks, so that one ray
+ * is tested against W triangles per call (1xN). The same kernels also test
+ * W rays against one triangle (Nx1), with the rays in a RayxW. Two tests are
+ * provided:
+ *
+ * - Möller-Trumbore: edge vectors and one determinant. Fastest, but a ray
+ *   hitting a shared edge exactly may miss both triangles.
+ * - Watertight (Woop, Benthin and Wald, JCGT 2013): the triangle is sheared
+ *   into a space where the ray runs along +z, and the 2D edge functions are
+ *   evaluated there. Edges shared by two triangles are evaluated with the
+ *   same operands, so no ray slips between them. The double precision
+ *   fallback of the paper for edge functions that are exactly 0 is omitted;
+ *   such hits are accepted.
+ *
+ * A hit requires tmin < t < tmax. u and v are the barycentric weights of v1
+ * and v2. Every lane computes the W = 1 instantiation exactly, whichever
+ * side (rays or triangles) is the packet.
+ */
+
+/*** @brief prim of the padding lanes of the last TriangleBlock. */
+#define TRIANGLE_NO_PRIM 0xFFFFFFFFu
+
+/*** @brief W triangles in SoA layout. */
+template <int W>
+struct TriangleBlock
+{
+    public:
+        /*** @brief Default constructor. Degenerate triangles at the origin, which never hit. */
+        TriangleBlock(void) { for (int i = 0; i < W; i++) prim[i] = TRIANGLE_NO_PRIM; };
+
+        /*** @brief Corners */
+        Vec3xW<W> v0, v1, v2;
+        /*** @brief Triangle index, or TRIANGLE_NO_PRIM */
+        uint32_t prim[W];
+};
+
+/*** @brief W rays in SoA layout. Broadcast one ray to test it against a TriangleBlock. */
+template <int W>
+struct RayxW
+{
+    public:
+        /*** @brief Default constructor. Zero rays. */
+        RayxW(void) {};
+
+        /**
+         * @brief Same ray in every lane.
+         *
+         * @param org The origin.
+         * @param dir The direction, need not be normalized.
+         * @param tmin Hits must be beyond this distance.
+         * @param tmax Hits must be closer than this distance.
+         */
+        RayxW(const Vec3& org, const Vec3& dir, float tmin, float tmax)
+            : org(Vec3xW<W>::Broadcast(org)), dir(Vec3xW<W>::Broadcast(dir)), tmin(tmin), tmax(tmax) {};
+
+        /*** @brief Origins and directions */
+        Vec3xW<W> org, dir;
+        /*** @brief Valid interval, exclusive */
+        FloatxW<W> tmin, tmax;
+};
+
+/**
+ * @brief One ray prepared for the watertight test: the axis permutation
+ *        and shear that map it onto +z.
+ */
+struct WatertightRay
+{
+    public:
+        /*** @brief Default constructor. Ray along +z from the origin. */
+        WatertightRay(void);
+
+        /**
+         * @brief Prepares a ray.
+         *
+         * @param org The origin.
+         * @param dir The direction, must not be zero.
+         * @param tmin Hits must be beyond this distance.
+         * @param tmax Hits must be closer than this distance.
+         */
+        WatertightRay(const Vec3& org, const Vec3& dir, float tmin, float tmax);
+
+        /*** @brief Origin */
+        Vec3 org;
+        /*** @brief Axis of the largest direction component, and the two others in winding order */
+        int kx, ky, kz;
+        /*** @brief Shear constants */
+        float sx, sy, sz;
+        /*** @brief Valid interval, exclusive */
+        float tmin, tmax;
+};
+
+/**
+ * @brief W rays prepared for the watertight test.
+ *
+ * The per-lane permutation and shear are stored as three rows of a 3x3
+ * matrix holding 1, -sx, -sy, sz and zeros, so that projecting a vertex is a
+ * dot product. Adding zeros and multiplying by one is exact, so lanes match
+ * WatertightRay.
+ */
+template <int W>
+struct WatertightRayxW
+{
+    public:
+        /*** @brief Default constructor. Rays along +z from the origin. */
+        WatertightRayxW(void);
+
+        /**
+         * @brief Prepares W rays.
+         *
+         * @param rays The rays, no zero direction.
+         */
+        explicit WatertightRayxW(const RayxW<W>& rays);
+
+        /*** @brief Origins */
+        Vec3xW<W> org;
+        /*** @brief Rows mapping a vertex relative to org into ray space */
+        Vec3xW<W> rx, ry, rz;
+        /*** @brief Valid interval, exclusive */
+        FloatxW<W> tmin, tmax;
+};
+
+/*** @brief Result of W tests. Lanes outside mask are unspecified. */
+template <int W>
+struct TriangleHitxW
+{
+    /*** @brief Lanes that hit */
+    MaskxW<W> mask;
+    /*** @brief Distance and barycentrics */
+    FloatxW<W> t, u, v;
+};
+
+/*** @brief Closest hit of a ray. */
+struct TriangleHit
+{
+    /*** @brief Distance and barycentrics */
+    float t, u, v;
+    /*** @brief Triangle index, TRIANGLE_NO_PRIM if nothing was hit */
+    uint32_t prim;
+};
+
+struct RayTriangle
+{
+    public:
+        enum Test
+        {
+            MollerTrumboreTest,
+            WatertightTest
+        };
+
+        /**
+         * @brief Möller-Trumbore, one ray against W triangles.
+         *
+         * @param ray The ray, broadcast to every lane.
+         * @param tri The triangles.
+         * @param hit Receives the hits.
+         */
+        template <int W>
+        static void MollerTrumbore(const RayxW<W>& ray, const TriangleBlock<W>& tri, TriangleHitxW<W>* hit);
+
+        /**
+         * @brief Möller-Trumbore, W rays against one triangle.
+         *
+         * @param rays The rays.
+         * @param v0 First corner.
+         * @param v1 Second corner.
+         * @param v2 Third corner.
+         * @param hit Receives the hits.
+         */
+        template <int W>
+        static void MollerTrumbore(const RayxW<W>& rays, const Vec3& v0, const Vec3& v1, const Vec3& v2, TriangleHitxW<W>* hit);
+
+        /*** @brief Watertight, one ray against W triangles. */
+        template <int W>
+        static void Watertight(const WatertightRay& ray, const TriangleBlock<W>& tri, TriangleHitxW<W>* hit);
+
+        /*** @brief Watertight, W rays against one triangle. */
+        template <int W>
+        static void Watertight(const WatertightRayxW<W>& rays, const Vec3& v0, const Vec3& v1, const Vec3& v2, TriangleHitxW<W>* hit);
+
+        /**
+         * @brief Closest hit of one ray against every block, brute force.
+         *
+         * @param blocks The triangles.
+         * @param org The ray origin.
+         * @param dir The ray direction.
+         * @param tmin Hits must be beyond this distance.
+         * @param tmax Hits must be closer than this distance.
+         * @param hit Receives the closest hit; on a miss prim is TRIANGLE_NO_PRIM and t is tmax.
+         *
+         * @return True on a hit.
+         */
+        template <Test T, int W>
+        static bool Closest(const AlignedVector<TriangleBlock<W> >& blocks, const Vec3& org, const Vec3& dir, float tmin, float tmax, TriangleHit* hit);
+
+        /*** @brief Closest over `count` contiguous blocks. Same parameters otherwise. */
+        template <Test T, int W>
+        static bool Closest(const TriangleBlock<W>* blocks, size_t count, const Vec3& org, const Vec3& dir, float tmin, float tmax, TriangleHit* hit);
+
+    private:
+        template <int W, int K>
+        static const FloatxW<W>& Axis(const Vec3xW<W>& a);
+
+        template <int W, int KX, int KY, int KZ>
+        static void WatertightPermuted(const WatertightRay& ray, const TriangleBlock<W>& tri, TriangleHitxW<W>* hit);
+
+        template <int W>
+        static void MollerTrumboreKernel(const Vec3xW<W>& org, const Vec3xW<W>& dir, const FloatxW<W>& tmin, const FloatxW<W>& tmax,
+            const Vec3xW<W>& v0, const Vec3xW<W>& v1, const Vec3xW<W>& v2, TriangleHitxW<W>* hit);
+
+        template <int W>
+        static void WatertightKernel(const Vec3xW<W>& a, const Vec3xW<W>& b, const Vec3xW<W>& c,
+            const FloatxW<W>& tmin, const FloatxW<W>& tmax, TriangleHitxW<W>* hit);
+};
+
+inline WatertightRay::WatertightRay(void)
+    : org(0.0F), kx(0), ky(1), kz(2), sx(0.0F), sy(0.0F), sz(1.0F), tmin(0.0F), tmax(0.0F) {};
+
+inline WatertightRay::WatertightRay(const Vec3& org, const Vec3& dir, float tmin, float tmax)
+    : org(org), tmin(tmin), tmax(tmax)
+{
+    float ax = fabsf(dir.x), ay = fabsf(dir.y), az = fabsf(dir.z);
+
+    kz = (ax > ay) ? (ax > az ? 0 : 2) : (ay > az ? 1 : 2);
+    kx = (kz + 1) % 3;
+    ky = (kx + 1) % 3;
+    // Keeps the winding: swapping x and y mirrors the projection.
+    if (dir[kz] < 0.0F)
+        std::swap(kx, ky);
+    sx = dir[kx] / dir[kz];
+    sy = dir[ky] / dir[kz];
+    sz = 1.0F / dir[kz];
+};
+
+template <int W>
+inline WatertightRayxW<W>::WatertightRayxW(void)
+{
+    rx.x = FloatxW<W>(1.0F);
+    ry.y = FloatxW<W>(1.0F);
+    rz.z = FloatxW<W>(1.0F);
+};
+
+template <int W>
+inline WatertightRayxW<W>::WatertightRayxW(const RayxW<W>& rays)
+    : org(rays.org), tmin(rays.tmin), tmax(rays.tmax)
+{
+    for (int i = 0; i < W; i++)
+    {
+        WatertightRay r(Vec3(0.0F), Vec3(rays.dir.x.v[i], rays.dir.y.v[i], rays.dir.z.v[i]), 0.0F, 0.0F);
+        float row[3][3] = { { 0.0F, 0.0F, 0.0F }, { 0.0F, 0.0F, 0.0F }, { 0.0F, 0.0F, 0.0F } };
+
+        row[0][r.kx] = 1.0F;
+        row[0][r.kz] = -r.sx;
+        row[1][r.ky] = 1.0F;
+        row[1][r.kz] = -r.sy;
+        row[2][r.kz] = r.sz;
+        rx.x.v[i] = row[0][0]; rx.y.v[i] = row[0][1]; rx.z.v[i] = row[0][2];
+        ry.x.v[i] = row[1][0]; ry.y.v[i] = row[1][1]; ry.z.v[i] = row[1][2];
+        rz.x.v[i] = row[2][0]; rz.y.v[i] = row[2][1]; rz.z.v[i] = row[2][2];
+    }
+};
+
+template <int W, int K>
+RT_INLINE const FloatxW<W>& RayTriangle::Axis(const Vec3xW<W>& a)
+{
+    return (K == 0 ? a.x : (K == 1 ? a.y : a.z));
+};
+
+template <int W>
+RT_INLINE void RayTriangle::MollerTrumboreKernel(const Vec3xW<W>& org, const Vec3xW<W>& dir, const FloatxW<W>& tmin, const FloatxW<W>& tmax,
+    const Vec3xW<W>& v0, const Vec3xW<W>& v1, const Vec3xW<W>& v2, TriangleHitxW<W>* hit)
+{
+    Vec3xW<W> e1 = v1 - v0;
+    Vec3xW<W> e2 = v2 - v0;
+    Vec3xW<W> p = Vec3xW<W>::Cross(dir, e2);
+    FloatxW<W> det = Vec3xW<W>::Dot(e1, p);
+    FloatxW<W> inv = FloatxW<W>(1.0F) / det;
+    Vec3xW<W> s = org - v0;
+    Vec3xW<W> q = Vec3xW<W>::Cross(s, e1);
+
+    hit->u = Vec3xW<W>::Dot(s, p) * inv;
+    hit->v = Vec3xW<W>::Dot(dir, q) * inv;
+    hit->t = Vec3xW<W>::Dot(e2, q) * inv;
+    // NaN lanes (degenerate triangles, det == 0) fail every comparison.
+    hit->mask = (hit->u >= FloatxW<W>(0.0F)) & (hit->v >= FloatxW<W>(0.0F)) & ((hit->u + hit->v) <= FloatxW<W>(1.0F))
+        & (hit->t > tmin) & (hit->t < tmax) & (det != FloatxW<W>(0.0F));
+};
+
+template <int W>
+RT_INLINE void RayTriangle::WatertightKernel(const Vec3xW<W>& a, const Vec3xW<W>& b, const Vec3xW<W>& c,
+    const FloatxW<W>& tmin, const FloatxW<W>& tmax, TriangleHitxW<W>* hit)
+{
+    const FloatxW<W> zero(0.0F);
+    // Edge functions; a, b and c hold the sheared x, y and the scaled z.
+    FloatxW<W> eu = (c.x * b.y) - (c.y * b.x);
+    FloatxW<W> ev = (a.x * c.y) - (a.y * c.x);
+    FloatxW<W> ew = (b.x * a.y) - (b.y * a.x);
+    MaskxW<W> negative = (eu < zero) | (ev < zero) | (ew < zero);
+    MaskxW<W> positive = (eu > zero) | (ev > zero) | (ew > zero);
+    // Inside when the three edge functions agree in sign (zeros included).
+    MaskxW<W> inside = !(negative & positive);
+    FloatxW<W> det = (eu + ev) + ew;
+    FloatxW<W> inv = FloatxW<W>(1.0F) / det;
+
+    hit->t = ((eu * a.z) + (ev * b.z) + (ew * c.z)) * inv;
+    hit->u = ev * inv;
+    hit->v = ew * inv;
+    hit->mask = inside & (det != zero) & (hit->t > tmin) & (hit->t < tmax);
+};
+
+template <int W>
+RT_INLINE void RayTriangle::MollerTrumbore(const RayxW<W>& ray, const TriangleBlock<W>& tri, TriangleHitxW<W>* hit)
+{
+    MollerTrumboreKernel(ray.org, ray.dir, ray.tmin, ray.tmax, tri.v0, tri.v1, tri.v2, hit);
+};
+
+template <int W>
+RT_INLINE void RayTriangle::MollerTrumbore(const RayxW<W>& rays, const Vec3& v0, const Vec3& v1, const Vec3& v2, TriangleHitxW<W>* hit)
+{
+    MollerTrumboreKernel(rays.org, rays.dir, rays.tmin, rays.tmax,
+        Vec3xW<W>::Broadcast(v0), Vec3xW<W>::Broadcast(v1), Vec3xW<W>::Broadcast(v2), hit);
+};
+
+template <int W, int KX, int KY, int KZ>
+RT_INLINE void RayTriangle::WatertightPermuted(const WatertightRay& ray, const TriangleBlock<W>& tri, TriangleHitxW<W>* hit)
+{
+    const FloatxW<W> ox(ray.org[KX]), oy(ray.org[KY]), oz(ray.org[KZ]);
+    const FloatxW<W> sx(ray.sx), sy(ray.sy), sz(ray.sz);
+    FloatxW<W> az = Axis<W, KZ>(tri.v0) - oz;
+    FloatxW<W> bz = Axis<W, KZ>(tri.v1) - oz;
+    FloatxW<W> cz = Axis<W, KZ>(tri.v2) - oz;
+    Vec3xW<W> a((Axis<W, KX>(tri.v0) - ox) - (sx * az), (Axis<W, KY>(tri.v0) - oy) - (sy * az), sz * az);
+    Vec3xW<W> b((Axis<W, KX>(tri.v1) - ox) - (sx * bz), (Axis<W, KY>(tri.v1) - oy) - (sy * bz), sz * bz);
+    Vec3xW<W> c((Axis<W, KX>(tri.v2) - ox) - (sx * cz), (Axis<W, KY>(tri.v2) - oy) - (sy * cz), sz * cz);
+
+    WatertightKernel(a, b, c, FloatxW<W>(ray.tmin), FloatxW<W>(ray.tmax), hit);
+};
+
+template <int W>
+RT_INLINE void RayTriangle::Watertight(const WatertightRay& ray, const TriangleBlock<W>& tri, TriangleHitxW<W>* hit)
+{
+    // One instantiation per axis permutation keeps the components in registers.
+    switch (ray.kz * 3 + ray.kx)
+    {
+        case 0 * 3 + 1: WatertightPermuted<W, 1, 2, 0>(ray, tri, hit); break;
+        case 0 * 3 + 2: WatertightPermuted<W, 2, 1, 0>(ray, tri, hit); break;
+        case 1 * 3 + 2: WatertightPermuted<W, 2, 0, 1>(ray, tri, hit); break;
+        case 1 * 3 + 0: WatertightPermuted<W, 0, 2, 1>(ray, tri, hit); break;
+        case 2 * 3 + 0: WatertightPermuted<W, 0, 1, 2>(ray, tri, hit); break;
+        default:        WatertightPermuted<W, 1, 0, 2>(ray, tri, hit); break;
+    }
+};
+
+template <int W>
+RT_INLINE void RayTriangle::Watertight(const WatertightRayxW<W>& rays, const Vec3& v0, const Vec3& v1, const Vec3& v2, TriangleHitxW<W>* hit)
+{
+    const Vec3* corners[3] = { &v0, &v1, &v2 };
+    Vec3xW<W> p[3];
+
+    for (int i = 0; i < 3; i++)
+    {
+        Vec3xW<W> d = Vec3xW<W>::Broadcast(*corners[i]) - rays.org;
+
+        p[i].x = Vec3xW<W>::Dot(d, rays.rx);
+        p[i].y = Vec3xW<W>::Dot(d, rays.ry);
+        p[i].z = Vec3xW<W>::Dot(d, rays.rz);
+    }
+    WatertightKernel(p[0], p[1], p[2], rays.tmin, rays.tmax, hit);
+};
+
+template <RayTriangle::Test T, int W>
+inline bool RayTriangle::Closest(const AlignedVector<TriangleBlock<W> >& blocks, const Vec3& org, const Vec3& dir, float tmin, float tmax, TriangleHit* hit)
+{
+    return (Closest<T, W>(blocks.data(), blocks.size(), org, dir, tmin, tmax, hit));
+};
+
+template <RayTriangle::Test T, int W>
+inline bool RayTriangle::Closest(const TriangleBlock<W>* blocks, size_t count, const Vec3& org, const Vec3& dir, float tmin, float tmax, TriangleHit* hit)
+{
+    RayxW<W> ray(org, dir, tmin, tmax);
+    WatertightRay wray(org, dir, tmin, tmax);
+    TriangleHitxW<W> h;
+
+    hit->t = tmax;
+    hit->u = hit->v = 0.0F;
+    hit->prim = TRIANGLE_NO_PRIM;
+    for (size_t b = 0; b < count; b++)
+    {
+        if (T == MollerTrumboreTest)
+            MollerTrumbore(ray, blocks[b], &h);
+        else
+            Watertight(wray, blocks[b], &h);
+        if (h.mask.None())
+            continue;
+        for (int i = 0; i < W; i++)
+        {
+            // Strict, so the lowest prim wins ties, as in a scalar loop.
+            if (h.mask[i] && h.t.v[i] < wray.tmax)
+            {
+                wray.tmax = h.t.v[i];
+                hit->t = h.t.v[i];
+                hit->u = h.u.v[i];
+                hit->v = h.v.v[i];
+                hit->prim = blocks[b].prim[i];
+            }
+        }
+        ray.tmax = FloatxW<W>(wray.tmax);
+    }
+    return (hit->prim != TRIANGLE_NO_PRIM);
+};
@@ -0,0 +1,101 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#pragma once
+
+#include <vector>
+#include "accel/triangle.h"
+#include "loaders/obj.h"
+
+/**
+ * OBJ interop for the accel types, kept out of accel/triangle.h so that the
+ * intersection code never pulls in the loader, whose non-inline definitions
+ * limit it to one translation unit per program.
+ */
+
+/**
+ * @brief Packs every triangle of the given shapes.
+ *
+ * Polygons are fanned from their first corner and faces referencing
+ * a missing vertex are skipped. Triangles are numbered in that order,
+ * shape after shape; the number becomes prim.
+ *
+ * @param attrib The vertices.
+ * @param shapes The shapes, indexing into attrib.vertices.
+ * @param blocks Receives ceil(triangles / W) blocks; padding lanes
+ *               have prim TRIANGLE_NO_PRIM.
+ *
+ * @return The number of triangles.
+ */
+template <int W>
+inline size_t packTriangles(const attrib_t& attrib, const std::vector<shape_t>& shapes, AlignedVector<TriangleBlock<W> >* blocks)
+{
+    const int vertexCount = static_cast<int>(attrib.vertices.size() / 3);
+    size_t count = 0;
+
+    blocks->clear();
+    for (size_t s = 0; s < shapes.size(); s++)
+    {
+        const mesh_t& mesh = shapes[s].mesh;
+        size_t first = 0;
+        size_t faces = mesh.num_face_vertices.empty() ? mesh.indices.size() / 3 : mesh.num_face_vertices.size();
+
+        for (size_t f = 0; f < faces; f++)
+        {
+            size_t n = mesh.num_face_vertices.empty() ? 3 : mesh.num_face_vertices[f];
+            bool valid = true;
+
+            for (size_t k = 0; k < n; k++)
+            {
+                int idx = mesh.indices[first + k].vertex_index;
+                valid = valid && idx >= 0 && idx < vertexCount;
+            }
+            for (size_t k = 1; valid && k + 1 < n; k++)
+            {
+                const int corners[3] = {
+                    mesh.indices[first].vertex_index,
+                    mesh.indices[first + k].vertex_index,
+                    mesh.indices[first + k + 1].vertex_index
+                };
+                if (count % W == 0)
+                    blocks->push_back(TriangleBlock<W>());
+                TriangleBlock<W>& block = blocks->back();
+                Vec3xW<W>* dst[3] = { &block.v0, &block.v1, &block.v2 };
+                int lane = static_cast<int>(count % W);
+
+                for (int c = 0; c < 3; c++)
+                {
+                    const float* v = &attrib.vertices[3 * static_cast<size_t>(corners[c])];
+                    dst[c]->x.v[lane] = v[0];
+                    dst[c]->y.v[lane] = v[1];
+                    dst[c]->z.v[lane] = v[2];
+                }
+                block.prim[lane] = static_cast<uint32_t>(count);
+                count++;
+            }
+            first += n;
+        }
+    }
+    return (count);
+};
@@ -0,0 +1,95 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#pragma once
+
+/**
+ * Build configuration.
+ *
+ * SIMD support is detected from the compiler's target flags (-msse4.1,
+ * -mavx2, -march=native, /arch:AVX2, ...), so the instruction set is chosen
+ * at compile time and every translation unit of a build agrees on it.
+ * Define RT_NO_SIMD to force the scalar code paths.
+ *
+ * RT_SIMD_SSE   SSE2 or later (always on for x86-64)
+ * RT_SIMD_SSE41 SSE4.1 (blendv, round)
+ * RT_SIMD_AVX   AVX (256-bit float)
+ * RT_SIMD_AVX2  AVX2 (256-bit integer)
+ * RT_SIMD_FMA   FMA3; only used where results need not match the scalar path
+ * RT_SIMD_F16C  F16C half-float conversions (-mf16c; implied by /arch:AVX2)
+ */
+
+#if !defined(RT_NO_SIMD)
+    #if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+        #define RT_SIMD_SSE 1
+    #endif
+    #if defined(__SSE4_1__) || defined(__AVX__)
+        #define RT_SIMD_SSE41 1
+    #endif
+    #if defined(__AVX__)
+        #define RT_SIMD_AVX 1
+    #endif
+    #if defined(__AVX2__)
+        #define RT_SIMD_AVX2 1
+    #endif
+    #if defined(__FMA__)
+        #define RT_SIMD_FMA 1
+    #endif
+    #if defined(__F16C__) || (defined(_MSC_VER) && defined(__AVX2__))
+        #define RT_SIMD_F16C 1
+    #endif
+#endif
+
+#if defined(RT_SIMD_SSE)
+    #include <immintrin.h>
+#endif
+
+/*** @brief Widest float vector the build targets, in lanes. */
+#if defined(RT_SIMD_AVX)
+    #define RT_SIMD_WIDTH 8
+#elif defined(RT_SIMD_SSE)
+    #define RT_SIMD_WIDTH 4
+#else
+    #define RT_SIMD_WIDTH 1
+#endif
+
+#define RT_ALIGN(n) alignas(n)
+
+/*** @brief Forces inlining of small kernels whose operands must stay in registers. */
+#if defined(_MSC_VER)
+    #define RT_INLINE __forceinline
+#elif defined(__GNUC__)
+    #define RT_INLINE inline __attribute__((always_inline))
+#else
+    #define RT_INLINE inline
+#endif
+
+/*** @brief Fully unrolls the next loop, for loops over the (up to 4) components of a vector. */
+#if defined(__clang__)
+    #define RT_UNROLL _Pragma("unroll")
+#elif defined(__GNUC__) && __GNUC__ >= 8
+    #define RT_UNROLL _Pragma("GCC unroll 4")
+#else
+    #define RT_UNROLL
+#endif
@@ -0,0 +1,286 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include "dispatch/kernels.h"
+#include "maths/fastmath.h"
+#include "maths/half.h"
+#include "accel/triangle.h"
+#include "utils/cpu_features.h"
+
+/**
+ * Run-time kernel dispatch.
+ *
+ * config.h fixes the instruction set of a build, which is the lowest one of
+ * the fleet it ships to. The batch kernels below are therefore also built
+ * once per path into libraytracer-core (see src/dispatch/), and the path is
+ * picked once, at the first call: the widest one this CPU runs, or the one
+ * named by the RT_DISPATCH environment variable ("scalar", "sse2",
+ * "sse4.2", "avx2") when the CPU runs it. Force switches paths later on,
+ * which is how each path is tested on a single machine.
+ *
+ * Every path returns the same bits: they only differ in packet width, and
+ * every packet lane computes the scalar result (FMA contraction is off in
+ * the path builds). There are no AVX-512 kernels; such CPUs take the AVX2
+ * path. Calls cost one indirect jump, so only whole arrays are dispatched;
+ * per-element code (a BVH node test, one sample) keeps using the headers
+ * directly at the build's instruction set.
+ */
+struct Dispatch
+{
+    public:
+        enum Path
+        {
+            ScalarPath,
+            Sse2Path,
+            Sse42Path,
+            Avx2Path,
+            PathCount
+        };
+
+        /*** @brief Kernels of a path, NULL if this binary was built without it. */
+        static const DispatchKernels* Table(Path path);
+
+        /*** @brief True if the path is built in and this CPU can run it. */
+        static bool Supported(Path path);
+
+        /*** @brief Widest supported path. */
+        static Path Best(void);
+
+        /*** @brief Path the entry points currently use. */
+        static Path Active(void);
+
+        /**
+         * @brief Switches every entry point to a path, for all threads.
+         *
+         * @param path The path.
+         *
+         * @return False, leaving the active path unchanged, if the path is not supported.
+         */
+        static bool Force(Path path);
+
+        /*** @brief Back to the path picked at startup. */
+        static void Reset(void);
+
+        /*** @brief Name of a path, as accepted by Parse and RT_DISPATCH. */
+        static const char* Name(Path path);
+
+        /*** @brief Path of a name; false if the name is unknown. */
+        static bool Parse(const char* name, Path* path);
+
+        /*** @brief Kernel table of the active path. */
+        static const DispatchKernels& Kernels(void);
+
+        /*** @brief Transform::Points on the active path. Spans are not split across threads. */
+        static void Points(const float m[4][4], const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count);
+        /*** @brief Transform::Points3x4 on the active path. */
+        static void Points3x4(const float m[4][4], const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count);
+        /*** @brief Transform::Vectors on the active path. */
+        static void Vectors(const float m[4][4], const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count);
+
+        /*** @brief FastMath batch functions on the active path. */
+        template <int T = FastMath::Precise> static void Sin(const float* x, float* out, size_t count);
+        template <int T = FastMath::Precise> static void Cos(const float* x, float* out, size_t count);
+        template <int T = FastMath::Precise> static void SinCos(const float* x, float* s, float* c, size_t count);
+        template <int T = FastMath::Precise> static void Exp(const float* x, float* out, size_t count);
+        template <int T = FastMath::Precise> static void Log(const float* x, float* out, size_t count);
+        template <int T = FastMath::Precise> static void Pow(const float* x, const float* y, float* out, size_t count);
+        template <int T = FastMath::Precise> static void Atan(const float* x, float* out, size_t count);
+        template <int T = FastMath::Precise> static void Atan2(const float* y, const float* x, float* out, size_t count);
+
+        /*** @brief Half::Encode on the active path. */
+        static void Encode(const float* src, Half* dst, size_t n);
+        /*** @brief Half::Decode on the active path. */
+        static void Decode(const Half* src, float* dst, size_t n);
+
+        /**
+         * @brief RayTriangle::Closest for a batch of rays on the active path.
+         *
+         * @param blocks The triangles.
+         * @param org The ray origins.
+         * @param dir The ray directions.
+         * @param count Number of rays.
+         * @param tmin Hits must be beyond this distance.
+         * @param tmax Hits must be closer than this distance.
+         * @param hits Receives one closest hit per ray.
+         *
+         * @return Number of rays that hit. Narrower paths repack the blocks once per call.
+         */
+        template <RayTriangle::Test T>
+        static size_t Closest(const AlignedVector<TriangleBlock<DISPATCH_BLOCK_WIDTH> >& blocks, const Vec3* org, const Vec3* dir,
+            size_t count, float tmin, float tmax, TriangleHit* hits);
+
+    private:
+        static std::atomic<const DispatchKernels*>& Current(void);
+
+        static Path Startup(void);
+};
+
+inline const DispatchKernels* Dispatch::Table(Path path)
+{
+    switch (path)
+    {
+        case ScalarPath: return (DispatchKernelsScalar());
+        case Sse2Path: return (DispatchKernelsSse2());
+        case Sse42Path: return (DispatchKernelsSse42());
+        case Avx2Path: return (DispatchKernelsAvx2());
+        default: return (NULL);
+    }
+};
+
+inline bool Dispatch::Supported(Path path)
+{
+    const cpu_features_t& f = GetCpuFeatures();
+    bool cpu = false;
+
+    // Each path is built for x86-64 plus the flags in the Makefile; check them all.
+    switch (path)
+    {
+        case ScalarPath: cpu = true; break;
+        case Sse2Path: cpu = f.sse2; break;
+        case Sse42Path: cpu = f.sse2 && f.sse3 && f.ssse3 && f.sse41 && f.sse42 && f.popcnt; break;
+        case Avx2Path: cpu = f.sse42 && f.popcnt && f.avx && f.avx2 && f.fma && f.f16c; break;
+        default: break;
+    }
+    return (cpu && Table(path) != NULL);
+};
+
+inline Dispatch::Path Dispatch::Best(void)
+{
+    for (int p = PathCount - 1; p > ScalarPath; p--)
+        if (Supported(static_cast<Path>(p)))
+            return (static_cast<Path>(p));
+    return (ScalarPath);
+};
+
+inline Dispatch::Path Dispatch::Active(void)
+{
+    const DispatchKernels* current = Current().load(std::memory_order_relaxed);
+
+    for (int p = 0; p < PathCount; p++)
+        if (Table(static_cast<Path>(p)) == current)
+            return (static_cast<Path>(p));
+    return (ScalarPath);
+};
+
+inline bool Dispatch::Force(Path path)
+{
+    if (!Supported(path))
+        return (false);
+    Current().store(Table(path), std::memory_order_relaxed);
+    return (true);
+};
+
+inline void Dispatch::Reset(void)
+{
+    Current().store(Table(Startup()), std::memory_order_relaxed);
+};
+
+inline const char* Dispatch::Name(Path path)
+{
+    static const char* const names[PathCount] = { "scalar", "sse2", "sse4.2", "avx2" };
+
+    return (path >= 0 && path < PathCount ? names[path] : "unknown");
+};
+
+inline bool Dispatch::Parse(const char* name, Path* path)
+{
+    for (int p = 0; name && p < PathCount; p++)
+    {
+        if (strcmp(name, Name(static_cast<Path>(p))) == 0)
+        {
+            *path = static_cast<Path>(p);
+            return (true);
+        }
+    }
+    return (false);
+};
+
+inline const DispatchKernels& Dispatch::Kernels(void)
+{
+    return (*Current().load(std::memory_order_relaxed));
+};
+
+inline void Dispatch::Points(const float m[4][4], const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count)
+{
+    Kernels().points(m, src, srcStride, dst, dstStride, count);
+};
+
+inline void Dispatch::Points3x4(const float m[4][4], const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count)
+{
+    Kernels().points3x4(m, src, srcStride, dst, dstStride, count);
+};
+
+inline void Dispatch::Vectors(const float m[4][4], const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count)
+{
+    Kernels().vectors(m, src, srcStride, dst, dstStride, count);
+};
+
+template <int T> inline void Dispatch::Sin(const float* x, float* out, size_t count) { Kernels().sin[T](x, out, count); };
+template <int T> inline void Dispatch::Cos(const float* x, float* out, size_t count) { Kernels().cos[T](x, out, count); };
+template <int T> inline void Dispatch::SinCos(const float* x, float* s, float* c, size_t count) { Kernels().sinCos[T](x, s, c, count); };
+template <int T> inline void Dispatch::Exp(const float* x, float* out, size_t count) { Kernels().exp[T](x, out, count); };
+template <int T> inline void Dispatch::Log(const float* x, float* out, size_t count) { Kernels().log[T](x, out, count); };
+template <int T> inline void Dispatch::Pow(const float* x, const float* y, float* out, size_t count) { Kernels().pow[T](x, y, out, count); };
+template <int T> inline void Dispatch::Atan(const float* x, float* out, size_t count) { Kernels().atan[T](x, out, count); };
+template <int T> inline void Dispatch::Atan2(const float* y, const float* x, float* out, size_t count) { Kernels().atan2[T](y, x, out, count); };
+
+inline void Dispatch::Encode(const float* src, Half* dst, size_t n)
+{
+    Kernels().encodeHalf(src, reinterpret_cast<uint16_t*>(dst), n);
+};
+
+inline void Dispatch::Decode(const Half* src, float* dst, size_t n)
+{
+    Kernels().decodeHalf(reinterpret_cast<const uint16_t*>(src), dst, n);
+};
+
+template <RayTriangle::Test T>
+inline size_t Dispatch::Closest(const AlignedVector<TriangleBlock<DISPATCH_BLOCK_WIDTH> >& blocks, const Vec3* org, const Vec3* dir,
+    size_t count, float tmin, float tmax, TriangleHit* hits)
+{
+    return (Kernels().closest[T](blocks.data(), blocks.size(), reinterpret_cast<const float*>(org), reinterpret_cast<const float*>(dir),
+        count, tmin, tmax, hits));
+};
+
+inline std::atomic<const DispatchKernels*>& Dispatch::Current(void)
+{
+    static std::atomic<const DispatchKernels*> current(Table(Startup()));
+
+    return (current);
+};
+
+inline Dispatch::Path Dispatch::Startup(void)
+{
+    Path path;
+
+    if (Parse(getenv("RT_DISPATCH"), &path) && Supported(path))
+        return (path);
+    return (Best());
+};
@@ -0,0 +1,91 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * Kernel table of one dispatch path.
+ *
+ * Each path (see dispatch/dispatch.h) is the same header code compiled with
+ * different target flags, in its own translation unit and namespace, and
+ * publishes its entry points through one DispatchKernels. The table only
+ * uses fundamental types, so that this header can be included next to code
+ * built for another instruction set without pulling any of it in; the typed
+ * wrappers live in Dispatch.
+ */
+
+/*** @brief Lanes of the TriangleBlocks the intersection kernels take, whatever the path. */
+#define DISPATCH_BLOCK_WIDTH 8
+
+struct DispatchKernels
+{
+    public:
+        /*** @brief Transform::Points, Points3x4 or Vectors, without a ThreadPool. */
+        typedef void (*TransformFn)(const float m[4][4], const float* src, size_t srcStride,
+            float* dst, size_t dstStride, size_t count);
+        /*** @brief One FastMath batch function of one tier. */
+        typedef void (*UnaryFn)(const float* x, float* out, size_t count);
+        typedef void (*BinaryFn)(const float* a, const float* b, float* out, size_t count);
+        typedef void (*SinCosFn)(const float* x, float* s, float* c, size_t count);
+        /*** @brief Half::Encode / Half::Decode, halves as their bit patterns. */
+        typedef void (*EncodeHalfFn)(const float* src, uint16_t* dst, size_t n);
+        typedef void (*DecodeHalfFn)(const uint16_t* src, float* dst, size_t n);
+        /**
+         * @brief RayTriangle::Closest for `count` rays.
+         *
+         * `blocks` points to TriangleBlock<DISPATCH_BLOCK_WIDTH>, `org` and
+         * `dir` to packed xyz triplets, `hits` to TriangleHit. Returns the
+         * number of rays that hit.
+         */
+        typedef size_t (*ClosestFn)(const void* blocks, size_t blockCount, const float* org, const float* dir,
+            size_t count, float tmin, float tmax, void* hits);
+
+        /*** @brief Path name, as accepted by Dispatch::Parse */
+        const char* name;
+        /*** @brief Batched transforms */
+        TransformFn points, points3x4, vectors;
+        /*** @brief FastMath batches, indexed by FastMath::Tier */
+        UnaryFn sin[2], cos[2], exp[2], log[2], atan[2];
+        BinaryFn pow[2], atan2[2];
+        SinCosFn sinCos[2];
+        /*** @brief Half conversions */
+        EncodeHalfFn encodeHalf;
+        DecodeHalfFn decodeHalf;
+        /*** @brief Closest hits, indexed by RayTriangle::Test */
+        ClosestFn closest[2];
+};
+
+/**
+ * @brief Tables of the paths built into libraytracer-core. A path whose
+ *        translation unit was built without its target flags (non-x86
+ *        compilers, for one) returns NULL.
+ */
+const DispatchKernels* DispatchKernelsScalar(void);
+const DispatchKernels* DispatchKernelsSse2(void);
+const DispatchKernels* DispatchKernelsSse42(void);
+const DispatchKernels* DispatchKernelsAvx2(void);
@@ -0,0 +1,325 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * Correctly rounded decimal to binary32 conversion.
+ *
+ * Short inputs go through Clinger's fast path (exact float mantissa times an
+ * exact power of ten). Everything else uses the Eisel-Lemire algorithm
+ * [https://arxiv.org/abs/2101.11408] with a truncated 128-bit table of powers
+ * of five covering the binary32 range. Inputs with more than 19 significant
+ * digits that Eisel-Lemire cannot round unambiguously fall back to strtof.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+
+#define FAST_FLOAT_SMALLEST_POWER (-65)
+#define FAST_FLOAT_LARGEST_POWER 38
+
+static const uint64_t fast_float_power_of_five_128[] = {
+    0x86ccbb52ea94baeaULL, 0x98e947129fc2b4e9ULL, // 5^-65
+    0xa87fea27a539e9a5ULL, 0x3f2398d747b36224ULL, // 5^-64
+    0xd29fe4b18e88640eULL, 0x8eec7f0d19a03aadULL, // 5^-63
+    0x83a3eeeef9153e89ULL, 0x1953cf68300424acULL, // 5^-62
+    0xa48ceaaab75a8e2bULL, 0x5fa8c3423c052dd7ULL, // 5^-61
+    0xcdb02555653131b6ULL, 0x3792f412cb06794dULL, // 5^-60
+    0x808e17555f3ebf11ULL, 0xe2bbd88bbee40bd0ULL, // 5^-59
+    0xa0b19d2ab70e6ed6ULL, 0x5b6aceaeae9d0ec4ULL, // 5^-58
+    0xc8de047564d20a8bULL, 0xf245825a5a445275ULL, // 5^-57
+    0xfb158592be068d2eULL, 0xeed6e2f0f0d56712ULL, // 5^-56
+    0x9ced737bb6c4183dULL, 0x55464dd69685606bULL, // 5^-55
+    0xc428d05aa4751e4cULL, 0xaa97e14c3c26b886ULL, // 5^-54
+    0xf53304714d9265dfULL, 0xd53dd99f4b3066a8ULL, // 5^-53
+    0x993fe2c6d07b7fabULL, 0xe546a8038efe4029ULL, // 5^-52
+    0xbf8fdb78849a5f96ULL, 0xde98520472bdd033ULL, // 5^-51
+    0xef73d256a5c0f77cULL, 0x963e66858f6d4440ULL, // 5^-50
+    0x95a8637627989aadULL, 0xdde7001379a44aa8ULL, // 5^-49
+    0xbb127c53b17ec159ULL, 0x5560c018580d5d52ULL, // 5^-48
+    0xe9d71b689dde71afULL, 0xaab8f01e6e10b4a6ULL, // 5^-47
+    0x9226712162ab070dULL, 0xcab3961304ca70e8ULL, // 5^-46
+    0xb6b00d69bb55c8d1ULL, 0x3d607b97c5fd0d22ULL, // 5^-45
+    0xe45c10c42a2b3b05ULL, 0x8cb89a7db77c506aULL, // 5^-44
+    0x8eb98a7a9a5b04e3ULL, 0x77f3608e92adb242ULL, // 5^-43
+    0xb267ed1940f1c61cULL, 0x55f038b237591ed3ULL, // 5^-42
+    0xdf01e85f912e37a3ULL, 0x6b6c46dec52f6688ULL, // 5^-41
+    0x8b61313bbabce2c6ULL, 0x2323ac4b3b3da015ULL, // 5^-40
+    0xae397d8aa96c1b77ULL, 0xabec975e0a0d081aULL, // 5^-39
+    0xd9c7dced53c72255ULL, 0x96e7bd358c904a21ULL, // 5^-38
+    0x881cea14545c7575ULL, 0x7e50d64177da2e54ULL, // 5^-37
+    0xaa242499697392d2ULL, 0xdde50bd1d5d0b9e9ULL, // 5^-36
+    0xd4ad2dbfc3d07787ULL, 0x955e4ec64b44e864ULL, // 5^-35
+    0x84ec3c97da624ab4ULL, 0xbd5af13bef0b113eULL, // 5^-34
+    0xa6274bbdd0fadd61ULL, 0xecb1ad8aeacdd58eULL, // 5^-33
+    0xcfb11ead453994baULL, 0x67de18eda5814af2ULL, // 5^-32
+    0x81ceb32c4b43fcf4ULL, 0x80eacf948770ced7ULL, // 5^-31
+    0xa2425ff75e14fc31ULL, 0xa1258379a94d028dULL, // 5^-30
+    0xcad2f7f5359a3b3eULL, 0x096ee45813a04330ULL, // 5^-29
+    0xfd87b5f28300ca0dULL, 0x8bca9d6e188853fcULL, // 5^-28
+    0x9e74d1b791e07e48ULL, 0x775ea264cf55347eULL, // 5^-27
+    0xc612062576589ddaULL, 0x95364afe032a819eULL, // 5^-26
+    0xf79687aed3eec551ULL, 0x3a83ddbd83f52205ULL, // 5^-25
+    0x9abe14cd44753b52ULL, 0xc4926a9672793543ULL, // 5^-24
+    0xc16d9a0095928a27ULL, 0x75b7053c0f178294ULL, // 5^-23
+    0xf1c90080baf72cb1ULL, 0x5324c68b12dd6339ULL, // 5^-22
+    0x971da05074da7beeULL, 0xd3f6fc16ebca5e04ULL, // 5^-21
+    0xbce5086492111aeaULL, 0x88f4bb1ca6bcf585ULL, // 5^-20
+    0xec1e4a7db69561a5ULL, 0x2b31e9e3d06c32e6ULL, // 5^-19
+    0x9392ee8e921d5d07ULL, 0x3aff322e62439fd0ULL, // 5^-18
+    0xb877aa3236a4b449ULL, 0x09befeb9fad487c3ULL, // 5^-17
+    0xe69594bec44de15bULL, 0x4c2ebe687989a9b4ULL, // 5^-16
+    0x901d7cf73ab0acd9ULL, 0x0f9d37014bf60a11ULL, // 5^-15
+    0xb424dc35095cd80fULL, 0x538484c19ef38c95ULL, // 5^-14
+    0xe12e13424bb40e13ULL, 0x2865a5f206b06fbaULL, // 5^-13
+    0x8cbccc096f5088cbULL, 0xf93f87b7442e45d4ULL, // 5^-12
+    0xafebff0bcb24aafeULL, 0xf78f69a51539d749ULL, // 5^-11
+    0xdbe6fecebdedd5beULL, 0xb573440e5a884d1cULL, // 5^-10
+    0x89705f4136b4a597ULL, 0x31680a88f8953031ULL, // 5^-9
+    0xabcc77118461cefcULL, 0xfdc20d2b36ba7c3eULL, // 5^-8
+    0xd6bf94d5e57a42bcULL, 0x3d32907604691b4dULL, // 5^-7
+    0x8637bd05af6c69b5ULL, 0xa63f9a49c2c1b110ULL, // 5^-6
+    0xa7c5ac471b478423ULL, 0x0fcf80dc33721d54ULL, // 5^-5
+    0xd1b71758e219652bULL, 0xd3c36113404ea4a9ULL, // 5^-4
+    0x83126e978d4fdf3bULL, 0x645a1cac083126eaULL, // 5^-3
+    0xa3d70a3d70a3d70aULL, 0x3d70a3d70a3d70a4ULL, // 5^-2
+    0xccccccccccccccccULL, 0xcccccccccccccccdULL, // 5^-1
+    0x8000000000000000ULL, 0x0000000000000000ULL, // 5^0
+    0xa000000000000000ULL, 0x0000000000000000ULL, // 5^1
+    0xc800000000000000ULL, 0x0000000000000000ULL, // 5^2
+    0xfa00000000000000ULL, 0x0000000000000000ULL, // 5^3
+    0x9c40000000000000ULL, 0x0000000000000000ULL, // 5^4
+    0xc350000000000000ULL, 0x0000000000000000ULL, // 5^5
+    0xf424000000000000ULL, 0x0000000000000000ULL, // 5^6
+    0x9896800000000000ULL, 0x0000000000000000ULL, // 5^7
+    0xbebc200000000000ULL, 0x0000000000000000ULL, // 5^8
+    0xee6b280000000000ULL, 0x0000000000000000ULL, // 5^9
+    0x9502f90000000000ULL, 0x0000000000000000ULL, // 5^10
+    0xba43b74000000000ULL, 0x0000000000000000ULL, // 5^11
+    0xe8d4a51000000000ULL, 0x0000000000000000ULL, // 5^12
+    0x9184e72a00000000ULL, 0x0000000000000000ULL, // 5^13
+    0xb5e620f480000000ULL, 0x0000000000000000ULL, // 5^14
+    0xe35fa931a0000000ULL, 0x0000000000000000ULL, // 5^15
+    0x8e1bc9bf04000000ULL, 0x0000000000000000ULL, // 5^16
+    0xb1a2bc2ec5000000ULL, 0x0000000000000000ULL, // 5^17
+    0xde0b6b3a76400000ULL, 0x0000000000000000ULL, // 5^18
+    0x8ac7230489e80000ULL, 0x0000000000000000ULL, // 5^19
+    0xad78ebc5ac620000ULL, 0x0000000000000000ULL, // 5^20
+    0xd8d726b7177a8000ULL, 0x0000000000000000ULL, // 5^21
+    0x878678326eac9000ULL, 0x0000000000000000ULL, // 5^22
+    0xa968163f0a57b400ULL, 0x0000000000000000ULL, // 5^23
+    0xd3c21bcecceda100ULL, 0x0000000000000000ULL, // 5^24
+    0x84595161401484a0ULL, 0x0000000000000000ULL, // 5^25
+    0xa56fa5b99019a5c8ULL, 0x0000000000000000ULL, // 5^26
+    0xcecb8f27f4200f3aULL, 0x0000000000000000ULL, // 5^27
+    0x813f3978f8940984ULL, 0x4000000000000000ULL, // 5^28
+    0xa18f07d736b90be5ULL, 0x5000000000000000ULL, // 5^29
+    0xc9f2c9cd04674edeULL, 0xa400000000000000ULL, // 5^30
+    0xfc6f7c4045812296ULL, 0x4d00000000000000ULL, // 5^31
+    0x9dc5ada82b70b59dULL, 0xf020000000000000ULL, // 5^32
+    0xc5371912364ce305ULL, 0x6c28000000000000ULL, // 5^33
+    0xf684df56c3e01bc6ULL, 0xc732000000000000ULL, // 5^34
+    0x9a130b963a6c115cULL, 0x3c7f400000000000ULL, // 5^35
+    0xc097ce7bc90715b3ULL, 0x4b9f100000000000ULL, // 5^36
+    0xf0bdc21abb48db20ULL, 0x1e86d40000000000ULL, // 5^37
+    0x96769950b50d88f4ULL, 0x1314448000000000ULL, // 5^38
+};
+
+static const float fast_float_exact_powers_of_ten[] = {
+    1e0f, 1e1f, 1e2f, 1e3f, 1e4f, 1e5f, 1e6f, 1e7f, 1e8f, 1e9f, 1e10f
+};
+
+static inline void fastFloatMultiply(uint64_t a, uint64_t b, uint64_t *high, uint64_t *low)
+{
+#if defined(__SIZEOF_INT128__)
+    unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+    *high = static_cast<uint64_t>(r >> 64);
+    *low = static_cast<uint64_t>(r);
+#else
+    uint64_t a_lo = a & 0xFFFFFFFFULL, a_hi = a >> 32;
+    uint64_t b_lo = b & 0xFFFFFFFFULL, b_hi = b >> 32;
+    uint64_t lo_lo = a_lo * b_lo, hi_lo = a_hi * b_lo;
+    uint64_t lo_hi = a_lo * b_hi, hi_hi = a_hi * b_hi;
+    uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFULL) + lo_hi;
+    *high = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+    *low = (cross << 32) | (lo_lo & 0xFFFFFFFFULL);
+#endif
+}
+
+static inline int fastFloatLeadingZeroes(uint64_t x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    return (__builtin_clzll(x));
+#else
+    int n = 0;
+    while (!(x & 0x8000000000000000ULL)) {
+        x <<= 1;
+        n++;
+    }
+    return (n);
+#endif
+}
+
+/**
+ * Eisel-Lemire for binary32: converts w * 10^q (w != 0) to the IEEE bits of
+ * the nearest float, sign excluded.
+ */
+static uint32_t fastFloatEiselLemire(int q, uint64_t w)
+{
+    static const int mantissa_bits = 23;
+    static const int minimum_exponent = -127;
+    static const int infinite_power = 0xFF;
+    if (q < FAST_FLOAT_SMALLEST_POWER) return (0);
+    if (q > FAST_FLOAT_LARGEST_POWER) return (static_cast<uint32_t>(infinite_power) << mantissa_bits);
+    int lz = fastFloatLeadingZeroes(w);
+    w <<= lz;
+    const uint64_t *pow5 = &fast_float_power_of_five_128[2 * (q - FAST_FLOAT_SMALLEST_POWER)];
+    uint64_t high, low;
+    fastFloatMultiply(w, pow5[0], &high, &low);
+    const uint64_t precision_mask = 0xFFFFFFFFFFFFFFFFULL >> (mantissa_bits + 3);
+    if ((high & precision_mask) == precision_mask) {
+        uint64_t high2, low2;
+        fastFloatMultiply(w, pow5[1], &high2, &low2);
+        low += high2;
+        if (high2 > low) high++;
+    }
+    int upperbit = static_cast<int>(high >> 63);
+    int shift = upperbit + 64 - mantissa_bits - 3;
+    uint64_t mantissa = high >> shift;
+    int power2 = (((152170 + 65536) * q) >> 16) + 63 + upperbit - lz - minimum_exponent;
+    if (power2 <= 0) {
+        if (-power2 + 1 >= 64) return (0);
+        mantissa >>= -power2 + 1;
+        mantissa += (mantissa & 1);
+        mantissa >>= 1;
+        power2 = (mantissa < (1ULL << mantissa_bits)) ? 0 : 1;
+        return (static_cast<uint32_t>(mantissa & ((1ULL << mantissa_bits) - 1)) | (static_cast<uint32_t>(power2) << mantissa_bits));
+    }
+    if (low <= 1 && q >= -17 && q <= 10 && (mantissa & 3) == 1) {
+        if ((mantissa << shift) == high) mantissa &= ~1ULL;
+    }
+    mantissa += (mantissa & 1);
+    mantissa >>= 1;
+    if (mantissa >= (2ULL << mantissa_bits)) {
+        mantissa = (1ULL << mantissa_bits);
+        power2++;
+    }
+    mantissa &= ~(1ULL << mantissa_bits);
+    if (power2 >= infinite_power) return (static_cast<uint32_t>(infinite_power) << mantissa_bits);
+    return (static_cast<uint32_t>(mantissa) | (static_cast<uint32_t>(power2) << mantissa_bits));
+}
+
+/**
+ * Parses `[+-]digits[.digits][(e|E)[+-]digits]` starting at `s`, reading no
+ * further than `s_end`, into the nearest float.
+ *
+ * @return Pointer past the last consumed character, or NULL when `s` does not
+ *         start with a number (in which case `result` is left untouched).
+ */
+static const char *parseFloatFast(const char *s, const char *s_end, float *result)
+{
+    const char *p = s;
+    bool negative = false;
+    if (p < s_end && (*p == '+' || *p == '-')) {
+        negative = (*p == '-');
+        p++;
+    }
+    uint64_t w = 0;
+    int digits = 0;
+    long exponent = 0;
+    bool truncated = false;
+    const char *start_digits = p;
+    while (p < s_end && static_cast<unsigned int>(*p - '0') < 10u) {
+        unsigned int d = static_cast<unsigned int>(*p - '0');
+        if (digits < 19) {
+            w = w * 10 + d;
+            if (w != 0) digits++;
+        } else {
+            exponent++;
+            if (d) truncated = true;
+        }
+        p++;
+    }
+    bool any_digit = (p != start_digits);
+    if (p < s_end && *p == '.') {
+        p++;
+        const char *start_frac = p;
+        while (p < s_end && static_cast<unsigned int>(*p - '0') < 10u) {
+            unsigned int d = static_cast<unsigned int>(*p - '0');
+            if (digits < 19) {
+                w = w * 10 + d;
+                if (w != 0) digits++;
+                exponent--;
+            } else if (d) {
+                truncated = true;
+            }
+            p++;
+        }
+        any_digit = any_digit || (p != start_frac);
+    }
+    if (!any_digit) return (NULL);
+    if (p < s_end && (*p == 'e' || *p == 'E')) {
+        p++;
+        bool exp_negative = false;
+        if (p < s_end && (*p == '+' || *p == '-')) {
+            exp_negative = (*p == '-');
+            p++;
+        }
+        const char *start_exp = p;
+        long e = 0;
+        while (p < s_end && static_cast<unsigned int>(*p - '0') < 10u) {
+            if (e < 100000) e = e * 10 + (*p - '0');
+            p++;
+        }
+        if (p == start_exp) return (NULL);
+        exponent += exp_negative ? -e : e;
+    }
+    uint32_t bits;
+    if (w == 0) {
+        bits = 0;
+    } else if (!truncated && w <= (1ULL << 24) && exponent >= -10 && exponent <= 10) {
+        float value = static_cast<float>(w);
+        if (exponent < 0) {
+            value /= fast_float_exact_powers_of_ten[-exponent];
+        } else {
+            value *= fast_float_exact_powers_of_ten[exponent];
+        }
+        memcpy(&bits, &value, sizeof(bits));
+    } else {
+        int q = static_cast<int>(exponent < -100000 ? -100000 : exponent);
+        bits = fastFloatEiselLemire(q, w);
+        if (truncated && bits != fastFloatEiselLemire(q, w + 1)) {
+            std::string copy(s, p);
+            float value = std::strtof(copy.c_str(), NULL);
+            memcpy(&bits, &value, sizeof(bits));
+            bits &= 0x7FFFFFFFu;
+        }
+    }
+    if (negative) bits |= 0x80000000u;
+    memcpy(result, &bits, sizeof(bits));
+    return (p);
+}
@@ -0,0 +1,125 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+#if defined(_WIN32)
+    #include <fstream>
+#else
+    #include <fcntl.h>
+    #include <sys/mman.h>
+    #include <sys/stat.h>
+    #include <unistd.h>
+#endif
+
+/**
+ * @brief Read-only view over the bytes of a file.
+ *
+ * On POSIX systems the file is mapped with mmap so that parsers can walk the
+ * page cache directly. Other platforms fall back to reading the whole file
+ * into an owned buffer, which keeps the same interface.
+ */
+class MappedFile {
+public:
+    MappedFile() : m_data(NULL), m_size(0) {}
+    ~MappedFile() { close(); }
+
+    /**
+     * @brief Maps the given file in memory.
+     *
+     * @param filename Path of the file to map.
+     *
+     * @return True on success, false if the file could not be opened or mapped.
+     */
+    bool open(const char *filename)
+    {
+        close();
+#if defined(_WIN32)
+        std::ifstream ifs(filename, std::ios::binary | std::ios::ate);
+        if (!ifs) return (false);
+        m_buffer.resize(static_cast<size_t>(ifs.tellg()));
+        ifs.seekg(0);
+        if (!m_buffer.empty() && !ifs.read(&m_buffer[0], static_cast<std::streamsize>(m_buffer.size()))) {
+            m_buffer.clear();
+            return (false);
+        }
+        m_data = m_buffer.empty() ? NULL : &m_buffer[0];
+        m_size = m_buffer.size();
+        return (true);
+#else
+        int fd = ::open(filename, O_RDONLY);
+        if (fd < 0) return (false);
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            ::close(fd);
+            return (false);
+        }
+        m_size = static_cast<size_t>(st.st_size);
+        if (m_size == 0) {
+            ::close(fd);
+            return (true);
+        }
+        void *addr = mmap(NULL, m_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (addr == MAP_FAILED) {
+            m_size = 0;
+            return (false);
+        }
+        madvise(addr, m_size, MADV_SEQUENTIAL);
+        m_data = static_cast<const char *>(addr);
+        return (true);
+#endif
+    }
+
+    /*** @brief Releases the mapping, if any. */
+    void close()
+    {
+#if defined(_WIN32)
+        m_buffer.clear();
+#else
+        if (m_data) munmap(const_cast<char *>(m_data), m_size);
+#endif
+        m_data = NULL;
+        m_size = 0;
+    }
+
+    /*** @brief First byte of the file, or NULL when the file is empty. */
+    const char *data() const { return (m_data); }
+
+    /*** @brief Size of the file in bytes. */
+    size_t size() const { return (m_size); }
+
+private:
+    MappedFile(const MappedFile &);
+    MappedFile &operator=(const MappedFile &);
+
+    const char *m_data;
+    size_t m_size;
+#if defined(_WIN32)
+    std::vector<char> m_buffer;
+#endif
+};
@@ -0,0 +1,419 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * Compact material table.
+ *
+ * material_t is convenient to fill from an MTL file but heavy to keep around:
+ * thirteen std::string texture names, thirteen texture_option_t and a
+ * std::map per material. MaterialTable flattens a parsed material list into
+ * an interned string pool, a deduplicated texture table addressed by integer
+ * handles, and one POD material_shading_t per material. Names are resolved
+ * through an open-addressing hash instead of a std::map.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "loaders/obj.h"
+
+#define MATERIAL_NO_STRING 0xFFFFFFFFu
+#define MATERIAL_NO_TEXTURE (-1)
+
+// Same order as OBJ_MATERIAL_TEXTURES.
+typedef enum {
+    MATERIAL_TEXTURE_AMBIENT,
+    MATERIAL_TEXTURE_DIFFUSE,
+    MATERIAL_TEXTURE_SPECULAR,
+    MATERIAL_TEXTURE_SPECULAR_HIGHLIGHT,
+    MATERIAL_TEXTURE_BUMP,
+    MATERIAL_TEXTURE_DISPLACEMENT,
+    MATERIAL_TEXTURE_ALPHA,
+    MATERIAL_TEXTURE_REFLECTION,
+    MATERIAL_TEXTURE_ROUGHNESS,
+    MATERIAL_TEXTURE_METALLIC,
+    MATERIAL_TEXTURE_SHEEN,
+    MATERIAL_TEXTURE_EMISSIVE,
+    MATERIAL_TEXTURE_NORMAL,
+    MATERIAL_TEXTURE_COUNT
+} material_texture_slot_t;
+
+typedef struct {
+    float ambient[3];
+    float diffuse[3];
+    float specular[3];
+    float transmittance[3];
+    float emission[3];
+    float shininess;
+    float ior;
+    float dissolve;
+    float roughness;
+    float metallic;
+    float sheen;
+    float clearcoat_thickness;
+    float clearcoat_roughness;
+    float anisotropy;
+    float anisotropy_rotation;
+    int illum;
+    uint32_t name;
+    int32_t textures[MATERIAL_TEXTURE_COUNT];
+} material_shading_t;
+
+typedef struct {
+    uint32_t path;
+    uint32_t option;
+} material_texture_t;
+
+typedef struct {
+    uint32_t material;
+    uint32_t key;
+    uint32_t value;
+} material_parameter_t;
+
+static inline uint32_t hashMaterialString(const char *s, size_t len)
+{
+    uint32_t h = 2166136261u;
+    for (size_t i = 0; i < len; i++) {
+        h ^= static_cast<unsigned char>(s[i]);
+        h *= 16777619u;
+    }
+    return (h);
+}
+
+/**
+ * @brief Append-only pool of unique, NUL-terminated strings.
+ *
+ * A handle is the index of the string in the pool; its characters live in one
+ * contiguous buffer. Interning the same text twice returns the same handle.
+ */
+class StringPool {
+public:
+    uint32_t intern(const char *s, size_t len)
+    {
+        if ((m_offsets.size() + 1) * 2 > m_slots.size()) {
+            grow();
+        }
+        uint32_t hash = hashMaterialString(s, len);
+        size_t mask = m_slots.size() - 1;
+        size_t slot = hash & mask;
+        while (m_slots[slot] != MATERIAL_NO_STRING) {
+            uint32_t h = m_slots[slot];
+            if (m_hashes[h] == hash && length(h) == len && memcmp(c_str(h), s, len) == 0) {
+                return (h);
+            }
+            slot = (slot + 1) & mask;
+        }
+        uint32_t handle = static_cast<uint32_t>(m_offsets.size());
+        m_offsets.push_back(static_cast<uint32_t>(m_chars.size()));
+        m_hashes.push_back(hash);
+        m_chars.insert(m_chars.end(), s, s + len);
+        m_chars.push_back('\0');
+        m_slots[slot] = handle;
+        return (handle);
+    }
+
+    uint32_t intern(const std::string &s) { return (intern(s.c_str(), s.size())); }
+
+    /*** @brief Handle of an already interned string, or MATERIAL_NO_STRING. */
+    uint32_t find(const char *s, size_t len) const
+    {
+        if (m_slots.empty()) return (MATERIAL_NO_STRING);
+        uint32_t hash = hashMaterialString(s, len);
+        size_t mask = m_slots.size() - 1;
+        for (size_t slot = hash & mask; m_slots[slot] != MATERIAL_NO_STRING; slot = (slot + 1) & mask) {
+            uint32_t h = m_slots[slot];
+            if (m_hashes[h] == hash && length(h) == len && memcmp(c_str(h), s, len) == 0) {
+                return (h);
+            }
+        }
+        return (MATERIAL_NO_STRING);
+    }
+
+    const char *c_str(uint32_t handle) const { return (&m_chars[m_offsets[handle]]); }
+
+    size_t length(uint32_t handle) const
+    {
+        size_t end = (handle + 1 < m_offsets.size()) ? m_offsets[handle + 1] : m_chars.size();
+        return (end - m_offsets[handle] - 1);
+    }
+
+    uint32_t hash(uint32_t handle) const { return (m_hashes[handle]); }
+
+    size_t size() const { return (m_offsets.size()); }
+
+    size_t bytes() const
+    {
+        return (m_chars.capacity() + (m_offsets.capacity() + m_hashes.capacity() + m_slots.capacity()) * sizeof(uint32_t));
+    }
+
+private:
+    void grow()
+    {
+        std::vector<uint32_t> slots(m_slots.empty() ? 64 : m_slots.size() * 2, MATERIAL_NO_STRING);
+        size_t mask = slots.size() - 1;
+        for (uint32_t h = 0; h < m_offsets.size(); h++) {
+            size_t slot = m_hashes[h] & mask;
+            while (slots[slot] != MATERIAL_NO_STRING) slot = (slot + 1) & mask;
+            slots[slot] = h;
+        }
+        m_slots.swap(slots);
+    }
+
+    std::vector<char> m_chars;
+    std::vector<uint32_t> m_offsets;
+    std::vector<uint32_t> m_hashes;
+    std::vector<uint32_t> m_slots;
+};
+
+static bool sameTextureOption(const texture_option_t &a, const texture_option_t &b)
+{
+    for (int i = 0; i < 3; i++) {
+        if (a.origin_offset[i] != b.origin_offset[i] || a.scale[i] != b.scale[i] || a.turbulence[i] != b.turbulence[i]) {
+            return (false);
+        }
+    }
+    return (a.type == b.type && a.sharpness == b.sharpness && a.brightness == b.brightness
+        && a.contrast == b.contrast && a.clamp == b.clamp && a.imfchan == b.imfchan
+        && a.blendu == b.blendu && a.blendv == b.blendv && a.bump_multiplier == b.bump_multiplier);
+}
+
+/**
+ * @brief Flat, read-only view of a material list.
+ *
+ * Texture handles index textures(); two slots referencing the same file with
+ * the same options share a handle. Unknown MTL parameters are kept as
+ * interned (key, value) pairs tagged with their material.
+ */
+class MaterialTable {
+public:
+    void build(const std::vector<material_t> &materials)
+    {
+        m_strings = StringPool();
+        m_shading.clear();
+        m_textures.clear();
+        m_options.clear();
+        m_parameters.clear();
+        m_shading.reserve(materials.size());
+
+        size_t capacity = 16;
+        while (capacity < materials.size() * 2) capacity <<= 1;
+        m_slots.assign(capacity, MATERIAL_NO_STRING);
+        std::vector<int32_t> texture_slots(capacity * 4, MATERIAL_NO_TEXTURE);
+
+        for (size_t i = 0; i < materials.size(); i++) {
+            const material_t &m = materials[i];
+            material_shading_t s;
+            memcpy(s.ambient, m.ambient, sizeof(s.ambient));
+            memcpy(s.diffuse, m.diffuse, sizeof(s.diffuse));
+            memcpy(s.specular, m.specular, sizeof(s.specular));
+            memcpy(s.transmittance, m.transmittance, sizeof(s.transmittance));
+            memcpy(s.emission, m.emission, sizeof(s.emission));
+            s.shininess = m.shininess;
+            s.ior = m.ior;
+            s.dissolve = m.dissolve;
+            s.roughness = m.roughness;
+            s.metallic = m.metallic;
+            s.sheen = m.sheen;
+            s.clearcoat_thickness = m.clearcoat_thickness;
+            s.clearcoat_roughness = m.clearcoat_roughness;
+            s.anisotropy = m.anisotropy;
+            s.anisotropy_rotation = m.anisotropy_rotation;
+            s.illum = m.illum;
+            s.name = m_strings.intern(m.name);
+            int texture = 0;
+#define X(n) s.textures[texture++] = addTexture(&texture_slots, m.n##_texname, m.n##_texopt);
+            OBJ_MATERIAL_TEXTURES(X)
+#undef X
+            for (std::map<std::string, std::string>::const_iterator it = m.unknown_parameter.begin(); it != m.unknown_parameter.end(); ++it) {
+                material_parameter_t p;
+                p.material = static_cast<uint32_t>(i);
+                p.key = m_strings.intern(it->first);
+                p.value = m_strings.intern(it->second);
+                m_parameters.push_back(p);
+            }
+
+            // First material wins on duplicate names, as with material_map.
+            size_t mask = m_slots.size() - 1;
+            size_t slot = m_strings.hash(s.name) & mask;
+            bool duplicate = false;
+            while (m_slots[slot] != MATERIAL_NO_STRING) {
+                if (m_shading[m_slots[slot]].name == s.name) {
+                    duplicate = true;
+                    break;
+                }
+                slot = (slot + 1) & mask;
+            }
+            if (!duplicate) {
+                m_slots[slot] = static_cast<uint32_t>(m_shading.size());
+            }
+            m_shading.push_back(s);
+        }
+    }
+
+    /**
+     * @brief Index of the material with the given name.
+     *
+     * @return The material id, or -1 when no material has this name.
+     */
+    int find(const char *name, size_t len) const
+    {
+        if (m_slots.empty()) return (-1);
+        uint32_t hash = hashMaterialString(name, len);
+        size_t mask = m_slots.size() - 1;
+        for (size_t slot = hash & mask; m_slots[slot] != MATERIAL_NO_STRING; slot = (slot + 1) & mask) {
+            uint32_t name_handle = m_shading[m_slots[slot]].name;
+            if (m_strings.hash(name_handle) == hash && m_strings.length(name_handle) == len
+                && memcmp(m_strings.c_str(name_handle), name, len) == 0) {
+                return (static_cast<int>(m_slots[slot]));
+            }
+        }
+        return (-1);
+    }
+
+    int find(const std::string &name) const { return (find(name.c_str(), name.size())); }
+
+    size_t size() const { return (m_shading.size()); }
+    const material_shading_t &operator[](size_t i) const { return (m_shading[i]); }
+    const material_shading_t *data() const { return (m_shading.empty() ? NULL : &m_shading[0]); }
+
+    const char *name(size_t i) const { return (m_strings.c_str(m_shading[i].name)); }
+    /*** @brief Path of a texture, or "" for MATERIAL_NO_TEXTURE and any other invalid handle. */
+    const char *texturePath(int32_t handle) const
+    {
+        if (!validTexture(handle)) return ("");
+        return (m_strings.c_str(m_textures[handle].path));
+    }
+
+    /*** @brief Options of a texture, or the MTL defaults for MATERIAL_NO_TEXTURE and any other invalid handle. */
+    const texture_option_t &textureOption(int32_t handle) const
+    {
+        static const texture_option_t defaults = defaultTextureOption();
+        if (!validTexture(handle)) return (defaults);
+        return (m_options[m_textures[handle].option]);
+    }
+
+    const std::vector<material_texture_t> &textures() const { return (m_textures); }
+    const std::vector<material_parameter_t> &parameters() const { return (m_parameters); }
+    const StringPool &strings() const { return (m_strings); }
+
+    /*** @brief Heap and inline bytes held by the table. */
+    size_t bytes() const
+    {
+        return (sizeof(*this) + m_strings.bytes()
+            + m_shading.capacity() * sizeof(material_shading_t)
+            + m_textures.capacity() * sizeof(material_texture_t)
+            + m_options.capacity() * sizeof(texture_option_t)
+            + m_parameters.capacity() * sizeof(material_parameter_t)
+            + m_slots.capacity() * sizeof(uint32_t));
+    }
+
+private:
+    bool validTexture(int32_t handle) const
+    {
+        return (handle >= 0 && static_cast<size_t>(handle) < m_textures.size());
+    }
+
+    // What the MTL parser sets before reading the options of a texture line.
+    static texture_option_t defaultTextureOption(void)
+    {
+        texture_option_t option;
+        std::string name;
+        ParseTextureNameAndOption(&name, &option, "", false);
+        return (option);
+    }
+
+    int32_t addTexture(std::vector<int32_t> *slots, const std::string &path, const texture_option_t &option)
+    {
+        if (path.empty()) return (MATERIAL_NO_TEXTURE);
+        uint32_t option_index = 0;
+        while (option_index < m_options.size() && !sameTextureOption(m_options[option_index], option)) option_index++;
+        if (option_index == m_options.size()) m_options.push_back(option);
+        uint32_t path_handle = m_strings.intern(path);
+
+        if ((m_textures.size() + 1) * 2 > slots->size()) {
+            std::vector<int32_t> grown(slots->size() * 2, MATERIAL_NO_TEXTURE);
+            for (size_t t = 0; t < m_textures.size(); t++) {
+                size_t slot = textureHash(m_textures[t]) & (grown.size() - 1);
+                while (grown[slot] != MATERIAL_NO_TEXTURE) slot = (slot + 1) & (grown.size() - 1);
+                grown[slot] = static_cast<int32_t>(t);
+            }
+            slots->swap(grown);
+        }
+        material_texture_t texture;
+        texture.path = path_handle;
+        texture.option = option_index;
+        size_t mask = slots->size() - 1;
+        size_t slot = textureHash(texture) & mask;
+        while ((*slots)[slot] != MATERIAL_NO_TEXTURE) {
+            const material_texture_t &other = m_textures[(*slots)[slot]];
+            if (other.path == texture.path && other.option == texture.option) {
+                return ((*slots)[slot]);
+            }
+            slot = (slot + 1) & mask;
+        }
+        (*slots)[slot] = static_cast<int32_t>(m_textures.size());
+        m_textures.push_back(texture);
+        return ((*slots)[slot]);
+    }
+
+    static uint32_t textureHash(const material_texture_t &t)
+    {
+        return ((t.path * 0x9E3779B1u) ^ (t.option * 0x85EBCA77u));
+    }
+
+    StringPool m_strings;
+    std::vector<material_shading_t> m_shading;
+    std::vector<material_texture_t> m_textures;
+    std::vector<texture_option_t> m_options;
+    std::vector<material_parameter_t> m_parameters;
+    std::vector<uint32_t> m_slots;
+};
+
+static size_t materialStringBytes(const std::string &s)
+{
+    // Heap block only when the string outgrew the small-string buffer.
+    return (s.capacity() > 15 ? s.capacity() + 1 : 0);
+}
+
+/**
+ * @brief Approximate memory held by a material_t list, for comparison with
+ *        MaterialTable::bytes(). std::map nodes are counted as their payload
+ *        plus the four words of a red-black tree node.
+ */
+inline size_t MaterialListBytes(const std::vector<material_t> &materials)
+{
+    size_t bytes = materials.capacity() * sizeof(material_t);
+    for (size_t i = 0; i < materials.size(); i++) {
+        const material_t &m = materials[i];
+        bytes += materialStringBytes(m.name);
+#define X(n) bytes += materialStringBytes(m.n##_texname);
+        OBJ_MATERIAL_TEXTURES(X)
+#undef X
+        for (std::map<std::string, std::string>::const_iterator it = m.unknown_parameter.begin(); it != m.unknown_parameter.end(); ++it) {
+            bytes += sizeof(std::pair<const std::string, std::string>) + 4 * sizeof(void *);
+            bytes += materialStringBytes(it->first) + materialStringBytes(it->second);
+        }
+    }
+    return (bytes);
+}
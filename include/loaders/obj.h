@@ -29,6 +29,7 @@
 
 #pragma once
 
+#include <algorithm>
 #include <map>
 #include <string>
 #include <vector>
@@ -41,6 +42,9 @@
 #include <utility>
 #include <fstream>
 #include <sstream>
+#include <chrono>
+#include "loaders/fast_float.h"
+#include "loaders/mapped_file.h"
 
 typedef enum {
     TEXTURE_TYPE_NONE,
@@ -118,6 +122,12 @@ typedef struct {
     std::map<std::string, std::string> unknown_parameter;
 } material_t;
 
+// Applies X(prefix) to every <prefix>_texname / <prefix>_texopt pair of material_t.
+#define OBJ_MATERIAL_TEXTURES(X) \
+    X(ambient) X(diffuse) X(specular) X(specular_highlight) X(bump) \
+    X(displacement) X(alpha) X(reflection) X(roughness) X(metallic) \
+    X(sheen) X(emissive) X(normal)
+
 typedef struct {
     std::string name;
     std::vector<int> intValues;
@@ -149,6 +159,28 @@ typedef struct {
     std::vector<float> texcoords;
 } attrib_t;
 
+typedef struct {
+    size_t bytes;
+    double seconds;
+    double megabytes_per_second;
+    size_t face_group_allocations;
+    double prescan_seconds;
+} load_stats_t;
+
+/**
+ * Line counts gathered by PrescanObj. The group_* arrays have one entry per
+ * shape candidate: the lines before the first `g`/`o`, then one per `g`/`o`
+ * line, which is where ObjShapeBuilder starts a new shape.
+ */
+typedef struct {
+    size_t vertices;
+    size_t normals;
+    size_t texcoords;
+    std::vector<size_t> group_polygons;
+    std::vector<size_t> group_corners;
+    std::vector<size_t> group_triangles;
+} obj_prescan_t;
+
 class MaterialReader {
 public:
     MaterialReader() {}
@@ -193,6 +225,39 @@ bool LoadObj(attrib_t *attrib, std::vector<shape_t> *shapes,
              std::istream *inStream, MaterialReader *readMatFn = NULL,
              bool triangulate = true);
 
+/**
+ * Memory-mapped variant: lines are parsed in place from the mapped file
+ * instead of being copied through a std::istream. When `stats` is not NULL
+ * it receives the file size, wall time, parse throughput and the number of
+ * face group allocations. With `prescan`, the file is first classified line
+ * by line so that attribute and index buffers are reserved once at their
+ * final size.
+ */
+inline bool LoadObj(attrib_t *attrib, std::vector<shape_t> *shapes,
+                    std::vector<material_t> *materials, std::string *err,
+                    const char *filename, const char *mtl_basedir,
+                    bool triangulate, load_stats_t *stats, bool prescan = false);
+
+/**
+ * Counts `v`/`vn`/`vt` lines and face polygons, corners and triangles per
+ * group without parsing any number.
+ */
+inline void PrescanObj(const char *data, size_t size, obj_prescan_t *scan);
+
+class ObjVisitor;
+
+/**
+ * Streaming variants: geometry is handed to `visitor` as it is parsed and no
+ * attrib_t/shape_t is built. LoadObj is implemented on top of these.
+ */
+inline bool LoadObjWithVisitor(ObjVisitor *visitor, std::vector<material_t> *materials,
+                               std::string *err, const char *filename,
+                               const char *mtl_basedir = NULL);
+
+inline bool LoadObjWithVisitor(ObjVisitor *visitor, std::vector<material_t> *materials,
+                               std::string *err, std::istream *inStream,
+                               MaterialReader *readMatFn = NULL);
+
 void LoadMtl(std::map<std::string, int> *material_map,
              std::vector<material_t> *materials, std::istream *inStream,
              std::string *warning);
@@ -259,7 +324,7 @@ static inline std::string parseString(const char **token)
 {
     std::string s;
     (*token) += strspn((*token), " \t");
-    size_t e = strcspn((*token), " \t\r");
+    size_t e = strcspn((*token), " \t\r\n");
     s = std::string((*token), &(*token)[e]);
     (*token) += e;
     return (s);
@@ -269,84 +334,16 @@ static inline int parseInt(const char **token)
 {
     (*token) += strspn((*token), " \t");
     int i = atoi((*token));
-    (*token) += strcspn((*token), " \t\r");
+    (*token) += strcspn((*token), " \t\r\n");
     return (i);
 }
 
-static bool tryParseDouble(const char *s, const char *s_end, double *result)
-{
-    if (s >= s_end) return (false);
-    double mantissa = 0.0;
-    int exponent = 0;
-    char sign = '+';
-    char exp_sign = '+';
-    char const *curr = s;
-    int read = 0;
-    bool end_not_reached = false;
-    if (*curr == '+' || *curr == '-') {
-        sign = *curr;
-        curr++;
-    } else if (IS_DIGIT(*curr)) {} else { goto fail; }
-    end_not_reached = (curr != s_end);
-    while (end_not_reached && IS_DIGIT(*curr)) {
-        mantissa *= 10;
-        mantissa += static_cast<int>(*curr - 0x30);
-        curr++;
-        read++;
-        end_not_reached = (curr != s_end);
-    }
-    if (read == 0) goto fail;
-    if (!end_not_reached) goto assemble;
-    if (*curr == '.') {
-        curr++;
-        read = 1;
-        end_not_reached = (curr != s_end);
-        while (end_not_reached && IS_DIGIT(*curr)) {
-            static const double pow_lut[] = {
-                1.0, 0.1, 0.01, 0.001, 0.0001, 0.00001, 0.000001, 0.0000001,
-            };
-            const int lut_entries = sizeof pow_lut / sizeof pow_lut[0];
-            mantissa += static_cast<int>(*curr - 0x30) * (read < lut_entries ? pow_lut[read] : std::pow(10.0, -read));
-            read++;
-            curr++;
-            end_not_reached = (curr != s_end);
-        }
-    } else if (*curr == 'e' || *curr == 'E') {} else { goto assemble; }
-    if (!end_not_reached) goto assemble;
-    if (*curr == 'e' || *curr == 'E') {
-        curr++;
-        end_not_reached = (curr != s_end);
-        if (end_not_reached && (*curr == '+' || *curr == '-')) {
-            exp_sign = *curr;
-            curr++;
-        } else if (IS_DIGIT(*curr)) {} else { goto fail; }
-        read = 0;
-        end_not_reached = (curr != s_end);
-        while (end_not_reached && IS_DIGIT(*curr)) {
-            exponent *= 10;
-            exponent += static_cast<int>(*curr - 0x30);
-            curr++;
-            read++;
-            end_not_reached = (curr != s_end);
-        }
-        exponent *= (exp_sign == '+' ? 1 : -1);
-        if (read == 0) goto fail;
-    }
-assemble:
-    *result = (sign == '+' ? 1 : -1) *
-        (exponent ? std::ldexp(mantissa * std::pow(5.0, exponent), exponent) : mantissa);
-    return (true);
-fail:
-    return (false);
-}
-
 static inline float parseReal(const char **token, double default_value = 0.0)
 {
     (*token) += strspn((*token), " \t");
-    const char *end = (*token) + strcspn((*token), " \t\r");
-    double val = default_value;
-    tryParseDouble((*token), end, &val);
-    float f = static_cast<float>(val);
+    const char *end = (*token) + strcspn((*token), " \t\r\n");
+    float f = static_cast<float>(default_value);
+    parseFloatFast((*token), end, &f);
     (*token) = end;
     return f;
 }
@@ -361,9 +358,20 @@ static inline void parseReal2(float *x, float *y, const char **token,
 static inline void parseReal3(float *x, float *y, float *z, const char **token,
     const double default_x = 0.0, const double default_y = 0.0, const double default_z = 0.0)
 {
-    (*x) = parseReal(token, default_x);
-    (*y) = parseReal(token, default_y);
-    (*z) = parseReal(token, default_z);
+    // Batched: the line end is located once and the three fields are then
+    // scanned inline instead of through six strspn/strcspn calls.
+    const char *p = (*token);
+    const char *line_end = p + strcspn(p, "\r\n");
+    float *out[3] = {x, y, z};
+    const double defaults[3] = {default_x, default_y, default_z};
+    for (int i = 0; i < 3; i++) {
+        while (p < line_end && IS_SPACE((*p))) p++;
+        (*out[i]) = static_cast<float>(defaults[i]);
+        const char *e = parseFloatFast(p, line_end, out[i]);
+        if (e) p = e;
+        while (p < line_end && !IS_SPACE((*p))) p++;
+    }
+    (*token) = p;
 }
 
 static inline void parseV(float *x, float *y, float *z, float *w,
@@ -379,7 +387,7 @@ static inline void parseV(float *x, float *y, float *z, float *w,
 static inline bool parseOnOff(const char **token, bool default_value = true)
 {
     (*token) += strspn((*token), " \t");
-    const char *end = (*token) + strcspn((*token), " \t\r");
+    const char *end = (*token) + strcspn((*token), " \t\r\n");
     bool ret = default_value;
     if ((0 == strncmp((*token), "on", 2))) {
         ret = true;
@@ -394,7 +402,7 @@ static inline texture_type_t parseTextureType(const char **token,
     texture_type_t default_value = TEXTURE_TYPE_NONE)
 {
     (*token) += strspn((*token), " \t");
-    const char *end = (*token) + strcspn((*token), " \t\r");
+    const char *end = (*token) + strcspn((*token), " \t\r\n");
     texture_type_t ty = default_value;
     if ((0 == strncmp((*token), "cube_top", strlen("cube_top")))) {
         ty = TEXTURE_TYPE_CUBE_TOP;
@@ -419,19 +427,19 @@ static tag_sizes parseTagTriple(const char **token)
 {
     tag_sizes ts;
     ts.num_ints = atoi((*token));
-    (*token) += strcspn((*token), "/ \t\r");
+    (*token) += strcspn((*token), "/ \t\r\n");
     if ((*token)[0] != '/') {
         return (ts);
     }
     (*token)++;
     ts.num_reals = atoi((*token));
-    (*token) += strcspn((*token), "/ \t\r");
+    (*token) += strcspn((*token), "/ \t\r\n");
     if ((*token)[0] != '/') {
         return (ts);
     }
     (*token)++;
     ts.num_strings = atoi((*token));
-    (*token) += strcspn((*token), "/ \t\r") + 1;
+    (*token) += strcspn((*token), "/ \t\r\n") + 1;
     return (ts);
 }
 
@@ -439,7 +447,7 @@ static vertex_index parseTriple(const char **token, int vsize, int vnsize, int v
 {
     vertex_index vi(-1);
     vi.v_idx = fixIndex(atoi((*token)), vsize);
-    (*token) += strcspn((*token), "/ \t\r");
+    (*token) += strcspn((*token), "/ \t\r\n");
     if ((*token)[0] != '/') {
         return (vi);
     }
@@ -447,17 +455,17 @@ static vertex_index parseTriple(const char **token, int vsize, int vnsize, int v
     if ((*token)[0] == '/') {
         (*token)++;
         vi.vn_idx = fixIndex(atoi((*token)), vnsize);
-        (*token) += strcspn((*token), "/ \t\r");
+        (*token) += strcspn((*token), "/ \t\r\n");
         return (vi);
     }
     vi.vt_idx = fixIndex(atoi((*token)), vtsize);
-    (*token) += strcspn((*token), "/ \t\r");
+    (*token) += strcspn((*token), "/ \t\r\n");
     if ((*token)[0] != '/') {
         return (vi);
     }
     (*token)++;
     vi.vn_idx = fixIndex(atoi((*token)), vnsize);
-    (*token) += strcspn((*token), "/ \t\r");
+    (*token) += strcspn((*token), "/ \t\r\n");
     return (vi);
 }
 
@@ -583,17 +591,61 @@ static void InitMaterial(material_t *material)
     material->unknown_parameter.clear();
 }
 
-static bool exportFaceGroupToShape(shape_t *shape, const std::vector<std::vector<vertex_index>> &faceGroup,
+/**
+ * Faces of the group being built, stored flat: the corners of face i are
+ * indices[offsets[i]] .. indices[offsets[i + 1]]. clear() keeps the capacity,
+ * so the same buffers are reused by every group of the file instead of one
+ * heap block per face. `allocations` counts how many times either buffer had
+ * to grow.
+ */
+struct face_group_t {
+    std::vector<vertex_index> indices;
+    std::vector<size_t> offsets;
+    size_t allocations;
+    face_group_t() : offsets(1, 0), allocations(0) {}
+    size_t size() const { return (offsets.size() - 1); }
+    bool empty() const { return (offsets.size() == 1); }
+    const vertex_index *face(size_t i) const { return (&indices[offsets[i]]); }
+    size_t faceSize(size_t i) const { return (offsets[i + 1] - offsets[i]); }
+    void clear()
+    {
+        indices.clear();
+        offsets.resize(1);
+    }
+    void push(const vertex_index *face, size_t count)
+    {
+        if (indices.size() + count > indices.capacity()) allocations++;
+        if (offsets.size() == offsets.capacity()) allocations++;
+        indices.insert(indices.end(), face, face + count);
+        offsets.push_back(indices.size());
+    }
+};
+
+static bool exportFaceGroupToShape(shape_t *shape, const face_group_t &faceGroup,
     const std::vector<tag_t> &tags, const int material_id, const std::string &name, bool triangulate) {
     if (faceGroup.empty()) {
         return (false);
     }
+    size_t num_faces = 0;
+    size_t num_corners = 0;
+    for (size_t i = 0; i < faceGroup.size(); i++) {
+        size_t npolys = faceGroup.faceSize(i);
+        num_faces += triangulate ? (npolys > 2 ? npolys - 2 : 0) : 1;
+        num_corners += triangulate ? (npolys > 2 ? 3 * (npolys - 2) : 0) : npolys;
+    }
+    // Only into an empty shape: every usemtl flushes into the same shape, and
+    // exact-size reserves there would make the appends quadratic.
+    if (shape->mesh.num_face_vertices.empty()) {
+        shape->mesh.indices.reserve(num_corners);
+        shape->mesh.num_face_vertices.reserve(num_faces);
+        shape->mesh.material_ids.reserve(num_faces);
+    }
     for (size_t i = 0; i < faceGroup.size(); i++) {
-        const std::vector<vertex_index> &face = faceGroup[i];
+        const vertex_index *face = faceGroup.face(i);
+        size_t npolys = faceGroup.faceSize(i);
         vertex_index i0 = face[0];
         vertex_index i1(-1);
         vertex_index i2 = face[1];
-        size_t npolys = face.size();
         if (triangulate) {
             for (size_t k = 2; k < npolys; k++) {
                 i1 = i2;
@@ -1011,200 +1063,465 @@ bool LoadObj(attrib_t *attrib, std::vector<shape_t> *shapes, std::vector<materia
     return (LoadObj(attrib, shapes, materials, err, &ifs, &matFileReader, trianglulate));
 }
 
-bool LoadObj(attrib_t *attrib, std::vector<shape_t> *shapes, std::vector<material_t> *materials, std::string *err, std::istream *inStream, MaterialReader *readMatFn, bool triangulate) {
-    std::stringstream errss;
-    std::vector<float> v;
-    std::vector<float> vn;
-    std::vector<float> vt;
-    std::vector<tag_t> tags;
-    std::vector<std::vector<vertex_index> > faceGroup;
-    std::string name;
-    std::map<std::string, int> material_map;
-    int material = -1;
-    shape_t shape;
-    std::string linebuf;
-    while (inStream->peek() != -1) {
-        safeGetline(*inStream, linebuf);
-        if (linebuf.size() > 0) {
-            if (linebuf[linebuf.size() - 1] == '\n') linebuf.erase(linebuf.size() - 1);
+/**
+ * Receives the geometry of an OBJ file as it is parsed.
+ *
+ * Face indices are already resolved (0-based, -1 when absent), and usemtl
+ * events carry the material id from the materials loaded by `mtllib`, or -1.
+ * The bulk `vertices`/`normals`/`texcoords` events are used by the parallel
+ * loader; their default forwards to the per-element events.
+ */
+class ObjVisitor {
+public:
+    virtual ~ObjVisitor() {}
+    virtual void vertex(float x, float y, float z) { (void)x; (void)y; (void)z; }
+    virtual void normal(float x, float y, float z) { (void)x; (void)y; (void)z; }
+    virtual void texcoord(float u, float v) { (void)u; (void)v; }
+    virtual void face(const vertex_index *indices, size_t count) { (void)indices; (void)count; }
+    virtual void usemtl(const std::string &name, int material_id) { (void)name; (void)material_id; }
+    virtual void group(const std::vector<std::string> &names) { (void)names; }
+    virtual void object(const std::string &name) { (void)name; }
+    virtual void tag(const tag_t &tag) { (void)tag; }
+    virtual void vertices(const float *xyz, size_t count)
+    {
+        for (size_t i = 0; i < count; i++) vertex(xyz[3 * i], xyz[3 * i + 1], xyz[3 * i + 2]);
+    }
+    virtual void normals(const float *xyz, size_t count)
+    {
+        for (size_t i = 0; i < count; i++) normal(xyz[3 * i], xyz[3 * i + 1], xyz[3 * i + 2]);
+    }
+    virtual void texcoords(const float *uv, size_t count)
+    {
+        for (size_t i = 0; i < count; i++) texcoord(uv[2 * i], uv[2 * i + 1]);
+    }
+};
+
+/*** @brief ObjVisitor producing the attrib_t/shape_t output of LoadObj. */
+class ObjShapeBuilder : public ObjVisitor {
+public:
+    ObjShapeBuilder(std::vector<shape_t> *shapes, bool triangulate)
+        : m_shapes(shapes), m_triangulate(triangulate), m_material(-1), m_scan(NULL), m_group(0) {}
+
+    virtual void vertex(float x, float y, float z) { m_v.push_back(x); m_v.push_back(y); m_v.push_back(z); }
+    virtual void normal(float x, float y, float z) { m_vn.push_back(x); m_vn.push_back(y); m_vn.push_back(z); }
+    virtual void texcoord(float u, float v) { m_vt.push_back(u); m_vt.push_back(v); }
+    virtual void vertices(const float *xyz, size_t count) { m_v.insert(m_v.end(), xyz, xyz + 3 * count); }
+    virtual void normals(const float *xyz, size_t count) { m_vn.insert(m_vn.end(), xyz, xyz + 3 * count); }
+    virtual void texcoords(const float *uv, size_t count) { m_vt.insert(m_vt.end(), uv, uv + 2 * count); }
+
+    virtual void face(const vertex_index *indices, size_t count)
+    {
+        m_faceGroup.push(indices, count);
+    }
+
+    virtual void usemtl(const std::string &name, int material_id)
+    {
+        (void)name;
+        if (material_id != m_material) {
+            exportFaceGroupToShape(&m_shape, m_faceGroup, m_tags, m_material, m_name, m_triangulate);
+            m_faceGroup.clear();
+            m_material = material_id;
         }
-        if (linebuf.size() > 0) {
-            if (linebuf[linebuf.size() - 1] == '\r') linebuf.erase(linebuf.size() - 1);
+    }
+
+    virtual void group(const std::vector<std::string> &names)
+    {
+        flushShape();
+        m_name = names.empty() ? std::string() : names[0];
+    }
+
+    virtual void object(const std::string &name)
+    {
+        flushShape();
+        m_name = name;
+    }
+
+    virtual void tag(const tag_t &tag) { m_tags.push_back(tag); }
+
+    /*** @brief Reserves room for a known number of attribute floats. */
+    void reserve(size_t v, size_t vn, size_t vt)
+    {
+        m_v.reserve(v);
+        m_vn.reserve(vn);
+        m_vt.reserve(vt);
+    }
+
+    /**
+     * @brief Reserves attributes, shapes and, as each shape starts, its
+     *        mesh arrays from a prescan of the same file. `scan` must stay
+     *        alive until finish().
+     */
+    void reserve(const obj_prescan_t &scan)
+    {
+        reserve(3 * scan.vertices, 3 * scan.normals, 2 * scan.texcoords);
+        m_shapes->reserve(m_shapes->size() + scan.group_polygons.size());
+        m_scan = &scan;
+        m_group = 0;
+        reserveShape();
+    }
+
+    /*** @brief Number of times the face group buffers were (re)allocated. */
+    size_t faceGroupAllocations() const { return (m_faceGroup.allocations); }
+
+    /*** @brief Flushes the pending shape and hands the attributes over. */
+    void finish(attrib_t *attrib)
+    {
+        bool ret = exportFaceGroupToShape(&m_shape, m_faceGroup, m_tags, m_material, m_name, m_triangulate);
+        if (ret || m_shape.mesh.indices.size()) {
+            m_shapes->push_back(shape_t());
+            std::swap(m_shapes->back(), m_shape);
         }
-        if (linebuf.empty()) {
-            continue;
+        m_faceGroup.clear();
+        attrib->vertices.swap(m_v);
+        attrib->normals.swap(m_vn);
+        attrib->texcoords.swap(m_vt);
+    }
+
+private:
+    void flushShape()
+    {
+        bool ret = exportFaceGroupToShape(&m_shape, m_faceGroup, m_tags, m_material, m_name, m_triangulate);
+        if (ret) {
+            // Swapped rather than copied, so a shape's arrays never exist twice.
+            m_shapes->push_back(shape_t());
+            std::swap(m_shapes->back(), m_shape);
         }
-        const char *token = linebuf.c_str();
+        m_shape = shape_t();
+        m_faceGroup.clear();
+        m_group++;
+        reserveShape();
+    }
+
+    void reserveShape()
+    {
+        if (!m_scan || m_group >= m_scan->group_polygons.size()) return;
+        size_t faces = m_triangulate ? m_scan->group_triangles[m_group] : m_scan->group_polygons[m_group];
+        size_t corners = m_triangulate ? 3 * m_scan->group_triangles[m_group] : m_scan->group_corners[m_group];
+        m_shape.mesh.indices.reserve(corners);
+        m_shape.mesh.num_face_vertices.reserve(faces);
+        m_shape.mesh.material_ids.reserve(faces);
+    }
+
+    std::vector<shape_t> *m_shapes;
+    bool m_triangulate;
+    std::vector<float> m_v;
+    std::vector<float> m_vn;
+    std::vector<float> m_vt;
+    std::vector<tag_t> m_tags;
+    face_group_t m_faceGroup;
+    std::string m_name;
+    int m_material;
+    shape_t m_shape;
+    const obj_prescan_t *m_scan;
+    size_t m_group;
+};
+
+struct obj_parser_state {
+    int v_count;
+    int vn_count;
+    int vt_count;
+    std::map<std::string, int> material_map;
+    std::vector<vertex_index> face;
+    obj_parser_state() : v_count(0), vn_count(0), vt_count(0) {}
+};
+
+static void parseObjLine(obj_parser_state *state, ObjVisitor *visitor, const char *token, const char *line_end,
+    std::vector<material_t> *materials, std::string *err, MaterialReader *readMatFn)
+{
+    token += strspn(token, " \t");
+    assert(token);
+    if (token >= line_end) return;
+    if (token[0] == '#') return;
+    if (token[0] == 'v' && IS_SPACE((token[1]))) {
+        token += 2;
+        float x, y, z;
+        parseReal3(&x, &y, &z, &token);
+        visitor->vertex(x, y, z);
+        state->v_count++;
+        return;
+    }
+    if (token[0] == 'v' && token[1] == 'n' && IS_SPACE((token[2]))) {
+        token += 3;
+        float x, y, z;
+        parseReal3(&x, &y, &z, &token);
+        visitor->normal(x, y, z);
+        state->vn_count++;
+        return;
+    }
+    if (token[0] == 'v' && token[1] == 't' && IS_SPACE((token[2]))) {
+        token += 3;
+        float x, y;
+        parseReal2(&x, &y, &token);
+        visitor->texcoord(x, y);
+        state->vt_count++;
+        return;
+    }
+    if (token[0] == 'f' && IS_SPACE((token[1]))) {
+        token += 2;
         token += strspn(token, " \t");
-        assert(token);
-        if (token[0] == '\0') continue;
-        if (token[0] == '#') continue;
-        if (token[0] == 'v' && IS_SPACE((token[1]))) {
-            token += 2;
-            float x, y, z;
-            parseReal3(&x, &y, &z, &token);
-            v.push_back(x);
-            v.push_back(y);
-            v.push_back(z);
-            continue;
-        }
-        if (token[0] == 'v' && token[1] == 'n' && IS_SPACE((token[2]))) {
-            token += 3;
-            float x, y, z;
-            parseReal3(&x, &y, &z, &token);
-            vn.push_back(x);
-            vn.push_back(y);
-            vn.push_back(z);
-            continue;
+        state->face.clear();
+        while (!IS_NEW_LINE(token[0])) {
+            vertex_index vi = parseTriple(&token, state->v_count, state->vn_count, state->vt_count);
+            state->face.push_back(vi);
+            size_t n = strspn(token, " \t\r");
+            token += n;
         }
-        if (token[0] == 'v' && token[1] == 't' && IS_SPACE((token[2]))) {
-            token += 3;
-            float x, y;
-            parseReal2(&x, &y, &token);
-            vt.push_back(x);
-            vt.push_back(y);
-            continue;
+        if (!state->face.empty()) {
+            visitor->face(&state->face[0], state->face.size());
         }
-        if (token[0] == 'f' && IS_SPACE((token[1]))) {
-            token += 2;
-            token += strspn(token, " \t");
-            std::vector<vertex_index> face;
-            face.reserve(3);
-            while (!IS_NEW_LINE(token[0])) {
-                vertex_index vi = parseTriple(&token, static_cast<int>(v.size() / 3), static_cast<int>(vn.size() / 3), static_cast<int>(vt.size() / 2));
-                face.push_back(vi);
-                size_t n = strspn(token, " \t\r");
-                token += n;
-            }
-            faceGroup.push_back(std::vector<vertex_index>());
-            faceGroup[faceGroup.size() - 1].swap(face);
-            continue;
+        return;
+    }
+    if ((0 == strncmp(token, "usemtl", 6)) && IS_SPACE((token[6]))) {
+        token += 7;
+        std::string namebuf(token, line_end);
+        int newMaterialId = -1;
+        std::map<std::string, int>::const_iterator it = state->material_map.find(namebuf);
+        if (it != state->material_map.end()) {
+            newMaterialId = it->second;
         }
-        if ((0 == strncmp(token, "usemtl", 6)) && IS_SPACE((token[6]))) {
+        visitor->usemtl(namebuf, newMaterialId);
+        return;
+    }
+    if ((0 == strncmp(token, "mtllib", 6)) && IS_SPACE((token[6]))) {
+        if (readMatFn) {
             token += 7;
-            std::stringstream ss;
-            ss << token;
-            std::string namebuf = ss.str();
-            int newMaterialId = -1;
-            if (material_map.find(namebuf) != material_map.end()) {
-                newMaterialId = material_map[namebuf];
+            std::vector<std::string> filenames;
+            SplitString(std::string(token, line_end), ' ', filenames);
+            if (filenames.empty()) {
+                if (err) {
+                    (*err) +=
+                        "WARN: Looks like empty filename for mtllib. Use default "
+                        "material. \n";
+                }
             } else {
-            }
-            if (newMaterialId != material) {
-                exportFaceGroupToShape(&shape, faceGroup, tags, material, name, triangulate);
-                faceGroup.clear();
-                material = newMaterialId;
-            }
-            continue;
-        }
-        if ((0 == strncmp(token, "mtllib", 6)) && IS_SPACE((token[6]))) {
-            if (readMatFn) {
-                token += 7;
-                std::vector<std::string> filenames;
-                SplitString(std::string(token), ' ', filenames);
-                if (filenames.empty()) {
-                    if (err) {
-                        (*err) +=
-                            "WARN: Looks like empty filename for mtllib. Use default "
-                            "material. \n";
+                bool found = false;
+                for (size_t s = 0; s < filenames.size(); s++) {
+                    std::string err_mtl;
+                    bool ok = (*readMatFn)(filenames[s].c_str(), materials, &state->material_map, &err_mtl);
+                    if (err && (!err_mtl.empty())) {
+                        (*err) += err_mtl;
                     }
-                } else {
-                    bool found = false;
-                    for (size_t s = 0; s < filenames.size(); s++) {
-                        std::string err_mtl;
-                        bool ok = (*readMatFn)(filenames[s].c_str(), materials, &material_map, &err_mtl);
-                        if (err && (!err_mtl.empty())) {
-                            (*err) += err_mtl;
-                        }
-                        if (ok) {
-                            found = true;
-                            break;
-                        }
+                    if (ok) {
+                        found = true;
+                        break;
                     }
-                    if (!found) {
-                        if (err) {
-                            (*err) +=
-                                "WARN: Failed to load material file(s). Use default "
-                                "material.\n";
-                        }
+                }
+                if (!found) {
+                    if (err) {
+                        (*err) +=
+                            "WARN: Failed to load material file(s). Use default "
+                            "material.\n";
                     }
                 }
             }
-            continue;
         }
-        if (token[0] == 'g' && IS_SPACE((token[1]))) {
-            bool ret = exportFaceGroupToShape(&shape, faceGroup, tags, material, name, triangulate);
-            if (ret) {
-                shapes->push_back(shape);
-            }
-            shape = shape_t();
-            faceGroup.clear();
-            std::vector<std::string> names;
-            names.reserve(2);
-            while (!IS_NEW_LINE(token[0])) {
-                std::string str = parseString(&token);
-                names.push_back(str);
-                token += strspn(token, " \t\r");
-            }
-            assert(names.size() > 0);
-            if (names.size() > 1) {
-                name = names[1];
-            } else {
-                name = "";
-            }
-            continue;
+        return;
+    }
+    if (token[0] == 'g' && IS_SPACE((token[1]))) {
+        std::vector<std::string> names;
+        names.reserve(2);
+        token += 2;
+        token += strspn(token, " \t\r");
+        while (!IS_NEW_LINE(token[0])) {
+            std::string str = parseString(&token);
+            names.push_back(str);
+            token += strspn(token, " \t\r");
         }
-        if (token[0] == 'o' && IS_SPACE((token[1]))) {
-            bool ret = exportFaceGroupToShape(&shape, faceGroup, tags, material, name, triangulate);
-            if (ret) {
-                shapes->push_back(shape);
-            }
-            faceGroup.clear();
-            shape = shape_t();
-            token += 2;
-            std::stringstream ss;
-            ss << token;
-            name = ss.str();
+        visitor->group(names);
+        return;
+    }
+    if (token[0] == 'o' && IS_SPACE((token[1]))) {
+        token += 2;
+        visitor->object(std::string(token, line_end));
+        return;
+    }
+    if (token[0] == 't' && IS_SPACE(token[1])) {
+        tag_t tag;
+        token += 2;
+        tag.name = parseString(&token);
+        token += strspn(token, " \t");
+        // The line is not NUL terminated and every step below skips one
+        // delimiter, so token is clamped to line_end: missing values read as 0.
+        tag_sizes ts = token < line_end ? parseTagTriple(&token) : tag_sizes();
+        token = std::min(token, line_end);
+        tag.intValues.resize(static_cast<size_t>(ts.num_ints));
+        for (size_t i = 0; i < static_cast<size_t>(ts.num_ints); ++i) {
+            tag.intValues[i] = token < line_end ? atoi(token) : 0;
+            token = std::min(token + strcspn(token, "/ \t\r\n") + 1, line_end);
+        }
+        tag.floatValues.resize(static_cast<size_t>(ts.num_reals));
+        for (size_t i = 0; i < static_cast<size_t>(ts.num_reals); ++i) {
+            tag.floatValues[i] = token < line_end ? parseReal(&token) : 0.0f;
+            token = std::min(token + strcspn(token, "/ \t\r\n") + 1, line_end);
+        }
+        tag.stringValues.resize(static_cast<size_t>(ts.num_strings));
+        for (size_t i = 0; i < static_cast<size_t>(ts.num_strings); ++i) {
+            tag.stringValues[i] = parseString(&token);
+            token += strspn(token, " \t");
+        }
+        visitor->tag(tag);
+    }
+}
+
+static void parseObjBuffer(ObjVisitor *visitor, std::vector<material_t> *materials,
+    std::string *err, const char *data, size_t size, MaterialReader *readMatFn)
+{
+    obj_parser_state state;
+    const char *cur = data;
+    const char *end = cur + size;
+    while (cur < end) {
+        const char *eol = static_cast<const char *>(memchr(cur, '\n', static_cast<size_t>(end - cur)));
+        if (!eol) {
+            // The mapping is not NUL terminated: only an unterminated last line is copied.
+            std::string tail(cur, end);
+            if (!tail.empty() && tail[tail.size() - 1] == '\r') tail.erase(tail.size() - 1);
+            parseObjLine(&state, visitor, tail.c_str(), tail.c_str() + tail.size(), materials, err, readMatFn);
+            break;
+        }
+        const char *line_end = (eol > cur && eol[-1] == '\r') ? eol - 1 : eol;
+        if (line_end > cur) {
+            parseObjLine(&state, visitor, cur, line_end, materials, err, readMatFn);
+        }
+        cur = eol + 1;
+    }
+}
+
+static void prescanObjLine(obj_prescan_t *scan, const char *line, const char *line_end)
+{
+    const char *token = line;
+    while (token < line_end && IS_SPACE((*token))) token++;
+    if (line_end - token < 2) return;
+    if (token[0] == 'v') {
+        if (IS_SPACE((token[1]))) {
+            scan->vertices++;
+        } else if (token[1] == 'n' && line_end - token > 2 && IS_SPACE((token[2]))) {
+            scan->normals++;
+        } else if (token[1] == 't' && line_end - token > 2 && IS_SPACE((token[2]))) {
+            scan->texcoords++;
+        }
+        return;
+    }
+    if (token[0] == 'f' && IS_SPACE((token[1]))) {
+        size_t corners = 0;
+        bool in_space = true;
+        for (const char *p = token + 2; p < line_end; p++) {
+            bool space = IS_SPACE((*p)) || (*p) == '\r';
+            if (in_space && !space) corners++;
+            in_space = space;
+        }
+        if (corners) {
+            scan->group_polygons.back()++;
+            scan->group_corners.back() += corners;
+            scan->group_triangles.back() += corners > 2 ? corners - 2 : 0;
+        }
+        return;
+    }
+    if ((token[0] == 'g' || token[0] == 'o') && IS_SPACE((token[1]))) {
+        scan->group_polygons.push_back(0);
+        scan->group_corners.push_back(0);
+        scan->group_triangles.push_back(0);
+    }
+}
+
+inline void PrescanObj(const char *data, size_t size, obj_prescan_t *scan)
+{
+    scan->vertices = scan->normals = scan->texcoords = 0;
+    scan->group_polygons.assign(1, 0);
+    scan->group_corners.assign(1, 0);
+    scan->group_triangles.assign(1, 0);
+    const char *cur = data;
+    const char *end = cur + size;
+    while (cur < end) {
+        const char *eol = static_cast<const char *>(memchr(cur, '\n', static_cast<size_t>(end - cur)));
+        const char *line_end = eol ? eol : end;
+        prescanObjLine(scan, cur, line_end);
+        cur = line_end + 1;
+    }
+}
+
+inline bool LoadObjWithVisitor(ObjVisitor *visitor, std::vector<material_t> *materials, std::string *err,
+    std::istream *inStream, MaterialReader *readMatFn)
+{
+    obj_parser_state state;
+    std::string linebuf;
+    while (inStream->peek() != -1) {
+        safeGetline(*inStream, linebuf);
+        if (linebuf.size() > 0) {
+            if (linebuf[linebuf.size() - 1] == '\n') linebuf.erase(linebuf.size() - 1);
+        }
+        if (linebuf.size() > 0) {
+            if (linebuf[linebuf.size() - 1] == '\r') linebuf.erase(linebuf.size() - 1);
+        }
+        if (linebuf.empty()) {
             continue;
         }
-        if (token[0] == 't' && IS_SPACE(token[1])) {
-            tag_t tag;
-            token += 2;
-            std::stringstream ss;
-            ss << token;
-            tag.name = ss.str();
-            token += tag.name.size() + 1;
-            tag_sizes ts = parseTagTriple(&token);
-            tag.intValues.resize(static_cast<size_t>(ts.num_ints));
-            for (size_t i = 0; i < static_cast<size_t>(ts.num_ints); ++i) {
-                tag.intValues[i] = atoi(token);
-                token += strcspn(token, "/ \t\r") + 1;
-            }
-            tag.floatValues.resize(static_cast<size_t>(ts.num_reals));
-            for (size_t i = 0; i < static_cast<size_t>(ts.num_reals); ++i) {
-                tag.floatValues[i] = parseReal(&token);
-                token += strcspn(token, "/ \t\r") + 1;
-            }
-            tag.stringValues.resize(static_cast<size_t>(ts.num_strings));
-            for (size_t i = 0; i < static_cast<size_t>(ts.num_strings); ++i) {
-                std::stringstream sstr;
-                sstr << token;
-                tag.stringValues[i] = sstr.str();
-                token += tag.stringValues[i].size() + 1;
-            }
-            tags.push_back(tag);
+        const char *token = linebuf.c_str();
+        parseObjLine(&state, visitor, token, token + linebuf.size(), materials, err, readMatFn);
+    }
+    return (true);
+}
+
+inline bool LoadObjWithVisitor(ObjVisitor *visitor, std::vector<material_t> *materials, std::string *err,
+    const char *filename, const char *mtl_basedir)
+{
+    MappedFile file;
+    if (!file.open(filename)) {
+        std::stringstream errss;
+        errss << "Cannot open file [" << filename << "]" << std::endl;
+        if (err) {
+            (*err) = errss.str();
         }
+        return (false);
     }
-    bool ret = exportFaceGroupToShape(&shape, faceGroup, tags, material, name, triangulate);
-    if (ret || shape.mesh.indices.size()) {
-        shapes->push_back(shape);
+    MaterialFileReader matFileReader(mtl_basedir ? mtl_basedir : "");
+    parseObjBuffer(visitor, materials, err, file.data(), file.size(), &matFileReader);
+    return (true);
+}
+
+bool LoadObj(attrib_t *attrib, std::vector<shape_t> *shapes, std::vector<material_t> *materials, std::string *err, std::istream *inStream, MaterialReader *readMatFn, bool triangulate) {
+    ObjShapeBuilder builder(shapes, triangulate);
+    LoadObjWithVisitor(&builder, materials, err, inStream, readMatFn);
+    builder.finish(attrib);
+    return (true);
+}
+
+inline bool LoadObj(attrib_t *attrib, std::vector<shape_t> *shapes, std::vector<material_t> *materials, std::string *err, const char *filename, const char *mtl_basedir, bool triangulate, load_stats_t *stats, bool prescan) {
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    attrib->vertices.clear();
+    attrib->normals.clear();
+    attrib->texcoords.clear();
+    shapes->clear();
+    MappedFile file;
+    if (!file.open(filename)) {
+        std::stringstream errss;
+        errss << "Cannot open file [" << filename << "]" << std::endl;
+        if (err) {
+            (*err) = errss.str();
+        }
+        return (false);
+    }
+    std::string baseDir;
+    if (mtl_basedir) {
+        baseDir = mtl_basedir;
+    }
+    MaterialFileReader matFileReader(baseDir);
+    ObjShapeBuilder builder(shapes, triangulate);
+    obj_prescan_t scan;
+    double prescan_seconds = 0.0;
+    if (prescan) {
+        std::chrono::steady_clock::time_point prescan_start = std::chrono::steady_clock::now();
+        PrescanObj(file.data(), file.size(), &scan);
+        builder.reserve(scan);
+        prescan_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - prescan_start).count();
     }
-    faceGroup.clear();
-    if (err) {
-        (*err) += errss.str();
+    parseObjBuffer(&builder, materials, err, file.data(), file.size(), &matFileReader);
+    builder.finish(attrib);
+    if (stats) {
+        stats->face_group_allocations = builder.faceGroupAllocations();
+        stats->prescan_seconds = prescan_seconds;
+        stats->bytes = file.size();
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stats->megabytes_per_second = stats->seconds > 0.0 ? (static_cast<double>(stats->bytes) / (1024.0 * 1024.0)) / stats->seconds : 0.0;
     }
-    attrib->vertices.swap(v);
-    attrib->normals.swap(vn);
-    attrib->texcoords.swap(vt);
     return (true);
 }
@@ -0,0 +1,422 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * Binary cache of parsed OBJ/MTL data.
+ *
+ * `LoadObjCached` stores the output of LoadObj in `<file>.rtcache` next to the
+ * asset and reuses it on later runs. The cache records every file it was built
+ * from (the OBJ and each MTL it referenced, found or not) with its size, mtime
+ * (in nanoseconds) and a 64-bit content hash. A dependency whose size and
+ * mtime both match is valid without being read. When only the mtime differs,
+ * as after a fresh checkout, the content hash decides instead. An edit that
+ * keeps the size and lands within the timestamp granularity of the file
+ * system (whole seconds on Windows, FAT or HFS+) goes unnoticed; touch the
+ * file or delete the cache in that case. An MTL that was missing at build
+ * time stays valid only while it is still missing. The cache is also keyed on
+ * the triangulate flag and on mtl_basedir.
+ *
+ * Layout (little endian, native POD layout, unaligned):
+ *   header      magic "RTCACHE\0", version, triangulate flag, mtl_basedir
+ *   deps        count, then per file: path, missing flag, size, mtime (ns), hash
+ *   attrib      vertices, normals, texcoords
+ *   shapes      count, then per shape: name, indices, num_face_vertices,
+ *               material_ids, tags
+ *   materials   count, then every field of material_t
+ *
+ * Arrays are written as a u64 element count followed by the raw elements,
+ * strings as a u64 length followed by the bytes.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <new>
+#include <stdexcept>
+#include <sys/stat.h>
+#include "loaders/obj.h"
+#include "utils/serialization.h"
+
+#define OBJ_CACHE_MAGIC "RTCACHE"
+#define OBJ_CACHE_VERSION 3u
+#define OBJ_CACHE_EXTENSION ".rtcache"
+
+typedef struct {
+    std::string path;
+    bool missing;
+    uint64_t size;
+    int64_t mtime;
+    uint64_t hash;
+} cache_dependency_t;
+
+inline uint64_t cacheHash(const char *data, size_t size)
+{
+    const uint64_t m = 0x9E3779B97F4A7C15ULL;
+    uint64_t h = 0xCBF29CE484222325ULL ^ (size * m);
+    size_t i = 0;
+    for (; i + 8 <= size; i += 8) {
+        uint64_t k;
+        memcpy(&k, data + i, sizeof(k));
+        k *= m;
+        k ^= k >> 29;
+        h = (h ^ k) * 0xBF58476D1CE4E5B9ULL;
+        h ^= h >> 32;
+    }
+    uint64_t k = 0;
+    if (size > i) memcpy(&k, data + i, size - i);
+    h = (h ^ (k * m)) * 0x94D049BB133111EBULL;
+    h ^= h >> 31;
+    return (h);
+}
+
+inline bool cacheStat(const std::string &path, uint64_t *size, int64_t *mtime)
+{
+    struct stat st;
+    if (stat(path.c_str(), &st) != 0) return (false);
+    (*size) = static_cast<uint64_t>(st.st_size);
+#if defined(__APPLE__)
+    (*mtime) = static_cast<int64_t>(st.st_mtimespec.tv_sec) * 1000000000 + st.st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+    (*mtime) = static_cast<int64_t>(st.st_mtime) * 1000000000;
+#else
+    (*mtime) = static_cast<int64_t>(st.st_mtim.tv_sec) * 1000000000 + st.st_mtim.tv_nsec;
+#endif
+    return (true);
+}
+
+inline bool cacheDescribe(const std::string &path, cache_dependency_t *dep)
+{
+    MappedFile file;
+    dep->path = path;
+    dep->missing = false;
+    if (!cacheStat(path, &dep->size, &dep->mtime) || !file.open(path.c_str())) return (false);
+    dep->hash = cacheHash(file.data(), file.size());
+    return (true);
+}
+
+inline void cacheDescribeMissing(const std::string &path, cache_dependency_t *dep)
+{
+    dep->path = path;
+    dep->missing = true;
+    dep->size = 0;
+    dep->mtime = 0;
+    dep->hash = 0;
+}
+
+inline bool cacheDependencyValid(const cache_dependency_t &dep)
+{
+    uint64_t size;
+    int64_t mtime;
+    if (!cacheStat(dep.path, &size, &mtime)) return (dep.missing);
+    if (dep.missing || size != dep.size) return (false);
+    if (mtime == dep.mtime) return (true);
+    MappedFile file;
+    if (!file.open(dep.path.c_str())) return (false);
+    return (cacheHash(file.data(), file.size()) == dep.hash);
+}
+
+inline void writeCacheStrings(CacheWriter *w, const std::vector<std::string> &v)
+{
+    w->pod(static_cast<uint64_t>(v.size()));
+    for (size_t i = 0; i < v.size(); i++) w->str(v[i]);
+}
+
+inline bool readCacheStrings(CacheReader *r, std::vector<std::string> *v)
+{
+    uint64_t n = 0;
+    if (!r->count(&n, sizeof(uint64_t))) return (false);
+    v->resize(static_cast<size_t>(n));
+    for (size_t i = 0; i < v->size(); i++) {
+        if (!r->str(&(*v)[i])) return (false);
+    }
+    return (true);
+}
+
+inline void writeCacheMaterial(CacheWriter *w, const material_t &m)
+{
+    w->str(m.name);
+    w->pod(m.ambient); w->pod(m.diffuse); w->pod(m.specular);
+    w->pod(m.transmittance); w->pod(m.emission);
+    w->pod(m.shininess); w->pod(m.ior); w->pod(m.dissolve); w->pod(m.illum);
+    w->pod(m.roughness); w->pod(m.metallic); w->pod(m.sheen);
+    w->pod(m.clearcoat_thickness); w->pod(m.clearcoat_roughness);
+    w->pod(m.anisotropy); w->pod(m.anisotropy_rotation);
+#define X(n) w->str(m.n##_texname); w->pod(m.n##_texopt);
+    OBJ_MATERIAL_TEXTURES(X)
+#undef X
+    w->pod(static_cast<uint64_t>(m.unknown_parameter.size()));
+    for (std::map<std::string, std::string>::const_iterator it = m.unknown_parameter.begin(); it != m.unknown_parameter.end(); ++it) {
+        w->str(it->first);
+        w->str(it->second);
+    }
+}
+
+/*** @brief Bytes of a material with empty strings and no unknown parameters. */
+inline size_t cacheMaterialMinSize(void)
+{
+    material_t m;
+    CacheWriter w;
+    InitMaterial(&m);
+    writeCacheMaterial(&w, m);
+    return (w.buffer().size());
+}
+
+inline bool readCacheMaterial(CacheReader *r, material_t *m)
+{
+    InitMaterial(m);
+    r->str(&m->name);
+    r->pod(&m->ambient); r->pod(&m->diffuse); r->pod(&m->specular);
+    r->pod(&m->transmittance); r->pod(&m->emission);
+    r->pod(&m->shininess); r->pod(&m->ior); r->pod(&m->dissolve); r->pod(&m->illum);
+    r->pod(&m->roughness); r->pod(&m->metallic); r->pod(&m->sheen);
+    r->pod(&m->clearcoat_thickness); r->pod(&m->clearcoat_roughness);
+    r->pod(&m->anisotropy); r->pod(&m->anisotropy_rotation);
+#define X(n) r->str(&m->n##_texname); r->pod(&m->n##_texopt);
+    OBJ_MATERIAL_TEXTURES(X)
+#undef X
+    uint64_t count = 0;
+    if (!r->count(&count, 2 * sizeof(uint64_t))) return (false);
+    for (uint64_t i = 0; i < count && r->ok(); i++) {
+        std::string key, value;
+        r->str(&key);
+        r->str(&value);
+        m->unknown_parameter.insert(std::pair<std::string, std::string>(key, value));
+    }
+    return (r->ok());
+}
+
+/**
+ * Writes a cache file for already loaded data.
+ *
+ * @param deps The files the data was built from, the OBJ first.
+ * @param mtl_basedir The base directory the MTL files were looked up in.
+ */
+inline bool SaveObjCache(const char *cache_path, const std::vector<cache_dependency_t> &deps, bool triangulate,
+    const std::string &mtl_basedir, const attrib_t &attrib, const std::vector<shape_t> &shapes, const std::vector<material_t> &materials)
+{
+    CacheWriter w;
+    w.bytes(OBJ_CACHE_MAGIC, sizeof(OBJ_CACHE_MAGIC));
+    w.pod(static_cast<uint32_t>(OBJ_CACHE_VERSION));
+    w.pod(static_cast<uint32_t>(triangulate ? 1 : 0));
+    w.str(mtl_basedir);
+    w.pod(static_cast<uint64_t>(deps.size()));
+    for (size_t i = 0; i < deps.size(); i++) {
+        w.str(deps[i].path);
+        w.pod(static_cast<uint32_t>(deps[i].missing ? 1 : 0));
+        w.pod(deps[i].size);
+        w.pod(deps[i].mtime);
+        w.pod(deps[i].hash);
+    }
+    w.array(attrib.vertices);
+    w.array(attrib.normals);
+    w.array(attrib.texcoords);
+    w.pod(static_cast<uint64_t>(shapes.size()));
+    for (size_t i = 0; i < shapes.size(); i++) {
+        const mesh_t &mesh = shapes[i].mesh;
+        w.str(shapes[i].name);
+        w.array(mesh.indices);
+        w.array(mesh.num_face_vertices);
+        w.array(mesh.material_ids);
+        w.pod(static_cast<uint64_t>(mesh.tags.size()));
+        for (size_t t = 0; t < mesh.tags.size(); t++) {
+            w.str(mesh.tags[t].name);
+            w.array(mesh.tags[t].intValues);
+            w.array(mesh.tags[t].floatValues);
+            writeCacheStrings(&w, mesh.tags[t].stringValues);
+        }
+    }
+    w.pod(static_cast<uint64_t>(materials.size()));
+    for (size_t i = 0; i < materials.size(); i++) {
+        writeCacheMaterial(&w, materials[i]);
+    }
+
+    // Write to a temporary file first so a concurrent reader never sees a partial cache.
+    std::string tmp = std::string(cache_path) + ".tmp";
+    FILE *fp = fopen(tmp.c_str(), "wb");
+    if (!fp) return (false);
+    const std::vector<char> &buf = w.buffer();
+    bool ok = fwrite(&buf[0], 1, buf.size(), fp) == buf.size();
+    ok = (fclose(fp) == 0) && ok;
+    if (!ok || rename(tmp.c_str(), cache_path) != 0) {
+        remove(tmp.c_str());
+        return (false);
+    }
+    return (true);
+}
+
+/**
+ * Reads a cache file with a single mapping.
+ *
+ * @return False if the file is missing, malformed, built with another
+ *         triangulate setting or mtl_basedir or stale with respect to any
+ *         dependency. Counts that would not fit in the file, and allocation
+ *         failures, are treated as a malformed file.
+ */
+inline bool LoadObjCache(const char *cache_path, bool triangulate, const std::string &mtl_basedir,
+    attrib_t *attrib, std::vector<shape_t> *shapes, std::vector<material_t> *materials)
+{
+    MappedFile file;
+    if (!file.open(cache_path)) return (false);
+    CacheReader r(file.data(), file.size());
+    char magic[sizeof(OBJ_CACHE_MAGIC)];
+    uint32_t version = 0, flags = 0;
+    if (!r.bytes(magic, sizeof(magic)) || memcmp(magic, OBJ_CACHE_MAGIC, sizeof(magic)) != 0) return (false);
+    if (!r.pod(&version) || version != OBJ_CACHE_VERSION) return (false);
+    if (!r.pod(&flags) || (flags != 0) != triangulate) return (false);
+    // Minimum serialized sizes: path length, missing flag, size, mtime, hash
+    // for a dependency; name and three array lengths plus the tag count for a
+    // shape; name, two array lengths and the string count for a tag.
+    const size_t dep_size = 4 * sizeof(uint64_t) + sizeof(uint32_t);
+    const size_t shape_size = 5 * sizeof(uint64_t);
+    const size_t tag_size = 4 * sizeof(uint64_t);
+    try {
+        std::string basedir;
+        uint64_t count = 0;
+        if (!r.str(&basedir) || basedir != mtl_basedir) return (false);
+        if (!r.count(&count, dep_size) || count == 0) return (false);
+        for (uint64_t i = 0; i < count; i++) {
+            cache_dependency_t dep;
+            uint32_t missing = 0;
+            if (!r.str(&dep.path) || !r.pod(&missing) || !r.pod(&dep.size) || !r.pod(&dep.mtime) || !r.pod(&dep.hash)) return (false);
+            dep.missing = missing != 0;
+            if (!cacheDependencyValid(dep)) return (false);
+        }
+        attrib_t a;
+        std::vector<shape_t> s;
+        std::vector<material_t> m;
+        r.array(&a.vertices);
+        r.array(&a.normals);
+        r.array(&a.texcoords);
+        if (!r.count(&count, shape_size)) return (false);
+        s.resize(static_cast<size_t>(count));
+        for (size_t i = 0; i < s.size() && r.ok(); i++) {
+            mesh_t &mesh = s[i].mesh;
+            r.str(&s[i].name);
+            r.array(&mesh.indices);
+            r.array(&mesh.num_face_vertices);
+            r.array(&mesh.material_ids);
+            uint64_t tags = 0;
+            if (!r.count(&tags, tag_size)) return (false);
+            mesh.tags.resize(static_cast<size_t>(tags));
+            for (size_t t = 0; t < mesh.tags.size() && r.ok(); t++) {
+                r.str(&mesh.tags[t].name);
+                r.array(&mesh.tags[t].intValues);
+                r.array(&mesh.tags[t].floatValues);
+                readCacheStrings(&r, &mesh.tags[t].stringValues);
+            }
+        }
+        if (!r.count(&count, cacheMaterialMinSize())) return (false);
+        m.resize(static_cast<size_t>(count));
+        for (size_t i = 0; i < m.size(); i++) {
+            if (!readCacheMaterial(&r, &m[i])) return (false);
+        }
+        if (!r.ok()) return (false);
+        attrib->vertices.swap(a.vertices);
+        attrib->normals.swap(a.normals);
+        attrib->texcoords.swap(a.texcoords);
+        shapes->swap(s);
+        materials->swap(m);
+    } catch (const std::bad_alloc &) {
+        return (false);
+    } catch (const std::length_error &) {
+        return (false);
+    }
+    return (true);
+}
+
+/*** @brief MaterialFileReader that remembers which MTL files it loaded and which it could not find. */
+class RecordingMaterialFileReader : public MaterialFileReader {
+public:
+    explicit RecordingMaterialFileReader(const std::string &mtl_basedir) : MaterialFileReader(mtl_basedir), m_baseDir(mtl_basedir) {}
+    virtual bool operator()(const std::string &matId,
+                            std::vector<material_t> *materials,
+                            std::map<std::string, int> *matMap,
+                            std::string *err)
+    {
+        bool ok = MaterialFileReader::operator()(matId, materials, matMap, err);
+        (ok ? m_loaded : m_missing).push_back(m_baseDir + matId);
+        return (ok);
+    }
+    const std::vector<std::string> &loaded() const { return (m_loaded); }
+    const std::vector<std::string> &missing() const { return (m_missing); }
+private:
+    std::string m_baseDir;
+    std::vector<std::string> m_loaded;
+    std::vector<std::string> m_missing;
+};
+
+/**
+ * LoadObj backed by `<filename>.rtcache`. On a valid cache the text files are
+ * not parsed at all; otherwise the OBJ is parsed from its mapping and the
+ * cache is (re)written. A cache that cannot be written is not an error.
+ *
+ * @param cache_hit Optional, set to true when the data came from the cache.
+ */
+inline bool LoadObjCached(attrib_t *attrib, std::vector<shape_t> *shapes,
+    std::vector<material_t> *materials, std::string *err, const char *filename,
+    const char *mtl_basedir = NULL, bool triangulate = true, bool *cache_hit = NULL)
+{
+    std::string cache_path = std::string(filename) + OBJ_CACHE_EXTENSION;
+    std::string basedir = mtl_basedir ? mtl_basedir : "";
+    if (cache_hit) (*cache_hit) = false;
+    if (LoadObjCache(cache_path.c_str(), triangulate, basedir, attrib, shapes, materials)) {
+        if (cache_hit) (*cache_hit) = true;
+        return (true);
+    }
+    attrib->vertices.clear();
+    attrib->normals.clear();
+    attrib->texcoords.clear();
+    shapes->clear();
+    materials->clear();
+    MappedFile file;
+    if (!file.open(filename)) {
+        std::stringstream errss;
+        errss << "Cannot open file [" << filename << "]" << std::endl;
+        if (err) {
+            (*err) = errss.str();
+        }
+        return (false);
+    }
+    RecordingMaterialFileReader matFileReader(basedir);
+    ObjShapeBuilder builder(shapes, triangulate);
+    parseObjBuffer(&builder, materials, err, file.data(), file.size(), &matFileReader);
+    builder.finish(attrib);
+
+    const std::vector<std::string> &loaded = matFileReader.loaded();
+    const std::vector<std::string> &missing = matFileReader.missing();
+    std::vector<cache_dependency_t> deps(1 + loaded.size() + missing.size());
+    if (!cacheStat(filename, &deps[0].size, &deps[0].mtime)) return (true);
+    deps[0].path = filename;
+    deps[0].missing = false;
+    deps[0].hash = cacheHash(file.data(), file.size());
+    for (size_t i = 0; i < loaded.size(); i++) {
+        if (!cacheDescribe(loaded[i], &deps[1 + i])) return (true);
+    }
+    for (size_t i = 0; i < missing.size(); i++) {
+        cacheDescribeMissing(missing[i], &deps[1 + loaded.size() + i]);
+    }
+    SaveObjCache(cache_path.c_str(), deps, triangulate, basedir, *attrib, *shapes, *materials);
+    return (true);
+}
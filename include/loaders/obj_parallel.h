@@ -0,0 +1,315 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * Multi-threaded OBJ loading.
+ *
+ * The mapped file is cut into chunks at newline boundaries. Each worker parses
+ * the `v`/`vn`/`vt`/`f` lines of its chunk into chunk-local arrays, keeping
+ * face indices exactly as written together with the chunk-local attribute
+ * counts seen at that line. Every other line (`g`, `o`, `usemtl`, `mtllib`,
+ * `t`, ...) is recorded as a directive. The merge then walks the chunks in
+ * file order: it hands the visitor all the attributes of a chunk in bulk, then
+ * replays that chunk's faces and directives in file order through the serial
+ * line parser, resolving relative indices with `fixIndex` against the global
+ * counts.
+ *
+ * The visitor events are therefore not the serial sequence: within a chunk,
+ * attributes come before the faces and directives that precede them in the
+ * file. Attribute and face order is preserved, and every face only refers to
+ * attributes already emitted, so LoadObjParallel produces exactly the output
+ * of the serial LoadObj.
+ */
+
+#pragma once
+
+#include <climits>
+#include <thread>
+#include "loaders/obj.h"
+
+#define OBJ_MISSING_INDEX INT_MIN
+
+struct obj_chunk_face {
+    size_t first;
+    size_t count;
+    int v_count;
+    int vn_count;
+    int vt_count;
+};
+
+struct obj_chunk_directive {
+    const char *begin;
+    const char *end;
+    size_t face;
+};
+
+struct obj_chunk {
+    const char *begin;
+    const char *end;
+    std::vector<float> v;
+    std::vector<float> vn;
+    std::vector<float> vt;
+    std::vector<vertex_index> corners;
+    std::vector<obj_chunk_face> faces;
+    std::vector<obj_chunk_directive> directives;
+    std::string tail;
+};
+
+static vertex_index parseRawTriple(const char **token)
+{
+    vertex_index vi(OBJ_MISSING_INDEX);
+    vi.v_idx = atoi((*token));
+    (*token) += strcspn((*token), "/ \t\r\n");
+    if ((*token)[0] != '/') {
+        return (vi);
+    }
+    (*token)++;
+    if ((*token)[0] == '/') {
+        (*token)++;
+        vi.vn_idx = atoi((*token));
+        (*token) += strcspn((*token), "/ \t\r\n");
+        return (vi);
+    }
+    vi.vt_idx = atoi((*token));
+    (*token) += strcspn((*token), "/ \t\r\n");
+    if ((*token)[0] != '/') {
+        return (vi);
+    }
+    (*token)++;
+    vi.vn_idx = atoi((*token));
+    (*token) += strcspn((*token), "/ \t\r\n");
+    return (vi);
+}
+
+static inline int fixRawIndex(int idx, int n)
+{
+    if (idx == OBJ_MISSING_INDEX) return (-1);
+    return (fixIndex(idx, n));
+}
+
+static void parseObjChunkLine(obj_chunk *chunk, const char *line, const char *line_end)
+{
+    const char *token = line + strspn(line, " \t");
+    if (token >= line_end) return;
+    if (token[0] == '#') return;
+    if (token[0] == 'v' && IS_SPACE((token[1]))) {
+        token += 2;
+        float x, y, z;
+        parseReal3(&x, &y, &z, &token);
+        chunk->v.push_back(x);
+        chunk->v.push_back(y);
+        chunk->v.push_back(z);
+        return;
+    }
+    if (token[0] == 'v' && token[1] == 'n' && IS_SPACE((token[2]))) {
+        token += 3;
+        float x, y, z;
+        parseReal3(&x, &y, &z, &token);
+        chunk->vn.push_back(x);
+        chunk->vn.push_back(y);
+        chunk->vn.push_back(z);
+        return;
+    }
+    if (token[0] == 'v' && token[1] == 't' && IS_SPACE((token[2]))) {
+        token += 3;
+        float x, y;
+        parseReal2(&x, &y, &token);
+        chunk->vt.push_back(x);
+        chunk->vt.push_back(y);
+        return;
+    }
+    if (token[0] == 'f' && IS_SPACE((token[1]))) {
+        token += 2;
+        token += strspn(token, " \t");
+        obj_chunk_face face;
+        face.first = chunk->corners.size();
+        face.v_count = static_cast<int>(chunk->v.size() / 3);
+        face.vn_count = static_cast<int>(chunk->vn.size() / 3);
+        face.vt_count = static_cast<int>(chunk->vt.size() / 2);
+        while (!IS_NEW_LINE(token[0])) {
+            chunk->corners.push_back(parseRawTriple(&token));
+            token += strspn(token, " \t\r");
+        }
+        face.count = chunk->corners.size() - face.first;
+        chunk->faces.push_back(face);
+        return;
+    }
+    obj_chunk_directive directive;
+    directive.begin = line;
+    directive.end = line_end;
+    directive.face = chunk->faces.size();
+    chunk->directives.push_back(directive);
+}
+
+static void parseObjChunk(obj_chunk *chunk)
+{
+    const char *cur = chunk->begin;
+    while (cur < chunk->end) {
+        const char *eol = static_cast<const char *>(memchr(cur, '\n', static_cast<size_t>(chunk->end - cur)));
+        if (!eol) {
+            chunk->tail.assign(cur, chunk->end);
+            if (!chunk->tail.empty() && chunk->tail[chunk->tail.size() - 1] == '\r') chunk->tail.erase(chunk->tail.size() - 1);
+            parseObjChunkLine(chunk, chunk->tail.c_str(), chunk->tail.c_str() + chunk->tail.size());
+            break;
+        }
+        const char *line_end = (eol > cur && eol[-1] == '\r') ? eol - 1 : eol;
+        if (line_end > cur) {
+            parseObjChunkLine(chunk, cur, line_end);
+        }
+        cur = eol + 1;
+    }
+}
+
+static void mergeObjChunkFace(obj_parser_state *state, ObjVisitor *visitor, const obj_chunk &chunk,
+    const obj_chunk_face &face, int v_base, int vn_base, int vt_base)
+{
+    state->face.resize(face.count);
+    for (size_t k = 0; k < face.count; k++) {
+        const vertex_index &raw = chunk.corners[face.first + k];
+        state->face[k].v_idx = fixRawIndex(raw.v_idx, v_base + face.v_count);
+        state->face[k].vn_idx = fixRawIndex(raw.vn_idx, vn_base + face.vn_count);
+        state->face[k].vt_idx = fixRawIndex(raw.vt_idx, vt_base + face.vt_count);
+    }
+    if (face.count) {
+        visitor->face(&state->face[0], face.count);
+    }
+}
+
+/**
+ * Parallel variant of the mapped LoadObjWithVisitor. Workers only parse; all
+ * visitor events are emitted from the calling thread. Faces, directives and
+ * attributes each arrive in file order, but the attributes of a chunk are
+ * emitted before its faces and directives (see above), so a visitor must not
+ * rely on how attribute events interleave with the others.
+ * `num_threads` set to 0 uses std::thread::hardware_concurrency().
+ */
+inline bool LoadObjParallelWithVisitor(ObjVisitor *visitor, std::vector<material_t> *materials,
+    std::string *err, const char *filename, const char *mtl_basedir = NULL,
+    unsigned int num_threads = 0, size_t *bytes = NULL)
+{
+    static const size_t min_chunk_size = 256 * 1024;
+    MappedFile file;
+    if (!file.open(filename)) {
+        std::stringstream errss;
+        errss << "Cannot open file [" << filename << "]" << std::endl;
+        if (err) {
+            (*err) = errss.str();
+        }
+        return (false);
+    }
+    if (bytes) {
+        (*bytes) = file.size();
+    }
+    if (num_threads == 0) {
+        num_threads = std::max(1u, std::thread::hardware_concurrency());
+    }
+    size_t num_chunks = std::max(static_cast<size_t>(1), std::min(static_cast<size_t>(num_threads), file.size() / min_chunk_size));
+    std::vector<obj_chunk> chunks(num_chunks);
+    const char *data = file.data();
+    const char *end = data + file.size();
+    const char *cur = data;
+    for (size_t i = 0; i < num_chunks; i++) {
+        const char *split = (i + 1 == num_chunks) ? end : data + (file.size() / num_chunks) * (i + 1);
+        if (split < cur) split = cur;
+        if (split < end) {
+            const char *eol = static_cast<const char *>(memchr(split, '\n', static_cast<size_t>(end - split)));
+            split = eol ? eol + 1 : end;
+        }
+        chunks[i].begin = cur;
+        chunks[i].end = split;
+        cur = split;
+    }
+
+    std::vector<std::thread> workers;
+    workers.reserve(num_chunks - 1);
+    for (size_t i = 1; i < num_chunks; i++) {
+        workers.push_back(std::thread(parseObjChunk, &chunks[i]));
+    }
+    if (num_chunks > 0) {
+        parseObjChunk(&chunks[0]);
+    }
+    for (size_t i = 0; i < workers.size(); i++) {
+        workers[i].join();
+    }
+
+    obj_parser_state state;
+    MaterialFileReader matFileReader(mtl_basedir ? mtl_basedir : "");
+    for (size_t i = 0; i < num_chunks; i++) {
+        obj_chunk &chunk = chunks[i];
+        int v_base = state.v_count;
+        int vn_base = state.vn_count;
+        int vt_base = state.vt_count;
+        if (!chunk.v.empty()) visitor->vertices(&chunk.v[0], chunk.v.size() / 3);
+        if (!chunk.vn.empty()) visitor->normals(&chunk.vn[0], chunk.vn.size() / 3);
+        if (!chunk.vt.empty()) visitor->texcoords(&chunk.vt[0], chunk.vt.size() / 2);
+        state.v_count += static_cast<int>(chunk.v.size() / 3);
+        state.vn_count += static_cast<int>(chunk.vn.size() / 3);
+        state.vt_count += static_cast<int>(chunk.vt.size() / 2);
+        size_t f = 0;
+        for (size_t d = 0; d < chunk.directives.size(); d++) {
+            const obj_chunk_directive &directive = chunk.directives[d];
+            for (; f < directive.face; f++) {
+                mergeObjChunkFace(&state, visitor, chunk, chunk.faces[f], v_base, vn_base, vt_base);
+            }
+            parseObjLine(&state, visitor, directive.begin, directive.end, materials, err, &matFileReader);
+        }
+        for (; f < chunk.faces.size(); f++) {
+            mergeObjChunkFace(&state, visitor, chunk, chunk.faces[f], v_base, vn_base, vt_base);
+        }
+        std::vector<float>().swap(chunk.v);
+        std::vector<float>().swap(chunk.vn);
+        std::vector<float>().swap(chunk.vt);
+    }
+    return (true);
+}
+
+/**
+ * Parallel variant of the memory-mapped LoadObj. The output is identical to
+ * the serial loader for the same file.
+ */
+inline bool LoadObjParallel(attrib_t *attrib, std::vector<shape_t> *shapes,
+    std::vector<material_t> *materials, std::string *err, const char *filename,
+    const char *mtl_basedir = NULL, bool triangulate = true, unsigned int num_threads = 0,
+    load_stats_t *stats = NULL)
+{
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    attrib->vertices.clear();
+    attrib->normals.clear();
+    attrib->texcoords.clear();
+    shapes->clear();
+    ObjShapeBuilder builder(shapes, triangulate);
+    size_t bytes = 0;
+    if (!LoadObjParallelWithVisitor(&builder, materials, err, filename, mtl_basedir, num_threads, &bytes)) {
+        return (false);
+    }
+    builder.finish(attrib);
+    if (stats) {
+        stats->face_group_allocations = builder.faceGroupAllocations();
+        stats->prescan_seconds = 0.0;
+        stats->bytes = bytes;
+        stats->seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+        stats->megabytes_per_second = stats->seconds > 0.0 ? (static_cast<double>(stats->bytes) / (1024.0 * 1024.0)) / stats->seconds : 0.0;
+    }
+    return (true);
+}
@@ -0,0 +1,198 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * Post-load vertex welding.
+ *
+ * OBJ corners reference positions, normals and texcoords through three
+ * independent indices (index_t). WeldMesh deduplicates the (v, vn, vt)
+ * triples of a shape with an open-addressing hash table and emits one vertex
+ * per unique triple plus a single 32-bit index stream, so a renderer gathers
+ * from one buffer per hit.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "loaders/obj.h"
+
+typedef enum {
+    WELD_LAYOUT_SOA,
+    WELD_LAYOUT_INTERLEAVED
+} weld_layout_t;
+
+#define WELD_INTERLEAVED_STRIDE 8
+
+typedef struct {
+    weld_layout_t layout;
+    // WELD_LAYOUT_SOA: one array per attribute; normals/texcoords are empty
+    // when no corner of the shape references them.
+    std::vector<float> positions;
+    std::vector<float> normals;
+    std::vector<float> texcoords;
+    // WELD_LAYOUT_INTERLEAVED: px py pz nx ny nz u v per vertex.
+    std::vector<float> interleaved;
+    std::vector<uint32_t> indices;
+    std::vector<unsigned char> num_face_vertices;
+    std::vector<int> material_ids;
+    size_t num_vertices;
+} welded_mesh_t;
+
+typedef struct {
+    size_t corners;
+    size_t unique_vertices;
+    size_t bytes_before;
+    size_t bytes_after;
+    // Attribute indices of unique vertices past the end of their attrib_t
+    // array; those attributes are output as 0 like missing ones.
+    size_t bad_indices;
+} weld_stats_t;
+
+static inline uint32_t weldHash(const index_t &idx)
+{
+    uint64_t h = static_cast<uint32_t>(idx.vertex_index) * 0x9E3779B97F4A7C15ULL;
+    h ^= static_cast<uint32_t>(idx.normal_index) * 0xC2B2AE3D27D4EB4FULL;
+    h ^= static_cast<uint32_t>(idx.texcoord_index) * 0x165667B19E3779F9ULL;
+    h ^= h >> 29;
+    return (static_cast<uint32_t>(h));
+}
+
+// Returns false for an index past the end of src, which reads as missing.
+static inline bool weldFetch(const std::vector<float> &src, int index, int components, float *dst)
+{
+    bool in_range = index < 0 || static_cast<size_t>(index) < src.size() / components;
+    for (int c = 0; c < components; c++) {
+        dst[c] = (index >= 0 && in_range) ? src[static_cast<size_t>(index) * components + c] : 0.0f;
+    }
+    return (in_range);
+}
+
+/**
+ * Welds one shape.
+ *
+ * @param stats Optional. bytes_before counts the shape's index_t corners;
+ *              the shared attrib_t arrays are accounted by WeldMeshes.
+ */
+inline void WeldMesh(const attrib_t &attrib, const shape_t &shape, welded_mesh_t *out,
+    weld_layout_t layout = WELD_LAYOUT_SOA, weld_stats_t *stats = NULL)
+{
+    const std::vector<index_t> &corners = shape.mesh.indices;
+    bool has_normals = false, has_texcoords = false;
+    for (size_t i = 0; i < corners.size(); i++) {
+        has_normals = has_normals || corners[i].normal_index >= 0;
+        has_texcoords = has_texcoords || corners[i].texcoord_index >= 0;
+    }
+
+    size_t capacity = 16;
+    while (capacity < corners.size() * 2) capacity <<= 1;
+    const uint32_t empty = 0xFFFFFFFFu;
+    std::vector<uint32_t> table(capacity, empty);
+    std::vector<index_t> unique;
+    unique.reserve(corners.size() / 2 + 1);
+
+    out->layout = layout;
+    out->indices.resize(corners.size());
+    for (size_t i = 0; i < corners.size(); i++) {
+        const index_t &key = corners[i];
+        size_t slot = weldHash(key) & (capacity - 1);
+        for (;;) {
+            uint32_t v = table[slot];
+            if (v == empty) {
+                v = static_cast<uint32_t>(unique.size());
+                table[slot] = v;
+                unique.push_back(key);
+                out->indices[i] = v;
+                break;
+            }
+            const index_t &other = unique[v];
+            if (other.vertex_index == key.vertex_index && other.normal_index == key.normal_index && other.texcoord_index == key.texcoord_index) {
+                out->indices[i] = v;
+                break;
+            }
+            slot = (slot + 1) & (capacity - 1);
+        }
+    }
+
+    size_t bad_indices = 0;
+    out->num_vertices = unique.size();
+    out->positions.clear();
+    out->normals.clear();
+    out->texcoords.clear();
+    out->interleaved.clear();
+    if (layout == WELD_LAYOUT_SOA) {
+        out->positions.resize(unique.size() * 3);
+        if (has_normals) out->normals.resize(unique.size() * 3);
+        if (has_texcoords) out->texcoords.resize(unique.size() * 2);
+        for (size_t i = 0; i < unique.size(); i++) {
+            bad_indices += !weldFetch(attrib.vertices, unique[i].vertex_index, 3, &out->positions[i * 3]);
+            if (has_normals) bad_indices += !weldFetch(attrib.normals, unique[i].normal_index, 3, &out->normals[i * 3]);
+            if (has_texcoords) bad_indices += !weldFetch(attrib.texcoords, unique[i].texcoord_index, 2, &out->texcoords[i * 2]);
+        }
+    } else {
+        out->interleaved.resize(unique.size() * WELD_INTERLEAVED_STRIDE);
+        for (size_t i = 0; i < unique.size(); i++) {
+            float *dst = &out->interleaved[i * WELD_INTERLEAVED_STRIDE];
+            bad_indices += !weldFetch(attrib.vertices, unique[i].vertex_index, 3, dst);
+            bad_indices += !weldFetch(attrib.normals, has_normals ? unique[i].normal_index : -1, 3, dst + 3);
+            bad_indices += !weldFetch(attrib.texcoords, has_texcoords ? unique[i].texcoord_index : -1, 2, dst + 6);
+        }
+    }
+    out->num_face_vertices = shape.mesh.num_face_vertices;
+    out->material_ids = shape.mesh.material_ids;
+
+    if (stats) {
+        stats->corners = corners.size();
+        stats->unique_vertices = unique.size();
+        stats->bytes_before = corners.size() * sizeof(index_t);
+        stats->bytes_after = (out->positions.size() + out->normals.size() + out->texcoords.size() + out->interleaved.size()) * sizeof(float)
+            + out->indices.size() * sizeof(uint32_t);
+        stats->bad_indices = bad_indices;
+    }
+}
+
+/**
+ * Welds every shape of a loaded file.
+ *
+ * @param stats Optional totals. bytes_before includes the attrib_t arrays,
+ *              since the welded meshes replace them entirely.
+ */
+inline void WeldMeshes(const attrib_t &attrib, const std::vector<shape_t> &shapes,
+    std::vector<welded_mesh_t> *out, weld_layout_t layout = WELD_LAYOUT_SOA, weld_stats_t *stats = NULL)
+{
+    out->resize(shapes.size());
+    weld_stats_t total = {0, 0, 0, 0, 0};
+    total.bytes_before = (attrib.vertices.size() + attrib.normals.size() + attrib.texcoords.size()) * sizeof(float);
+    for (size_t i = 0; i < shapes.size(); i++) {
+        weld_stats_t s;
+        WeldMesh(attrib, shapes[i], &(*out)[i], layout, &s);
+        total.corners += s.corners;
+        total.unique_vertices += s.unique_vertices;
+        total.bytes_before += s.bytes_before;
+        total.bytes_after += s.bytes_after;
+        total.bad_indices += s.bad_indices;
+    }
+    if (stats) {
+        (*stats) = total;
+    }
+}
@@ -0,0 +1,198 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#pragma once
+
+#include "maths/mat4.h"
+
+/**
+ * @brief Affine transform stored as the top three rows of a Mat4.
+ *
+ * The bottom row of an affine Mat4 is always (0, 0, 0, 1), so it is not
+ * stored: 48 bytes instead of 64 per instance. Same layout as Mat4 (the
+ * translation is column 3), same results as the matching Mat4 methods.
+ */
+struct Affine3x4
+{
+    public:
+        /*** @brief Default constructor initializes the transform to identity. */
+        Affine3x4(void);
+
+        /**
+         * @brief Keeps the top three rows of a matrix.
+         *
+         * @param m The matrix; its bottom row is assumed to be (0, 0, 0, 1).
+         */
+        explicit Affine3x4(const Mat4& m);
+
+        /**
+         * @brief Expands back to a 4x4 matrix.
+         *
+         * @return The matrix with bottom row (0, 0, 0, 1).
+         */
+        Mat4 ToMat4(void) const;
+
+        /**
+         * @brief Composes two transforms: (a * b) applies b first.
+         *
+         * @param b The transform to apply first.
+         *
+         * @return The composed transform.
+         */
+        Affine3x4 operator*(const Affine3x4& b) const;
+
+        /**
+         * @brief Transforms a point.
+         *
+         * @param pts The point to transform.
+         *
+         * @return The transformed point, as Mat4::MultiplyPoint3x4.
+         */
+        Vec3 MultiplyPoint(const Vec3& pts) const;
+
+        /**
+         * @brief Transforms a vector (ignoring translation).
+         *
+         * @param v The vector to transform.
+         *
+         * @return The transformed vector, as Mat4::MultiplyVector.
+         */
+        Vec3 MultiplyVector(const Vec3& v) const;
+
+        /*** @brief MultiplyPoint over an array of float3, see Transform::Points3x4. */
+        void MultiplyPoints(const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count, ThreadPool* pool = NULL) const;
+
+        /*** @brief MultiplyVector over an array of float3, see Transform::Vectors. */
+        void MultiplyVectors(const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count, ThreadPool* pool = NULL) const;
+
+        /**
+         * @brief Inverse transform, e.g. world to object space for instanced
+         *        ray intersection.
+         *
+         * @return The inverse, or an all-zero transform if singular.
+         */
+        Affine3x4 Inverse(void) const;
+
+        /**
+         * @brief Inverse transpose of the linear part, with no translation.
+         *
+         * @return The normal transform, or an all-zero transform if singular.
+         */
+        Affine3x4 NormalMatrix(void) const;
+
+        /** Data storage: rows 0 to 2 of the equivalent Mat4. */
+        float data[3][4];
+};
+
+inline Affine3x4::Affine3x4(void)
+{
+    data[0][0] = 1.0F; data[0][1] = 0.0F; data[0][2] = 0.0F; data[0][3] = 0.0F;
+    data[1][0] = 0.0F; data[1][1] = 1.0F; data[1][2] = 0.0F; data[1][3] = 0.0F;
+    data[2][0] = 0.0F; data[2][1] = 0.0F; data[2][2] = 1.0F; data[2][3] = 0.0F;
+};
+
+inline Affine3x4::Affine3x4(const Mat4& m)
+{
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 4; j++)
+            data[i][j] = m.data[i][j];
+};
+
+inline Mat4 Affine3x4::ToMat4(void) const
+{
+    Mat4 out;
+
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 4; j++)
+            out.data[i][j] = data[i][j];
+    return (out);
+};
+
+inline Affine3x4 Affine3x4::operator*(const Affine3x4& b) const
+{
+    Affine3x4 out;
+
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 4; j++)
+            out.data[i][j] = (data[i][0] * b.data[0][j]) + (data[i][1] * b.data[1][j]) + (data[i][2] * b.data[2][j]);
+        out.data[i][3] += data[i][3];
+    }
+    return (out);
+};
+
+inline Vec3 Affine3x4::MultiplyPoint(const Vec3& pts) const
+{
+    Vec3 out;
+
+    out.x = data[0][0] * pts.x + data[0][1] * pts.y + data[0][2] * pts.z + data[0][3];
+    out.y = data[1][0] * pts.x + data[1][1] * pts.y + data[1][2] * pts.z + data[1][3];
+    out.z = data[2][0] * pts.x + data[2][1] * pts.y + data[2][2] * pts.z + data[2][3];
+    return (out);
+};
+
+inline Vec3 Affine3x4::MultiplyVector(const Vec3& v) const
+{
+    Vec3 out;
+
+    out.x = data[0][0] * v.x + data[0][1] * v.y + data[0][2] * v.z;
+    out.y = data[1][0] * v.x + data[1][1] * v.y + data[1][2] * v.z;
+    out.z = data[2][0] * v.x + data[2][1] * v.y + data[2][2] * v.z;
+    return (out);
+};
+
+inline void Affine3x4::MultiplyPoints(const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count, ThreadPool* pool) const
+{
+    Transform::Points3x4(data, src, srcStride, dst, dstStride, count, pool);
+};
+
+inline void Affine3x4::MultiplyVectors(const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count, ThreadPool* pool) const
+{
+    Transform::Vectors(data, src, srcStride, dst, dstStride, count, pool);
+};
+
+inline Affine3x4 Affine3x4::Inverse(void) const
+{
+    Affine3x4 out;
+
+    if (!Simd::AffineInverse(data, out.data))
+    {
+        for (int i = 0; i < 3; i++)
+            for (int j = 0; j < 4; j++)
+                out.data[i][j] = 0.0F;
+    }
+    return (out);
+};
+
+inline Affine3x4 Affine3x4::NormalMatrix(void) const
+{
+    Affine3x4 out;
+
+    if (!Simd::NormalMatrix(data, out.data))
+    {
+        for (int i = 0; i < 3; i++)
+            out.data[i][0] = out.data[i][1] = out.data[i][2] = 0.0F;
+    }
+    return (out);
+};
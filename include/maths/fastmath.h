@@ -0,0 +1,541 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "config.h"
+
+/**
+ * Fast approximations of the libm transcendental functions.
+ *
+ * Each function exists in two tiers, selected by template argument:
+ *
+ *   FastMath::Precise  Cephes single-precision polynomials, 1 to 4 ulp
+ *                      (the bound is given per function).
+ *   FastMath::Fast     Shorter minimax polynomials for sampling and shading:
+ *                      relative error below 1e-4, absolute below 2e-5 for
+ *                      sin and cos.
+ *
+ * Both tiers share the range reductions and handle specials (0, inf, NaN,
+ * overflow) like libm. The bounds were measured against double-precision
+ * libm by bench/bench_fastmath.cpp.
+ *
+ * Every function has a scalar entry point and a batch entry point working on
+ * arrays; the batch one runs the same operation sequence on 8 (AVX2) or 4
+ * (SSE) lanes, so both give bit-identical results as long as the compiler
+ * does not contract them into FMAs (-ffp-contract=off). Denormal results of
+ * Exp are flushed to zero.
+ */
+
+/*** @brief Scalar lanes: masks are floats with all bits set or cleared. */
+struct FastMathScalarOps
+{
+    public:
+        typedef float F;
+        typedef int32_t I;
+
+        static inline F Load(const float* p) { return (*p); };
+        static inline void Store(float* p, F a) { (*p) = a; };
+        static inline F Set(float a) { return (a); };
+        static inline I SetI(int32_t a) { return (a); };
+        static inline F Add(F a, F b) { return (a + b); };
+        static inline F Sub(F a, F b) { return (a - b); };
+        static inline F Mul(F a, F b) { return (a * b); };
+        static inline F Div(F a, F b) { return (a / b); };
+        // Same NaN behaviour as minps/maxps: the second operand wins when unordered.
+        static inline F Min(F a, F b) { return ((a < b) ? a : b); };
+        static inline F Max(F a, F b) { return ((a > b) ? a : b); };
+        static inline I AsI(F a) { I i; memcpy(&i, &a, sizeof(i)); return (i); };
+        static inline F AsF(I a) { F f; memcpy(&f, &a, sizeof(f)); return (f); };
+        static inline F And(F a, F b) { return (AsF(AsI(a) & AsI(b))); };
+        static inline F Or(F a, F b) { return (AsF(AsI(a) | AsI(b))); };
+        static inline F Xor(F a, F b) { return (AsF(AsI(a) ^ AsI(b))); };
+        static inline F Mask(bool b) { return (AsF(b ? -1 : 0)); };
+        static inline F Less(F a, F b) { return (Mask(a < b)); };
+        static inline F Greater(F a, F b) { return (Mask(a > b)); };
+        static inline F Equal(F a, F b) { return (Mask(a == b)); };
+        static inline F Select(F m, F a, F b) { return (AsF((AsI(m) & AsI(a)) | (~AsI(m) & AsI(b)))); };
+        static inline I AddI(I a, I b) { return (static_cast<I>(static_cast<uint32_t>(a) + static_cast<uint32_t>(b))); };
+        static inline I SubI(I a, I b) { return (static_cast<I>(static_cast<uint32_t>(a) - static_cast<uint32_t>(b))); };
+        static inline I AndI(I a, I b) { return (a & b); };
+        static inline I OrI(I a, I b) { return (a | b); };
+        static inline I EqualI(I a, I b) { return (a == b ? -1 : 0); };
+        template <int N> static inline I Shl(I a) { return (static_cast<I>(static_cast<uint32_t>(a) << N)); };
+        template <int N> static inline I Sra(I a) { return (a >= 0 ? a >> N : ~(~a >> N)); };
+        template <int N> static inline I Srl(I a) { return (static_cast<I>(static_cast<uint32_t>(a) >> N)); };
+        static inline F ToF(I a) { return (static_cast<F>(a)); };
+        // cvttps2dq returns INT32_MIN for NaN and out-of-range inputs.
+        static inline I TruncI(F a) { return ((a > -2147483648.0F && a < 2147483648.0F) ? static_cast<I>(a) : INT32_MIN); };
+};
+
+#if defined(RT_SIMD_SSE)
+struct FastMathSseOps
+{
+    public:
+        typedef __m128 F;
+        typedef __m128i I;
+
+        static inline F Load(const float* p) { return (_mm_loadu_ps(p)); };
+        static inline void Store(float* p, F a) { _mm_storeu_ps(p, a); };
+        static inline F Set(float a) { return (_mm_set1_ps(a)); };
+        static inline I SetI(int32_t a) { return (_mm_set1_epi32(a)); };
+        static inline F Add(F a, F b) { return (_mm_add_ps(a, b)); };
+        static inline F Sub(F a, F b) { return (_mm_sub_ps(a, b)); };
+        static inline F Mul(F a, F b) { return (_mm_mul_ps(a, b)); };
+        static inline F Div(F a, F b) { return (_mm_div_ps(a, b)); };
+        static inline F Min(F a, F b) { return (_mm_min_ps(a, b)); };
+        static inline F Max(F a, F b) { return (_mm_max_ps(a, b)); };
+        static inline I AsI(F a) { return (_mm_castps_si128(a)); };
+        static inline F AsF(I a) { return (_mm_castsi128_ps(a)); };
+        static inline F And(F a, F b) { return (_mm_and_ps(a, b)); };
+        static inline F Or(F a, F b) { return (_mm_or_ps(a, b)); };
+        static inline F Xor(F a, F b) { return (_mm_xor_ps(a, b)); };
+        static inline F Less(F a, F b) { return (_mm_cmplt_ps(a, b)); };
+        static inline F Greater(F a, F b) { return (_mm_cmpgt_ps(a, b)); };
+        static inline F Equal(F a, F b) { return (_mm_cmpeq_ps(a, b)); };
+        static inline F Select(F m, F a, F b) { return (_mm_or_ps(_mm_and_ps(m, a), _mm_andnot_ps(m, b))); };
+        static inline I AddI(I a, I b) { return (_mm_add_epi32(a, b)); };
+        static inline I SubI(I a, I b) { return (_mm_sub_epi32(a, b)); };
+        static inline I AndI(I a, I b) { return (_mm_and_si128(a, b)); };
+        static inline I OrI(I a, I b) { return (_mm_or_si128(a, b)); };
+        static inline I EqualI(I a, I b) { return (_mm_cmpeq_epi32(a, b)); };
+        template <int N> static inline I Shl(I a) { return (_mm_slli_epi32(a, N)); };
+        template <int N> static inline I Sra(I a) { return (_mm_srai_epi32(a, N)); };
+        template <int N> static inline I Srl(I a) { return (_mm_srli_epi32(a, N)); };
+        static inline F ToF(I a) { return (_mm_cvtepi32_ps(a)); };
+        static inline I TruncI(F a) { return (_mm_cvttps_epi32(a)); };
+};
+#endif
+
+#if defined(RT_SIMD_AVX2)
+struct FastMathAvxOps
+{
+    public:
+        typedef __m256 F;
+        typedef __m256i I;
+
+        static inline F Load(const float* p) { return (_mm256_loadu_ps(p)); };
+        static inline void Store(float* p, F a) { _mm256_storeu_ps(p, a); };
+        static inline F Set(float a) { return (_mm256_set1_ps(a)); };
+        static inline I SetI(int32_t a) { return (_mm256_set1_epi32(a)); };
+        static inline F Add(F a, F b) { return (_mm256_add_ps(a, b)); };
+        static inline F Sub(F a, F b) { return (_mm256_sub_ps(a, b)); };
+        static inline F Mul(F a, F b) { return (_mm256_mul_ps(a, b)); };
+        static inline F Div(F a, F b) { return (_mm256_div_ps(a, b)); };
+        static inline F Min(F a, F b) { return (_mm256_min_ps(a, b)); };
+        static inline F Max(F a, F b) { return (_mm256_max_ps(a, b)); };
+        static inline I AsI(F a) { return (_mm256_castps_si256(a)); };
+        static inline F AsF(I a) { return (_mm256_castsi256_ps(a)); };
+        static inline F And(F a, F b) { return (_mm256_and_ps(a, b)); };
+        static inline F Or(F a, F b) { return (_mm256_or_ps(a, b)); };
+        static inline F Xor(F a, F b) { return (_mm256_xor_ps(a, b)); };
+        static inline F Less(F a, F b) { return (_mm256_cmp_ps(a, b, _CMP_LT_OQ)); };
+        static inline F Greater(F a, F b) { return (_mm256_cmp_ps(a, b, _CMP_GT_OQ)); };
+        static inline F Equal(F a, F b) { return (_mm256_cmp_ps(a, b, _CMP_EQ_OQ)); };
+        static inline F Select(F m, F a, F b) { return (_mm256_blendv_ps(b, a, m)); };
+        static inline I AddI(I a, I b) { return (_mm256_add_epi32(a, b)); };
+        static inline I SubI(I a, I b) { return (_mm256_sub_epi32(a, b)); };
+        static inline I AndI(I a, I b) { return (_mm256_and_si256(a, b)); };
+        static inline I OrI(I a, I b) { return (_mm256_or_si256(a, b)); };
+        static inline I EqualI(I a, I b) { return (_mm256_cmpeq_epi32(a, b)); };
+        template <int N> static inline I Shl(I a) { return (_mm256_slli_epi32(a, N)); };
+        template <int N> static inline I Sra(I a) { return (_mm256_srai_epi32(a, N)); };
+        template <int N> static inline I Srl(I a) { return (_mm256_srli_epi32(a, N)); };
+        static inline F ToF(I a) { return (_mm256_cvtepi32_ps(a)); };
+        static inline I TruncI(F a) { return (_mm256_cvttps_epi32(a)); };
+};
+#endif
+
+struct FastMath
+{
+    public:
+        /*** @brief Accuracy tiers, see the file comment. */
+        enum Tier { Precise, Fast };
+
+        /**
+         * @brief Sine. Precise: at most 2 ulp on [-pi, pi], absolute error
+         *        below 1e-7 up to |x| = 8192; accuracy degrades beyond.
+         *
+         * @param x Angle in radians.
+         *
+         * @return sin(x).
+         */
+        template <int T = Precise> static inline float Sin(float x);
+
+        /*** @brief Cosine. Same domain and error as Sin. */
+        template <int T = Precise> static inline float Cos(float x);
+
+        /**
+         * @brief Sine and cosine sharing one range reduction.
+         *
+         * @param x Angle in radians.
+         * @param s Receives sin(x).
+         * @param c Receives cos(x).
+         */
+        template <int T = Precise> static inline void SinCos(float x, float* s, float* c);
+
+        /*** @brief e^x. Precise: at most 1 ulp. Overflows to inf above ln(FLT_MAX), 0 below ln(FLT_MIN). */
+        template <int T = Precise> static inline float Exp(float x);
+
+        /*** @brief Natural logarithm. Precise: at most 1 ulp, denormals included. -inf at 0, NaN below. */
+        template <int T = Precise> static inline float Log(float x);
+
+        /**
+         * @brief x^y computed as Exp(y * Log(x)), so the error grows with
+         *        |y * ln(x)|: Precise is about 2 + 1.5 * |y * ln(x)| ulp
+         *        (under 7 ulp for x^(1/2.4) on [0, 1]). Returns 1 when y is
+         *        0 or x is 1, NaN for negative x.
+         */
+        template <int T = Precise> static inline float Pow(float x, float y);
+
+        /*** @brief Arc tangent. Precise: at most 3 ulp. */
+        template <int T = Precise> static inline float Atan(float x);
+
+        /**
+         * @brief Arc tangent of y / x in [-pi, pi], using the signs of both
+         *        arguments (including signed zeros) to pick the quadrant.
+         *        Precise: at most 4 ulp.
+         */
+        template <int T = Precise> static inline float Atan2(float y, float x);
+
+        /**
+         * @brief Batch variants: out[i] = F(x[i]) for i < count. `out` may
+         *        alias the inputs.
+         */
+        template <int T = Precise> static inline void Sin(const float* x, float* out, size_t count);
+        template <int T = Precise> static inline void Cos(const float* x, float* out, size_t count);
+        template <int T = Precise> static inline void SinCos(const float* x, float* s, float* c, size_t count);
+        template <int T = Precise> static inline void Exp(const float* x, float* out, size_t count);
+        template <int T = Precise> static inline void Log(const float* x, float* out, size_t count);
+        template <int T = Precise> static inline void Pow(const float* x, const float* y, float* out, size_t count);
+        template <int T = Precise> static inline void Atan(const float* x, float* out, size_t count);
+        template <int T = Precise> static inline void Atan2(const float* y, const float* x, float* out, size_t count);
+
+        /*** @brief The kernels, written once against the lane operations of O. */
+        template <class O, int T> static inline void SinCosKernel(typename O::F x, typename O::F* s, typename O::F* c);
+        template <class O, int T> static inline typename O::F ExpKernel(typename O::F x);
+        template <class O, int T> static inline typename O::F LogKernel(typename O::F x);
+        template <class O, int T> static inline typename O::F PowKernel(typename O::F x, typename O::F y);
+        template <class O, int T> static inline typename O::F AtanKernel(typename O::F x);
+        template <class O, int T> static inline typename O::F Atan2Kernel(typename O::F y, typename O::F x);
+
+    private:
+        template <class O, int T> struct SinOp { static inline typename O::F Run(typename O::F x) { typename O::F s, c; SinCosKernel<O, T>(x, &s, &c); return (s); }; };
+        template <class O, int T> struct CosOp { static inline typename O::F Run(typename O::F x) { typename O::F s, c; SinCosKernel<O, T>(x, &s, &c); return (c); }; };
+        template <class O, int T> struct ExpOp { static inline typename O::F Run(typename O::F x) { return (ExpKernel<O, T>(x)); }; };
+        template <class O, int T> struct LogOp { static inline typename O::F Run(typename O::F x) { return (LogKernel<O, T>(x)); }; };
+        template <class O, int T> struct AtanOp { static inline typename O::F Run(typename O::F x) { return (AtanKernel<O, T>(x)); }; };
+        template <class O, int T> struct PowOp { static inline typename O::F Run(typename O::F x, typename O::F y) { return (PowKernel<O, T>(x, y)); }; };
+        template <class O, int T> struct Atan2Op { static inline typename O::F Run(typename O::F y, typename O::F x) { return (Atan2Kernel<O, T>(y, x)); }; };
+
+        template <template <class, int> class Op, int T>
+        static inline void Batch(const float* x, float* out, size_t count);
+
+        template <template <class, int> class Op, int T>
+        static inline void Batch2(const float* a, const float* b, float* out, size_t count);
+};
+
+template <class O, int T>
+inline void FastMath::SinCosKernel(typename O::F x, typename O::F* s, typename O::F* c)
+{
+    typedef typename O::F F;
+    typedef typename O::I I;
+
+    const F sign = O::And(x, O::Set(-0.0F));
+    const F ax = O::Xor(x, sign);
+    // Octant j rounded up to even: ax = j * pi/4 + r with |r| <= pi/4. The
+    // clamp only keeps the conversion defined for huge or NaN inputs.
+    I j = O::TruncI(O::Min(O::Mul(ax, O::Set(1.27323954473516F)), O::Set(16777216.0F)));
+    j = O::AndI(O::AddI(j, O::SetI(1)), O::SetI(~1));
+    const F y = O::ToF(j);
+
+    // pi/4 in three parts, the first two exact in float, so y * part is exact.
+    const F r = O::Sub(O::Sub(O::Sub(ax, O::Mul(y, O::Set(0.78515625F))), O::Mul(y, O::Set(2.4187564849853515625e-4F))), O::Mul(y, O::Set(3.77489497744594108e-8F)));
+    const F z = O::Mul(r, r);
+    F ps, pc;
+    if (T == Precise)
+    {
+        ps = O::Add(O::Mul(O::Mul(O::Add(O::Mul(O::Add(O::Mul(O::Set(-1.9515295891E-4F), z), O::Set(8.3321608736E-3F)), z), O::Set(-1.6666654611E-1F)), z), r), r);
+        pc = O::Mul(O::Mul(O::Add(O::Mul(O::Add(O::Mul(O::Set(2.443315711809948E-5F), z), O::Set(-1.388731625493765E-3F)), z), O::Set(4.166664568298827E-2F)), z), z);
+        pc = O::Add(O::Sub(pc, O::Mul(O::Set(0.5F), z)), O::Set(1.0F));
+    }
+    else
+    {
+        ps = O::Add(O::Mul(O::Mul(O::Add(O::Mul(O::Set(8.163281716e-03F), z), O::Set(-1.666339040e-01F)), z), r), r);
+        pc = O::Add(O::Mul(O::Add(O::Mul(O::Set(4.045845196e-02F), z), O::Set(-4.997605681e-01F)), z), O::Set(1.0F));
+    }
+
+    // Odd quadrants swap the polynomials; sin is negated in quadrants 2 and
+    // 3 (bit 2 of j), cos in quadrants 1 and 2 (bit 2 of j + 2).
+    const F swap = O::AsF(O::EqualI(O::AndI(j, O::SetI(2)), O::SetI(2)));
+    const F sneg = O::AsF(O::template Shl<29>(O::AndI(j, O::SetI(4))));
+    const F cneg = O::AsF(O::template Shl<29>(O::AndI(O::AddI(j, O::SetI(2)), O::SetI(4))));
+    (*s) = O::Xor(O::Xor(O::Select(swap, pc, ps), sneg), sign);
+    (*c) = O::Xor(O::Select(swap, ps, pc), cneg);
+};
+
+template <class O, int T>
+inline typename O::F FastMath::ExpKernel(typename O::F x)
+{
+    typedef typename O::F F;
+    typedef typename O::I I;
+
+    const float hi = 88.72283935546875F;
+    const float lo = -87.33654022216797F;
+    // Operand order keeps NaN: min/max return their second operand when unordered.
+    const F xc = O::Min(O::Set(hi), O::Max(O::Set(lo), x));
+    const F t = O::Mul(xc, O::Set(1.44269504088896341F));
+    // Round to nearest even through the 1.5 * 2^23 trick, exact for |t| < 2^22.
+    const F n = O::Sub(O::Add(t, O::Set(12582912.0F)), O::Set(12582912.0F));
+
+    F p;
+    if (T == Precise)
+    {
+        const F r = O::Sub(O::Sub(xc, O::Mul(n, O::Set(0.693359375F))), O::Mul(n, O::Set(-2.12194440e-4F)));
+        const F z = O::Mul(r, r);
+        p = O::Add(O::Mul(O::Set(1.9875691500E-4F), r), O::Set(1.3981999507E-3F));
+        p = O::Add(O::Mul(p, r), O::Set(8.3334519073E-3F));
+        p = O::Add(O::Mul(p, r), O::Set(4.1665795894E-2F));
+        p = O::Add(O::Mul(p, r), O::Set(1.6666665459E-1F));
+        p = O::Add(O::Mul(p, r), O::Set(5.0000001201E-1F));
+        p = O::Add(O::Add(O::Mul(p, z), r), O::Set(1.0F));
+    }
+    else
+    {
+        // 2^f on [-0.5, 0.5].
+        const F f = O::Sub(t, n);
+        p = O::Add(O::Mul(O::Set(5.517166853e-02F), f), O::Set(2.426111251e-01F));
+        p = O::Add(O::Mul(p, f), O::Set(6.932609677e-01F));
+        p = O::Add(O::Mul(p, f), O::Set(9.999280572e-01F));
+    }
+
+    // 2^n in two factors, since n reaches 128 near the top of the range.
+    const I ni = O::TruncI(n);
+    const I h = O::template Sra<1>(ni);
+    const F e1 = O::AsF(O::template Shl<23>(O::AddI(h, O::SetI(127))));
+    const F e2 = O::AsF(O::template Shl<23>(O::AddI(O::SubI(ni, h), O::SetI(127))));
+    F out = O::Mul(O::Mul(p, e1), e2);
+    out = O::Select(O::Greater(x, O::Set(hi)), O::Set(HUGE_VALF), out);
+    out = O::Select(O::Less(x, O::Set(lo)), O::Set(0.0F), out);
+    return (out);
+};
+
+template <class O, int T>
+inline typename O::F FastMath::LogKernel(typename O::F x)
+{
+    typedef typename O::F F;
+    typedef typename O::I I;
+
+    // Denormals are scaled into the normal range first.
+    const F denormal = O::Less(x, O::Set(1.17549435e-38F));
+    const F xs = O::Select(denormal, O::Mul(x, O::Set(8388608.0F)), x);
+    const I bits = O::AsI(xs);
+    // x = m * 2^e with m in [0.5, 1).
+    F e = O::Sub(O::ToF(O::SubI(O::template Srl<23>(bits), O::SetI(126))), O::And(denormal, O::Set(23.0F)));
+    F m = O::AsF(O::OrI(O::AndI(bits, O::SetI(0x007FFFFF)), O::SetI(0x3F000000)));
+    // Below sqrt(1/2), use 2m and e - 1 so that m - 1 is in [-0.29, 0.41].
+    const F small = O::Less(m, O::Set(0.707106781186547524F));
+    e = O::Sub(e, O::And(small, O::Set(1.0F)));
+    m = O::Sub(O::Add(m, O::And(small, m)), O::Set(1.0F));
+    const F z = O::Mul(m, m);
+
+    F out;
+    if (T == Precise)
+    {
+        F y = O::Add(O::Mul(O::Set(7.0376836292E-2F), m), O::Set(-1.1514610310E-1F));
+        y = O::Add(O::Mul(y, m), O::Set(1.1676998740E-1F));
+        y = O::Add(O::Mul(y, m), O::Set(-1.2420140846E-1F));
+        y = O::Add(O::Mul(y, m), O::Set(1.4249322787E-1F));
+        y = O::Add(O::Mul(y, m), O::Set(-1.6668057665E-1F));
+        y = O::Add(O::Mul(y, m), O::Set(2.0000714765E-1F));
+        y = O::Add(O::Mul(y, m), O::Set(-2.4999993993E-1F));
+        y = O::Add(O::Mul(y, m), O::Set(3.3333331174E-1F));
+        y = O::Mul(O::Mul(y, m), z);
+        y = O::Add(y, O::Mul(e, O::Set(-2.12194440e-4F)));
+        y = O::Add(y, O::Mul(O::Set(-0.5F), z));
+        out = O::Add(O::Add(m, y), O::Mul(e, O::Set(0.693359375F)));
+    }
+    else
+    {
+        F y = O::Add(O::Mul(O::Set(1.784061044e-01F), m), O::Set(-2.699142396e-01F));
+        y = O::Add(O::Mul(y, m), O::Set(3.357071877e-01F));
+        y = O::Add(O::Mul(y, m), O::Set(-4.995359480e-01F));
+        out = O::Add(O::Add(m, O::Mul(y, z)), O::Mul(e, O::Set(0.693147182F)));
+    }
+
+    out = O::Select(O::Equal(x, O::Set(0.0F)), O::Set(-HUGE_VALF), out);
+    out = O::Select(O::Less(x, O::Set(0.0F)), O::Set(NAN), out);
+    out = O::Select(O::Equal(x, O::Set(HUGE_VALF)), x, out);
+    out = O::Select(O::Equal(x, x), out, x);
+    return (out);
+};
+
+template <class O, int T>
+inline typename O::F FastMath::PowKernel(typename O::F x, typename O::F y)
+{
+    typedef typename O::F F;
+
+    F out = ExpKernel<O, T>(O::Mul(y, LogKernel<O, T>(x)));
+    const F one = O::Or(O::Equal(y, O::Set(0.0F)), O::Equal(x, O::Set(1.0F)));
+    return (O::Select(one, O::Set(1.0F), out));
+};
+
+template <class O, int T>
+inline typename O::F FastMath::AtanKernel(typename O::F x)
+{
+    typedef typename O::F F;
+
+    const F sign = O::And(x, O::Set(-0.0F));
+    const F ax = O::Xor(x, sign);
+    F out;
+    if (T == Precise)
+    {
+        // atan(x) = y0 + atan(r) with |r| <= tan(pi/8).
+        const F big = O::Greater(ax, O::Set(2.414213562373095F));
+        const F mid = O::Greater(ax, O::Set(0.4142135623730950F));
+        const F num = O::Select(big, O::Set(-1.0F), O::Select(mid, O::Sub(ax, O::Set(1.0F)), ax));
+        const F den = O::Select(big, ax, O::Select(mid, O::Add(ax, O::Set(1.0F)), O::Set(1.0F)));
+        const F y0 = O::Select(big, O::Set(1.5707963267948966F), O::And(mid, O::Set(0.7853981633974483F)));
+        const F r = O::Div(num, den);
+        const F z = O::Mul(r, r);
+        F p = O::Add(O::Mul(O::Set(8.05374449538e-2F), z), O::Set(-1.38776856032E-1F));
+        p = O::Add(O::Mul(p, z), O::Set(1.99777106478E-1F));
+        p = O::Add(O::Mul(p, z), O::Set(-3.33329491539E-1F));
+        out = O::Add(y0, O::Add(O::Mul(O::Mul(p, z), r), r));
+    }
+    else
+    {
+        // atan(x) = pi/2 - atan(1/x) above 1.
+        const F big = O::Greater(ax, O::Set(1.0F));
+        const F r = O::Div(O::Select(big, O::Set(1.0F), ax), O::Select(big, ax, O::Set(1.0F)));
+        const F z = O::Mul(r, r);
+        F p = O::Add(O::Mul(O::Set(2.484027855e-02F), z), O::Set(-9.409793466e-02F));
+        p = O::Add(O::Mul(p, z), O::Set(1.868141741e-01F));
+        p = O::Add(O::Mul(p, z), O::Set(-3.321307302e-01F));
+        out = O::Add(O::Mul(O::Mul(p, z), r), r);
+        out = O::Select(big, O::Sub(O::Set(1.5707963267948966F), out), out);
+    }
+    return (O::Xor(out, sign));
+};
+
+template <class O, int T>
+inline typename O::F FastMath::Atan2Kernel(typename O::F y, typename O::F x)
+{
+    typedef typename O::F F;
+
+    const F signMask = O::Set(-0.0F);
+    const F ax = O::Xor(x, O::And(x, signMask));
+    const F ay = O::Xor(y, O::And(y, signMask));
+    const F mx = O::Max(ax, ay);
+    const F mn = O::Min(ax, ay);
+    F a = O::Div(mn, mx);
+    a = O::Select(O::Equal(mx, O::Set(0.0F)), O::Set(0.0F), a);
+    a = O::Select(O::Equal(mn, O::Set(HUGE_VALF)), O::Set(1.0F), a);
+    F t = AtanKernel<O, T>(a);
+    t = O::Select(O::Greater(ay, ax), O::Sub(O::Set(1.5707963267948966F), t), t);
+    const F xneg = O::AsF(O::EqualI(O::AndI(O::AsI(x), O::AsI(signMask)), O::AsI(signMask)));
+    t = O::Select(xneg, O::Sub(O::Set(3.14159265358979323846F), t), t);
+    t = O::Xor(t, O::And(y, signMask));
+    const F ordered = O::And(O::Equal(x, x), O::Equal(y, y));
+    return (O::Select(ordered, t, O::Add(x, y)));
+};
+
+template <template <class, int> class Op, int T>
+inline void FastMath::Batch(const float* x, float* out, size_t count)
+{
+    size_t i = 0;
+#if defined(RT_SIMD_AVX2)
+    for (; i + 8 <= count; i += 8)
+        FastMathAvxOps::Store(out + i, Op<FastMathAvxOps, T>::Run(FastMathAvxOps::Load(x + i)));
+#endif
+#if defined(RT_SIMD_SSE)
+    for (; i + 4 <= count; i += 4)
+        FastMathSseOps::Store(out + i, Op<FastMathSseOps, T>::Run(FastMathSseOps::Load(x + i)));
+#endif
+    for (; i < count; i++)
+        out[i] = Op<FastMathScalarOps, T>::Run(x[i]);
+};
+
+template <template <class, int> class Op, int T>
+inline void FastMath::Batch2(const float* a, const float* b, float* out, size_t count)
+{
+    size_t i = 0;
+#if defined(RT_SIMD_AVX2)
+    for (; i + 8 <= count; i += 8)
+        FastMathAvxOps::Store(out + i, Op<FastMathAvxOps, T>::Run(FastMathAvxOps::Load(a + i), FastMathAvxOps::Load(b + i)));
+#endif
+#if defined(RT_SIMD_SSE)
+    for (; i + 4 <= count; i += 4)
+        FastMathSseOps::Store(out + i, Op<FastMathSseOps, T>::Run(FastMathSseOps::Load(a + i), FastMathSseOps::Load(b + i)));
+#endif
+    for (; i < count; i++)
+        out[i] = Op<FastMathScalarOps, T>::Run(a[i], b[i]);
+};
+
+template <int T> inline float FastMath::Sin(float x) { return (SinOp<FastMathScalarOps, T>::Run(x)); };
+template <int T> inline float FastMath::Cos(float x) { return (CosOp<FastMathScalarOps, T>::Run(x)); };
+template <int T> inline void FastMath::SinCos(float x, float* s, float* c) { SinCosKernel<FastMathScalarOps, T>(x, s, c); };
+template <int T> inline float FastMath::Exp(float x) { return (ExpKernel<FastMathScalarOps, T>(x)); };
+template <int T> inline float FastMath::Log(float x) { return (LogKernel<FastMathScalarOps, T>(x)); };
+template <int T> inline float FastMath::Pow(float x, float y) { return (PowKernel<FastMathScalarOps, T>(x, y)); };
+template <int T> inline float FastMath::Atan(float x) { return (AtanKernel<FastMathScalarOps, T>(x)); };
+template <int T> inline float FastMath::Atan2(float y, float x) { return (Atan2Kernel<FastMathScalarOps, T>(y, x)); };
+
+template <int T> inline void FastMath::Sin(const float* x, float* out, size_t count) { Batch<SinOp, T>(x, out, count); };
+template <int T> inline void FastMath::Cos(const float* x, float* out, size_t count) { Batch<CosOp, T>(x, out, count); };
+template <int T> inline void FastMath::Exp(const float* x, float* out, size_t count) { Batch<ExpOp, T>(x, out, count); };
+template <int T> inline void FastMath::Log(const float* x, float* out, size_t count) { Batch<LogOp, T>(x, out, count); };
+template <int T> inline void FastMath::Atan(const float* x, float* out, size_t count) { Batch<AtanOp, T>(x, out, count); };
+template <int T> inline void FastMath::Pow(const float* x, const float* y, float* out, size_t count) { Batch2<PowOp, T>(x, y, out, count); };
+template <int T> inline void FastMath::Atan2(const float* y, const float* x, float* out, size_t count) { Batch2<Atan2Op, T>(y, x, out, count); };
+
+template <int T>
+inline void FastMath::SinCos(const float* x, float* s, float* c, size_t count)
+{
+    size_t i = 0;
+#if defined(RT_SIMD_AVX2)
+    for (; i + 8 <= count; i += 8)
+    {
+        FastMathAvxOps::F vs, vc;
+        SinCosKernel<FastMathAvxOps, T>(FastMathAvxOps::Load(x + i), &vs, &vc);
+        FastMathAvxOps::Store(s + i, vs);
+        FastMathAvxOps::Store(c + i, vc);
+    }
+#endif
+#if defined(RT_SIMD_SSE)
+    for (; i + 4 <= count; i += 4)
+    {
+        FastMathSseOps::F vs, vc;
+        SinCosKernel<FastMathSseOps, T>(FastMathSseOps::Load(x + i), &vs, &vc);
+        FastMathSseOps::Store(s + i, vs);
+        FastMathSseOps::Store(c + i, vc);
+    }
+#endif
+    for (; i < count; i++)
+        SinCosKernel<FastMathScalarOps, T>(x[i], &s[i], &c[i]);
+};
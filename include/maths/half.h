@@ -0,0 +1,279 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include "config.h"
+#include "maths/vecn.h"
+
+/**
+ * IEEE 754 binary16 storage types.
+ *
+ * Half, Half2, Half3 and Half4 halve the footprint of float data whose
+ * precision allows it (normals, texture coordinates, colour buffers): 11
+ * significant bits, a relative error below 2^-11, and a range up to 65504.
+ * They are storage only; arithmetic is done after converting back to
+ * float/Vec.
+ *
+ * Conversions round to nearest even, keep infinities, signed zeros and
+ * subnormals, turn overflow into infinity, and keep NaNs quiet with the top
+ * of their payload. The scalar conversions use integer operations only, so
+ * they do not depend on the FTZ/DAZ mode. The batch conversions use F16C
+ * when config.h enables it (8 values per instruction) and give the same
+ * bits as the scalar ones.
+ */
+
+/*** @brief Half-precision float. */
+struct Half
+{
+    public:
+        /*** @brief Default constructor. +0. */
+        Half(void);
+
+        /**
+         * @brief Rounds a float to the nearest half.
+         *
+         * @param f The value.
+         */
+        explicit Half(float f);
+
+        /*** @brief Converts back to float, exactly. */
+        operator float(void) const;
+
+        /*** @brief Half with the given bit pattern. */
+        static Half FromBits(uint16_t bits);
+
+        /*** @brief Bits of the half nearest to f. */
+        static uint16_t Encode(float f);
+
+        /*** @brief Float value of a half bit pattern. */
+        static float Decode(uint16_t h);
+
+        /**
+         * @brief Converts an array of floats.
+         *
+         * @param src The floats.
+         * @param dst Receives the halves; may not overlap src.
+         * @param n The number of values.
+         */
+        static void Encode(const float* src, Half* dst, size_t n);
+
+        /**
+         * @brief Converts an array of halves.
+         *
+         * @param src The halves.
+         * @param dst Receives the floats; may not overlap src.
+         * @param n The number of values.
+         */
+        static void Decode(const Half* src, float* dst, size_t n);
+
+        /*** @brief Sign, 5 exponent bits and 10 mantissa bits */
+        uint16_t bits;
+};
+
+/**
+ * @brief Half-precision VecN (Half2, Half3, Half4: 4, 6 and 8 bytes).
+ *
+ * @tparam N 2, 3 or 4.
+ */
+template <int N>
+struct VecN<Half, N> : public VecNData<Half, N>
+{
+    public:
+        /*** @brief Default constructor. All components +0. */
+        VecN(void);
+
+        /*** @brief Rounds each component to the nearest half. */
+        explicit VecN(const VecN<float, N>& v);
+
+        /*** @brief Converts back to float, exactly. */
+        operator VecN<float, N>(void) const;
+
+        /*** @brief Converts an array of float vectors, as Half::Encode. */
+        static void Encode(const VecN<float, N>* src, VecN* dst, size_t n);
+
+        /*** @brief Converts an array of half vectors, as Half::Decode. */
+        static void Decode(const VecN* src, VecN<float, N>* dst, size_t n);
+};
+
+typedef VecN<Half, 2> Half2;
+typedef VecN<Half, 3> Half3;
+typedef VecN<Half, 4> Half4;
+
+// The array conversions treat VecN and HalfN arrays as flat component arrays.
+static_assert(sizeof(Half) == 2 && sizeof(Half2) == 4 && sizeof(Half3) == 6 && sizeof(Half4) == 8, "HalfN must be packed");
+static_assert(sizeof(Vec2) == 2 * sizeof(float) && sizeof(Vec3) == 3 * sizeof(float) && sizeof(Vec4) == 4 * sizeof(float),
+    "VecN must be packed");
+
+inline Half::Half(void) : bits(0u) {};
+
+inline Half::Half(float f) : bits(Encode(f)) {};
+
+inline Half::operator float(void) const
+{
+    return (Decode(bits));
+};
+
+inline Half Half::FromBits(uint16_t bits)
+{
+    Half h;
+
+    h.bits = bits;
+    return (h);
+};
+
+inline uint16_t Half::Encode(float f)
+{
+    uint32_t u;
+    memcpy(&u, &f, sizeof(u));
+    uint32_t sign = (u >> 16) & 0x8000u;
+    uint32_t a = u & 0x7fffffffu;
+    uint32_t o;
+
+    if (a >= 0x47800000u)
+    {
+        // 2^16 and up, infinities and NaNs. NaNs keep the top of their payload, made quiet.
+        o = (a > 0x7f800000u) ? (0x7e00u | ((a >> 13) & 0x3ffu)) : 0x7c00u;
+    }
+    else if (a < 0x38800000u)
+    {
+        // Below 2^-14: subnormal halves, in units of 2^-24.
+        int e = static_cast<int>(a >> 23);
+        if (e < 102)
+            o = 0u;
+        else
+        {
+            uint32_t mant = (a & 0x7fffffu) | 0x800000u;
+            int shift = 126 - e;
+            uint32_t rem = mant & ((1u << shift) - 1u);
+            uint32_t halfway = 1u << (shift - 1);
+            o = mant >> shift;
+            o += (rem > halfway || (rem == halfway && (o & 1u))) ? 1u : 0u;
+        }
+    }
+    else
+    {
+        // Normal: rebias the exponent and round the 13 dropped bits to nearest even;
+        // a carry out of the mantissa bumps the exponent, up to infinity.
+        o = ((a + 0xc8000fffu + ((a >> 13) & 1u)) >> 13) & 0xffffu;
+    }
+    return (static_cast<uint16_t>(o | sign));
+};
+
+inline float Half::Decode(uint16_t h)
+{
+    const uint32_t shiftedExp = 0x7c00u << 13;
+    uint32_t o = (static_cast<uint32_t>(h) & 0x7fffu) << 13;
+    uint32_t exp = o & shiftedExp;
+    float f;
+
+    o += (127u - 15u) << 23;
+    if (exp == shiftedExp)
+    {
+        // Infinity or NaN; NaNs come out quiet, as from F16C.
+        o += (128u - 16u) << 23;
+        if (o & 0x7fffffu)
+            o |= 0x400000u;
+    }
+    else if (exp == 0u)
+    {
+        // Subnormal: let the FPU renormalize; both operands and the result are normal floats.
+        const uint32_t magicBits = 113u << 23;
+        float magic;
+        memcpy(&magic, &magicBits, sizeof(magic));
+        o += 1u << 23;
+        memcpy(&f, &o, sizeof(f));
+        f -= magic;
+        memcpy(&o, &f, sizeof(o));
+    }
+    o |= static_cast<uint32_t>(h & 0x8000u) << 16;
+    memcpy(&f, &o, sizeof(f));
+    return (f);
+};
+
+inline void Half::Encode(const float* src, Half* dst, size_t n)
+{
+    size_t i = 0;
+
+#if defined(RT_SIMD_F16C)
+    for (; i + 8 <= n; i += 8)
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm256_cvtps_ph(_mm256_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+    for (; i + 4 <= n; i += 4)
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + i), _mm_cvtps_ph(_mm_loadu_ps(src + i), _MM_FROUND_TO_NEAREST_INT));
+#endif
+    for (; i < n; i++)
+        dst[i].bits = Encode(src[i]);
+};
+
+inline void Half::Decode(const Half* src, float* dst, size_t n)
+{
+    size_t i = 0;
+
+#if defined(RT_SIMD_F16C)
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i))));
+    for (; i + 4 <= n; i += 4)
+        _mm_storeu_ps(dst + i, _mm_cvtph_ps(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i))));
+#endif
+    for (; i < n; i++)
+        dst[i] = Decode(src[i].bits);
+};
+
+template <int N>
+inline VecN<Half, N>::VecN(void) : VecNData<Half, N>(Half(), Half(), Half(), Half()) {};
+
+template <int N>
+inline VecN<Half, N>::VecN(const VecN<float, N>& v) : VecNData<Half, N>(Half(), Half(), Half(), Half())
+{
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        this->Ref(i) = Half(v[i]);
+};
+
+template <int N>
+inline VecN<Half, N>::operator VecN<float, N>(void) const
+{
+    VecN<float, N> out;
+
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        out[i] = this->At(i);
+    return (out);
+};
+
+template <int N>
+inline void VecN<Half, N>::Encode(const VecN<float, N>* src, VecN* dst, size_t n)
+{
+    Half::Encode(reinterpret_cast<const float*>(src), reinterpret_cast<Half*>(dst), N * n);
+};
+
+template <int N>
+inline void VecN<Half, N>::Decode(const VecN* src, VecN<float, N>* dst, size_t n)
+{
+    Half::Decode(reinterpret_cast<const Half*>(src), reinterpret_cast<float*>(dst), N * n);
+};
@@ -24,8 +24,18 @@
 
 #pragma once
 
+#include <iosfwd>
 #include "maths/vec3.h"
+#include "maths/simd.h"
+#include "maths/transform.h"
 
+/**
+ * @brief 4x4 float matrix acting on column vectors.
+ *
+ * data[r][c] is row r, column c. A point p transforms as M * (p, 1), so the
+ * translation is column 3 (data[0..2][3]) and the bottom row of an affine
+ * matrix is (0, 0, 0, 1). (a * b) applies b first.
+ */
 struct Mat4
 {
     public:
@@ -47,7 +57,7 @@ struct Mat4
          *
          * @param m The matrix to copy.
          */
-        Mat4(const Mat4& m);
+        Mat4(const Mat4& m) = default;
 
         /**
          * @brief Accessor to retrieve a reference to a specific row of the matrix.
@@ -86,7 +96,8 @@ struct Mat4
         bool operator!=(const Mat4& b) const;
 
         /**
-         * @brief Creates a translation matrix from a given translation vector.
+         * @brief Creates a translation matrix from a given translation vector,
+         *        stored in column 3 like GetPosition reads it.
          *
          * @param a The translation vector.
          *
@@ -157,22 +168,24 @@ struct Mat4
         Vec3 GetPosition(void) const;
 
         /**
-         * @brief Transforms a point by this matrix, considering it as a 4x4 transformation.
+         * @brief Transforms a point by this matrix, considering it as a 4x4 transformation:
+         *        M * (p, 1), divided by the resulting w.
          *
          * @param pts The point to transform.
          *
          * @return The transformed point.
          */
-        static Vec3 MultiplyPoint(const Vec3& pts);
+        Vec3 MultiplyPoint(const Vec3& pts) const;
 
         /**
-         * @brief Transforms a point by this matrix, considering it as a 3x4 transformation (ignoring perspective).
+         * @brief Transforms a point by this matrix, considering it as a 3x4 transformation (ignoring perspective):
+         *        rows 0 to 2 of M * (p, 1).
          *
          * @param pts The point to transform.
          *
          * @return The transformed point.
          */
-        static Vec3 MultiplyPoint3x4(const Vec3& pts);
+        Vec3 MultiplyPoint3x4(const Vec3& pts) const;
 
         /**
          * @brief Transforms a vector by this matrix (ignoring translation).
@@ -181,7 +194,52 @@ struct Mat4
          *
          * return The transformed vector.
          */
-        static Vec3 MultiplyVector(const Vec3& v);
+        Vec3 MultiplyVector(const Vec3& v) const;
+
+        /**
+         * @brief MultiplyPoint over an array of float3, see Transform::Points.
+         *
+         * @param src First input point.
+         * @param srcStride Floats between consecutive inputs.
+         * @param dst First output point, may be src when the strides match.
+         * @param dstStride Floats between consecutive outputs.
+         * @param count Number of points.
+         * @param pool Optional workers for large arrays.
+         */
+        void MultiplyPoints(const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count, ThreadPool* pool = NULL) const;
+
+        /*** @brief MultiplyPoint3x4 over an array of float3. Same parameters as MultiplyPoints. */
+        void MultiplyPoints3x4(const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count, ThreadPool* pool = NULL) const;
+
+        /*** @brief MultiplyVector over an array of float3. Same parameters as MultiplyPoints. */
+        void MultiplyVectors(const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count, ThreadPool* pool = NULL) const;
+
+        /**
+         * @brief General inverse.
+         *
+         * @return The inverse, or Mat4::zero if the matrix is singular.
+         */
+        Mat4 Inverse(void) const;
+
+        /**
+         * @brief Inverse of an affine transform (bottom row 0 0 0 1), cheaper
+         *        than Inverse: only the upper 3x3 is inverted.
+         *
+         * @param m The affine transform.
+         * @param result Receives the inverse; untouched on failure.
+         *
+         * @return False if the bottom row is not (0, 0, 0, 1) or the upper
+         *         3x3 is singular.
+         */
+        static bool Inverse3DAffine(const Mat4& m, Mat4& result);
+
+        /**
+         * @brief Inverse transpose of the upper 3x3, padded to a 4x4 with no
+         *        translation. Transforms normals with MultiplyVector.
+         *
+         * @return The normal matrix, or Mat4::zero if the upper 3x3 is singular.
+         */
+        Mat4 NormalMatrix(void) const;
 
         /** Data storage for the matrix, organized as a 4x4 array of floats. */
         float data[4][4];
@@ -190,218 +248,227 @@ struct Mat4
         static const Mat4 zero;
         /*** @brief Shorthand for writing an identity matrix */
         static const Mat4 identity;
+};
+
+inline Mat4::Mat4(void)
+{
+    data[0][0] = 1.0F; data[0][1] = 0.0F; data[0][2] = 0.0F; data[0][3] = 0.0F;
+    data[1][0] = 0.0F; data[1][1] = 1.0F; data[1][2] = 0.0F; data[1][3] = 0.0F;
+    data[2][0] = 0.0F; data[2][1] = 0.0F; data[2][2] = 1.0F; data[2][3] = 0.0F;
+    data[3][0] = 0.0F; data[3][1] = 0.0F; data[3][2] = 0.0F; data[3][3] = 1.0F;
+};
+
+inline Mat4::Mat4(const Vec4& c0, const Vec4& c1, const Vec4& c2, const Vec4& c3)
+{
+    SetColumn(0, c0);
+    SetColumn(1, c1);
+    SetColumn(2, c2);
+    SetColumn(3, c3);
+};
+
+inline Mat4 Mat4::operator*(const Mat4& b) const
+{
+    Mat4 out;
+
+    Simd::Mat4Multiply(data, b.data, out.data);
+    return (out);
+};
+
+inline bool Mat4::operator==(const Mat4& b) const
+{
+    return (
+        GetColumn(0) == b.GetColumn(0) &&
+        GetColumn(1) == b.GetColumn(1) &&
+        GetColumn(2) == b.GetColumn(2) &&
+        GetColumn(3) == b.GetColumn(3)
+    );
+};
+
+inline bool Mat4::operator!=(const Mat4& b) const
+{
+    return (!((*this) == b));
+};
+
+inline Mat4 Mat4::Translate(const Vec3& a)
+{
+    Mat4 out;
+
+    out[0][3] = a.x;
+    out[1][3] = a.y;
+    out[2][3] = a.z;
+
+    return (out);
+};
+
+inline Mat4 Mat4::Scale(const Vec3& a)
+{
+    Mat4 out;
+
+    out[0][0] = a.x;
+    out[1][1] = a.y;
+    out[2][2] = a.z;
+
+    return (out);
+};
+
+inline Mat4 Mat4::QuatToMatrix(float x, float y, float z, float w)
+{
+    Mat4 out;
+
+    const float x2 = x + x;
+    const float y2 = y + y;
+    const float z2 = z + z;
 
-    inline Mat4::Mat4(void)
-    {
-        data[0][0] = 1.0F; data[0][1] = 0.0F; data[0][2] = 0.0F; data[0][3] = 0.0F;
-        data[1][0] = 0.0F; data[1][1] = 1.0F; data[1][2] = 0.0F; data[1][3] = 0.0F;
-        data[2][0] = 0.0F; data[2][1] = 0.0F; data[2][2] = 1.0F; data[2][3] = 0.0F;
-        data[3][0] = 0.0F; data[3][1] = 0.0F; data[3][2] = 0.0F; data[3][3] = 1.0F;
-    };
-
-    inline Mat4::Mat4(const Vec4& c0, const Vec4& c1, const Vec4& c2, const Vec4& c3)
-    {
-        data[0][0] = c0.x; data[0][1] = c0.y; data[0][2] = c0.z; data[0][3] = c0.w;
-        data[1][0] = c1.x; data[1][1] = c0.y; data[1][2] = c1.z; data[1][3] = c1.w;
-        data[2][0] = c2.x; data[2][1] = c0.y; data[2][2] = c2.z; data[2][3] = c2.w;
-        data[3][0] = c3.x; data[3][1] = c0.y; data[3][2] = c3.z; data[3][3] = c3.w;
-    };
-
-    inline Mat4::Mat4(const Mat4& m)
-    {
-        data[0][0] = m.data[0][0]; data[0][1] = m.data[0][1]; data[0][2] = m.data[0][2]; data[0][3] = m.data[0][3];
-        data[1][0] = m.data[1][0]; data[1][1] = m.data[1][1]; data[1][2] = m.data[1][2]; data[1][3] = m.data[1][3];
-        data[2][0] = m.data[2][0]; data[2][1] = m.data[2][1]; data[2][2] = m.data[2][2]; data[2][3] = m.data[2][3];
-        data[3][0] = m.data[3][0]; data[3][1] = m.data[3][1]; data[3][2] = m.data[3][2]; data[3][3] = m.data[3][3];
-    };
-
-    inline Mat4 Mat4::operator*(const Mat4& b) const
-    {
-        Mat4 out;
-
-        out[0][0] = (data[0][0] * b.data[0][0]) + (data[0][1] * b.data[1][0]) +(data[0][2] * b.data[2][0]) + (data[0][3] * b.data[3][0]);
-        out[0][1] = (data[0][0] * b.data[0][1]) + (data[0][1] * b.data[1][1]) +(data[0][2] * b.data[2][1]) + (data[0][3] * b.data[3][1]);
-        out[0][2] = (data[0][0] * b.data[0][2]) + (data[0][1] * b.data[1][2]) +(data[0][2] * b.data[2][2]) + (data[0][3] * b.data[3][2]);
-        out[0][3] = (data[0][0] * b.data[0][3]) + (data[0][1] * b.data[1][3]) +(data[0][2] * b.data[2][3]) + (data[0][3] * b.data[3][3]);
-
-        out[1][0] = (data[1][0] * b.data[0][0]) + (data[1][1] * b.data[1][0]) +(data[1][2] * b.data[2][0]) + (data[1][3] * b.data[3][0]);
-        out[1][1] = (data[1][0] * b.data[0][1]) + (data[1][1] * b.data[1][1]) +(data[1][2] * b.data[2][1]) + (data[1][3] * b.data[3][1]);
-        out[1][2] = (data[1][0] * b.data[0][2]) + (data[1][1] * b.data[1][2]) +(data[1][2] * b.data[2][2]) + (data[1][3] * b.data[3][2]);
-        out[1][3] = (data[1][0] * b.data[0][3]) + (data[1][1] * b.data[1][3]) +(data[1][2] * b.data[2][3]) + (data[1][3] * b.data[3][3]);
-
-        out[2][0] = (data[2][0] * b.data[0][0]) + (data[2][1] * b.data[1][0]) +(data[2][2] * b.data[2][0]) + (data[2][3] * b.data[3][0]);
-        out[2][1] = (data[2][0] * b.data[0][1]) + (data[2][1] * b.data[1][1]) +(data[2][2] * b.data[2][1]) + (data[2][3] * b.data[3][1]);
-        out[2][2] = (data[2][0] * b.data[0][2]) + (data[2][1] * b.data[1][2]) +(data[2][2] * b.data[2][2]) + (data[2][3] * b.data[3][2]);
-        out[2][3] = (data[2][0] * b.data[0][3]) + (data[2][1] * b.data[1][3]) +(data[2][2] * b.data[2][3]) + (data[2][3] * b.data[3][3]);
-
-        out[3][0] = (data[3][0] * b.data[0][0]) + (data[3][1] * b.data[1][0]) +(data[3][2] * b.data[2][0]) + (data[3][3] * b.data[3][0]);
-        out[3][1] = (data[3][0] * b.data[0][1]) + (data[3][1] * b.data[1][1]) +(data[3][2] * b.data[2][1]) + (data[3][3] * b.data[3][1]);
-        out[3][2] = (data[3][0] * b.data[0][2]) + (data[3][1] * b.data[1][2]) +(data[3][2] * b.data[2][2]) + (data[3][3] * b.data[3][2]);
-        out[3][3] = (data[3][0] * b.data[0][3]) + (data[3][1] * b.data[1][3]) +(data[3][2] * b.data[2][3]) + (data[3][3] * b.data[3][3]);
-
-        return (out);
-    };
-
-    inline bool Mat4::operator==(const Mat4& b) const
-    {
-        return (
-            GetColumn(0) == b.GetColumn(0) &&
-            GetColumn(1) == b.GetColumn(1) &&
-            GetColumn(2) == b.GetColumn(2) &&
-            GetColumn(3) == b.GetColumn(3)
-        );
-    };
-
-    inline bool Mat4::operator!=(const Mat4& b) const
-    {
-        return (!((*this) == b));
-    };
-
-    inline Mat4 Mat4::Translate(const Vec3& a)
-    {
-        Mat4 out;
-
-        out[3][0] = a.x;
-        out[3][1] = a.y;
-        out[3][2] = a.z;
-
-        return (out);
-    };
-
-    inline Mat4 Mat4::Scale(const Vec3& a)
-    {
-        Mat4 out;
-
-        out[0][0] = a.x;
-        out[1][1] = a.y;
-        out[2][2] = a.z;
-
-        return (out);
-    };
-
-    inline Mat4 Mat4::QuatToMatrix(float x, float y, float z, float w)
-    {
-        Mat4 out;
-
-        const float x2 = x + x;
-        const float y2 = y + y;
-        const float z2 = z + z;
-
-        const float xx = x * x2;
-        const float xy = x * y2;
-        const float xz = x * z2;
-
-        const float yy = y * y2;
-        const float yz = y * z2;
-        const float zz = z * z2;
-
-        const float wx = w * x2;
-        const float wy = w * y2;
-        const float wz = w * z2;
-
-        out.data[0][0] = 1.0f - (yy + zz);
-        out.data[0][1] = xy + wz;
-        out.data[0][2] = xz - wy;
-        out.data[0][3] = 0.0f;
-
-        out.data[1][0] = xy - wz;
-        out.data[1][1] = 1.0f - (xx + zz);
-        out.data[1][2] = yz + wx;
-        out.data[1][3] = 0.0f;
-
-        out.data[2][0] = xz + wy;
-        out.data[2][1] = yz - wx;
-        out.data[2][2] = 1.0f - (xx + yy);
-        out.data[2][3] = 0.0f;
-
-        out.data[3][0] = 0;
-        out.data[3][1] = 0;
-        out.data[3][2] = 0;
-        out.data[3][3] = 1.0f;
-
-        return (out);
-    };
-
-    inline Vec4 Mat4::GetColumn(int index) const
-    {
-        if (index == 0) return (Vec4(data[0][0], data[1][0], data[2][0], data[3][0]));
-        if (index == 1) return (Vec4(data[0][1], data[1][1], data[2][1], data[3][1]));
-        if (index == 2) return (Vec4(data[0][2], data[1][2], data[2][2], data[3][2]));
-                        return (Vec4(data[0][3], data[1][3], data[2][3], data[3][3]));
-    };
-
-    inline void Mat4::SetColumn(int index, const Vec4& c)
-    {
-        data[0][index] = c.x;
-        data[1][index] = c.y;
-        data[2][index] = c.z;
-        data[3][index] = c.w;
-    };
-
-    inline Vec4 Mat4::GetRow(int index) const
-    {
-        if (index == 0) return (Vec4(data[0][0], data[0][1], data[0][2], data[0][3]));
-        if (index == 1) return (Vec4(data[1][0], data[1][1], data[1][2], data[1][3]));
-        if (index == 2) return (Vec4(data[2][0], data[2][1], data[2][2], data[2][3]));
-                        return (Vec4(data[3][0], data[3][1], data[3][2], data[3][3]));
-    };
-
-    inline void Mat4::SetRow(int index, const Vec4& r)
-    {
-        data[index][0] = r.x;
-        data[index][1] = r.y;
-        data[index][2] = r.z;
-        data[index][3] = r.w;
-    };
-
-    inline Vec3 Mat4::GetPosition(void) const
-    {
-        return (Vec3(data[0][3], data[1][3], data[2][3]));
-    };
-
-    inline Vec3 Mat4::MultiplyPoint(const Vec3& pts)
-    {
-        Vec3 out;
-        float w;
-
-        out.x = data[0][0] * pts.x + data[0][1] * pts.y + data[0][2] * pts.z + data[0][3];
-        out.y = data[1][0] * pts.x + data[1][1] * pts.y + data[1][2] * pts.z + data[1][3];
-        out.z = data[2][0] * pts.x + data[2][1] * pts.y + data[2][2] * pts.z + data[2][3];
-        w =     data[3][0] * pts.x + data[3][1] * pts.y + data[3][2] * pts.z + data[3][3];
-        w = 1.0F / w;
-        out *= w;
-        return (out);
-    };
-
-    inline Vec3 Mat4::MultiplyPoint3x4(const Vec3& pts)
-    {
-        Vec3 out;
-
-        out.x = data[0][0] * pts.x + data[0][1] * pts.y + data[0][2] * pts.z + data[0][3];
-        out.y = data[1][0] * pts.x + data[1][1] * pts.y + data[1][2] * pts.z + data[1][3];
-        out.z = data[2][0] * pts.x + data[2][1] * pts.y + data[2][2] * pts.z + data[2][3];
-        return (out);
-    };
-
-    inline Vec3 Mat4::MultiplyVector(const Vec3& v)
-    {
-        Vec3 out;
-
-        out.x = data[0][0] * v.x + data[0][1] * v.y + data[0][2] * v.z;
-        out.y = data[1][0] * v.x + data[1][1] * v.y + data[1][2] * v.z;
-        out.z = data[2][0] * v.x + data[2][1] * v.y + data[2][2] * v.z;
-        return (out);
-    };
+    const float xx = x * x2;
+    const float xy = x * y2;
+    const float xz = x * z2;
+
+    const float yy = y * y2;
+    const float yz = y * z2;
+    const float zz = z * z2;
+
+    const float wx = w * x2;
+    const float wy = w * y2;
+    const float wz = w * z2;
+
+    out.data[0][0] = 1.0f - (yy + zz);
+    out.data[0][1] = xy - wz;
+    out.data[0][2] = xz + wy;
+    out.data[0][3] = 0.0f;
+
+    out.data[1][0] = xy + wz;
+    out.data[1][1] = 1.0f - (xx + zz);
+    out.data[1][2] = yz - wx;
+    out.data[1][3] = 0.0f;
+
+    out.data[2][0] = xz - wy;
+    out.data[2][1] = yz + wx;
+    out.data[2][2] = 1.0f - (xx + yy);
+    out.data[2][3] = 0.0f;
+
+    out.data[3][0] = 0;
+    out.data[3][1] = 0;
+    out.data[3][2] = 0;
+    out.data[3][3] = 1.0f;
+
+    return (out);
+};
+
+inline Vec4 Mat4::GetColumn(int index) const
+{
+    if (index == 0) return (Vec4(data[0][0], data[1][0], data[2][0], data[3][0]));
+    if (index == 1) return (Vec4(data[0][1], data[1][1], data[2][1], data[3][1]));
+    if (index == 2) return (Vec4(data[0][2], data[1][2], data[2][2], data[3][2]));
+    return (Vec4(data[0][3], data[1][3], data[2][3], data[3][3]));
+};
+
+inline void Mat4::SetColumn(int index, const Vec4& c)
+{
+    data[0][index] = c.x;
+    data[1][index] = c.y;
+    data[2][index] = c.z;
+    data[3][index] = c.w;
+};
+
+inline Vec4 Mat4::GetRow(int index) const
+{
+    if (index == 0) return (Vec4(data[0][0], data[0][1], data[0][2], data[0][3]));
+    if (index == 1) return (Vec4(data[1][0], data[1][1], data[1][2], data[1][3]));
+    if (index == 2) return (Vec4(data[2][0], data[2][1], data[2][2], data[2][3]));
+    return (Vec4(data[3][0], data[3][1], data[3][2], data[3][3]));
+};
+
+inline void Mat4::SetRow(int index, const Vec4& r)
+{
+    data[index][0] = r.x;
+    data[index][1] = r.y;
+    data[index][2] = r.z;
+    data[index][3] = r.w;
+};
+
+inline Vec3 Mat4::GetPosition(void) const
+{
+    return (Vec3(data[0][3], data[1][3], data[2][3]));
+};
+
+inline Vec3 Mat4::MultiplyPoint(const Vec3& pts) const
+{
+    Vec3 out;
+    float w;
+
+    out.x = data[0][0] * pts.x + data[0][1] * pts.y + data[0][2] * pts.z + data[0][3];
+    out.y = data[1][0] * pts.x + data[1][1] * pts.y + data[1][2] * pts.z + data[1][3];
+    out.z = data[2][0] * pts.x + data[2][1] * pts.y + data[2][2] * pts.z + data[2][3];
+    w =     data[3][0] * pts.x + data[3][1] * pts.y + data[3][2] * pts.z + data[3][3];
+    w = 1.0F / w;
+    out *= w;
+    return (out);
 };
 
-const Mat4 Mat4::zero       = Mat4(Vec4(0.0F), Vec4(0.0F), Vec4(0.0F), Vec4(0.0F));
-const Mat4 Mat4::identity   = Mat4();
+inline Vec3 Mat4::MultiplyPoint3x4(const Vec3& pts) const
+{
+    Vec3 out;
+
+    out.x = data[0][0] * pts.x + data[0][1] * pts.y + data[0][2] * pts.z + data[0][3];
+    out.y = data[1][0] * pts.x + data[1][1] * pts.y + data[1][2] * pts.z + data[1][3];
+    out.z = data[2][0] * pts.x + data[2][1] * pts.y + data[2][2] * pts.z + data[2][3];
+    return (out);
+};
+
+inline Vec3 Mat4::MultiplyVector(const Vec3& v) const
+{
+    Vec3 out;
+
+    out.x = data[0][0] * v.x + data[0][1] * v.y + data[0][2] * v.z;
+    out.y = data[1][0] * v.x + data[1][1] * v.y + data[1][2] * v.z;
+    out.z = data[2][0] * v.x + data[2][1] * v.y + data[2][2] * v.z;
+    return (out);
+};
+
+inline void Mat4::MultiplyPoints(const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count, ThreadPool* pool) const
+{
+    Transform::Points(data, src, srcStride, dst, dstStride, count, pool);
+};
+
+inline void Mat4::MultiplyPoints3x4(const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count, ThreadPool* pool) const
+{
+    Transform::Points3x4(data, src, srcStride, dst, dstStride, count, pool);
+};
 
-std::ostream& operator<<(std::ostream& os, const Mat4& m)
+inline void Mat4::MultiplyVectors(const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count, ThreadPool* pool) const
 {
-    os << m.data[0][0] << '\t' << m.data[0][1] << '\t' << m.data[0][2] << '\t' << m.data[0][3] << '\n';
-    os << m.data[1][0] << '\t' << m.data[1][1] << '\t' << m.data[1][2] << '\t' << m.data[1][3] << '\n';
-    os << m.data[2][0] << '\t' << m.data[2][1] << '\t' << m.data[2][2] << '\t' << m.data[2][3] << '\n';
-    os << m.data[3][0] << '\t' << m.data[3][1] << '\t' << m.data[3][2] << '\t' << m.data[3][3];
-    return (os);
+    Transform::Vectors(data, src, srcStride, dst, dstStride, count, pool);
 };
+
+inline Mat4 Mat4::Inverse(void) const
+{
+    Mat4 out;
+
+    if (!Simd::Mat4Inverse(data, out.data))
+        return (Mat4::zero);
+    return (out);
+};
+
+inline bool Mat4::Inverse3DAffine(const Mat4& m, Mat4& result)
+{
+    Mat4 out;
+
+    if (m.data[3][0] != 0.0F || m.data[3][1] != 0.0F || m.data[3][2] != 0.0F || m.data[3][3] != 1.0F)
+        return (false);
+    if (!Simd::AffineInverse(m.data, out.data))
+        return (false);
+    result = out;
+    return (true);
+};
+
+inline Mat4 Mat4::NormalMatrix(void) const
+{
+    Mat4 out;
+
+    if (!Simd::NormalMatrix(data, out.data))
+        return (Mat4::zero);
+    return (out);
+};
+
+/*** @brief Writes the matrix row by row, tab separated. Defined in libraytracer-core. */
+std::ostream& operator<<(std::ostream& os, const Mat4& m);
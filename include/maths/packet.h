@@ -0,0 +1,406 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <algorithm>
+#include "maths/simd.h"
+
+/**
+ * SoA packets.
+ *
+ * FloatxW<W> holds W floats, MaskxW<W> holds one all-ones/all-zeros lane per
+ * float, and Vec3xW<W> holds W three-dimensional vectors as three FloatxW.
+ * Every lane computes exactly what the matching Vec3 operation computes on
+ * one vector (same operations, same order), so a packet can replace a loop
+ * over Vec3 without changing results. Widths 4 and 8 map onto one SSE or
+ * AVX register when config.h enables them; other widths use plain loops.
+ * Operations are forced inline (RT_INLINE): a packet passed to an outlined
+ * call goes through memory, which costs more than the operation itself.
+ */
+
+/*** @brief Alignment of a W-lane packet: its size for power-of-two widths, capped at a cache line. */
+#define RT_PACKET_ALIGN(W) (((W) & ((W) - 1)) ? 4 : ((W) * 4 < 64 ? (W) * 4 : 64))
+
+/*** @brief Lane kernels, specialized below for the native register widths. */
+template <int W>
+struct PacketKernel
+{
+    public:
+        static RT_INLINE void Fill(float a, float* r) { for (int i = 0; i < W; i++) r[i] = a; };
+        static RT_INLINE void LoadU(const float* a, float* r) { for (int i = 0; i < W; i++) r[i] = a[i]; };
+        static RT_INLINE void Add(const float* a, const float* b, float* r) { for (int i = 0; i < W; i++) r[i] = a[i] + b[i]; };
+        static RT_INLINE void Sub(const float* a, const float* b, float* r) { for (int i = 0; i < W; i++) r[i] = a[i] - b[i]; };
+        static RT_INLINE void Mul(const float* a, const float* b, float* r) { for (int i = 0; i < W; i++) r[i] = a[i] * b[i]; };
+        static RT_INLINE void Div(const float* a, const float* b, float* r) { for (int i = 0; i < W; i++) r[i] = a[i] / b[i]; };
+        static RT_INLINE void Min(const float* a, const float* b, float* r) { for (int i = 0; i < W; i++) r[i] = std::min(a[i], b[i]); };
+        static RT_INLINE void Max(const float* a, const float* b, float* r) { for (int i = 0; i < W; i++) r[i] = std::max(a[i], b[i]); };
+        static RT_INLINE void Sqrt(const float* a, float* r) { for (int i = 0; i < W; i++) r[i] = sqrtf(a[i]); };
+        static RT_INLINE void Less(const float* a, const float* b, uint32_t* r) { for (int i = 0; i < W; i++) r[i] = a[i] < b[i] ? ~0u : 0u; };
+        static RT_INLINE void LessEqual(const float* a, const float* b, uint32_t* r) { for (int i = 0; i < W; i++) r[i] = a[i] <= b[i] ? ~0u : 0u; };
+        static RT_INLINE void Equal(const float* a, const float* b, uint32_t* r) { for (int i = 0; i < W; i++) r[i] = a[i] == b[i] ? ~0u : 0u; };
+        static RT_INLINE void Blend(const uint32_t* m, const float* a, const float* b, float* r) { for (int i = 0; i < W; i++) r[i] = m[i] ? a[i] : b[i]; };
+        static RT_INLINE void And(const uint32_t* a, const uint32_t* b, uint32_t* r) { for (int i = 0; i < W; i++) r[i] = a[i] & b[i]; };
+        static RT_INLINE void Or(const uint32_t* a, const uint32_t* b, uint32_t* r) { for (int i = 0; i < W; i++) r[i] = a[i] | b[i]; };
+        static RT_INLINE void Xor(const uint32_t* a, const uint32_t* b, uint32_t* r) { for (int i = 0; i < W; i++) r[i] = a[i] ^ b[i]; };
+        static RT_INLINE void Not(const uint32_t* a, uint32_t* r) { for (int i = 0; i < W; i++) r[i] = ~a[i]; };
+        static RT_INLINE bool Any(const uint32_t* a) { uint32_t o = 0u; for (int i = 0; i < W; i++) o |= a[i]; return (o != 0u); };
+        static RT_INLINE uint64_t Bits(const uint32_t* a) { uint64_t b = 0; for (int i = 0; i < W; i++) b |= static_cast<uint64_t>(a[i] & 1u) << i; return (b); };
+};
+
+#if defined(RT_SIMD_SSE)
+template <>
+struct PacketKernel<4>
+{
+    public:
+        static RT_INLINE void Fill(float a, float* r) { _mm_store_ps(r, _mm_set1_ps(a)); };
+        static RT_INLINE void LoadU(const float* a, float* r) { _mm_store_ps(r, _mm_loadu_ps(a)); };
+        static RT_INLINE void Add(const float* a, const float* b, float* r) { _mm_store_ps(r, _mm_add_ps(_mm_load_ps(a), _mm_load_ps(b))); };
+        static RT_INLINE void Sub(const float* a, const float* b, float* r) { _mm_store_ps(r, _mm_sub_ps(_mm_load_ps(a), _mm_load_ps(b))); };
+        static RT_INLINE void Mul(const float* a, const float* b, float* r) { _mm_store_ps(r, _mm_mul_ps(_mm_load_ps(a), _mm_load_ps(b))); };
+        static RT_INLINE void Div(const float* a, const float* b, float* r) { _mm_store_ps(r, _mm_div_ps(_mm_load_ps(a), _mm_load_ps(b))); };
+        // Operands swapped so that NaN and signed zero behave like std::min/std::max.
+        static RT_INLINE void Min(const float* a, const float* b, float* r) { _mm_store_ps(r, _mm_min_ps(_mm_load_ps(b), _mm_load_ps(a))); };
+        static RT_INLINE void Max(const float* a, const float* b, float* r) { _mm_store_ps(r, _mm_max_ps(_mm_load_ps(b), _mm_load_ps(a))); };
+        static RT_INLINE void Sqrt(const float* a, float* r) { _mm_store_ps(r, _mm_sqrt_ps(_mm_load_ps(a))); };
+        static RT_INLINE void Less(const float* a, const float* b, uint32_t* r) { _mm_store_ps(reinterpret_cast<float*>(r), _mm_cmplt_ps(_mm_load_ps(a), _mm_load_ps(b))); };
+        static RT_INLINE void LessEqual(const float* a, const float* b, uint32_t* r) { _mm_store_ps(reinterpret_cast<float*>(r), _mm_cmple_ps(_mm_load_ps(a), _mm_load_ps(b))); };
+        static RT_INLINE void Equal(const float* a, const float* b, uint32_t* r) { _mm_store_ps(reinterpret_cast<float*>(r), _mm_cmpeq_ps(_mm_load_ps(a), _mm_load_ps(b))); };
+        static RT_INLINE void Blend(const uint32_t* m, const float* a, const float* b, float* r)
+        {
+            const __m128 mask = _mm_load_ps(reinterpret_cast<const float*>(m));
+            _mm_store_ps(r, _mm_or_ps(_mm_and_ps(mask, _mm_load_ps(a)), _mm_andnot_ps(mask, _mm_load_ps(b))));
+        };
+        static RT_INLINE void And(const uint32_t* a, const uint32_t* b, uint32_t* r) { _mm_store_ps(reinterpret_cast<float*>(r), _mm_and_ps(LoadMask(a), LoadMask(b))); };
+        static RT_INLINE void Or(const uint32_t* a, const uint32_t* b, uint32_t* r) { _mm_store_ps(reinterpret_cast<float*>(r), _mm_or_ps(LoadMask(a), LoadMask(b))); };
+        static RT_INLINE void Xor(const uint32_t* a, const uint32_t* b, uint32_t* r) { _mm_store_ps(reinterpret_cast<float*>(r), _mm_xor_ps(LoadMask(a), LoadMask(b))); };
+        static RT_INLINE void Not(const uint32_t* a, uint32_t* r) { _mm_store_ps(reinterpret_cast<float*>(r), _mm_xor_ps(LoadMask(a), _mm_castsi128_ps(_mm_set1_epi32(-1)))); };
+        static RT_INLINE bool Any(const uint32_t* a) { return (_mm_movemask_ps(LoadMask(a)) != 0); };
+        static RT_INLINE uint64_t Bits(const uint32_t* a) { return (static_cast<uint64_t>(_mm_movemask_ps(LoadMask(a)))); };
+
+    private:
+        static RT_INLINE __m128 LoadMask(const uint32_t* m) { return (_mm_load_ps(reinterpret_cast<const float*>(m))); };
+};
+#endif
+
+#if defined(RT_SIMD_AVX)
+template <>
+struct PacketKernel<8>
+{
+    public:
+        static RT_INLINE void Fill(float a, float* r) { _mm256_store_ps(r, _mm256_set1_ps(a)); };
+        static RT_INLINE void LoadU(const float* a, float* r) { _mm256_store_ps(r, _mm256_loadu_ps(a)); };
+        static RT_INLINE void Add(const float* a, const float* b, float* r) { _mm256_store_ps(r, _mm256_add_ps(_mm256_load_ps(a), _mm256_load_ps(b))); };
+        static RT_INLINE void Sub(const float* a, const float* b, float* r) { _mm256_store_ps(r, _mm256_sub_ps(_mm256_load_ps(a), _mm256_load_ps(b))); };
+        static RT_INLINE void Mul(const float* a, const float* b, float* r) { _mm256_store_ps(r, _mm256_mul_ps(_mm256_load_ps(a), _mm256_load_ps(b))); };
+        static RT_INLINE void Div(const float* a, const float* b, float* r) { _mm256_store_ps(r, _mm256_div_ps(_mm256_load_ps(a), _mm256_load_ps(b))); };
+        static RT_INLINE void Min(const float* a, const float* b, float* r) { _mm256_store_ps(r, _mm256_min_ps(_mm256_load_ps(b), _mm256_load_ps(a))); };
+        static RT_INLINE void Max(const float* a, const float* b, float* r) { _mm256_store_ps(r, _mm256_max_ps(_mm256_load_ps(b), _mm256_load_ps(a))); };
+        static RT_INLINE void Sqrt(const float* a, float* r) { _mm256_store_ps(r, _mm256_sqrt_ps(_mm256_load_ps(a))); };
+        static RT_INLINE void Less(const float* a, const float* b, uint32_t* r) { _mm256_store_ps(reinterpret_cast<float*>(r), _mm256_cmp_ps(_mm256_load_ps(a), _mm256_load_ps(b), _CMP_LT_OQ)); };
+        static RT_INLINE void LessEqual(const float* a, const float* b, uint32_t* r) { _mm256_store_ps(reinterpret_cast<float*>(r), _mm256_cmp_ps(_mm256_load_ps(a), _mm256_load_ps(b), _CMP_LE_OQ)); };
+        static RT_INLINE void Equal(const float* a, const float* b, uint32_t* r) { _mm256_store_ps(reinterpret_cast<float*>(r), _mm256_cmp_ps(_mm256_load_ps(a), _mm256_load_ps(b), _CMP_EQ_OQ)); };
+        static RT_INLINE void Blend(const uint32_t* m, const float* a, const float* b, float* r)
+        {
+            _mm256_store_ps(r, _mm256_blendv_ps(_mm256_load_ps(b), _mm256_load_ps(a), _mm256_load_ps(reinterpret_cast<const float*>(m))));
+        };
+        static RT_INLINE void And(const uint32_t* a, const uint32_t* b, uint32_t* r) { _mm256_store_ps(reinterpret_cast<float*>(r), _mm256_and_ps(LoadMask(a), LoadMask(b))); };
+        static RT_INLINE void Or(const uint32_t* a, const uint32_t* b, uint32_t* r) { _mm256_store_ps(reinterpret_cast<float*>(r), _mm256_or_ps(LoadMask(a), LoadMask(b))); };
+        static RT_INLINE void Xor(const uint32_t* a, const uint32_t* b, uint32_t* r) { _mm256_store_ps(reinterpret_cast<float*>(r), _mm256_xor_ps(LoadMask(a), LoadMask(b))); };
+        static RT_INLINE void Not(const uint32_t* a, uint32_t* r) { _mm256_store_ps(reinterpret_cast<float*>(r), _mm256_xor_ps(LoadMask(a), _mm256_castsi256_ps(_mm256_set1_epi32(-1)))); };
+        static RT_INLINE bool Any(const uint32_t* a) { return (_mm256_movemask_ps(LoadMask(a)) != 0); };
+        static RT_INLINE uint64_t Bits(const uint32_t* a) { return (static_cast<uint64_t>(_mm256_movemask_ps(LoadMask(a)))); };
+
+    private:
+        static RT_INLINE __m256 LoadMask(const uint32_t* m) { return (_mm256_load_ps(reinterpret_cast<const float*>(m))); };
+};
+#endif
+
+/*** @brief Per-lane boolean, stored as all-ones or all-zeros 32-bit lanes. */
+template <int W>
+struct RT_ALIGN(RT_PACKET_ALIGN(W)) MaskxW
+{
+    public:
+        /*** @brief Default constructor. All lanes false. */
+        RT_INLINE MaskxW(void) { for (int i = 0; i < W; i++) m[i] = 0u; };
+
+        /**
+         * @brief Initializes all lanes to the same value.
+         *
+         * @param b The value for every lane.
+         */
+        RT_INLINE explicit MaskxW(bool b) { for (int i = 0; i < W; i++) m[i] = b ? ~0u : 0u; };
+
+        RT_INLINE MaskxW operator&(const MaskxW& o) const { MaskxW r; PacketKernel<W>::And(m, o.m, r.m); return (r); };
+        RT_INLINE MaskxW operator|(const MaskxW& o) const { MaskxW r; PacketKernel<W>::Or(m, o.m, r.m); return (r); };
+        RT_INLINE MaskxW operator^(const MaskxW& o) const { MaskxW r; PacketKernel<W>::Xor(m, o.m, r.m); return (r); };
+        RT_INLINE MaskxW operator!(void) const { MaskxW r; PacketKernel<W>::Not(m, r.m); return (r); };
+
+        /*** @brief True if lane i is set. */
+        RT_INLINE bool operator[](int i) const { return (m[i] != 0u); };
+
+        /*** @brief Sets lane i. */
+        RT_INLINE void Set(int i, bool b) { m[i] = b ? ~0u : 0u; };
+
+        /*** @brief Lane i in bit i. Only meaningful for W <= 64. */
+        RT_INLINE uint64_t Bits(void) const { return (PacketKernel<W>::Bits(m)); };
+
+        /*** @brief True if any lane is set. */
+        RT_INLINE bool Any(void) const { return (PacketKernel<W>::Any(m)); };
+
+        /*** @brief True if every lane is set. */
+        RT_INLINE bool All(void) const { uint32_t a = ~0u; for (int i = 0; i < W; i++) a &= m[i]; return (a != 0u); };
+
+        /*** @brief True if no lane is set. */
+        RT_INLINE bool None(void) const { return (!Any()); };
+
+        /*** @brief Number of lanes set. */
+        RT_INLINE int Count(void) const { int c = 0; for (int i = 0; i < W; i++) c += m[i] ? 1 : 0; return (c); };
+
+        /*** @brief Lanes, all-ones when true. */
+        uint32_t m[W];
+};
+
+/*** @brief W floats processed together. */
+template <int W>
+struct RT_ALIGN(RT_PACKET_ALIGN(W)) FloatxW
+{
+    public:
+        /*** @brief Default constructor. All lanes 0. */
+        RT_INLINE FloatxW(void) { PacketKernel<W>::Fill(0.0F, v); };
+
+        /**
+         * @brief Broadcasts a value to every lane.
+         *
+         * @param a The value.
+         */
+        RT_INLINE FloatxW(float a) { PacketKernel<W>::Fill(a, v); };
+
+        /**
+         * @brief Loads W consecutive floats.
+         *
+         * @param src Source, no alignment required.
+         *
+         * @return The packet.
+         */
+        static RT_INLINE FloatxW Load(const float* src) { FloatxW r; PacketKernel<W>::LoadU(src, r.v); return (r); };
+
+        /**
+         * @brief Stores the W lanes to consecutive floats.
+         *
+         * @param dst Destination, no alignment required.
+         */
+        RT_INLINE void Store(float* dst) const { for (int i = 0; i < W; i++) dst[i] = v[i]; };
+
+        RT_INLINE FloatxW operator+(const FloatxW& o) const { FloatxW r; PacketKernel<W>::Add(v, o.v, r.v); return (r); };
+        RT_INLINE FloatxW operator-(const FloatxW& o) const { FloatxW r; PacketKernel<W>::Sub(v, o.v, r.v); return (r); };
+        RT_INLINE FloatxW operator*(const FloatxW& o) const { FloatxW r; PacketKernel<W>::Mul(v, o.v, r.v); return (r); };
+        RT_INLINE FloatxW operator/(const FloatxW& o) const { FloatxW r; PacketKernel<W>::Div(v, o.v, r.v); return (r); };
+        RT_INLINE FloatxW operator-(void) const { FloatxW r; for (int i = 0; i < W; i++) r.v[i] = -v[i]; return (r); };
+        RT_INLINE void operator+=(const FloatxW& o) { *this = *this + o; };
+        RT_INLINE void operator-=(const FloatxW& o) { *this = *this - o; };
+        RT_INLINE void operator*=(const FloatxW& o) { *this = *this * o; };
+        RT_INLINE void operator/=(const FloatxW& o) { *this = *this / o; };
+
+        RT_INLINE MaskxW<W> operator<(const FloatxW& o) const { MaskxW<W> r; PacketKernel<W>::Less(v, o.v, r.m); return (r); };
+        RT_INLINE MaskxW<W> operator<=(const FloatxW& o) const { MaskxW<W> r; PacketKernel<W>::LessEqual(v, o.v, r.m); return (r); };
+        RT_INLINE MaskxW<W> operator>(const FloatxW& o) const { return (o < *this); };
+        RT_INLINE MaskxW<W> operator>=(const FloatxW& o) const { return (o <= *this); };
+        RT_INLINE MaskxW<W> operator==(const FloatxW& o) const { MaskxW<W> r; PacketKernel<W>::Equal(v, o.v, r.m); return (r); };
+        RT_INLINE MaskxW<W> operator!=(const FloatxW& o) const { return (!(*this == o)); };
+
+        RT_INLINE float operator[](int i) const { return (v[i]); };
+        RT_INLINE float& operator[](int i) { return (v[i]); };
+
+        static RT_INLINE FloatxW Min(const FloatxW& a, const FloatxW& b) { FloatxW r; PacketKernel<W>::Min(a.v, b.v, r.v); return (r); };
+        static RT_INLINE FloatxW Max(const FloatxW& a, const FloatxW& b) { FloatxW r; PacketKernel<W>::Max(a.v, b.v, r.v); return (r); };
+        static RT_INLINE FloatxW Sqrt(const FloatxW& a) { FloatxW r; PacketKernel<W>::Sqrt(a.v, r.v); return (r); };
+
+        /**
+         * @brief Per-lane select.
+         *
+         * @param m The mask.
+         * @param a Lanes taken where the mask is set.
+         * @param b Lanes taken elsewhere.
+         *
+         * @return The blended packet.
+         */
+        static RT_INLINE FloatxW Blend(const MaskxW<W>& m, const FloatxW& a, const FloatxW& b) { FloatxW r; PacketKernel<W>::Blend(m.m, a.v, b.v, r.v); return (r); };
+
+        /*** @brief Lanes */
+        float v[W];
+};
+
+/**
+ * @brief W three-dimensional vectors in SoA layout, mirroring the Vec3 API.
+ *
+ * Masked arithmetic is expressed with the Masked* helpers: inactive lanes
+ * keep the value of the first operand.
+ */
+template <int W>
+struct Vec3xW
+{
+    public:
+        /*** @brief Default constructor. Initializes every lane to (0, 0, 0). */
+        RT_INLINE Vec3xW(void) {};
+
+        /**
+         * @brief Initializes from three packets.
+         *
+         * @param x The x components
+         * @param y The y components
+         * @param z The z components
+         */
+        RT_INLINE Vec3xW(const FloatxW<W>& x, const FloatxW<W>& y, const FloatxW<W>& z) : x(x), y(y), z(z) {};
+
+        /**
+         * @brief Broadcasts one vector to every lane.
+         *
+         * @param a Any type exposing x, y and z (Vec3, Vec3A, ...).
+         *
+         * @return The packet.
+         */
+        template <typename V>
+        static RT_INLINE Vec3xW Broadcast(const V& a) { return (Vec3xW(FloatxW<W>(a.x), FloatxW<W>(a.y), FloatxW<W>(a.z))); };
+
+        /**
+         * @brief Transposes W consecutive AoS vectors into a packet.
+         *
+         * @param src W vectors of any type exposing x, y and z.
+         *
+         * @return The packet.
+         */
+        template <typename V>
+        static RT_INLINE Vec3xW Gather(const V* src)
+        {
+            Vec3xW r;
+            for (int i = 0; i < W; i++)
+            {
+                r.x.v[i] = src[i].x;
+                r.y.v[i] = src[i].y;
+                r.z.v[i] = src[i].z;
+            }
+            return (r);
+        };
+
+        /**
+         * @brief Transposes the packet back into W AoS vectors.
+         *
+         * @param dst W vectors of any type exposing x, y and z.
+         */
+        template <typename V>
+        RT_INLINE void Scatter(V* dst) const
+        {
+            for (int i = 0; i < W; i++)
+            {
+                dst[i].x = x.v[i];
+                dst[i].y = y.v[i];
+                dst[i].z = z.v[i];
+            }
+        };
+
+        /**
+         * @brief Loads W vectors from three SoA arrays.
+         *
+         * @param xs The x components.
+         * @param ys The y components.
+         * @param zs The z components.
+         *
+         * @return The packet.
+         */
+        static RT_INLINE Vec3xW Load(const float* xs, const float* ys, const float* zs)
+        {
+            return (Vec3xW(FloatxW<W>::Load(xs), FloatxW<W>::Load(ys), FloatxW<W>::Load(zs)));
+        };
+
+        RT_INLINE Vec3xW operator+(const Vec3xW& o) const { return (Vec3xW(x + o.x, y + o.y, z + o.z)); };
+        RT_INLINE Vec3xW operator-(const Vec3xW& o) const { return (Vec3xW(x - o.x, y - o.y, z - o.z)); };
+        RT_INLINE Vec3xW operator*(const Vec3xW& o) const { return (Vec3xW(x * o.x, y * o.y, z * o.z)); };
+        RT_INLINE Vec3xW operator/(const Vec3xW& o) const { return (Vec3xW(x / o.x, y / o.y, z / o.z)); };
+        RT_INLINE Vec3xW operator*(const FloatxW<W>& f) const { return (Vec3xW(x * f, y * f, z * f)); };
+        RT_INLINE Vec3xW operator/(const FloatxW<W>& f) const { return (Vec3xW(x / f, y / f, z / f)); };
+        RT_INLINE Vec3xW operator-(void) const { return (Vec3xW(-x, -y, -z)); };
+        RT_INLINE void operator+=(const Vec3xW& o) { *this = *this + o; };
+        RT_INLINE void operator-=(const Vec3xW& o) { *this = *this - o; };
+        RT_INLINE void operator*=(const Vec3xW& o) { *this = *this * o; };
+        RT_INLINE void operator/=(const Vec3xW& o) { *this = *this / o; };
+        RT_INLINE void operator*=(const FloatxW<W>& f) { *this = *this * f; };
+        RT_INLINE void operator/=(const FloatxW<W>& f) { *this = *this / f; };
+
+        /*** @brief Lanes where all three components are equal. */
+        RT_INLINE MaskxW<W> operator==(const Vec3xW& o) const { return ((x == o.x) & (y == o.y) & (z == o.z)); };
+        RT_INLINE MaskxW<W> operator!=(const Vec3xW& o) const { return (!(*this == o)); };
+
+        static RT_INLINE Vec3xW Min(const Vec3xW& a, const Vec3xW& b) { return (Vec3xW(FloatxW<W>::Min(a.x, b.x), FloatxW<W>::Min(a.y, b.y), FloatxW<W>::Min(a.z, b.z))); };
+        static RT_INLINE Vec3xW Max(const Vec3xW& a, const Vec3xW& b) { return (Vec3xW(FloatxW<W>::Max(a.x, b.x), FloatxW<W>::Max(a.y, b.y), FloatxW<W>::Max(a.z, b.z))); };
+
+        static RT_INLINE Vec3xW Cross(const Vec3xW& a, const Vec3xW& b)
+        {
+            return (Vec3xW(
+                (a.y * b.z) - (a.z * b.y),
+                (a.z * b.x) - (a.x * b.z),
+                (a.x * b.y) - (a.y * b.x)
+            ));
+        };
+
+        static RT_INLINE FloatxW<W> Dot(const Vec3xW& a, const Vec3xW& b) { return ((a.x * b.x) + (a.y * b.y) + (a.z * b.z)); };
+        static RT_INLINE FloatxW<W> Length(const Vec3xW& a) { return (FloatxW<W>::Sqrt(Dot(a, a))); };
+        static RT_INLINE FloatxW<W> Distance(const Vec3xW& a, const Vec3xW& b) { return (Length(a - b)); };
+        static RT_INLINE Vec3xW Normalize(const Vec3xW& a) { return (a / Length(a)); };
+
+        static RT_INLINE Vec3xW Blend(const MaskxW<W>& m, const Vec3xW& a, const Vec3xW& b)
+        {
+            return (Vec3xW(FloatxW<W>::Blend(m, a.x, b.x), FloatxW<W>::Blend(m, a.y, b.y), FloatxW<W>::Blend(m, a.z, b.z)));
+        };
+
+        static RT_INLINE Vec3xW MaskedAdd(const MaskxW<W>& m, const Vec3xW& a, const Vec3xW& b) { return (Blend(m, a + b, a)); };
+        static RT_INLINE Vec3xW MaskedSub(const MaskxW<W>& m, const Vec3xW& a, const Vec3xW& b) { return (Blend(m, a - b, a)); };
+        static RT_INLINE Vec3xW MaskedMul(const MaskxW<W>& m, const Vec3xW& a, const Vec3xW& b) { return (Blend(m, a * b, a)); };
+        static RT_INLINE Vec3xW MaskedMul(const MaskxW<W>& m, const Vec3xW& a, const FloatxW<W>& f) { return (Blend(m, a * f, a)); };
+
+        /**
+         * @brief Normalizes the active lanes only; inactive lanes are left as
+         *        is, so zero-length vectors there produce no NaN.
+         */
+        static RT_INLINE Vec3xW MaskedNormalize(const MaskxW<W>& m, const Vec3xW& a)
+        {
+            FloatxW<W> l = FloatxW<W>::Blend(m, Length(a), FloatxW<W>(1.0F));
+            return (Blend(m, a / l, a));
+        };
+
+        /*** @brief X, Y, Z packets */
+        FloatxW<W> x, y, z;
+};
+
+typedef FloatxW<4> Floatx4;
+typedef FloatxW<8> Floatx8;
+typedef FloatxW<16> Floatx16;
+typedef MaskxW<4> Maskx4;
+typedef MaskxW<8> Maskx8;
+typedef MaskxW<16> Maskx16;
+typedef Vec3xW<4> Vec3x4;
+typedef Vec3xW<8> Vec3x8;
+typedef Vec3xW<16> Vec3x16;
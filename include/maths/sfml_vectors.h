@@ -0,0 +1,68 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <SFML/System/Vector2.hpp>
+#include <SFML/System/Vector3.hpp>
+#include "maths/vec2.h"
+#include "maths/vec3.h"
+#include "maths/vec4.h"
+
+/**
+ * SFML interop for the maths types, kept out of the core headers so that
+ * headless builds never see SFML. Replaces the former implicit
+ * `operator sf::Vector*f` conversions and the toSFMLVector members.
+ */
+
+/*** @brief Converts to an SFML 2D vector. */
+inline sf::Vector2f toSFMLVector(const Vec2& v)
+{
+    return (sf::Vector2f(v.x, v.y));
+};
+
+/*** @brief Converts to an SFML 3D vector. */
+inline sf::Vector3f toSFMLVector(const Vec3& v)
+{
+    return (sf::Vector3f(v.x, v.y, v.z));
+};
+
+/*** @brief Converts to an SFML 3D vector, discarding w. */
+inline sf::Vector3f toSFMLVector(const Vec4& v)
+{
+    return (sf::Vector3f(v.x, v.y, v.z));
+};
+
+/*** @brief Converts from an SFML 2D vector. */
+inline Vec2 fromSFMLVector(const sf::Vector2f& v)
+{
+    return (Vec2(v.x, v.y));
+};
+
+/*** @brief Converts from an SFML 3D vector. */
+inline Vec3 fromSFMLVector(const sf::Vector3f& v)
+{
+    return (Vec3(v.x, v.y, v.z));
+};
@@ -0,0 +1,381 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#pragma once
+
+#include <cmath>
+#include "config.h"
+
+/**
+ * @brief Compile-time selected SIMD kernels shared by the maths types.
+ *
+ * Every kernel performs the same IEEE operations, in the same order, as the
+ * scalar code it replaces, so results are bit-identical whichever path is
+ * compiled (no FMA contraction, no reassociated sums, no reciprocal
+ * approximations).
+ */
+struct Simd
+{
+    public:
+        /**
+         * @brief Row-major 4x4 product: out[i][j] = sum over k of a[i][k] * b[k][j],
+         *        summed from k = 0 to 3. `out` may alias `a` or `b`.
+         *
+         * @param a Left matrix.
+         * @param b Right matrix.
+         * @param out Result.
+         */
+        static inline void Mat4Multiply(const float a[4][4], const float b[4][4], float out[4][4]);
+
+        /**
+         * @brief General 4x4 inverse from the twelve 2x2 sub-determinants of
+         *        the top and bottom row pairs. `out` may alias `m`.
+         *
+         * @param m The matrix to invert.
+         * @param out The inverse; left untouched when the matrix is singular.
+         *
+         * @return False if the determinant is zero or not finite.
+         */
+        static inline bool Mat4Inverse(const float m[4][4], float out[4][4]);
+
+        /**
+         * @brief Inverse of an affine transform given as three rows [R | t]:
+         *        [R^-1 | -R^-1 t], from the cofactors of R. `out` may alias `m`.
+         *
+         * @param m Rows 0-2 of the transform; a fourth row is never read.
+         * @param out The inverse rows; left untouched when R is singular.
+         *
+         * @return False if det(R) is zero or not finite.
+         */
+        static inline bool AffineInverse(const float m[][4], float out[][4]);
+
+        /**
+         * @brief Inverse transpose of the upper 3x3 of `m`, for normals.
+         *        Column 3 of `out` is set to 0. `out` may alias `m`.
+         *
+         * @param m Rows 0-2 of the transform.
+         * @param out The normal matrix rows; left untouched when singular.
+         *
+         * @return False if the 3x3 determinant is zero or not finite.
+         */
+        static inline bool NormalMatrix(const float m[][4], float out[][4]);
+
+    private:
+        /*** @brief Scalar cofactors of the upper 3x3, as computed lane-wise by Cross. */
+        static inline bool Cofactors3x3(const float m[][4], float cof[3][3], float* inv);
+
+    public:
+
+#if defined(RT_SIMD_SSE)
+        /**
+         * @brief Sum of the first three lanes, as ((x + y) + z).
+         *
+         * @param v The vector to reduce.
+         *
+         * @return The sum.
+         */
+        static inline float HorizontalAdd3(__m128 v);
+
+        /**
+         * @brief Sum of the four lanes, as (((x + y) + z) + w).
+         *
+         * @param v The vector to reduce.
+         *
+         * @return The sum.
+         */
+        static inline float HorizontalAdd4(__m128 v);
+
+        /**
+         * @brief Lane-wise (a.yzx * b.zxy) - (a.zxy * b.yzx); lane 3 is 0.
+         *
+         * @param a Left operand.
+         * @param b Right operand.
+         *
+         * @return The cross product.
+         */
+        static inline __m128 Cross(__m128 a, __m128 b);
+#endif
+};
+
+inline void Simd::Mat4Multiply(const float a[4][4], const float b[4][4], float out[4][4])
+{
+#if defined(RT_SIMD_AVX)
+    const __m256 b0 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b[0]));
+    const __m256 b1 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b[1]));
+    const __m256 b2 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b[2]));
+    const __m256 b3 = _mm256_broadcast_ps(reinterpret_cast<const __m128 *>(b[3]));
+    __m256 r[2];
+    for (int i = 0; i < 2; i++)
+    {
+        const float *lo = a[2 * i];
+        const float *hi = a[2 * i + 1];
+        __m256 acc = _mm256_mul_ps(_mm256_setr_ps(lo[0], lo[0], lo[0], lo[0], hi[0], hi[0], hi[0], hi[0]), b0);
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_setr_ps(lo[1], lo[1], lo[1], lo[1], hi[1], hi[1], hi[1], hi[1]), b1));
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_setr_ps(lo[2], lo[2], lo[2], lo[2], hi[2], hi[2], hi[2], hi[2]), b2));
+        acc = _mm256_add_ps(acc, _mm256_mul_ps(_mm256_setr_ps(lo[3], lo[3], lo[3], lo[3], hi[3], hi[3], hi[3], hi[3]), b3));
+        r[i] = acc;
+    }
+    _mm256_storeu_ps(out[0], r[0]);
+    _mm256_storeu_ps(out[2], r[1]);
+#elif defined(RT_SIMD_SSE)
+    const __m128 b0 = _mm_loadu_ps(b[0]);
+    const __m128 b1 = _mm_loadu_ps(b[1]);
+    const __m128 b2 = _mm_loadu_ps(b[2]);
+    const __m128 b3 = _mm_loadu_ps(b[3]);
+    __m128 r[4];
+    for (int i = 0; i < 4; i++)
+    {
+        __m128 acc = _mm_mul_ps(_mm_set1_ps(a[i][0]), b0);
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(a[i][1]), b1));
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(a[i][2]), b2));
+        acc = _mm_add_ps(acc, _mm_mul_ps(_mm_set1_ps(a[i][3]), b3));
+        r[i] = acc;
+    }
+    for (int i = 0; i < 4; i++)
+        _mm_storeu_ps(out[i], r[i]);
+#else
+    float r[4][4];
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            r[i][j] = (a[i][0] * b[0][j]) + (a[i][1] * b[1][j]) + (a[i][2] * b[2][j]) + (a[i][3] * b[3][j]);
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            out[i][j] = r[i][j];
+#endif
+};
+
+inline bool Simd::Mat4Inverse(const float m[4][4], float out[4][4])
+{
+    // s[k] and c[k] are the 2x2 determinants of columns (i, j) in rows 0-1 and
+    // rows 2-3 respectively, for (i, j) = (0,1) (0,2) (0,3) (1,2) (1,3) (2,3).
+    // Output row i is (P1 * D1 - P2 * D2) + P3 * D3, where the P are columns
+    // of m with rows reordered to (1, 0, 3, 2), the D are (c, c, s, s)
+    // vectors, and every other lane is negated.
+    static const int skip[4][3] = { { 1, 2, 3 }, { 0, 2, 3 }, { 0, 1, 3 }, { 0, 1, 2 } };
+    static const int pair[4][3] = { { 5, 4, 3 }, { 5, 2, 1 }, { 4, 2, 0 }, { 3, 1, 0 } };
+#if defined(RT_SIMD_SSE)
+    const __m128 r0 = _mm_loadu_ps(m[0]);
+    const __m128 r1 = _mm_loadu_ps(m[1]);
+    const __m128 r2 = _mm_loadu_ps(m[2]);
+    const __m128 r3 = _mm_loadu_ps(m[3]);
+    // (s0, s1, s2, s3), (c0, c1, c2, c3) and (s4, s5, c4, c5).
+    const __m128 s03 = _mm_sub_ps(
+        _mm_mul_ps(_mm_shuffle_ps(r0, r0, _MM_SHUFFLE(1, 0, 0, 0)), _mm_shuffle_ps(r1, r1, _MM_SHUFFLE(2, 3, 2, 1))),
+        _mm_mul_ps(_mm_shuffle_ps(r1, r1, _MM_SHUFFLE(1, 0, 0, 0)), _mm_shuffle_ps(r0, r0, _MM_SHUFFLE(2, 3, 2, 1))));
+    const __m128 c03 = _mm_sub_ps(
+        _mm_mul_ps(_mm_shuffle_ps(r2, r2, _MM_SHUFFLE(1, 0, 0, 0)), _mm_shuffle_ps(r3, r3, _MM_SHUFFLE(2, 3, 2, 1))),
+        _mm_mul_ps(_mm_shuffle_ps(r3, r3, _MM_SHUFFLE(1, 0, 0, 0)), _mm_shuffle_ps(r2, r2, _MM_SHUFFLE(2, 3, 2, 1))));
+    const __m128 lo01 = _mm_shuffle_ps(r0, r2, _MM_SHUFFLE(2, 1, 2, 1));
+    const __m128 lo23 = _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(2, 1, 2, 1));
+    const __m128 hi01 = _mm_shuffle_ps(r0, r2, _MM_SHUFFLE(3, 3, 3, 3));
+    const __m128 hi23 = _mm_shuffle_ps(r1, r3, _MM_SHUFFLE(3, 3, 3, 3));
+    const __m128 sc45 = _mm_sub_ps(_mm_mul_ps(lo01, hi23), _mm_mul_ps(lo23, hi01));
+
+    float s[6], c[6];
+    float tmp[4];
+    _mm_storeu_ps(s, s03);
+    _mm_storeu_ps(c, c03);
+    _mm_storeu_ps(tmp, sc45);
+    s[4] = tmp[0]; s[5] = tmp[1]; c[4] = tmp[2]; c[5] = tmp[3];
+#else
+    static const int ci[6] = { 0, 0, 0, 1, 1, 2 };
+    static const int cj[6] = { 1, 2, 3, 2, 3, 3 };
+    float s[6], c[6];
+    for (int k = 0; k < 6; k++)
+    {
+        s[k] = m[0][ci[k]] * m[1][cj[k]] - m[1][ci[k]] * m[0][cj[k]];
+        c[k] = m[2][ci[k]] * m[3][cj[k]] - m[3][ci[k]] * m[2][cj[k]];
+    }
+#endif
+
+    const float det = s[0] * c[5] - s[1] * c[4] + s[2] * c[3] + s[3] * c[2] - s[4] * c[1] + s[5] * c[0];
+    if (det == 0.0F || !std::isfinite(det))
+        return (false);
+    const float inv = 1.0F / det;
+
+#if defined(RT_SIMD_SSE)
+    const __m128 p[4] = {
+        _mm_shuffle_ps(_mm_shuffle_ps(r1, r0, _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(r3, r2, _MM_SHUFFLE(0, 0, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0)),
+        _mm_shuffle_ps(_mm_shuffle_ps(r1, r0, _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(r3, r2, _MM_SHUFFLE(1, 1, 1, 1)), _MM_SHUFFLE(2, 0, 2, 0)),
+        _mm_shuffle_ps(_mm_shuffle_ps(r1, r0, _MM_SHUFFLE(2, 2, 2, 2)), _mm_shuffle_ps(r3, r2, _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0)),
+        _mm_shuffle_ps(_mm_shuffle_ps(r1, r0, _MM_SHUFFLE(3, 3, 3, 3)), _mm_shuffle_ps(r3, r2, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0))
+    };
+    const __m128 d[6] = {
+        _mm_shuffle_ps(c03, s03, _MM_SHUFFLE(0, 0, 0, 0)),
+        _mm_shuffle_ps(c03, s03, _MM_SHUFFLE(1, 1, 1, 1)),
+        _mm_shuffle_ps(c03, s03, _MM_SHUFFLE(2, 2, 2, 2)),
+        _mm_shuffle_ps(c03, s03, _MM_SHUFFLE(3, 3, 3, 3)),
+        _mm_shuffle_ps(sc45, sc45, _MM_SHUFFLE(0, 0, 2, 2)),
+        _mm_shuffle_ps(sc45, sc45, _MM_SHUFFLE(1, 1, 3, 3))
+    };
+    const __m128 even = _mm_castsi128_ps(_mm_setr_epi32(0, static_cast<int>(0x80000000u), 0, static_cast<int>(0x80000000u)));
+    const __m128 odd = _mm_castsi128_ps(_mm_setr_epi32(static_cast<int>(0x80000000u), 0, static_cast<int>(0x80000000u), 0));
+    const __m128 scale = _mm_set1_ps(inv);
+    __m128 r[4];
+    for (int i = 0; i < 4; i++)
+    {
+        __m128 acc = _mm_sub_ps(_mm_mul_ps(p[skip[i][0]], d[pair[i][0]]), _mm_mul_ps(p[skip[i][1]], d[pair[i][1]]));
+        acc = _mm_add_ps(acc, _mm_mul_ps(p[skip[i][2]], d[pair[i][2]]));
+        r[i] = _mm_mul_ps(_mm_xor_ps(acc, (i & 1) ? odd : even), scale);
+    }
+    for (int i = 0; i < 4; i++)
+        _mm_storeu_ps(out[i], r[i]);
+#else
+    static const int row[4] = { 1, 0, 3, 2 };
+    float r[4][4];
+    for (int i = 0; i < 4; i++)
+    {
+        for (int j = 0; j < 4; j++)
+        {
+            const float* d = (j < 2) ? c : s;
+            float acc = m[row[j]][skip[i][0]] * d[pair[i][0]] - m[row[j]][skip[i][1]] * d[pair[i][1]];
+            acc = acc + m[row[j]][skip[i][2]] * d[pair[i][2]];
+            r[i][j] = (((i + j) & 1) ? -acc : acc) * inv;
+        }
+    }
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            out[i][j] = r[i][j];
+#endif
+    return (true);
+};
+
+// cof rows are the cross products r1 x r2, r2 x r0 and r0 x r1 of the rows
+// of the upper 3x3, i.e. its cofactor matrix; `inv` receives 1 / det.
+inline bool Simd::Cofactors3x3(const float m[][4], float cof[3][3], float* inv)
+{
+    for (int i = 0; i < 3; i++)
+    {
+        const float* a = m[i == 2 ? 0 : i + 1];
+        const float* b = m[i == 0 ? 2 : i - 1];
+        cof[i][0] = a[1] * b[2] - a[2] * b[1];
+        cof[i][1] = a[2] * b[0] - a[0] * b[2];
+        cof[i][2] = a[0] * b[1] - a[1] * b[0];
+    }
+    const float det = (m[0][0] * cof[0][0] + m[0][1] * cof[0][1]) + m[0][2] * cof[0][2];
+    // det - det is NaN for infinite or NaN det, and 0 otherwise.
+    if (det == 0.0F || det - det != 0.0F)
+        return (false);
+    (*inv) = 1.0F / det;
+    return (true);
+};
+
+inline bool Simd::AffineInverse(const float m[][4], float out[][4])
+{
+#if defined(RT_SIMD_SSE)
+    const __m128 r0 = _mm_loadu_ps(m[0]);
+    const __m128 r1 = _mm_loadu_ps(m[1]);
+    const __m128 r2 = _mm_loadu_ps(m[2]);
+    const __m128 c0 = Cross(r1, r2);
+    const __m128 det = _mm_set1_ps(HorizontalAdd3(_mm_mul_ps(r0, c0)));
+    if (_mm_cvtss_f32(det) == 0.0F || _mm_cvtss_f32(_mm_sub_ss(det, det)) != 0.0F)
+        return (false);
+    const __m128 inv = _mm_div_ps(_mm_set1_ps(1.0F), det);
+    // Row j of the scaled cofactors is column j of R^-1.
+    __m128 s0 = _mm_mul_ps(c0, inv);
+    __m128 s1 = _mm_mul_ps(Cross(r2, r0), inv);
+    __m128 s2 = _mm_mul_ps(Cross(r0, r1), inv);
+    __m128 t = _mm_add_ps(_mm_add_ps(
+        _mm_mul_ps(s0, _mm_shuffle_ps(r0, r0, _MM_SHUFFLE(3, 3, 3, 3))),
+        _mm_mul_ps(s1, _mm_shuffle_ps(r1, r1, _MM_SHUFFLE(3, 3, 3, 3)))),
+        _mm_mul_ps(s2, _mm_shuffle_ps(r2, r2, _MM_SHUFFLE(3, 3, 3, 3))));
+    t = _mm_xor_ps(t, _mm_set1_ps(-0.0F));
+    _MM_TRANSPOSE4_PS(s0, s1, s2, t);
+    _mm_storeu_ps(out[0], s0);
+    _mm_storeu_ps(out[1], s1);
+    _mm_storeu_ps(out[2], s2);
+#else
+    float cof[3][3], inv;
+    if (!Cofactors3x3(m, cof, &inv))
+        return (false);
+    float r[3][4];
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 3; j++)
+            r[i][j] = cof[j][i] * inv;
+    for (int i = 0; i < 3; i++)
+        r[i][3] = -((r[i][0] * m[0][3] + r[i][1] * m[1][3]) + r[i][2] * m[2][3]);
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 4; j++)
+            out[i][j] = r[i][j];
+#endif
+    return (true);
+};
+
+inline bool Simd::NormalMatrix(const float m[][4], float out[][4])
+{
+#if defined(RT_SIMD_SSE)
+    const __m128 r0 = _mm_loadu_ps(m[0]);
+    const __m128 r1 = _mm_loadu_ps(m[1]);
+    const __m128 r2 = _mm_loadu_ps(m[2]);
+    const __m128 c0 = Cross(r1, r2);
+    const __m128 det = _mm_set1_ps(HorizontalAdd3(_mm_mul_ps(r0, c0)));
+    if (_mm_cvtss_f32(det) == 0.0F || _mm_cvtss_f32(_mm_sub_ss(det, det)) != 0.0F)
+        return (false);
+    const __m128 inv = _mm_div_ps(_mm_set1_ps(1.0F), det);
+    // Cross leaves lane 3 at +0, but 0 * inv is -0 for a negative determinant.
+    const __m128 xyz = _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0));
+    _mm_storeu_ps(out[0], _mm_and_ps(_mm_mul_ps(c0, inv), xyz));
+    _mm_storeu_ps(out[1], _mm_and_ps(_mm_mul_ps(Cross(r2, r0), inv), xyz));
+    _mm_storeu_ps(out[2], _mm_and_ps(_mm_mul_ps(Cross(r0, r1), inv), xyz));
+#else
+    float cof[3][3], inv;
+    if (!Cofactors3x3(m, cof, &inv))
+        return (false);
+    for (int i = 0; i < 3; i++)
+    {
+        for (int j = 0; j < 3; j++)
+            out[i][j] = cof[i][j] * inv;
+        out[i][3] = 0.0F;
+    }
+#endif
+    return (true);
+};
+
+#if defined(RT_SIMD_SSE)
+inline float Simd::HorizontalAdd3(__m128 v)
+{
+    __m128 s = _mm_add_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+    s = _mm_add_ss(s, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)));
+    return (_mm_cvtss_f32(s));
+};
+
+inline float Simd::HorizontalAdd4(__m128 v)
+{
+    __m128 s = _mm_add_ss(v, _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 1, 1, 1)));
+    s = _mm_add_ss(s, _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 2, 2, 2)));
+    s = _mm_add_ss(s, _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 3, 3, 3)));
+    return (_mm_cvtss_f32(s));
+};
+
+inline __m128 Simd::Cross(__m128 a, __m128 b)
+{
+    const __m128 a_yzx = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 0, 2, 1));
+    const __m128 a_zxy = _mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2));
+    const __m128 b_yzx = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1));
+    const __m128 b_zxy = _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 1, 0, 2));
+    __m128 r = _mm_sub_ps(_mm_mul_ps(a_yzx, b_zxy), _mm_mul_ps(a_zxy, b_yzx));
+    // Lane 3 is w*w - w*w, which is NaN when w is infinite.
+    return (_mm_and_ps(r, _mm_castsi128_ps(_mm_setr_epi32(-1, -1, -1, 0))));
+};
+#endif
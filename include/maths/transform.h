@@ -0,0 +1,261 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+#include <algorithm>
+#include "config.h"
+#include "utils/thread_pool.h"
+
+/**
+ * Batched transforms of float3 arrays.
+ *
+ * The matrix uses the Mat4 layout read by MultiplyPoint: out[r] is the dot
+ * of row r with (x, y, z, 1), so the translation is column 3. Inputs and
+ * outputs are strided in floats (3 for attrib_t arrays, WELD_INTERLEAVED_STRIDE
+ * for interleaved meshes); `src` and `dst` may be the same array when the
+ * strides match. With SSE, packed spans are transposed four vectors at a time
+ * into SoA registers and other strides use one register per vector; given a
+ * ThreadPool, large spans are split across its workers. Every vector gets exactly the result of the matching Mat4
+ * method. Only Points reads row 3, so Points3x4 and Vectors also accept the
+ * rows of an Affine3x4.
+ */
+struct Transform
+{
+    public:
+        /*** @brief Vectors per job below which a span is not split across threads. */
+        static const size_t minBatch = 64 * 1024;
+
+        /**
+         * @brief Mat4::MultiplyPoint over a span: full 4x4 with perspective divide.
+         *
+         * @param m The matrix.
+         * @param src First input vector.
+         * @param srcStride Floats between consecutive inputs, at least 3.
+         * @param dst First output vector.
+         * @param dstStride Floats between consecutive outputs, at least 3.
+         * @param count Number of vectors.
+         * @param pool Optional workers for large spans.
+         */
+        static inline void Points(const float m[4][4], const float* src, size_t srcStride,
+            float* dst, size_t dstStride, size_t count, ThreadPool* pool = NULL);
+
+        /*** @brief Mat4::MultiplyPoint3x4 over a span (affine, row 3 ignored). Same parameters as Points. */
+        static inline void Points3x4(const float m[4][4], const float* src, size_t srcStride,
+            float* dst, size_t dstStride, size_t count, ThreadPool* pool = NULL);
+
+        /**
+         * @brief Mat4::MultiplyVector over a span (upper 3x3 only). Normals
+         *        need the inverse transpose of the point matrix.
+         *
+         * Same parameters as Points.
+         */
+        static inline void Vectors(const float m[4][4], const float* src, size_t srcStride,
+            float* dst, size_t dstStride, size_t count, ThreadPool* pool = NULL);
+
+        /**
+         * @brief In-place Points3x4 over a packed xyz array such as attrib_t::vertices.
+         *
+         * @param m The matrix.
+         * @param xyz The array, 3 floats per vector.
+         * @param pool Optional workers for large arrays.
+         */
+        static inline void Points3x4(const float m[4][4], std::vector<float>* xyz, ThreadPool* pool = NULL);
+
+        /*** @brief In-place Vectors over a packed xyz array such as attrib_t::normals. */
+        static inline void Vectors(const float m[4][4], std::vector<float>* xyz, ThreadPool* pool = NULL);
+
+    private:
+        enum Kind { POINT, POINT_3X4, VECTOR };
+
+        template <int K>
+        static inline void Span(const float m[4][4], const float* src, size_t srcStride,
+            float* dst, size_t dstStride, size_t count);
+
+        template <int K>
+        static inline void Run(const float m[4][4], const float* src, size_t srcStride,
+            float* dst, size_t dstStride, size_t count, ThreadPool* pool);
+};
+
+template <int K>
+inline void Transform::Span(const float m[4][4], const float* src, size_t srcStride,
+    float* dst, size_t dstStride, size_t count)
+{
+    size_t i = 0;
+#if defined(RT_SIMD_SSE)
+    if (srcStride == 3 && dstStride == 3)
+    {
+        // Packed xyz: four vectors are three registers, transposed to SoA and back.
+        __m128 r[4][4];
+        for (int a = 0; a < (K == POINT ? 4 : 3); a++)
+            for (int b = 0; b < 4; b++)
+                r[a][b] = _mm_set1_ps(m[a][b]);
+
+        for (; i + 4 <= count; i += 4)
+        {
+            const float* s = src + i * 3;
+            const __m128 a = _mm_loadu_ps(s);
+            const __m128 b = _mm_loadu_ps(s + 4);
+            const __m128 c = _mm_loadu_ps(s + 8);
+            const __m128 x = _mm_shuffle_ps(a, _mm_shuffle_ps(b, c, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+            const __m128 y = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(0, 0, 1, 1)), _mm_shuffle_ps(b, c, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+            const __m128 z = _mm_shuffle_ps(_mm_shuffle_ps(a, b, _MM_SHUFFLE(1, 1, 2, 2)), c, _MM_SHUFFLE(3, 0, 2, 0));
+
+            __m128 o[3];
+            for (int row = 0; row < 3; row++)
+            {
+                o[row] = _mm_add_ps(_mm_add_ps(_mm_mul_ps(r[row][0], x), _mm_mul_ps(r[row][1], y)), _mm_mul_ps(r[row][2], z));
+                if (K != VECTOR) o[row] = _mm_add_ps(o[row], r[row][3]);
+            }
+            if (K == POINT)
+            {
+                __m128 w = _mm_add_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(r[3][0], x), _mm_mul_ps(r[3][1], y)), _mm_mul_ps(r[3][2], z)), r[3][3]);
+                w = _mm_div_ps(_mm_set1_ps(1.0F), w);
+                for (int row = 0; row < 3; row++)
+                    o[row] = _mm_mul_ps(o[row], w);
+            }
+
+            float* d = dst + i * 3;
+            _mm_storeu_ps(d, _mm_shuffle_ps(_mm_shuffle_ps(o[0], o[1], _MM_SHUFFLE(0, 0, 0, 0)), _mm_shuffle_ps(o[2], o[0], _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(d + 4, _mm_shuffle_ps(_mm_shuffle_ps(o[1], o[2], _MM_SHUFFLE(1, 1, 1, 1)), _mm_shuffle_ps(o[0], o[1], _MM_SHUFFLE(2, 2, 2, 2)), _MM_SHUFFLE(2, 0, 2, 0)));
+            _mm_storeu_ps(d + 8, _mm_shuffle_ps(_mm_shuffle_ps(o[2], o[0], _MM_SHUFFLE(3, 3, 2, 2)), _mm_shuffle_ps(o[1], o[2], _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0)));
+        }
+    }
+    else
+    {
+        // Any stride: one vector per register, columns scaled by the broadcast components.
+        const float* m3 = (K == POINT) ? m[3] : m[2];
+        const __m128 c0 = _mm_setr_ps(m[0][0], m[1][0], m[2][0], m3[0]);
+        const __m128 c1 = _mm_setr_ps(m[0][1], m[1][1], m[2][1], m3[1]);
+        const __m128 c2 = _mm_setr_ps(m[0][2], m[1][2], m[2][2], m3[2]);
+        const __m128 c3 = _mm_setr_ps(m[0][3], m[1][3], m[2][3], m3[3]);
+
+        for (; i < count; i++)
+        {
+            const float* s = src + i * srcStride;
+            __m128 o = _mm_add_ps(_mm_add_ps(_mm_mul_ps(c0, _mm_set1_ps(s[0])), _mm_mul_ps(c1, _mm_set1_ps(s[1]))), _mm_mul_ps(c2, _mm_set1_ps(s[2])));
+            if (K != VECTOR) o = _mm_add_ps(o, c3);
+            if (K == POINT)
+                o = _mm_mul_ps(o, _mm_div_ps(_mm_set1_ps(1.0F), _mm_shuffle_ps(o, o, _MM_SHUFFLE(3, 3, 3, 3))));
+
+            float* d = dst + i * dstStride;
+            _mm_storel_pi(reinterpret_cast<__m64*>(d), o);
+            _mm_store_ss(d + 2, _mm_movehl_ps(o, o));
+        }
+        return;
+    }
+#endif
+
+    for (; i < count; i++)
+    {
+        const float* s = src + i * srcStride;
+        const float x = s[0], y = s[1], z = s[2];
+        float* d = dst + i * dstStride;
+        float ox, oy, oz;
+        if (K == VECTOR)
+        {
+            ox = m[0][0] * x + m[0][1] * y + m[0][2] * z;
+            oy = m[1][0] * x + m[1][1] * y + m[1][2] * z;
+            oz = m[2][0] * x + m[2][1] * y + m[2][2] * z;
+        }
+        else
+        {
+            ox = m[0][0] * x + m[0][1] * y + m[0][2] * z + m[0][3];
+            oy = m[1][0] * x + m[1][1] * y + m[1][2] * z + m[1][3];
+            oz = m[2][0] * x + m[2][1] * y + m[2][2] * z + m[2][3];
+        }
+        if (K == POINT)
+        {
+            float w = m[3][0] * x + m[3][1] * y + m[3][2] * z + m[3][3];
+            w = 1.0F / w;
+            ox *= w;
+            oy *= w;
+            oz *= w;
+        }
+        d[0] = ox;
+        d[1] = oy;
+        d[2] = oz;
+    }
+};
+
+template <int K>
+inline void Transform::Run(const float m[4][4], const float* src, size_t srcStride,
+    float* dst, size_t dstStride, size_t count, ThreadPool* pool)
+{
+    size_t jobs = pool ? std::min(pool->size(), count / minBatch) : 0;
+    if (jobs < 2)
+    {
+        Span<K>(m, src, srcStride, dst, dstStride, count);
+        return;
+    }
+
+    // The matrix is copied so the jobs do not depend on the caller's storage layout.
+    struct Job { float m[4][4]; };
+    Job job;
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 4; j++)
+            job.m[i][j] = (i < 3 || K == POINT) ? m[i][j] : 0.0F;
+
+    size_t per = (count + jobs - 1) / jobs;
+    for (size_t begin = 0; begin < count; begin += per)
+    {
+        size_t n = std::min(per, count - begin);
+        const float* s = src + begin * srcStride;
+        float* d = dst + begin * dstStride;
+        pool->submit([job, s, srcStride, d, dstStride, n] { Span<K>(job.m, s, srcStride, d, dstStride, n); });
+    }
+    pool->wait();
+};
+
+inline void Transform::Points(const float m[4][4], const float* src, size_t srcStride,
+    float* dst, size_t dstStride, size_t count, ThreadPool* pool)
+{
+    Run<POINT>(m, src, srcStride, dst, dstStride, count, pool);
+};
+
+inline void Transform::Points3x4(const float m[4][4], const float* src, size_t srcStride,
+    float* dst, size_t dstStride, size_t count, ThreadPool* pool)
+{
+    Run<POINT_3X4>(m, src, srcStride, dst, dstStride, count, pool);
+};
+
+inline void Transform::Vectors(const float m[4][4], const float* src, size_t srcStride,
+    float* dst, size_t dstStride, size_t count, ThreadPool* pool)
+{
+    Run<VECTOR>(m, src, srcStride, dst, dstStride, count, pool);
+};
+
+inline void Transform::Points3x4(const float m[4][4], std::vector<float>* xyz, ThreadPool* pool)
+{
+    if (!xyz->empty())
+        Run<POINT_3X4>(m, &(*xyz)[0], 3, &(*xyz)[0], 3, xyz->size() / 3, pool);
+};
+
+inline void Transform::Vectors(const float m[4][4], std::vector<float>* xyz, ThreadPool* pool)
+{
+    if (!xyz->empty())
+        Run<VECTOR>(m, &(*xyz)[0], 3, &(*xyz)[0], 3, xyz->size() / 3, pool);
+};
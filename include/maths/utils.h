@@ -661,11 +661,8 @@ struct Mathf
             return (Pow(10.0F, RoundToInt(Log10(positiveNumber))));
         };
 
+        /*** @brief Constants below are defined once, in libraytracer-core. */
         static const float Epsilon;
         static const float Pi;
         static const float Tau;
 };
-
-const float Mathf::Epsilon   = 1.4001298E-45;
-const float Mathf::Pi        = PI;
-const float Mathf::Tau       = (PI * 2.0F);
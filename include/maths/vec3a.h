@@ -0,0 +1,319 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+#include "maths/simd.h"
+
+/**
+ * @brief 16-byte aligned 3-dimensional vector.
+ *
+ * Same operations and results as Vec3, stored as four floats so that each
+ * operation is a single SIMD instruction when RT_SIMD_SSE is enabled. The
+ * fourth lane is padding and is kept at 0 by every operation except
+ * division.
+ */
+struct RT_ALIGN(16) Vec3A
+{
+    public:
+        /*** @brief Default constructor. Initializes vector to (0, 0, 0). */
+        Vec3A(void);
+
+        /**
+         * @brief Initializes vector with given x, y, z values.
+         *
+         * @param x The x component
+         * @param y The y component
+         * @param z The z component
+         */
+        Vec3A(float x, float y, float z);
+
+        /**
+         * @brief Initializes vector with all components set to the same value.
+         *
+         * @param a The value to set for all components.
+         */
+        explicit Vec3A(float a);
+
+        /**
+         * @brief Converts from any type exposing x, y and z (Vec3, Vec4, ...).
+         *
+         * @param v The vector to convert.
+         */
+        template <typename V>
+        explicit Vec3A(const V& v) : x(v.x), y(v.y), z(v.z), w(0.0F) {};
+
+#if defined(RT_SIMD_SSE)
+        /**
+         * @brief Wraps a SIMD register.
+         *
+         * @param v The register; lane 3 is stored as is.
+         */
+        explicit Vec3A(__m128 v);
+
+        /*** @brief The vector as a SIMD register. */
+        __m128 Load(void) const;
+#endif
+
+        /**
+         * @brief Converts to any type constructible from (x, y, z).
+         *
+         * @return The converted vector.
+         */
+        template <typename V>
+        V As(void) const { return (V(x, y, z)); };
+
+        Vec3A operator*(const Vec3A& v) const;
+        Vec3A operator/(const Vec3A& v) const;
+        Vec3A operator+(const Vec3A& v) const;
+        Vec3A operator-(const Vec3A& v) const;
+        Vec3A operator-(void) const;
+        Vec3A operator*(float f) const;
+        Vec3A operator/(float f) const;
+        void operator*=(const Vec3A& v);
+        void operator/=(const Vec3A& v);
+        void operator+=(const Vec3A& v);
+        void operator-=(const Vec3A& v);
+        void operator*=(float f);
+        void operator/=(float f);
+
+        /**
+         * @brief Compares x, y and z; the padding lane is ignored.
+         *
+         * @param v The vector to compare with.
+         *
+         * @return True if all three components are equal.
+         */
+        bool operator==(const Vec3A& v) const;
+        bool operator!=(const Vec3A& v) const;
+
+        float operator[](int i) const;
+        float& operator[](int i);
+
+        /**
+         * @brief Component-wise minimum, std::min semantics.
+         *
+         * @param a First vector.
+         * @param b Second vector.
+         *
+         * @return The minimum vector.
+         */
+        static Vec3A Min(const Vec3A& a, const Vec3A& b);
+
+        /**
+         * @brief Component-wise maximum, std::max semantics.
+         *
+         * @param a First vector.
+         * @param b Second vector.
+         *
+         * @return The maximum vector.
+         */
+        static Vec3A Max(const Vec3A& a, const Vec3A& b);
+
+        /**
+         * @brief Cross product of two vectors.
+         *
+         * @param a First vector.
+         * @param b Second vector.
+         *
+         * @return The cross product.
+         */
+        static Vec3A Cross(const Vec3A& a, const Vec3A& b);
+
+        /**
+         * @brief Dot product of two vectors.
+         *
+         * @param a First vector.
+         * @param b Second vector.
+         *
+         * @return The dot product.
+         */
+        static float Dot(const Vec3A& a, const Vec3A& b);
+
+        /**
+         * @brief Length of a vector.
+         *
+         * @param a The vector.
+         *
+         * @return The length.
+         */
+        static float Length(const Vec3A& a);
+
+        /**
+         * @brief Distance between two points.
+         *
+         * @param a First point.
+         * @param b Second point.
+         *
+         * @return The distance.
+         */
+        static float Distance(const Vec3A& a, const Vec3A& b);
+
+        /**
+         * @brief Normalizes the vector.
+         *
+         * @param a The vector to normalize.
+         *
+         * @return The vector divided by its length.
+         */
+        static Vec3A Normalize(const Vec3A& a);
+
+        /*** @brief X, Y, Z vector component and padding */
+        float x, y, z, w;
+};
+
+inline Vec3A::Vec3A(void) : x(0.0F), y(0.0F), z(0.0F), w(0.0F) {};
+inline Vec3A::Vec3A(float x, float y, float z) : x(x), y(y), z(z), w(0.0F) {};
+inline Vec3A::Vec3A(float a) : x(a), y(a), z(a), w(0.0F) {};
+
+#if defined(RT_SIMD_SSE)
+inline Vec3A::Vec3A(__m128 v)
+{
+    _mm_store_ps(&x, v);
+};
+
+inline __m128 Vec3A::Load(void) const
+{
+    return (_mm_load_ps(&x));
+};
+
+inline Vec3A Vec3A::operator*(const Vec3A& v) const { return (Vec3A(_mm_mul_ps(Load(), v.Load()))); };
+inline Vec3A Vec3A::operator/(const Vec3A& v) const { return (Vec3A(_mm_div_ps(Load(), v.Load()))); };
+inline Vec3A Vec3A::operator+(const Vec3A& v) const { return (Vec3A(_mm_add_ps(Load(), v.Load()))); };
+inline Vec3A Vec3A::operator-(const Vec3A& v) const { return (Vec3A(_mm_sub_ps(Load(), v.Load()))); };
+inline Vec3A Vec3A::operator-(void) const { return (Vec3A(_mm_xor_ps(Load(), _mm_set1_ps(-0.0F)))); };
+inline Vec3A Vec3A::operator*(float f) const { return (Vec3A(_mm_mul_ps(Load(), _mm_set1_ps(f)))); };
+inline Vec3A Vec3A::operator/(float f) const { return (Vec3A(_mm_div_ps(Load(), _mm_set1_ps(f)))); };
+
+inline bool Vec3A::operator==(const Vec3A& v) const
+{
+    return ((_mm_movemask_ps(_mm_cmpeq_ps(Load(), v.Load())) & 7) == 7);
+};
+
+inline Vec3A Vec3A::Min(const Vec3A& a, const Vec3A& b)
+{
+    // minps returns its second operand unless the first is smaller, like std::min(a, b).
+    return (Vec3A(_mm_min_ps(b.Load(), a.Load())));
+};
+
+inline Vec3A Vec3A::Max(const Vec3A& a, const Vec3A& b)
+{
+    return (Vec3A(_mm_max_ps(b.Load(), a.Load())));
+};
+
+inline Vec3A Vec3A::Cross(const Vec3A& a, const Vec3A& b)
+{
+    return (Vec3A(Simd::Cross(a.Load(), b.Load())));
+};
+
+inline float Vec3A::Dot(const Vec3A& a, const Vec3A& b)
+{
+    return (Simd::HorizontalAdd3(_mm_mul_ps(a.Load(), b.Load())));
+};
+
+inline float Vec3A::Length(const Vec3A& a)
+{
+    return (_mm_cvtss_f32(_mm_sqrt_ss(_mm_set_ss(Dot(a, a)))));
+};
+#else
+inline Vec3A Vec3A::operator*(const Vec3A& v) const { return (Vec3A(x * v.x, y * v.y, z * v.z)); };
+inline Vec3A Vec3A::operator/(const Vec3A& v) const { return (Vec3A(x / v.x, y / v.y, z / v.z)); };
+inline Vec3A Vec3A::operator+(const Vec3A& v) const { return (Vec3A(x + v.x, y + v.y, z + v.z)); };
+inline Vec3A Vec3A::operator-(const Vec3A& v) const { return (Vec3A(x - v.x, y - v.y, z - v.z)); };
+inline Vec3A Vec3A::operator-(void) const { return (Vec3A(-x, -y, -z)); };
+inline Vec3A Vec3A::operator*(float f) const { return (Vec3A(x * f, y * f, z * f)); };
+inline Vec3A Vec3A::operator/(float f) const { return (Vec3A(x / f, y / f, z / f)); };
+
+inline bool Vec3A::operator==(const Vec3A& v) const
+{
+    return (x == v.x && y == v.y && z == v.z);
+};
+
+inline Vec3A Vec3A::Min(const Vec3A& a, const Vec3A& b)
+{
+    return (Vec3A(std::min(a.x, b.x), std::min(a.y, b.y), std::min(a.z, b.z)));
+};
+
+inline Vec3A Vec3A::Max(const Vec3A& a, const Vec3A& b)
+{
+    return (Vec3A(std::max(a.x, b.x), std::max(a.y, b.y), std::max(a.z, b.z)));
+};
+
+inline Vec3A Vec3A::Cross(const Vec3A& a, const Vec3A& b)
+{
+    return (Vec3A(
+        (a.y * b.z) - (a.z * b.y),
+        (a.z * b.x) - (a.x * b.z),
+        (a.x * b.y) - (a.y * b.x)
+    ));
+};
+
+inline float Vec3A::Dot(const Vec3A& a, const Vec3A& b)
+{
+    return ((a.x * b.x) + (a.y * b.y) + (a.z * b.z));
+};
+
+inline float Vec3A::Length(const Vec3A& a)
+{
+    return (sqrtf(Dot(a, a)));
+};
+#endif
+
+inline void Vec3A::operator*=(const Vec3A& v) { *this = *this * v; };
+inline void Vec3A::operator/=(const Vec3A& v) { *this = *this / v; };
+inline void Vec3A::operator+=(const Vec3A& v) { *this = *this + v; };
+inline void Vec3A::operator-=(const Vec3A& v) { *this = *this - v; };
+inline void Vec3A::operator*=(float f) { *this = *this * f; };
+inline void Vec3A::operator/=(float f) { *this = *this / f; };
+
+inline bool Vec3A::operator!=(const Vec3A& v) const
+{
+    return (!((*this) == v));
+};
+
+inline float Vec3A::operator[](int i) const
+{
+    if (i == 0) return (x);
+    if (i == 1) return (y);
+    return (z);
+};
+
+inline float& Vec3A::operator[](int i)
+{
+    if (i == 0) return (x);
+    if (i == 1) return (y);
+    return (z);
+};
+
+inline float Vec3A::Distance(const Vec3A& a, const Vec3A& b)
+{
+    return (Length(a - b));
+};
+
+inline Vec3A Vec3A::Normalize(const Vec3A& a)
+{
+    return (a / Length(a));
+};
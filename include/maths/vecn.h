@@ -0,0 +1,882 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <iosfwd>
+#include <type_traits>
+#include "config.h"
+#include "maths/utils.h"
+
+/**
+ * Small fixed-size vectors.
+ *
+ * VecN<T, N> holds N = 2, 3 or 4 components of type T, named x, y, z and w.
+ * Vec2, Vec3 and Vec4 are the float instantiations, Vec2i/Vec3i/Vec4i the
+ * int32_t ones and Vec2u/Vec3u/Vec4u the uint32_t ones (grid walks, Morton
+ * codes, tile indices); maths/half.h specializes VecN<Half, N> as storage
+ * (Half2, Half3, Half4). Every operation computes what the former float-only
+ * Vec2/Vec3/Vec4 computed, in the same order, so results are unchanged.
+ *
+ * Constructors are constexpr, so the shorthands (Vec3::up, ...) and user
+ * constants are constant-initialized. Operations that only make sense for
+ * floating-point components (Length, Normalize, Lerp, ...) do not compile
+ * for integers, and the bitwise ones do not compile for floats. Min, Max and
+ * Clamp on four components are one SSE instruction per operation (SSE4.1 for
+ * integers); Vec3A/Vec4A remain the register-resident float variants.
+ */
+
+template <typename T, int N>
+struct VecN;
+
+/*** @brief Named components of a VecN. Every size takes four values and keeps the first N. */
+template <typename T, int N>
+struct VecNData;
+
+template <typename T>
+struct VecNData<T, 2>
+{
+    public:
+        constexpr VecNData(T x, T y, T, T) : x(x), y(y) {};
+
+        /*** @brief Component i; the last one past the end, as VecN::operator[]. */
+        constexpr T At(int i) const { return ((i == 0) ? x : y); };
+        T& Ref(int i) { return ((i == 0) ? x : y); };
+
+        /*** @brief X, Y components */
+        T x, y;
+};
+
+template <typename T>
+struct VecNData<T, 3>
+{
+    public:
+        constexpr VecNData(T x, T y, T z, T) : x(x), y(y), z(z) {};
+
+        constexpr T At(int i) const { return ((i == 0) ? x : ((i == 1) ? y : z)); };
+        T& Ref(int i) { return ((i == 0) ? x : ((i == 1) ? y : z)); };
+
+        /*** @brief X, Y, Z components */
+        T x, y, z;
+};
+
+template <typename T>
+struct VecNData<T, 4>
+{
+    public:
+        constexpr VecNData(T x, T y, T z, T w) : x(x), y(y), z(z), w(w) {};
+
+        constexpr T At(int i) const { return ((i == 0) ? x : ((i == 1) ? y : ((i == 2) ? z : w))); };
+        T& Ref(int i) { return ((i == 0) ? x : ((i == 1) ? y : ((i == 2) ? z : w))); };
+
+        /*** @brief X, Y, Z, W components */
+        T x, y, z, w;
+};
+
+/*** @brief Component-wise min/max, specialized below where one SIMD instruction does it. */
+template <typename T, int N>
+struct VecKernel
+{
+    public:
+        static RT_INLINE void Min(const VecN<T, N>& a, const VecN<T, N>& b, VecN<T, N>* r)
+        {
+            RT_UNROLL
+            for (int i = 0; i < N; i++)
+            {
+                T ai = a.At(i), bi = b.At(i);
+                r->Ref(i) = std::min(ai, bi);
+            }
+        };
+
+        static RT_INLINE void Max(const VecN<T, N>& a, const VecN<T, N>& b, VecN<T, N>* r)
+        {
+            RT_UNROLL
+            for (int i = 0; i < N; i++)
+            {
+                T ai = a.At(i), bi = b.At(i);
+                r->Ref(i) = std::max(ai, bi);
+            }
+        };
+};
+
+/**
+ * @brief Vector of N components of type T.
+ *
+ * @tparam T float, int32_t, uint32_t (or Half, see maths/half.h).
+ * @tparam N 2, 3 or 4.
+ */
+template <typename T, int N>
+struct VecN : public VecNData<T, N>
+{
+    static_assert(N >= 2 && N <= 4, "VecN has 2, 3 or 4 components");
+    static_assert(std::is_arithmetic<T>::value, "VecN components are numbers; Half has its own specialization");
+
+    public:
+        /*** @brief Default constructor. Initializes every component to 0. */
+        constexpr VecN(void);
+
+        /**
+         * @brief Initializes vector with all components set to the same value.
+         *
+         * @param a The value to set for all components.
+         */
+        constexpr VecN(T a);
+
+        /*** @brief Initializes a 2-component vector. */
+        constexpr VecN(T x, T y);
+
+        /*** @brief Initializes a 3-component vector. */
+        constexpr VecN(T x, T y, T z);
+
+        /*** @brief Initializes a 4-component vector. */
+        constexpr VecN(T x, T y, T z, T w);
+
+        /**
+         * @brief Copy constructor.
+         *
+         * @param v The vector to copy.
+         */
+        VecN(const VecN& v) = default;
+
+        /**
+         * @brief Initializes vector from one of another size: extra components
+         *        are dropped, missing ones set to 0 (Vec3(Vec2), Vec2(Vec4), ...).
+         *
+         * @param v The vector to copy components from.
+         */
+        template <int M>
+        constexpr VecN(const VecN<T, M>& v);
+
+        /**
+         * @brief Initializes vector from a smaller one and the next component
+         *        (Vec3(Vec2, z), Vec4(Vec3, w), ...); the rest is set to 0.
+         *
+         * @param v The vector to copy the first components from.
+         * @param a The next component.
+         */
+        template <int M>
+        constexpr VecN(const VecN<T, M>& v, T a);
+
+        /*** @brief Same with the next two components (Vec4(Vec2, z, w)). */
+        template <int M>
+        constexpr VecN(const VecN<T, M>& v, T a, T b);
+
+        /**
+         * @brief Converts each component of a vector of another type, as
+         *        static_cast does (truncation from float to int).
+         *
+         * @param v The vector to convert.
+         */
+        template <typename U>
+        constexpr explicit VecN(const VecN<U, N>& v);
+
+        /*** @brief Component-wise operations. */
+        VecN operator*(const VecN& v) const;
+        VecN operator/(const VecN& v) const;
+        VecN operator+(const VecN& v) const;
+        VecN operator-(const VecN& v) const;
+
+        /*** @brief Operations with a scalar. */
+        VecN operator*(T f) const;
+        VecN operator/(T f) const;
+
+        /*** @brief In-place component-wise operations. */
+        void operator*=(const VecN& v);
+        void operator/=(const VecN& v);
+        void operator+=(const VecN& v);
+        void operator-=(const VecN& v);
+
+        /*** @brief In-place operations with a scalar. */
+        void operator*=(T f);
+        void operator/=(T f);
+
+        /*** @brief Component-wise bitwise operations, integer components only. */
+        VecN operator&(const VecN& v) const;
+        VecN operator|(const VecN& v) const;
+        VecN operator^(const VecN& v) const;
+        VecN operator<<(int s) const;
+        VecN operator>>(int s) const;
+
+        /**
+         * @brief Compares this vector with another vector for equality.
+         *
+         * @param v The vector to compare with.
+         *
+         * @return True if every component is equal, false otherwise.
+         */
+        bool operator==(const VecN& v) const;
+
+        /*** @brief Negation of operator==. */
+        bool operator!=(const VecN& v) const;
+
+        /**
+         * @brief Accesses vector component by index.
+         *
+         * @param i The index (0 for x, 1 for y, ...); larger ones give the last component.
+         *
+         * @return The component value.
+         */
+        T operator[](int i) const;
+
+        /*** @brief Accesses vector component by index, as a reference. */
+        T& operator[](int i);
+
+        /**
+         * @brief Finds component-wise minimum of two vectors, as std::min.
+         *
+         * @param a The first vector.
+         * @param b The second vector.
+         *
+         * @return The resulting vector.
+         */
+        static VecN Min(const VecN& a, const VecN& b);
+
+        /*** @brief Finds component-wise maximum of two vectors, as std::max. */
+        static VecN Max(const VecN& a, const VecN& b);
+
+        /**
+         * @brief Clamps the components of the vector between corresponding min and max values.
+         *
+         * @param a The vector to clamp.
+         * @param min The vector of minimum values.
+         * @param max The vector of maximum values.
+         *
+         * @return The resulting clamped vector.
+         */
+        static VecN Clamp(const VecN& a, const VecN& min, const VecN& max);
+
+        /**
+         * @brief Computes the dot product of two vectors.
+         *
+         * @param a The first vector.
+         * @param b The second vector.
+         *
+         * @return The dot product.
+         */
+        static T Dot(const VecN& a, const VecN& b);
+
+        /*** @brief Computes the cross product of two vectors. 3 components only. */
+        static VecN Cross(const VecN& a, const VecN& b);
+
+        /*** @brief Rotates a vector by 90 degrees counter-clockwise. 2 components only. */
+        static VecN Perpendicular(const VecN& v);
+
+        /**
+         * @brief Raises each component of the vector to a given power.
+         *
+         * @param a The vector.
+         * @param exp The exponent.
+         *
+         * @return The resulting vector.
+         */
+        static VecN Pow(const VecN& a, T exp);
+
+        /*** @brief Computes the length of the vector. */
+        static T Length(const VecN& a);
+
+        /*** @brief Computes the distance between two vectors. */
+        static T Distance(const VecN& a, const VecN& b);
+
+        /*** @brief Divides the vector by its length. */
+        static VecN Normalize(const VecN& a);
+
+        /**
+         * @brief Moves a vector towards a target vector by a maximum distance delta.
+         *
+         * @param current The current vector.
+         * @param target The target vector.
+         * @param maxDistanceDelta The maximum distance to move.
+         *
+         * @return The resulting vector.
+         */
+        static VecN MoveTowards(const VecN& current, const VecN& target, T maxDistanceDelta);
+
+        /**
+         * @brief Linearly interpolates between two vectors without clamping the interpolant.
+         *
+         * @param a The start vector.
+         * @param b The end vector.
+         * @param t The interpolant, where 0 returns the start vector and 1 returns the end vector.
+         *
+         * @return The interpolated vector.
+         */
+        static VecN LerpUnclamped(const VecN& a, const VecN& b, T t);
+
+        /*** @brief Linearly interpolates between two vectors, clamping the interpolant between 0 and 1. */
+        static VecN Lerp(const VecN& a, const VecN& b, T t);
+
+        /**
+         * @brief Projects vector v onto the vector normal.
+         *
+         * @param v The vector to project.
+         * @param normal The vector to project onto.
+         *
+         * @return The projected vector, zero if normal is (nearly) zero.
+         */
+        static VecN Project(const VecN& v, const VecN& normal);
+
+        /*** @brief Projects vector v onto a plane defined by its normal. */
+        static VecN ProjectOnPlane(const VecN& v, const VecN& planeNormal);
+
+        /**
+         * @brief Reflects a vector off a surface with a given normal.
+         *
+         * @param inDirection The incident vector.
+         * @param inNormal The normal of the surface.
+         *
+         * @return The reflected vector.
+         */
+        static VecN Reflect(const VecN& inDirection, const VecN& inNormal);
+
+        /*** @brief Shorthand for writing VecN(0) */
+        static const VecN zero;
+        /*** @brief Shorthand for writing VecN(1) */
+        static const VecN one;
+        /*** @brief Shorthand for writing (0, 1, ...) */
+        static const VecN up;
+        /*** @brief Shorthand for writing (0, -1, ...) */
+        static const VecN down;
+        /*** @brief Shorthand for writing (-1, 0, ...) */
+        static const VecN left;
+        /*** @brief Shorthand for writing (1, 0, ...) */
+        static const VecN right;
+        /*** @brief Shorthand for writing (0, 0, 1, ...) */
+        static const VecN forward;
+        /*** @brief Shorthand for writing (0, 0, -1, ...) */
+        static const VecN backward;
+
+    private:
+        typedef VecNData<T, N> Data;
+
+        /*** @brief Component i of (v, a, b, 0, ...). */
+        template <int M>
+        static constexpr T Pick(const VecN<T, M>& v, T a, T b, int i);
+
+        /*** @brief s on one axis, 0 elsewhere. */
+        static constexpr VecN Axis(int axis, T s);
+
+        struct Raw {};
+        constexpr VecN(Raw, T x, T y, T z, T w) : Data(x, y, z, w) {};
+};
+
+typedef VecN<float, 2> Vec2;
+typedef VecN<float, 3> Vec3;
+typedef VecN<float, 4> Vec4;
+typedef VecN<int32_t, 2> Vec2i;
+typedef VecN<int32_t, 3> Vec3i;
+typedef VecN<int32_t, 4> Vec4i;
+typedef VecN<uint32_t, 2> Vec2u;
+typedef VecN<uint32_t, 3> Vec3u;
+typedef VecN<uint32_t, 4> Vec4u;
+
+#if defined(RT_SIMD_SSE)
+// _mm_min_ps(b, a) is b < a ? b : a, which is std::min(a, b) down to NaNs and signed zeros.
+template <>
+struct VecKernel<float, 4>
+{
+    public:
+        static RT_INLINE void Min(const Vec4& a, const Vec4& b, Vec4* r) { _mm_storeu_ps(&r->x, _mm_min_ps(_mm_loadu_ps(&b.x), _mm_loadu_ps(&a.x))); };
+        static RT_INLINE void Max(const Vec4& a, const Vec4& b, Vec4* r) { _mm_storeu_ps(&r->x, _mm_max_ps(_mm_loadu_ps(&b.x), _mm_loadu_ps(&a.x))); };
+};
+#endif
+
+#if defined(RT_SIMD_SSE41)
+template <>
+struct VecKernel<int32_t, 4>
+{
+    public:
+        static RT_INLINE void Min(const Vec4i& a, const Vec4i& b, Vec4i* r) { Store(r, _mm_min_epi32(Load(a), Load(b))); };
+        static RT_INLINE void Max(const Vec4i& a, const Vec4i& b, Vec4i* r) { Store(r, _mm_max_epi32(Load(a), Load(b))); };
+
+    private:
+        static RT_INLINE __m128i Load(const Vec4i& a) { return (_mm_loadu_si128(reinterpret_cast<const __m128i*>(&a.x))); };
+        static RT_INLINE void Store(Vec4i* r, __m128i v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(&r->x), v); };
+};
+
+template <>
+struct VecKernel<uint32_t, 4>
+{
+    public:
+        static RT_INLINE void Min(const Vec4u& a, const Vec4u& b, Vec4u* r) { Store(r, _mm_min_epu32(Load(a), Load(b))); };
+        static RT_INLINE void Max(const Vec4u& a, const Vec4u& b, Vec4u* r) { Store(r, _mm_max_epu32(Load(a), Load(b))); };
+
+    private:
+        static RT_INLINE __m128i Load(const Vec4u& a) { return (_mm_loadu_si128(reinterpret_cast<const __m128i*>(&a.x))); };
+        static RT_INLINE void Store(Vec4u* r, __m128i v) { _mm_storeu_si128(reinterpret_cast<__m128i*>(&r->x), v); };
+};
+#endif
+
+template <typename T, int N> constexpr VecN<T, N>::VecN(void) : Data(T(0), T(0), T(0), T(0)) {};
+template <typename T, int N> constexpr VecN<T, N>::VecN(T a) : Data(a, a, a, a) {};
+
+template <typename T, int N>
+constexpr VecN<T, N>::VecN(T x, T y) : Data(x, y, T(0), T(0))
+{
+    static_assert(N == 2, "VecN(x, y) needs 2 components");
+};
+
+template <typename T, int N>
+constexpr VecN<T, N>::VecN(T x, T y, T z) : Data(x, y, z, T(0))
+{
+    static_assert(N == 3, "VecN(x, y, z) needs 3 components");
+};
+
+template <typename T, int N>
+constexpr VecN<T, N>::VecN(T x, T y, T z, T w) : Data(x, y, z, w)
+{
+    static_assert(N == 4, "VecN(x, y, z, w) needs 4 components");
+};
+
+template <typename T, int N>
+template <int M>
+constexpr VecN<T, N>::VecN(const VecN<T, M>& v)
+    : Data(Pick(v, T(0), T(0), 0), Pick(v, T(0), T(0), 1), Pick(v, T(0), T(0), 2), Pick(v, T(0), T(0), 3)) {};
+
+template <typename T, int N>
+template <int M>
+constexpr VecN<T, N>::VecN(const VecN<T, M>& v, T a)
+    : Data(Pick(v, a, T(0), 0), Pick(v, a, T(0), 1), Pick(v, a, T(0), 2), Pick(v, a, T(0), 3))
+{
+    static_assert(M < N, "VecN(v, a) needs a smaller v");
+};
+
+template <typename T, int N>
+template <int M>
+constexpr VecN<T, N>::VecN(const VecN<T, M>& v, T a, T b)
+    : Data(Pick(v, a, b, 0), Pick(v, a, b, 1), Pick(v, a, b, 2), Pick(v, a, b, 3))
+{
+    static_assert(M + 1 < N, "VecN(v, a, b) needs a v two components smaller");
+};
+
+template <typename T, int N>
+template <typename U>
+constexpr VecN<T, N>::VecN(const VecN<U, N>& v)
+    : Data(static_cast<T>(v.At(0)), static_cast<T>(v.At(1)), static_cast<T>(v.At(2)), static_cast<T>(v.At(3))) {};
+
+template <typename T, int N>
+template <int M>
+constexpr T VecN<T, N>::Pick(const VecN<T, M>& v, T a, T b, int i)
+{
+    return ((i < M) ? v.At(i) : ((i == M) ? a : ((i == M + 1) ? b : T(0))));
+};
+
+template <typename T, int N>
+constexpr VecN<T, N> VecN<T, N>::Axis(int axis, T s)
+{
+    return (VecN(Raw(), (axis == 0) ? s : T(0), (axis == 1) ? s : T(0), (axis == 2) ? s : T(0), (axis == 3) ? s : T(0)));
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::operator*(const VecN& v) const
+{
+    VecN out;
+
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        out.Ref(i) = this->At(i) * v.At(i);
+    return (out);
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::operator/(const VecN& v) const
+{
+    VecN out;
+
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        out.Ref(i) = this->At(i) / v.At(i);
+    return (out);
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::operator+(const VecN& v) const
+{
+    VecN out;
+
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        out.Ref(i) = this->At(i) + v.At(i);
+    return (out);
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::operator-(const VecN& v) const
+{
+    VecN out;
+
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        out.Ref(i) = this->At(i) - v.At(i);
+    return (out);
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::operator*(T f) const
+{
+    VecN out;
+
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        out.Ref(i) = this->At(i) * f;
+    return (out);
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::operator/(T f) const
+{
+    VecN out;
+
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        out.Ref(i) = this->At(i) / f;
+    return (out);
+};
+
+template <typename T, int N>
+inline void VecN<T, N>::operator*=(const VecN& v)
+{
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        this->Ref(i) *= v.At(i);
+};
+
+template <typename T, int N>
+inline void VecN<T, N>::operator/=(const VecN& v)
+{
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        this->Ref(i) /= v.At(i);
+};
+
+template <typename T, int N>
+inline void VecN<T, N>::operator+=(const VecN& v)
+{
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        this->Ref(i) += v.At(i);
+};
+
+template <typename T, int N>
+inline void VecN<T, N>::operator-=(const VecN& v)
+{
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        this->Ref(i) -= v.At(i);
+};
+
+template <typename T, int N>
+inline void VecN<T, N>::operator*=(T f)
+{
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        this->Ref(i) *= f;
+};
+
+template <typename T, int N>
+inline void VecN<T, N>::operator/=(T f)
+{
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        this->Ref(i) /= f;
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::operator&(const VecN& v) const
+{
+    static_assert(std::is_integral<T>::value, "bitwise operations need integer components");
+    VecN out;
+
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        out.Ref(i) = this->At(i) & v.At(i);
+    return (out);
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::operator|(const VecN& v) const
+{
+    static_assert(std::is_integral<T>::value, "bitwise operations need integer components");
+    VecN out;
+
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        out.Ref(i) = this->At(i) | v.At(i);
+    return (out);
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::operator^(const VecN& v) const
+{
+    static_assert(std::is_integral<T>::value, "bitwise operations need integer components");
+    VecN out;
+
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        out.Ref(i) = this->At(i) ^ v.At(i);
+    return (out);
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::operator<<(int s) const
+{
+    static_assert(std::is_integral<T>::value, "bitwise operations need integer components");
+    VecN out;
+
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        out.Ref(i) = static_cast<T>(this->At(i) << s);
+    return (out);
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::operator>>(int s) const
+{
+    static_assert(std::is_integral<T>::value, "bitwise operations need integer components");
+    VecN out;
+
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        out.Ref(i) = static_cast<T>(this->At(i) >> s);
+    return (out);
+};
+
+template <typename T, int N>
+inline bool VecN<T, N>::operator==(const VecN& v) const
+{
+    bool equal = true;
+
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        equal = equal && this->At(i) == v.At(i);
+    return (equal);
+};
+
+template <typename T, int N>
+inline bool VecN<T, N>::operator!=(const VecN& v) const
+{
+    return (!((*this) == v));
+};
+
+template <typename T, int N>
+inline T VecN<T, N>::operator[](int i) const
+{
+    return (this->At(i));
+};
+
+template <typename T, int N>
+inline T& VecN<T, N>::operator[](int i)
+{
+    return (this->Ref(i));
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::Min(const VecN& a, const VecN& b)
+{
+    VecN out;
+
+    VecKernel<T, N>::Min(a, b, &out);
+    return (out);
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::Max(const VecN& a, const VecN& b)
+{
+    VecN out;
+
+    VecKernel<T, N>::Max(a, b, &out);
+    return (out);
+};
+
+// Mathf::Clamp order: std::min(max, std::max(x, min)).
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::Clamp(const VecN& a, const VecN& min, const VecN& max)
+{
+    return (Min(max, Max(a, min)));
+};
+
+template <typename T, int N>
+inline T VecN<T, N>::Dot(const VecN& a, const VecN& b)
+{
+    T dot = a.x * b.x;
+
+    RT_UNROLL
+    for (int i = 1; i < N; i++)
+        dot = dot + a.At(i) * b.At(i);
+    return (dot);
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::Cross(const VecN& a, const VecN& b)
+{
+    static_assert(N == 3, "Cross needs 3 components");
+    return (VecN(Raw(),
+        (a.At(1) * b.At(2)) - (a.At(2) * b.At(1)),
+        (a.At(2) * b.At(0)) - (a.At(0) * b.At(2)),
+        (a.At(0) * b.At(1)) - (a.At(1) * b.At(0)),
+        T(0)
+    ));
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::Perpendicular(const VecN& v)
+{
+    static_assert(N == 2, "Perpendicular needs 2 components");
+    return (VecN(Raw(), -v.At(1), v.At(0), T(0), T(0)));
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::Pow(const VecN& a, T exp)
+{
+    static_assert(std::is_floating_point<T>::value, "Pow needs floating-point components");
+    VecN out;
+
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        out.Ref(i) = std::pow(a.At(i), exp);
+    return (out);
+};
+
+template <typename T, int N>
+inline T VecN<T, N>::Length(const VecN& a)
+{
+    static_assert(std::is_floating_point<T>::value, "Length needs floating-point components");
+    return (std::sqrt(Dot(a, a)));
+};
+
+template <typename T, int N>
+inline T VecN<T, N>::Distance(const VecN& a, const VecN& b)
+{
+    return (Length(a - b));
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::Normalize(const VecN& a)
+{
+    T l = Length(a);
+
+    return (a / l);
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::MoveTowards(const VecN& current, const VecN& target, T maxDistanceDelta)
+{
+    static_assert(std::is_floating_point<T>::value, "MoveTowards needs floating-point components");
+    VecN toVector = target - current;
+    T sqdist = Dot(toVector, toVector);
+
+    if (sqdist == T(0) || (maxDistanceDelta >= T(0) && sqdist <= maxDistanceDelta * maxDistanceDelta))
+        return (target);
+
+    T dist = std::sqrt(sqdist);
+    VecN out;
+
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        out.Ref(i) = current.At(i) + toVector.At(i) / dist * maxDistanceDelta;
+    return (out);
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::LerpUnclamped(const VecN& a, const VecN& b, T t)
+{
+    static_assert(std::is_floating_point<T>::value, "Lerp needs floating-point components");
+    VecN out;
+
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        out.Ref(i) = a.At(i) + (b.At(i) - a.At(i)) * t;
+    return (out);
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::Lerp(const VecN& a, const VecN& b, T t)
+{
+    return (LerpUnclamped(a, b, Mathf::Clamp01(t)));
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::Project(const VecN& v, const VecN& normal)
+{
+    static_assert(std::is_floating_point<T>::value, "Project needs floating-point components");
+    T sqrMag = Dot(normal, normal);
+
+    if (sqrMag < Mathf::Epsilon)
+        return (zero);
+
+    T dot = Dot(v, normal);
+    VecN out;
+
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        out.Ref(i) = normal.At(i) * dot / sqrMag;
+    return (out);
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::ProjectOnPlane(const VecN& v, const VecN& planeNormal)
+{
+    static_assert(std::is_floating_point<T>::value, "ProjectOnPlane needs floating-point components");
+    T sqrMag = Dot(planeNormal, planeNormal);
+
+    if (sqrMag < Mathf::Epsilon)
+        return (v);
+
+    T dot = Dot(v, planeNormal);
+    VecN out;
+
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        out.Ref(i) = v.At(i) - planeNormal.At(i) * dot / sqrMag;
+    return (out);
+};
+
+template <typename T, int N>
+inline VecN<T, N> VecN<T, N>::Reflect(const VecN& inDirection, const VecN& inNormal)
+{
+    static_assert(std::is_floating_point<T>::value, "Reflect needs floating-point components");
+    T factor = T(-2) * Dot(inNormal, inDirection);
+    VecN out;
+
+    RT_UNROLL
+    for (int i = 0; i < N; i++)
+        out.Ref(i) = factor * inNormal.At(i) + inDirection.At(i);
+    return (out);
+};
+
+template <typename T, int N> const VecN<T, N> VecN<T, N>::zero     = VecN<T, N>(T(0));
+template <typename T, int N> const VecN<T, N> VecN<T, N>::one      = VecN<T, N>(T(1));
+template <typename T, int N> const VecN<T, N> VecN<T, N>::up       = VecN<T, N>::Axis(1, T(1));
+template <typename T, int N> const VecN<T, N> VecN<T, N>::down     = VecN<T, N>::Axis(1, T(-1));
+template <typename T, int N> const VecN<T, N> VecN<T, N>::left     = VecN<T, N>::Axis(0, T(-1));
+template <typename T, int N> const VecN<T, N> VecN<T, N>::right    = VecN<T, N>::Axis(0, T(1));
+template <typename T, int N> const VecN<T, N> VecN<T, N>::forward  = VecN<T, N>::Axis(2, T(1));
+template <typename T, int N> const VecN<T, N> VecN<T, N>::backward = VecN<T, N>::Axis(2, T(-1));
+
+/*** @brief Writes the vector as (x, y, ...). Defined in libraytracer-core for the aliases above. */
+template <typename T, int N>
+std::ostream& operator<<(std::ostream& os, const VecN<T, N>& v);
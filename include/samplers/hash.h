@@ -0,0 +1,132 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+
+/**
+ * Integer hashes shared by the samplers.
+ *
+ * Every sampler derives its randomness from a seed built out of the pixel
+ * coordinates, a user seed (e.g. the frame number) and, where needed, the
+ * sample index and dimension. Hashing instead of sharing a global generator
+ * keeps every pixel and sample reproducible on its own, whatever the thread
+ * or tile order.
+ */
+
+struct SamplerHash
+{
+    public:
+        /**
+         * @brief Bijective 32-bit mixer ("lowbias32", C. Wellons).
+         *
+         * @param x The value.
+         *
+         * @return The hashed value.
+         */
+        static uint32_t Mix(uint32_t x);
+
+        /**
+         * @brief 64-bit finalizer (splitmix64).
+         *
+         * @param x The value.
+         *
+         * @return The hashed value.
+         */
+        static uint64_t Mix64(uint64_t x);
+
+        /**
+         * @brief Hashes a value into a seed.
+         *
+         * @param seed The seed so far.
+         * @param v The value to fold in.
+         *
+         * @return The new seed.
+         */
+        static uint32_t Combine(uint32_t seed, uint32_t v);
+
+        /**
+         * @brief Seed of a pixel.
+         *
+         * @param x The pixel column.
+         * @param y The pixel row.
+         * @param seed User seed, e.g. the frame number.
+         *
+         * @return The pixel seed.
+         */
+        static uint32_t Pixel(uint32_t x, uint32_t y, uint32_t seed);
+
+        /*** @brief Reverses the bit order of a 32-bit value. */
+        static uint32_t ReverseBits(uint32_t x);
+
+        /*** @brief Top 24 bits of x as a float in [0, 1), exactly. */
+        static float ToFloat(uint32_t x);
+};
+
+inline uint32_t SamplerHash::Mix(uint32_t x)
+{
+    x ^= x >> 16;
+    x *= 0x7feb352du;
+    x ^= x >> 15;
+    x *= 0x846ca68bu;
+    x ^= x >> 16;
+    return (x);
+};
+
+inline uint64_t SamplerHash::Mix64(uint64_t x)
+{
+    x ^= x >> 30;
+    x *= 0xbf58476d1ce4e5b9ULL;
+    x ^= x >> 27;
+    x *= 0x94d049bb133111ebULL;
+    x ^= x >> 31;
+    return (x);
+};
+
+inline uint32_t SamplerHash::Combine(uint32_t seed, uint32_t v)
+{
+    return (Mix(seed ^ (v + 0x9e3779b9u + (seed << 6) + (seed >> 2))));
+};
+
+inline uint32_t SamplerHash::Pixel(uint32_t x, uint32_t y, uint32_t seed)
+{
+    return (Combine(Combine(Mix(seed), x), y));
+};
+
+inline uint32_t SamplerHash::ReverseBits(uint32_t x)
+{
+    x = ((x >> 1) & 0x55555555u) | ((x & 0x55555555u) << 1);
+    x = ((x >> 2) & 0x33333333u) | ((x & 0x33333333u) << 2);
+    x = ((x >> 4) & 0x0f0f0f0fu) | ((x & 0x0f0f0f0fu) << 4);
+    x = ((x >> 8) & 0x00ff00ffu) | ((x & 0x00ff00ffu) << 8);
+    return ((x >> 16) | (x << 16));
+};
+
+inline float SamplerHash::ToFloat(uint32_t x)
+{
+    // 24 bits fit the mantissa, so the result never rounds up to 1.
+    return (static_cast<float>(x >> 8) * (1.0F / 16777216.0F));
+};
@@ -0,0 +1,391 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include "maths/packet.h"
+#include "samplers/hash.h"
+
+/**
+ * PCG32 random number generator (O'Neill, "PCG: A Family of Simple Fast
+ * Space-Efficient Statistically Good Algorithms for Random Number
+ * Generation", 2014): a 64-bit LCG whose output goes through a xorshift and
+ * a random rotation. Each generator has 2^63 selectable streams of period
+ * 2^64, and can jump ahead in O(log n).
+ *
+ * PCG32::ForPixel gives every (pixel, sample) its own reproducible sequence:
+ * the pixel picks the stream and the sample index jumps to its own block of
+ * PCG32_SAMPLE_STRIDE draws. PCG32xW runs W such generators side by side
+ * (e.g. W samples of a pixel); each lane yields exactly the values of the
+ * matching scalar PCG32. Widths 4 and 8 run in AVX2 registers; without
+ * AVX2 (no per-lane shifts) the lanes are stepped one by one, and a scalar
+ * PCG32 per lane is faster.
+ */
+
+/*** @brief LCG multiplier. */
+#define PCG32_MULT 0x5851f42d4c957f2dULL
+
+/*** @brief State and stream of a default-constructed generator. */
+#define PCG32_DEFAULT_STATE 0x853c49e6748fea9bULL
+#define PCG32_DEFAULT_STREAM 0xda3e39cb94b95bdbULL
+
+/*** @brief Draws reserved per sample by ForPixel before the next sample's block starts. */
+#define PCG32_SAMPLE_STRIDE 65536ULL
+
+struct PCG32
+{
+    public:
+        /*** @brief Default constructor. The reference generator of the PCG paper. */
+        PCG32(void);
+
+        /**
+         * @brief Constructor.
+         *
+         * @param initState Starting state.
+         * @param initSeq Stream selector; only the low 63 bits matter.
+         */
+        PCG32(uint64_t initState, uint64_t initSeq);
+
+        /*** @brief Reseeds, as the constructor. */
+        void Seed(uint64_t initState, uint64_t initSeq);
+
+        /*** @brief Next 32 uniformly distributed bits. */
+        uint32_t NextUInt(void);
+
+        /**
+         * @brief Uniform integer in [0, bound), without modulo bias.
+         *
+         * @param bound Exclusive upper bound, must not be 0.
+         */
+        uint32_t NextUInt(uint32_t bound);
+
+        /*** @brief Uniform float in [0, 1). */
+        float NextFloat(void);
+
+        /**
+         * @brief Jumps ahead, or back for a negative delta.
+         *
+         * @param delta Number of draws to skip.
+         */
+        void Advance(int64_t delta);
+
+        /**
+         * @brief Generator of one sample of one pixel.
+         *
+         * @param x The pixel column.
+         * @param y The pixel row.
+         * @param sampleIndex The sample index within the pixel.
+         * @param seed User seed, e.g. the frame number.
+         *
+         * @return The generator, positioned at the start of the sample's block.
+         */
+        static PCG32 ForPixel(uint32_t x, uint32_t y, uint32_t sampleIndex, uint32_t seed = 0);
+
+        /*** @brief LCG state and increment (always odd) */
+        uint64_t state, inc;
+};
+
+/**
+ * @brief Lane kernels of PCG32xW. The generic one is a plain loop; AVX2
+ *        brings the variable shifts and 32x32->64 multiplies needed to run
+ *        4 or 8 streams in vector registers.
+ */
+template <int W>
+struct PCG32Kernel
+{
+    public:
+        static RT_INLINE void Next(uint64_t* state, const uint64_t* inc, uint32_t* out)
+        {
+            for (int i = 0; i < W; i++)
+            {
+                uint64_t old = state[i];
+                state[i] = old * PCG32_MULT + inc[i];
+                uint32_t xorshifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+                uint32_t rot = static_cast<uint32_t>(old >> 59u);
+                out[i] = (xorshifted >> rot) | (xorshifted << ((~rot + 1u) & 31u));
+            }
+        };
+
+        static RT_INLINE void NextFloat(uint64_t* state, const uint64_t* inc, float* out)
+        {
+            uint32_t bits[W];
+
+            Next(state, inc, bits);
+            for (int i = 0; i < W; i++)
+                out[i] = SamplerHash::ToFloat(bits[i]);
+        };
+};
+
+#if defined(RT_SIMD_AVX2)
+/*** @brief Four 64-bit lanes per register; the 32-bit outputs are packed afterwards. */
+struct PCG32Avx2
+{
+    public:
+        // Low 32 bits of each output, still in 64-bit lanes.
+        static RT_INLINE __m256i Next(uint64_t* state, const uint64_t* inc)
+        {
+            const __m256i multLo = _mm256_set1_epi64x(static_cast<int64_t>(PCG32_MULT & 0xffffffffULL));
+            const __m256i multHi = _mm256_set1_epi64x(static_cast<int64_t>(PCG32_MULT >> 32));
+            const __m256i low32 = _mm256_set1_epi64x(0xffffffffLL);
+            __m256i old = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(state));
+            // old * MULT mod 2^64 from 32-bit halves; the high * high product overflows out.
+            __m256i lo = _mm256_mul_epu32(old, multLo);
+            __m256i cross = _mm256_add_epi64(_mm256_mul_epu32(_mm256_srli_epi64(old, 32), multLo), _mm256_mul_epu32(old, multHi));
+            __m256i next = _mm256_add_epi64(_mm256_add_epi64(lo, _mm256_slli_epi64(cross, 32)),
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(inc)));
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(state), next);
+            __m256i xorshifted = _mm256_and_si256(_mm256_srli_epi64(_mm256_xor_si256(_mm256_srli_epi64(old, 18), old), 27), low32);
+            __m256i rot = _mm256_srli_epi64(old, 59);
+            // Shifting left by 32 - rot in 64-bit lanes moves the wrapped bits up, and
+            // rot = 0 pushes them out of the low half entirely, as in the scalar code.
+            __m256i left = _mm256_sllv_epi64(xorshifted, _mm256_sub_epi64(_mm256_set1_epi64x(32), rot));
+            return (_mm256_and_si256(_mm256_or_si256(_mm256_srlv_epi64(xorshifted, rot), left), low32));
+        };
+
+        // Packs the low halves of the 64-bit lanes of a and b into 8 32-bit lanes.
+        static RT_INLINE __m256i Pack(__m256i a, __m256i b)
+        {
+            const __m256i even = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+            __m256i pa = _mm256_permutevar8x32_epi32(a, even);
+            __m256i pb = _mm256_permutevar8x32_epi32(b, even);
+            return (_mm256_permute2x128_si256(pa, pb, 0x20));
+        };
+
+        static RT_INLINE __m256 ToFloat(__m256i bits)
+        {
+            return (_mm256_mul_ps(_mm256_cvtepi32_ps(_mm256_srli_epi32(bits, 8)), _mm256_set1_ps(1.0F / 16777216.0F)));
+        };
+};
+
+template <>
+struct PCG32Kernel<4>
+{
+    public:
+        static RT_INLINE void Next(uint64_t* state, const uint64_t* inc, uint32_t* out)
+        {
+            __m256i bits = PCG32Avx2::Pack(PCG32Avx2::Next(state, inc), _mm256_setzero_si256());
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out), _mm256_castsi256_si128(bits));
+        };
+
+        static RT_INLINE void NextFloat(uint64_t* state, const uint64_t* inc, float* out)
+        {
+            __m256i bits = PCG32Avx2::Pack(PCG32Avx2::Next(state, inc), _mm256_setzero_si256());
+            _mm_store_ps(out, _mm256_castps256_ps128(PCG32Avx2::ToFloat(bits)));
+        };
+};
+
+template <>
+struct PCG32Kernel<8>
+{
+    public:
+        static RT_INLINE void Next(uint64_t* state, const uint64_t* inc, uint32_t* out)
+        {
+            __m256i a = PCG32Avx2::Next(state, inc);
+            __m256i b = PCG32Avx2::Next(state + 4, inc + 4);
+            _mm256_storeu_si256(reinterpret_cast<__m256i*>(out), PCG32Avx2::Pack(a, b));
+        };
+
+        static RT_INLINE void NextFloat(uint64_t* state, const uint64_t* inc, float* out)
+        {
+            __m256i a = PCG32Avx2::Next(state, inc);
+            __m256i b = PCG32Avx2::Next(state + 4, inc + 4);
+            _mm256_store_ps(out, PCG32Avx2::ToFloat(PCG32Avx2::Pack(a, b)));
+        };
+};
+#endif
+
+/*** @brief W PCG32 generators in SoA layout. */
+template <int W>
+struct PCG32xW
+{
+    public:
+        /*** @brief Default constructor. W copies of the default generator. */
+        PCG32xW(void);
+
+        /*** @brief Stores a generator in a lane. */
+        void Set(int lane, const PCG32& rng);
+
+        /*** @brief Reads the generator of a lane. */
+        PCG32 Get(int lane) const;
+
+        /*** @brief Next 32 bits of every lane. */
+        void NextUInt(uint32_t* out);
+
+        /*** @brief Uniform floats in [0, 1), one per lane. */
+        FloatxW<W> NextFloat(void);
+
+        /*** @brief Jumps every lane ahead by the same amount. */
+        void Advance(int64_t delta);
+
+        /**
+         * @brief Generators of W consecutive samples of one pixel.
+         *
+         * @param x The pixel column.
+         * @param y The pixel row.
+         * @param firstSample Sample index of lane 0; lane i gets firstSample + i.
+         * @param seed User seed, e.g. the frame number.
+         */
+        static PCG32xW ForPixel(uint32_t x, uint32_t y, uint32_t firstSample, uint32_t seed = 0);
+
+        /*** @brief LCG states and increments */
+        uint64_t state[W], inc[W];
+};
+
+inline PCG32::PCG32(void) : state(PCG32_DEFAULT_STATE), inc(PCG32_DEFAULT_STREAM) {};
+
+inline PCG32::PCG32(uint64_t initState, uint64_t initSeq)
+{
+    Seed(initState, initSeq);
+};
+
+inline void PCG32::Seed(uint64_t initState, uint64_t initSeq)
+{
+    state = 0u;
+    inc = (initSeq << 1u) | 1u;
+    NextUInt();
+    state += initState;
+    NextUInt();
+};
+
+inline uint32_t PCG32::NextUInt(void)
+{
+    uint64_t old = state;
+    state = old * PCG32_MULT + inc;
+    uint32_t xorshifted = static_cast<uint32_t>(((old >> 18u) ^ old) >> 27u);
+    uint32_t rot = static_cast<uint32_t>(old >> 59u);
+    return ((xorshifted >> rot) | (xorshifted << ((~rot + 1u) & 31u)));
+};
+
+inline uint32_t PCG32::NextUInt(uint32_t bound)
+{
+    // Rejects the 2^32 % bound lowest values, so every residue is equally likely.
+    uint32_t threshold = (~bound + 1u) % bound;
+
+    for (;;)
+    {
+        uint32_t r = NextUInt();
+        if (r >= threshold)
+            return (r % bound);
+    }
+};
+
+inline float PCG32::NextFloat(void)
+{
+    return (SamplerHash::ToFloat(NextUInt()));
+};
+
+inline void PCG32::Advance(int64_t delta)
+{
+    // Composes the affine map state -> state * MULT + inc with itself |delta| times,
+    // by squaring; a negative delta wraps around the 2^64 period.
+    uint64_t curMult = PCG32_MULT, curPlus = inc, accMult = 1u, accPlus = 0u;
+    uint64_t steps = static_cast<uint64_t>(delta);
+
+    while (steps > 0)
+    {
+        if (steps & 1u)
+        {
+            accMult *= curMult;
+            accPlus = accPlus * curMult + curPlus;
+        }
+        curPlus = (curMult + 1u) * curPlus;
+        curMult *= curMult;
+        steps >>= 1u;
+    }
+    state = accMult * state + accPlus;
+};
+
+inline PCG32 PCG32::ForPixel(uint32_t x, uint32_t y, uint32_t sampleIndex, uint32_t seed)
+{
+    uint32_t pixel = SamplerHash::Pixel(x, y, seed);
+    PCG32 rng(SamplerHash::Mix64(pixel), pixel);
+
+    rng.Advance(static_cast<int64_t>(sampleIndex * PCG32_SAMPLE_STRIDE));
+    return (rng);
+};
+
+template <int W>
+inline PCG32xW<W>::PCG32xW(void)
+{
+    for (int i = 0; i < W; i++)
+    {
+        state[i] = PCG32_DEFAULT_STATE;
+        inc[i] = PCG32_DEFAULT_STREAM;
+    }
+};
+
+template <int W>
+inline void PCG32xW<W>::Set(int lane, const PCG32& rng)
+{
+    state[lane] = rng.state;
+    inc[lane] = rng.inc;
+};
+
+template <int W>
+inline PCG32 PCG32xW<W>::Get(int lane) const
+{
+    PCG32 rng;
+
+    rng.state = state[lane];
+    rng.inc = inc[lane];
+    return (rng);
+};
+
+template <int W>
+RT_INLINE void PCG32xW<W>::NextUInt(uint32_t* out)
+{
+    PCG32Kernel<W>::Next(state, inc, out);
+};
+
+template <int W>
+RT_INLINE FloatxW<W> PCG32xW<W>::NextFloat(void)
+{
+    FloatxW<W> r;
+
+    PCG32Kernel<W>::NextFloat(state, inc, r.v);
+    return (r);
+};
+
+template <int W>
+inline void PCG32xW<W>::Advance(int64_t delta)
+{
+    for (int i = 0; i < W; i++)
+    {
+        PCG32 rng = Get(i);
+        rng.Advance(delta);
+        state[i] = rng.state;
+    }
+};
+
+template <int W>
+inline PCG32xW<W> PCG32xW<W>::ForPixel(uint32_t x, uint32_t y, uint32_t firstSample, uint32_t seed)
+{
+    PCG32xW rngs;
+
+    for (int i = 0; i < W; i++)
+        rngs.Set(i, PCG32::ForPixel(x, y, firstSample + static_cast<uint32_t>(i), seed));
+    return (rngs);
+};
@@ -0,0 +1,134 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include "maths/vec2.h"
+#include "samplers/hash.h"
+
+/**
+ * Rank-1 (Kronecker) sequences with blue-noise per-pixel offsets.
+ *
+ * R1 is the golden ratio sequence frac(0.5 + n / phi); R2 (M. Roberts, "The
+ * Unreasonable Effectiveness of Quasirandom Sequences", 2018) is its 2D
+ * generalization with the plastic number g: frac(0.5 + n (1/g, 1/g^2)).
+ * Both are computed in 0.32 fixed point, so the fractional part is exact
+ * whatever the index.
+ *
+ * Each pixel shifts the sequence (Cranley-Patterson rotation) by the value
+ * of the R2 dither mask, frac(x / g + y / g^2), whose spectrum is close to
+ * blue noise: neighbouring pixels get well separated offsets, which pushes
+ * the remaining error to high frequencies (Georgiev and Fajardo, "Blue-noise
+ * Dithered Sampling", 2016). The mask is computed, not read from a tiled
+ * texture, so it never repeats. The seed adds one more shift, e.g. to change
+ * the pattern from frame to frame.
+ */
+
+/*** @brief 2^32 / phi, 2^32 / g and 2^32 / g^2, rounded. */
+#define R1_ALPHA 0x9e3779b9u
+#define R2_ALPHA1 0xc13fa9a9u
+#define R2_ALPHA2 0x91e10da6u
+
+struct R2
+{
+    public:
+        /*** @brief Point n of the R1 sequence, in 0.32 fixed point. */
+        static uint32_t Sample1D(uint32_t index);
+
+        /*** @brief Point n of the R2 sequence, as two 0.32 fixed-point values. */
+        static void Sample2D(uint32_t index, uint32_t* x, uint32_t* y);
+
+        /**
+         * @brief R2 dither mask.
+         *
+         * @param x The pixel column.
+         * @param y The pixel row.
+         *
+         * @return The mask value, in 0.32 fixed point.
+         */
+        static uint32_t Dither(uint32_t x, uint32_t y);
+};
+
+/*** @brief Blue-noise shifted rank-1 samples of one pixel. */
+struct R2Sampler
+{
+    public:
+        /**
+         * @brief Constructor.
+         *
+         * @param x The pixel column.
+         * @param y The pixel row.
+         * @param seed User seed, e.g. the frame number.
+         */
+        R2Sampler(uint32_t x, uint32_t y, uint32_t seed = 0);
+
+        /*** @brief Sample n of the shifted R1 sequence, in [0, 1). */
+        float Get1D(uint32_t index) const;
+
+        /*** @brief Sample n of the shifted R2 sequence, in [0, 1)^2. */
+        Vec2 Get2D(uint32_t index) const;
+
+        /*** @brief Per-pixel shifts, 0.32 fixed point */
+        uint32_t shift[2];
+};
+
+inline uint32_t R2::Sample1D(uint32_t index)
+{
+    return (0x80000000u + index * R1_ALPHA);
+};
+
+inline void R2::Sample2D(uint32_t index, uint32_t* x, uint32_t* y)
+{
+    *x = 0x80000000u + index * R2_ALPHA1;
+    *y = 0x80000000u + index * R2_ALPHA2;
+};
+
+inline uint32_t R2::Dither(uint32_t x, uint32_t y)
+{
+    return (x * R2_ALPHA1 + y * R2_ALPHA2);
+};
+
+inline R2Sampler::R2Sampler(uint32_t x, uint32_t y, uint32_t seed)
+{
+    uint32_t s = SamplerHash::Mix(seed);
+
+    // The transposed mask for the second axis: same spectrum, decorrelated from the first.
+    shift[0] = R2::Dither(x, y) + s;
+    shift[1] = R2::Dither(y, x) + SamplerHash::Mix(s);
+};
+
+inline float R2Sampler::Get1D(uint32_t index) const
+{
+    return (SamplerHash::ToFloat(R2::Sample1D(index) + shift[0]));
+};
+
+inline Vec2 R2Sampler::Get2D(uint32_t index) const
+{
+    uint32_t x, y;
+
+    R2::Sample2D(index, &x, &y);
+    return (Vec2(SamplerHash::ToFloat(x + shift[0]), SamplerHash::ToFloat(y + shift[1])));
+};
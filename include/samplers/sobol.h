@@ -0,0 +1,237 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#include "maths/vec2.h"
+#include "samplers/hash.h"
+
+/**
+ * Owen-scrambled Sobol sequence.
+ *
+ * Sobol points are computed from direction numbers of Joe and Kuo
+ * ("Constructing Sobol sequences with better two-dimensional projections",
+ * 2008) for the first SOBOL_DIMENSIONS dimensions. The scrambling is the
+ * hash-based nested uniform scramble of Laine and Karras, with the hash of
+ * Burley ("Practical Hash-based Owen Scrambling", JCGT 2020): every bit
+ * only depends on the bits above it, so the scrambled points keep the
+ * stratification of the sequence ((0, m, 2)-nets in dimensions 0 and 1)
+ * while decorrelating pixels.
+ *
+ * SobolSampler follows Burley's padding: each 1D or 2D request draws from
+ * dimensions 0 and 1 with its own scramble seed and its own shuffle of the
+ * sample index, so every pair of dimensions has the quality of the first
+ * two, and any prefix of 2^m samples of a pixel stays stratified.
+ */
+
+/*** @brief Number of dimensions with direction numbers. */
+#define SOBOL_DIMENSIONS 8
+
+struct Sobol
+{
+    public:
+        /**
+         * @brief Unscrambled Sobol point.
+         *
+         * @param index The point index.
+         * @param dim The dimension, below SOBOL_DIMENSIONS.
+         *
+         * @return The coordinate as a 0.32 fixed-point value.
+         */
+        static uint32_t Sample(uint32_t index, int dim);
+
+        /**
+         * @brief Nested uniform (Owen) scramble of a 0.32 fixed-point value.
+         *
+         * @param x The value.
+         * @param seed Selects the permutation.
+         *
+         * @return The scrambled value.
+         */
+        static uint32_t OwenScramble(uint32_t x, uint32_t seed);
+
+        /**
+         * @brief Scrambled and shuffled Sobol point, as a float.
+         *
+         * @param index The point index.
+         * @param dim The dimension, below SOBOL_DIMENSIONS.
+         * @param seed Scramble seed; the same seed must be used for every
+         *             dimension of a point.
+         *
+         * @return The coordinate, in [0, 1).
+         */
+        static float ScrambledSample(uint32_t index, int dim, uint32_t seed);
+
+    private:
+        static const uint32_t* Matrix(int dim);
+
+        // Owen scramble of the index itself: permutes points within aligned power-of-two blocks.
+        static uint32_t Shuffle(uint32_t index, uint32_t seed);
+
+        static float ScrambledShuffled(uint32_t shuffled, int dim, uint32_t seed);
+
+        friend struct SobolSampler;
+};
+
+/*** @brief Padded Owen-scrambled Sobol samples of one pixel. */
+struct SobolSampler
+{
+    public:
+        /**
+         * @brief Constructor.
+         *
+         * @param x The pixel column.
+         * @param y The pixel row.
+         * @param seed User seed, e.g. the frame number.
+         */
+        SobolSampler(uint32_t x, uint32_t y, uint32_t seed = 0);
+
+        /*** @brief Starts a sample: later requests draw its dimensions from the first one. */
+        void StartSample(uint32_t index);
+
+        /*** @brief Next dimension of the current sample, in [0, 1). */
+        float Next1D(void);
+
+        /*** @brief Next two dimensions of the current sample, in [0, 1)^2. */
+        Vec2 Next2D(void);
+
+        /*** @brief Pixel seed */
+        uint32_t seed;
+        /*** @brief Current sample index, and next dimension */
+        uint32_t index, dimension;
+};
+
+inline const uint32_t* Sobol::Matrix(int dim)
+{
+    // Joe-Kuo new-joe-kuo-6.21201, dimensions 2 to 8: degree s, coefficients a, initial m.
+    struct Entry { int s; uint32_t a; uint32_t m[5]; };
+    struct Table
+    {
+        Table(void)
+        {
+            static const Entry entries[SOBOL_DIMENSIONS - 1] = {
+                { 1, 0, { 1 } },
+                { 2, 1, { 1, 3 } },
+                { 3, 1, { 1, 3, 1 } },
+                { 3, 2, { 1, 1, 1 } },
+                { 4, 1, { 1, 1, 3, 3 } },
+                { 4, 4, { 1, 3, 5, 13 } },
+                { 5, 2, { 1, 1, 5, 5, 17 } }
+            };
+
+            for (int i = 0; i < 32; i++)
+                v[0][i] = 1u << (31 - i);
+            for (int d = 1; d < SOBOL_DIMENSIONS; d++)
+            {
+                const Entry& e = entries[d - 1];
+                for (int i = 0; i < 32; i++)
+                {
+                    if (i < e.s)
+                    {
+                        v[d][i] = e.m[i] << (31 - i);
+                        continue;
+                    }
+                    v[d][i] = v[d][i - e.s] ^ (v[d][i - e.s] >> e.s);
+                    for (int k = 1; k < e.s; k++)
+                        v[d][i] ^= ((e.a >> (e.s - 1 - k)) & 1u) * v[d][i - k];
+                }
+            }
+        }
+        uint32_t v[SOBOL_DIMENSIONS][32];
+    };
+    static const Table table;
+
+    return (table.v[dim]);
+};
+
+inline uint32_t Sobol::Sample(uint32_t index, int dim)
+{
+    // The generator matrix of dimension 0 is the bit reversal (van der Corput).
+    if (dim == 0)
+        return (SamplerHash::ReverseBits(index));
+    const uint32_t* v = Matrix(dim);
+    uint32_t x = 0u;
+
+    // Branch-free: the index bits are as good as random for the predictor.
+    for (int i = 0; index; i++, index >>= 1)
+        x ^= v[i] & (0u - (index & 1u));
+    return (x);
+};
+
+inline uint32_t Sobol::OwenScramble(uint32_t x, uint32_t seed)
+{
+    // Laine-Karras permutation on the reversed bits, so that each bit
+    // only depends on the more significant ones of x.
+    x = SamplerHash::ReverseBits(x);
+    x ^= x * 0x3d20adeau;
+    x += seed;
+    x *= (seed >> 16) | 1u;
+    x ^= x * 0x05526c56u;
+    x ^= x * 0x53a22864u;
+    return (SamplerHash::ReverseBits(x));
+};
+
+inline uint32_t Sobol::Shuffle(uint32_t index, uint32_t seed)
+{
+    return (OwenScramble(index, SamplerHash::Combine(seed, 0xa511e9b3u)));
+};
+
+inline float Sobol::ScrambledSample(uint32_t index, int dim, uint32_t seed)
+{
+    return (ScrambledShuffled(Shuffle(index, seed), dim, seed));
+};
+
+inline float Sobol::ScrambledShuffled(uint32_t shuffled, int dim, uint32_t seed)
+{
+    return (SamplerHash::ToFloat(OwenScramble(Sample(shuffled, dim), SamplerHash::Combine(seed, static_cast<uint32_t>(dim)))));
+};
+
+inline SobolSampler::SobolSampler(uint32_t x, uint32_t y, uint32_t seed)
+    : seed(SamplerHash::Pixel(x, y, seed)), index(0u), dimension(0u) {};
+
+inline void SobolSampler::StartSample(uint32_t index)
+{
+    this->index = index;
+    dimension = 0u;
+};
+
+inline float SobolSampler::Next1D(void)
+{
+    float r = Sobol::ScrambledSample(index, 0, SamplerHash::Combine(seed, dimension));
+
+    dimension++;
+    return (r);
+};
+
+inline Vec2 SobolSampler::Next2D(void)
+{
+    uint32_t s = SamplerHash::Combine(seed, dimension);
+    uint32_t shuffled = Sobol::Shuffle(index, s);
+    Vec2 r(Sobol::ScrambledShuffled(shuffled, 0, s), Sobol::ScrambledShuffled(shuffled, 1, s));
+
+    dimension += 2u;
+    return (r);
+};
@@ -0,0 +1,326 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * Mipmap pyramids.
+ *
+ * BuildMipmap turns a decoded texture_image_t into a full chain down to 1x1,
+ * each level half the size of the previous one (rounded down, at least 1).
+ * All levels live in one contiguous byte array, level 0 first, so a pyramid
+ * is one allocation and can be written to disk as is. Levels are filtered
+ * from the previous level with either a 2x2 box or a separable Kaiser
+ * windowed sinc, which keeps more detail for the same amount of aliasing.
+ * Filtering works on the stored 8-bit values directly.
+ */
+
+#pragma once
+
+#include <cmath>
+#include <cstdio>
+#include "loaders/mapped_file.h"
+#include "textures/texture_cache.h"
+#include "utils/serialization.h"
+
+#define MIPMAP_MAGIC "RTMIPS"
+#define MIPMAP_VERSION 1u
+
+typedef enum {
+    MIP_FILTER_BOX,
+    MIP_FILTER_KAISER
+} mip_filter_t;
+
+typedef struct {
+    int width;
+    int height;
+    size_t offset;
+} mip_level_t;
+
+typedef struct {
+    int channels;
+    std::vector<mip_level_t> levels;
+    std::vector<unsigned char> data;
+} mipmap_t;
+
+static inline unsigned char mipQuantize(float v)
+{
+    if (v <= 0.0f) return (0);
+    if (v >= 255.0f) return (255);
+    return (static_cast<unsigned char>(v + 0.5f));
+}
+
+static void mipDownsampleBox(const unsigned char *src, int sw, int sh, unsigned char *dst, int dw, int dh, int channels)
+{
+    for (int y = 0; y < dh; y++) {
+        int y0 = std::min(2 * y, sh - 1), y1 = std::min(2 * y + 1, sh - 1);
+        for (int x = 0; x < dw; x++) {
+            int x0 = std::min(2 * x, sw - 1), x1 = std::min(2 * x + 1, sw - 1);
+            for (int c = 0; c < channels; c++) {
+                int sum = src[(static_cast<size_t>(y0) * sw + x0) * channels + c] + src[(static_cast<size_t>(y0) * sw + x1) * channels + c]
+                    + src[(static_cast<size_t>(y1) * sw + x0) * channels + c] + src[(static_cast<size_t>(y1) * sw + x1) * channels + c];
+                dst[(static_cast<size_t>(y) * dw + x) * channels + c] = static_cast<unsigned char>((sum + 2) >> 2);
+            }
+        }
+    }
+}
+
+static double mipBesselI0(double x)
+{
+    double sum = 1.0, term = 1.0;
+    for (int k = 1; k < 32; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+    }
+    return (sum);
+}
+
+#define MIP_KAISER_TAPS 8
+
+// Weights of a 2:1 downsampling kernel at source offsets -3.5 .. 3.5.
+static void mipKaiserWeights(float *weights)
+{
+    const double alpha = 4.0, radius = 4.0, pi = 3.14159265358979323846;
+    double total = 0.0;
+    double w[MIP_KAISER_TAPS];
+    for (int i = 0; i < MIP_KAISER_TAPS; i++) {
+        double x = (i - MIP_KAISER_TAPS / 2 + 0.5) / 2.0;
+        double sinc = x == 0.0 ? 1.0 : std::sin(pi * x) / (pi * x);
+        double r = (i - MIP_KAISER_TAPS / 2 + 0.5) / radius;
+        w[i] = sinc * mipBesselI0(alpha * std::sqrt(std::max(0.0, 1.0 - r * r))) / mipBesselI0(alpha);
+        total += w[i];
+    }
+    for (int i = 0; i < MIP_KAISER_TAPS; i++) {
+        weights[i] = static_cast<float>(w[i] / total);
+    }
+}
+
+static void mipDownsampleKaiser(const unsigned char *src, int sw, int sh, unsigned char *dst, int dw, int dh, int channels)
+{
+    float weights[MIP_KAISER_TAPS];
+    mipKaiserWeights(weights);
+    // Horizontal pass into floats, then vertical pass with edge clamping.
+    // A source axis that did not shrink (size 1) is copied through.
+    std::vector<float> tmp(static_cast<size_t>(dw) * sh * channels);
+    for (int y = 0; y < sh; y++) {
+        for (int x = 0; x < dw; x++) {
+            for (int c = 0; c < channels; c++) {
+                float v = 0.0f;
+                if (sw == dw) {
+                    v = src[(static_cast<size_t>(y) * sw + x) * channels + c];
+                } else {
+                    for (int t = 0; t < MIP_KAISER_TAPS; t++) {
+                        int sx = std::max(0, std::min(sw - 1, 2 * x + t - MIP_KAISER_TAPS / 2 + 1));
+                        v += weights[t] * src[(static_cast<size_t>(y) * sw + sx) * channels + c];
+                    }
+                }
+                tmp[(static_cast<size_t>(y) * dw + x) * channels + c] = v;
+            }
+        }
+    }
+    for (int y = 0; y < dh; y++) {
+        for (int x = 0; x < dw; x++) {
+            for (int c = 0; c < channels; c++) {
+                float v = 0.0f;
+                if (sh == dh) {
+                    v = tmp[(static_cast<size_t>(y) * dw + x) * channels + c];
+                } else {
+                    for (int t = 0; t < MIP_KAISER_TAPS; t++) {
+                        int sy = std::max(0, std::min(sh - 1, 2 * y + t - MIP_KAISER_TAPS / 2 + 1));
+                        v += weights[t] * tmp[(static_cast<size_t>(sy) * dw + x) * channels + c];
+                    }
+                }
+                dst[(static_cast<size_t>(y) * dw + x) * channels + c] = mipQuantize(v);
+            }
+        }
+    }
+}
+
+/**
+ * @brief Builds the full mip chain of an image.
+ *
+ * @return False if the image is empty or its pixels are missing.
+ */
+inline bool BuildMipmap(const texture_image_t &image, mipmap_t *mipmap, mip_filter_t filter = MIP_FILTER_BOX)
+{
+    mipmap->levels.clear();
+    mipmap->data.clear();
+    mipmap->channels = image.channels;
+    if (image.width <= 0 || image.height <= 0 || image.channels <= 0
+        || image.pixels.size() < static_cast<size_t>(image.width) * image.height * image.channels) {
+        return (false);
+    }
+    size_t total = 0;
+    int w = image.width, h = image.height;
+    for (;;) {
+        mip_level_t level;
+        level.width = w;
+        level.height = h;
+        level.offset = total;
+        mipmap->levels.push_back(level);
+        total += static_cast<size_t>(w) * h * image.channels;
+        if (w == 1 && h == 1) break;
+        w = std::max(1, w / 2);
+        h = std::max(1, h / 2);
+    }
+    mipmap->data.resize(total);
+    memcpy(&mipmap->data[0], &image.pixels[0], static_cast<size_t>(image.width) * image.height * image.channels);
+    for (size_t i = 1; i < mipmap->levels.size(); i++) {
+        const mip_level_t &s = mipmap->levels[i - 1];
+        const mip_level_t &d = mipmap->levels[i];
+        if (filter == MIP_FILTER_KAISER) {
+            mipDownsampleKaiser(&mipmap->data[s.offset], s.width, s.height, &mipmap->data[d.offset], d.width, d.height, image.channels);
+        } else {
+            mipDownsampleBox(&mipmap->data[s.offset], s.width, s.height, &mipmap->data[d.offset], d.width, d.height, image.channels);
+        }
+    }
+    return (true);
+}
+
+/**
+ * @brief Builds the pyramids of several textures, one job per texture.
+ *
+ * NULL images produce an empty mipmap_t.
+ */
+inline void BuildMipmaps(const std::vector<std::shared_ptr<const texture_image_t> > &images,
+    std::vector<mipmap_t> *mipmaps, ThreadPool *pool, mip_filter_t filter = MIP_FILTER_BOX)
+{
+    mipmaps->assign(images.size(), mipmap_t());
+    for (size_t i = 0; i < images.size(); i++) {
+        if (!images[i]) continue;
+        const texture_image_t *image = images[i].get();
+        mipmap_t *mipmap = &(*mipmaps)[i];
+        pool->submit([image, mipmap, filter] { BuildMipmap(*image, mipmap, filter); });
+    }
+    pool->wait();
+}
+
+inline bool SaveMipmap(const char *path, const mipmap_t &mipmap)
+{
+    CacheWriter w;
+    w.bytes(MIPMAP_MAGIC, sizeof(MIPMAP_MAGIC));
+    w.pod(static_cast<uint32_t>(MIPMAP_VERSION));
+    w.pod(static_cast<int32_t>(mipmap.channels));
+    w.array(mipmap.levels);
+    w.array(mipmap.data);
+    const std::vector<char> &buf = w.buffer();
+    std::string tmp = std::string(path) + ".tmp";
+    FILE *fp = fopen(tmp.c_str(), "wb");
+    if (!fp) return (false);
+    bool ok = fwrite(&buf[0], 1, buf.size(), fp) == buf.size();
+    ok = (fclose(fp) == 0) && ok;
+    if (!ok || rename(tmp.c_str(), path) != 0) {
+        remove(tmp.c_str());
+        return (false);
+    }
+    return (true);
+}
+
+/**
+ * @brief Loads a pyramid written by SaveMipmap.
+ *
+ * @return False if the file is missing, truncated, from another version, has
+ *         no channels, or if its levels do not fit in its data. `mipmap` is
+ *         only modified on success.
+ */
+inline bool LoadMipmap(const char *path, mipmap_t *mipmap)
+{
+    MappedFile file;
+    if (!file.open(path)) return (false);
+    CacheReader r(file.data(), file.size());
+    char magic[sizeof(MIPMAP_MAGIC)];
+    uint32_t version = 0;
+    int32_t channels = 0;
+    mipmap_t loaded;
+    if (!r.bytes(magic, sizeof(magic)) || memcmp(magic, MIPMAP_MAGIC, sizeof(magic)) != 0) return (false);
+    if (!r.pod(&version) || version != MIPMAP_VERSION) return (false);
+    if (!r.pod(&channels) || channels <= 0) return (false);
+    if (!r.array(&loaded.levels) || !r.array(&loaded.data)) return (false);
+    loaded.channels = channels;
+    const uint64_t size = loaded.data.size();
+    for (size_t i = 0; i < loaded.levels.size(); i++) {
+        const mip_level_t &l = loaded.levels[i];
+        if (l.width <= 0 || l.height <= 0 || l.offset > size) return (false);
+        // Compared by division so that a forged level size cannot wrap around.
+        const uint64_t texels = static_cast<uint64_t>(l.width) * static_cast<uint64_t>(l.height);
+        if (texels > (size - l.offset) / static_cast<uint64_t>(channels)) return (false);
+    }
+    std::swap(*mipmap, loaded);
+    return (true);
+}
+
+/**
+ * @brief Level of detail for a footprint given as texture-coordinate
+ *        derivatives along screen x and y (isotropic, largest axis).
+ *
+ * @return A continuous level in [0, levels - 1].
+ */
+inline float SelectMipLevel(const mipmap_t &mipmap, float dudx, float dvdx, float dudy, float dvdy)
+{
+    if (mipmap.levels.empty()) return (0.0f);
+    float w = static_cast<float>(mipmap.levels[0].width);
+    float h = static_cast<float>(mipmap.levels[0].height);
+    float lx = (dudx * w) * (dudx * w) + (dvdx * h) * (dvdx * h);
+    float ly = (dudy * w) * (dudy * w) + (dvdy * h) * (dvdy * h);
+    float lod = 0.5f * std::log2(std::max(std::max(lx, ly), 1e-20f));
+    return (std::max(0.0f, std::min(lod, static_cast<float>(mipmap.levels.size() - 1))));
+}
+
+static void sampleMipLevel(const mipmap_t &mipmap, size_t index, float u, float v, float *out)
+{
+    const mip_level_t &l = mipmap.levels[index];
+    const unsigned char *texels = &mipmap.data[l.offset];
+    float x = (u - std::floor(u)) * l.width - 0.5f;
+    float y = (v - std::floor(v)) * l.height - 0.5f;
+    float fx = std::floor(x), fy = std::floor(y);
+    float tx = x - fx, ty = y - fy;
+    int x0 = (static_cast<int>(fx) % l.width + l.width) % l.width, x1 = (x0 + 1) % l.width;
+    int y0 = (static_cast<int>(fy) % l.height + l.height) % l.height, y1 = (y0 + 1) % l.height;
+    for (int c = 0; c < std::min(mipmap.channels, 4); c++) {
+        float a = texels[(static_cast<size_t>(y0) * l.width + x0) * mipmap.channels + c];
+        float b = texels[(static_cast<size_t>(y0) * l.width + x1) * mipmap.channels + c];
+        float d = texels[(static_cast<size_t>(y1) * l.width + x0) * mipmap.channels + c];
+        float e = texels[(static_cast<size_t>(y1) * l.width + x1) * mipmap.channels + c];
+        out[c] = ((a + (b - a) * tx) + ((d + (e - d) * tx) - (a + (b - a) * tx)) * ty) * (1.0f / 255.0f);
+    }
+}
+
+/**
+ * @brief Trilinear lookup with repeat wrapping.
+ *
+ * @param out Receives min(channels, 4) values in [0, 1].
+ */
+inline void SampleMipmap(const mipmap_t &mipmap, float u, float v, float lod, float *out)
+{
+    if (mipmap.levels.empty()) return;
+    lod = std::max(0.0f, std::min(lod, static_cast<float>(mipmap.levels.size() - 1)));
+    size_t l0 = static_cast<size_t>(lod);
+    size_t l1 = std::min(l0 + 1, mipmap.levels.size() - 1);
+    float t = lod - static_cast<float>(l0);
+    sampleMipLevel(mipmap, l0, u, v, out);
+    if (t == 0.0f || l1 == l0) return;
+    float upper[4];
+    sampleMipLevel(mipmap, l1, u, v, upper);
+    for (int c = 0; c < mipmap.channels && c < 4; c++) {
+        out[c] += (upper[c] - out[c]) * t;
+    }
+}
@@ -0,0 +1,56 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#pragma once
+
+#include <SFML/Graphics/Image.hpp>
+#include "textures/texture_cache.h"
+
+/**
+ * @brief TextureDecoder backed by sf::Image (PNG, JPG, BMP, TGA, ...).
+ *        Images are always expanded to RGBA8.
+ */
+class SFMLTextureDecoder : public TextureDecoder {
+public:
+    SFMLTextureDecoder() {}
+    virtual ~SFMLTextureDecoder() {}
+    virtual bool operator()(const std::string &path, texture_image_t *image,
+                            std::string *err)
+    {
+        sf::Image decoded;
+        if (!decoded.loadFromFile(path)) {
+            if (err) {
+                (*err) = "Cannot decode texture [" + path + "]";
+            }
+            return (false);
+        }
+        sf::Vector2u size = decoded.getSize();
+        image->width = static_cast<int>(size.x);
+        image->height = static_cast<int>(size.y);
+        image->channels = 4;
+        const sf::Uint8 *pixels = decoded.getPixelsPtr();
+        image->pixels.assign(pixels, pixels + static_cast<size_t>(size.x) * size.y * 4);
+        return (true);
+    }
+};
@@ -0,0 +1,307 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+/**
+ * Texture cache.
+ *
+ * Textures are registered by path (request) without touching the disk. The
+ * first access schedules a decode on a ThreadPool through a pluggable
+ * TextureDecoder; later accesses hit the decoded image. Decoded bytes are
+ * kept under a configurable budget by evicting the least recently used
+ * textures. Images are handed out as shared pointers, so an evicted texture
+ * stays valid for whoever still holds it. Registering the textures of loaded
+ * materials is in textures/texture_cache_obj.h, which keeps this header free
+ * of the OBJ loader.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstring>
+#include <list>
+#include <map>
+#include <memory>
+#include <string>
+#include "utils/thread_pool.h"
+
+#define TEXTURE_NO_HANDLE (-1)
+
+typedef int texture_handle_t;
+
+typedef struct {
+    int width;
+    int height;
+    int channels;
+    std::vector<unsigned char> pixels;
+} texture_image_t;
+
+typedef struct {
+    size_t hits;
+    size_t misses;
+    size_t decodes;
+    size_t decode_failures;
+    size_t evictions;
+    double decode_seconds;
+    size_t resident_bytes;
+    size_t peak_bytes;
+} texture_cache_stats_t;
+
+/**
+ * @brief Turns a file into pixels. Called from the cache's worker threads,
+ *        so implementations must be reentrant.
+ */
+class TextureDecoder {
+public:
+    TextureDecoder() {}
+    virtual ~TextureDecoder() {}
+    virtual bool operator()(const std::string &path, texture_image_t *image,
+                            std::string *err) = 0;
+};
+
+class TextureCache {
+public:
+    /**
+     * @param decoder      Decoder used for every texture; must outlive the cache.
+     * @param pool         Workers running the decodes; must outlive the cache.
+     * @param budget_bytes Maximum decoded bytes kept resident, 0 for no limit.
+     */
+    TextureCache(TextureDecoder *decoder, ThreadPool *pool, size_t budget_bytes = 0)
+        : m_decoder(decoder), m_pool(pool), m_budget(budget_bytes), m_pending(0)
+    {
+        memset(&m_stats, 0, sizeof(m_stats));
+    }
+
+    ~TextureCache()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_ready.wait(lock, [this] { return (m_pending == 0); });
+    }
+
+    /**
+     * @brief Registers a texture without decoding it.
+     *
+     * Backslashes are turned into slashes, since MTL files written on Windows
+     * use them. The same path always yields the same handle.
+     */
+    texture_handle_t request(const std::string &path)
+    {
+        std::string key = path;
+        for (size_t i = 0; i < key.size(); i++) {
+            if (key[i] == '\\') key[i] = '/';
+        }
+        std::unique_lock<std::mutex> lock(m_mutex);
+        std::map<std::string, texture_handle_t>::const_iterator it = m_handles.find(key);
+        if (it != m_handles.end()) {
+            return (it->second);
+        }
+        texture_handle_t handle = static_cast<texture_handle_t>(m_entries.size());
+        m_entries.push_back(Entry());
+        m_entries.back().path = key;
+        m_entries.back().lru = m_lru.end();
+        m_handles[key] = handle;
+        return (handle);
+    }
+
+    /**
+     * @brief Non-blocking access.
+     *
+     * @return The decoded image, or NULL while it is not resident; in that
+     *         case a decode is scheduled if none is running. NULL for
+     *         TEXTURE_NO_HANDLE and other handles never returned by request.
+     */
+    std::shared_ptr<const texture_image_t> tryGet(texture_handle_t handle)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!valid(handle)) return (std::shared_ptr<const texture_image_t>());
+        return (lookup(handle));
+    }
+
+    /**
+     * @brief Blocking access: waits for the decode if needed.
+     *
+     * @return The decoded image, or NULL if the decoder failed or the handle
+     *         is not valid (see tryGet).
+     */
+    std::shared_ptr<const texture_image_t> get(texture_handle_t handle)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!valid(handle)) return (std::shared_ptr<const texture_image_t>());
+        std::shared_ptr<const texture_image_t> image = lookup(handle);
+        Entry &entry = m_entries[handle];
+        // Loops because a concurrent decode may evict the image before we wake.
+        while (!image && !entry.failed) {
+            if (!entry.decoding) schedule(handle);
+            m_ready.wait(lock, [&entry] { return (!entry.decoding); });
+            image = entry.image;
+        }
+        if (image) touch(handle);
+        return (image);
+    }
+
+    /*** @brief Schedules decodes without waiting, e.g. right after loading. Ignores invalid handles. */
+    void prefetch(texture_handle_t handle)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        if (!valid(handle)) return;
+        Entry &entry = m_entries[handle];
+        if (!entry.image && !entry.decoding && !entry.failed) schedule(handle);
+    }
+
+    /*** @brief Normalized path of a texture, empty for an invalid handle. */
+    std::string path(texture_handle_t handle)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return (valid(handle) ? m_entries[handle].path : std::string());
+    }
+
+    /*** @brief Last decoder error for this texture, empty if none or for an invalid handle. */
+    std::string error(texture_handle_t handle)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return (valid(handle) ? m_entries[handle].err : std::string());
+    }
+
+    size_t size()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return (m_entries.size());
+    }
+
+    texture_cache_stats_t stats()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        return (m_stats);
+    }
+
+    void setBudget(size_t budget_bytes)
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_budget = budget_bytes;
+        evict(TEXTURE_NO_HANDLE);
+    }
+
+private:
+    TextureCache(const TextureCache &);
+    TextureCache &operator=(const TextureCache &);
+
+    struct Entry {
+        Entry() : bytes(0), decoding(false), failed(false) {}
+        std::string path;
+        std::shared_ptr<const texture_image_t> image;
+        std::list<texture_handle_t>::iterator lru;
+        size_t bytes;
+        bool decoding;
+        bool failed;
+        std::string err;
+    };
+
+    // Called with m_mutex held, like every helper below.
+    bool valid(texture_handle_t handle) const
+    {
+        return (handle >= 0 && static_cast<size_t>(handle) < m_entries.size());
+    }
+
+    std::shared_ptr<const texture_image_t> lookup(texture_handle_t handle)
+    {
+        Entry &entry = m_entries[handle];
+        if (entry.image) {
+            m_stats.hits++;
+            touch(handle);
+            return (entry.image);
+        }
+        m_stats.misses++;
+        if (!entry.decoding && !entry.failed) schedule(handle);
+        return (std::shared_ptr<const texture_image_t>());
+    }
+
+    void touch(texture_handle_t handle)
+    {
+        m_lru.splice(m_lru.begin(), m_lru, m_entries[handle].lru);
+    }
+
+    void schedule(texture_handle_t handle)
+    {
+        m_entries[handle].decoding = true;
+        m_pending++;
+        m_pool->submit(std::bind(&TextureCache::decode, this, handle, m_entries[handle].path));
+    }
+
+    void decode(texture_handle_t handle, const std::string &path)
+    {
+        std::shared_ptr<texture_image_t> image(new texture_image_t());
+        image->width = image->height = image->channels = 0;
+        std::string err;
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+        bool ok = (*m_decoder)(path, image.get(), &err);
+        double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+        std::unique_lock<std::mutex> lock(m_mutex);
+        Entry &entry = m_entries[handle];
+        m_stats.decodes++;
+        m_stats.decode_seconds += seconds;
+        entry.decoding = false;
+        if (ok) {
+            entry.image = image;
+            entry.bytes = image->pixels.capacity() + sizeof(texture_image_t);
+            m_lru.push_front(handle);
+            entry.lru = m_lru.begin();
+            m_stats.resident_bytes += entry.bytes;
+            m_stats.peak_bytes = std::max(m_stats.peak_bytes, m_stats.resident_bytes);
+            evict(handle);
+        } else {
+            entry.failed = true;
+            entry.err = err;
+            m_stats.decode_failures++;
+        }
+        m_pending--;
+        m_ready.notify_all();
+    }
+
+    // Drops least recently used images until under budget, never `keep`.
+    void evict(texture_handle_t keep)
+    {
+        while (m_budget && m_stats.resident_bytes > m_budget && !m_lru.empty()) {
+            texture_handle_t victim = m_lru.back();
+            if (victim == keep) break;
+            Entry &entry = m_entries[victim];
+            m_lru.pop_back();
+            entry.lru = m_lru.end();
+            entry.image.reset();
+            m_stats.resident_bytes -= entry.bytes;
+            entry.bytes = 0;
+            m_stats.evictions++;
+        }
+    }
+
+    TextureDecoder *m_decoder;
+    ThreadPool *m_pool;
+    size_t m_budget;
+    size_t m_pending;
+    std::deque<Entry> m_entries;
+    std::map<std::string, texture_handle_t> m_handles;
+    std::list<texture_handle_t> m_lru;
+    texture_cache_stats_t m_stats;
+    std::mutex m_mutex;
+    std::condition_variable m_ready;
+};
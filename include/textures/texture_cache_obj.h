@@ -0,0 +1,58 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include "loaders/obj.h"
+#include "textures/texture_cache.h"
+
+/**
+ * OBJ interop for TextureCache, kept out of textures/texture_cache.h so that
+ * the cache never pulls in the loader, whose non-inline definitions limit it
+ * to one translation unit per program.
+ */
+
+/**
+ * @brief Registers every texture referenced by a material list.
+ *
+ * @param cache The cache to register the textures with.
+ * @param materials The loaded materials.
+ * @param basedir Prefixed to every texture name.
+ *
+ * @return One handle per material and OBJ_MATERIAL_TEXTURES slot, in
+ *         that order; TEXTURE_NO_HANDLE where the slot is empty.
+ */
+inline std::vector<texture_handle_t> requestMaterialTextures(TextureCache *cache,
+    const std::vector<material_t> &materials, const std::string &basedir = "")
+{
+    std::vector<texture_handle_t> handles;
+    for (size_t i = 0; i < materials.size(); i++) {
+#define X(n) handles.push_back(materials[i].n##_texname.empty() ? TEXTURE_NO_HANDLE : cache->request(basedir + materials[i].n##_texname));
+        OBJ_MATERIAL_TEXTURES(X)
+#undef X
+    }
+    return (handles);
+}
@@ -0,0 +1,98 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#include <vector>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+
+/**
+ * @brief std::allocator replacement honouring an alignment larger than the
+ *        one of operator new, which C++11 does not guarantee for over-aligned
+ *        types (e.g. 32-byte AVX packets stored in a std::vector).
+ *
+ * @tparam Align Power of two, 0 for alignof(T). The default is resolved at
+ *               allocation, so it may name a type that is still incomplete.
+ */
+template <typename T, size_t Align = 0>
+class AlignedAllocator {
+public:
+    typedef T value_type;
+
+    template <typename U>
+    struct rebind {
+        typedef AlignedAllocator<U, Align> other;
+    };
+
+    AlignedAllocator() {}
+
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U, Align> &) {}
+
+    T *allocate(size_t n)
+    {
+        if (n > static_cast<size_t>(-1) / sizeof(T)) {
+            throw std::bad_alloc();
+        }
+        size_t align = Align ? Align : alignof(T);
+        align = align < sizeof(void *) ? sizeof(void *) : align;
+#if defined(_WIN32)
+        void *p = _aligned_malloc(n * sizeof(T), align);
+#else
+        void *p = NULL;
+        if (posix_memalign(&p, align, n * sizeof(T)) != 0) {
+            p = NULL;
+        }
+#endif
+        if (!p) {
+            throw std::bad_alloc();
+        }
+        return (static_cast<T *>(p));
+    }
+
+    void deallocate(T *p, size_t)
+    {
+#if defined(_WIN32)
+        _aligned_free(p);
+#else
+        free(p);
+#endif
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U, Align> &) const { return (true); }
+
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U, Align> &) const { return (false); }
+};
+
+/*** @brief std::vector whose storage honours alignof(T). */
+template <typename T>
+using AlignedVector = std::vector<T, AlignedAllocator<T> >;
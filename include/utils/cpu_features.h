@@ -0,0 +1,143 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#pragma once
+
+#include <cstdint>
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#elif defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#include <cpuid.h>
+#endif
+
+/**
+ * Run-time CPU feature detection.
+ *
+ * config.h describes what the compiler was allowed to emit; this describes
+ * what the machine running the binary can execute. AVX and AVX-512 are only
+ * reported when the OS also saves their registers (XCR0), since the CPUID
+ * bits alone say nothing about context switches. Everything is false on
+ * non-x86 targets.
+ */
+
+typedef struct {
+    bool sse2;
+    bool sse3;
+    bool ssse3;
+    bool sse41;
+    bool sse42;
+    bool popcnt;
+    bool avx;
+    bool avx2;
+    bool fma;
+    bool f16c;
+    bool bmi2;
+    bool avx512f;
+    bool avx512dq;
+    bool avx512bw;
+    bool avx512vl;
+} cpu_features_t;
+
+#if (defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))) || (defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__)))
+    #define RT_HAS_CPUID 1
+#endif
+
+#if defined(RT_HAS_CPUID)
+static inline void cpuidQuery(unsigned int leaf, unsigned int sub, unsigned int regs[4])
+{
+#if defined(_MSC_VER)
+    int r[4];
+    __cpuidex(r, static_cast<int>(leaf), static_cast<int>(sub));
+    for (int i = 0; i < 4; i++) {
+        regs[i] = static_cast<unsigned int>(r[i]);
+    }
+#else
+    __cpuid_count(leaf, sub, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// XCR0; only valid when CPUID reports OSXSAVE. Written as asm so that the
+// caller does not need -mxsave.
+static inline uint64_t cpuidXcr0()
+{
+#if defined(_MSC_VER)
+    return (static_cast<uint64_t>(_xgetbv(0)));
+#else
+    uint32_t lo, hi;
+    __asm__ __volatile__("xgetbv" : "=a"(lo), "=d"(hi) : "c"(0));
+    return ((static_cast<uint64_t>(hi) << 32) | lo);
+#endif
+}
+#endif
+
+static inline cpu_features_t detectCpuFeatures()
+{
+    cpu_features_t f = cpu_features_t();
+#if defined(RT_HAS_CPUID)
+    unsigned int r[4];
+    cpuidQuery(0, 0, r);
+    const unsigned int maxLeaf = r[0];
+    if (maxLeaf < 1) {
+        return (f);
+    }
+    cpuidQuery(1, 0, r);
+    const unsigned int ecx1 = r[2];
+    const unsigned int edx1 = r[3];
+    f.sse2 = (edx1 >> 26) & 1;
+    f.sse3 = ecx1 & 1;
+    f.ssse3 = (ecx1 >> 9) & 1;
+    f.sse41 = (ecx1 >> 19) & 1;
+    f.sse42 = (ecx1 >> 20) & 1;
+    f.popcnt = (ecx1 >> 23) & 1;
+
+    // XCR0 bits 1-2: XMM and YMM state; bits 5-7: opmask and ZMM state.
+    const bool osxsave = (ecx1 >> 27) & 1;
+    const uint64_t xcr0 = osxsave ? cpuidXcr0() : 0;
+    const bool ymm = (xcr0 & 0x6) == 0x6;
+    const bool zmm = ymm && (xcr0 & 0xE0) == 0xE0;
+
+    f.avx = ymm && ((ecx1 >> 28) & 1);
+    f.fma = f.avx && ((ecx1 >> 12) & 1);
+    f.f16c = f.avx && ((ecx1 >> 29) & 1);
+    if (maxLeaf >= 7) {
+        cpuidQuery(7, 0, r);
+        const unsigned int ebx7 = r[1];
+        f.avx2 = f.avx && ((ebx7 >> 5) & 1);
+        f.bmi2 = (ebx7 >> 8) & 1;
+        f.avx512f = zmm && ((ebx7 >> 16) & 1);
+        f.avx512dq = f.avx512f && ((ebx7 >> 17) & 1);
+        f.avx512bw = f.avx512f && ((ebx7 >> 30) & 1);
+        f.avx512vl = f.avx512f && ((ebx7 >> 31) & 1);
+    }
+#endif
+    return (f);
+}
+
+/*** @brief Features of the running CPU, detected on the first call. */
+inline const cpu_features_t &GetCpuFeatures()
+{
+    static const cpu_features_t features = detectCpuFeatures();
+    return (features);
+}
@@ -0,0 +1,93 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#pragma once
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+/**
+ * Flat binary serialization shared by the on-disk caches.
+ *
+ * Values are written in native byte order and POD layout without alignment.
+ * Arrays are a u64 element count followed by the raw elements, strings a u64
+ * length followed by the bytes. CacheReader checks every length against the
+ * bytes that are left and stays failed after the first short read.
+ */
+
+class CacheWriter {
+public:
+    void bytes(const void *p, size_t n) { m_buf.insert(m_buf.end(), static_cast<const char *>(p), static_cast<const char *>(p) + n); }
+    template <typename T> void pod(const T &v) { bytes(&v, sizeof(T)); }
+    void str(const std::string &s) { pod(static_cast<uint64_t>(s.size())); bytes(s.data(), s.size()); }
+    template <typename T> void array(const std::vector<T> &v)
+    {
+        pod(static_cast<uint64_t>(v.size()));
+        if (!v.empty()) bytes(&v[0], v.size() * sizeof(T));
+    }
+    const std::vector<char> &buffer() const { return (m_buf); }
+private:
+    std::vector<char> m_buf;
+};
+
+class CacheReader {
+public:
+    CacheReader(const char *data, size_t size) : m_cur(data), m_end(data + size), m_ok(true) {}
+    bool bytes(void *p, size_t n)
+    {
+        if (!m_ok || static_cast<size_t>(m_end - m_cur) < n) return (m_ok = false);
+        if (n) memcpy(p, m_cur, n);
+        m_cur += n;
+        return (true);
+    }
+    template <typename T> bool pod(T *v) { return (bytes(v, sizeof(T))); }
+    /*** @brief Reads a record count, rejecting more records of at least `record` bytes than are left. */
+    bool count(uint64_t *n, size_t record)
+    {
+        if (!pod(n) || static_cast<uint64_t>(m_end - m_cur) / record < (*n)) return (m_ok = false);
+        return (true);
+    }
+    bool str(std::string *s)
+    {
+        uint64_t n = 0;
+        if (!pod(&n) || static_cast<uint64_t>(m_end - m_cur) < n) return (m_ok = false);
+        s->assign(m_cur, static_cast<size_t>(n));
+        m_cur += n;
+        return (true);
+    }
+    template <typename T> bool array(std::vector<T> *v)
+    {
+        uint64_t n = 0;
+        if (!pod(&n) || static_cast<uint64_t>(m_end - m_cur) / sizeof(T) < n) return (m_ok = false);
+        v->resize(static_cast<size_t>(n));
+        return (n == 0 || bytes(&(*v)[0], static_cast<size_t>(n) * sizeof(T)));
+    }
+    bool ok() const { return (m_ok); }
+private:
+    const char *m_cur;
+    const char *m_end;
+    bool m_ok;
+};
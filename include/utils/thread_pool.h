@@ -0,0 +1,121 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+#pragma once
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * @brief Fixed set of worker threads consuming a FIFO of jobs.
+ *
+ * Jobs must not throw. The destructor finishes every queued job before
+ * joining the workers.
+ */
+class ThreadPool {
+public:
+    /**
+     * @param num_threads Number of workers, 0 for
+     *                    std::thread::hardware_concurrency().
+     */
+    explicit ThreadPool(unsigned int num_threads = 0) : m_active(0), m_stop(false)
+    {
+        if (num_threads == 0) {
+            num_threads = std::max(1u, std::thread::hardware_concurrency());
+        }
+        m_workers.reserve(num_threads);
+        for (unsigned int i = 0; i < num_threads; i++) {
+            m_workers.push_back(std::thread(&ThreadPool::run, this));
+        }
+    }
+
+    ~ThreadPool()
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_all();
+        for (size_t i = 0; i < m_workers.size(); i++) {
+            m_workers[i].join();
+        }
+    }
+
+    /*** @brief Queues a job; it runs on one of the workers. */
+    void submit(const std::function<void()> &job)
+    {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_jobs.push_back(job);
+        }
+        m_wake.notify_one();
+    }
+
+    /*** @brief Blocks until the queue is empty and no job is running. */
+    void wait()
+    {
+        std::unique_lock<std::mutex> lock(m_mutex);
+        m_idle.wait(lock, [this] { return (m_jobs.empty() && m_active == 0); });
+    }
+
+    size_t size() const { return (m_workers.size()); }
+
+private:
+    ThreadPool(const ThreadPool &);
+    ThreadPool &operator=(const ThreadPool &);
+
+    void run()
+    {
+        for (;;) {
+            std::function<void()> job;
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_wake.wait(lock, [this] { return (m_stop || !m_jobs.empty()); });
+                if (m_jobs.empty()) return;
+                job.swap(m_jobs.front());
+                m_jobs.pop_front();
+                m_active++;
+            }
+            job();
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                m_active--;
+                if (m_jobs.empty() && m_active == 0) m_idle.notify_all();
+            }
+        }
+    }
+
+    std::vector<std::thread> m_workers;
+    std::deque<std::function<void()> > m_jobs;
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    std::condition_variable m_idle;
+    size_t m_active;
+    bool m_stop;
+};
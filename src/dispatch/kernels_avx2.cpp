@@ -0,0 +1,39 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+// AVX2 path: 8-wide packets, 8-wide FastMath and F16C. Built with
+// -mavx2 -mfma -mf16c; FMA contraction stays off so results match the
+// other paths bit for bit.
+#undef RT_NO_SIMD
+
+#if defined(__AVX2__) && defined(__FMA__) && defined(__F16C__)
+    #define DISPATCH_NAMESPACE dispatch_avx2
+    #define DISPATCH_GETTER DispatchKernelsAvx2
+    #define DISPATCH_NAME "avx2"
+    #include "kernels_impl.h"
+#else
+    #include "dispatch/kernels.h"
+    const DispatchKernels* DispatchKernelsAvx2(void) { return (NULL); }
+#endif
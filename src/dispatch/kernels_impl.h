@@ -0,0 +1,184 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+/**
+ * Body of every dispatch path.
+ *
+ * Included once by each src/dispatch/kernels_<path>.cpp, which defines
+ * DISPATCH_NAMESPACE and DISPATCH_GETTER and is built with the target flags
+ * of its path. The maths headers are included inside DISPATCH_NAMESPACE, so
+ * each path gets its own copy of every inline function and template: without
+ * it, the linker would be free to keep the AVX2 build of, say, Vec3::Dot for
+ * the whole program. For the same reason the system headers are all included
+ * first, outside of it, and the code below must not instantiate out-of-line
+ * templates on types that are not in DISPATCH_NAMESPACE (std::vector<float>
+ * growth, for one), which is why the OBJ loader and its accel adapters
+ * (accel/triangle_obj.h) are not included here.
+ * Only dispatch/kernels.h is shared with the other paths.
+ */
+
+#include <algorithm>
+#include <cmath>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <functional>
+#include <iosfwd>
+#include <mutex>
+#include <new>
+#include <thread>
+#include <vector>
+#if defined(_WIN32)
+#include <malloc.h>
+#endif
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86)
+#include <immintrin.h>
+#endif
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+#include "dispatch/kernels.h"
+
+namespace DISPATCH_NAMESPACE
+{
+
+#include "maths/transform.h"
+#include "maths/fastmath.h"
+#include "maths/half.h"
+#include "accel/triangle.h"
+
+static_assert(sizeof(Half) == sizeof(uint16_t), "Half must be its bit pattern");
+static_assert(sizeof(Vec3) == 3 * sizeof(float), "Vec3 must be packed xyz");
+static_assert(sizeof(TriangleHit) == 4 * sizeof(float), "TriangleHit layout is shared across paths");
+
+template <int K>
+static void TransformSpan(const float m[4][4], const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count)
+{
+    if (K == 0)
+        Transform::Points(m, src, srcStride, dst, dstStride, count);
+    else if (K == 1)
+        Transform::Points3x4(m, src, srcStride, dst, dstStride, count);
+    else
+        Transform::Vectors(m, src, srcStride, dst, dstStride, count);
+};
+
+#define DISPATCH_UNARY(F, T) static void F##T(const float* x, float* out, size_t count) { FastMath::F<FastMath::T>(x, out, count); };
+#define DISPATCH_BINARY(F, T) static void F##T(const float* a, const float* b, float* out, size_t count) { FastMath::F<FastMath::T>(a, b, out, count); };
+#define DISPATCH_TIERS(F, D) D(F, Precise) D(F, Fast)
+DISPATCH_TIERS(Sin, DISPATCH_UNARY)
+DISPATCH_TIERS(Cos, DISPATCH_UNARY)
+DISPATCH_TIERS(Exp, DISPATCH_UNARY)
+DISPATCH_TIERS(Log, DISPATCH_UNARY)
+DISPATCH_TIERS(Atan, DISPATCH_UNARY)
+DISPATCH_TIERS(Pow, DISPATCH_BINARY)
+DISPATCH_TIERS(Atan2, DISPATCH_BINARY)
+#undef DISPATCH_UNARY
+#undef DISPATCH_BINARY
+#undef DISPATCH_TIERS
+
+template <int T>
+static void SinCosBatch(const float* x, float* s, float* c, size_t count)
+{
+    FastMath::SinCos<T>(x, s, c, count);
+};
+
+static void EncodeHalf(const float* src, uint16_t* dst, size_t n)
+{
+    Half::Encode(src, reinterpret_cast<Half*>(dst), n);
+};
+
+static void DecodeHalf(const uint16_t* src, float* dst, size_t n)
+{
+    Half::Decode(reinterpret_cast<const Half*>(src), dst, n);
+};
+
+template <RayTriangle::Test T, int W>
+static size_t ClosestRays(const TriangleBlock<W>* blocks, size_t blockCount, const float* org, const float* dir,
+    size_t count, float tmin, float tmax, TriangleHit* hits)
+{
+    size_t hitCount = 0;
+
+    for (size_t i = 0; i < count; i++)
+    {
+        const Vec3 o(org[3 * i], org[3 * i + 1], org[3 * i + 2]);
+        const Vec3 d(dir[3 * i], dir[3 * i + 1], dir[3 * i + 2]);
+        hitCount += RayTriangle::Closest<T, W>(blocks, blockCount, o, d, tmin, tmax, &hits[i]) ? 1 : 0;
+    }
+    return (hitCount);
+};
+
+/**
+ * Paths narrower than DISPATCH_BLOCK_WIDTH repack the blocks once per call,
+ * so rays should come in batches. Every lane computes the W = 1 result and
+ * ties go to the lowest prim whatever the width, so the hits are the same.
+ */
+template <RayTriangle::Test T>
+static size_t Closest(const void* blocks, size_t blockCount, const float* org, const float* dir,
+    size_t count, float tmin, float tmax, void* hits)
+{
+    static const int W = RT_SIMD_WIDTH < 4 ? DISPATCH_BLOCK_WIDTH : RT_SIMD_WIDTH;
+    static const int S = DISPATCH_BLOCK_WIDTH / W;
+    static_assert(DISPATCH_BLOCK_WIDTH % W == 0, "path width must divide the block width");
+    const TriangleBlock<DISPATCH_BLOCK_WIDTH>* src = static_cast<const TriangleBlock<DISPATCH_BLOCK_WIDTH>*>(blocks);
+    TriangleHit* out = static_cast<TriangleHit*>(hits);
+
+    if (S == 1)
+        return (ClosestRays<T>(reinterpret_cast<const TriangleBlock<W>*>(src), blockCount, org, dir, count, tmin, tmax, out));
+
+    AlignedVector<TriangleBlock<W> > split(blockCount * S);
+    for (size_t b = 0; b < blockCount; b++)
+    {
+        for (int l = 0; l < DISPATCH_BLOCK_WIDTH; l++)
+        {
+            TriangleBlock<W>& dst = split[b * S + l / W];
+            const int k = l % W;
+            dst.v0.x.v[k] = src[b].v0.x.v[l]; dst.v0.y.v[k] = src[b].v0.y.v[l]; dst.v0.z.v[k] = src[b].v0.z.v[l];
+            dst.v1.x.v[k] = src[b].v1.x.v[l]; dst.v1.y.v[k] = src[b].v1.y.v[l]; dst.v1.z.v[k] = src[b].v1.z.v[l];
+            dst.v2.x.v[k] = src[b].v2.x.v[l]; dst.v2.y.v[k] = src[b].v2.y.v[l]; dst.v2.z.v[k] = src[b].v2.z.v[l];
+            dst.prim[k] = src[b].prim[l];
+        }
+    }
+    return (ClosestRays<T>(split.data(), split.size(), org, dir, count, tmin, tmax, out));
+};
+
+static const DispatchKernels kernels = {
+    DISPATCH_NAME,
+    TransformSpan<0>, TransformSpan<1>, TransformSpan<2>,
+    { SinPrecise, SinFast }, { CosPrecise, CosFast }, { ExpPrecise, ExpFast }, { LogPrecise, LogFast }, { AtanPrecise, AtanFast },
+    { PowPrecise, PowFast }, { Atan2Precise, Atan2Fast },
+    { SinCosBatch<FastMath::Precise>, SinCosBatch<FastMath::Fast> },
+    EncodeHalf, DecodeHalf,
+    { Closest<RayTriangle::MollerTrumboreTest>, Closest<RayTriangle::WatertightTest> }
+};
+
+}
+
+const DispatchKernels* DISPATCH_GETTER(void)
+{
+    return (&DISPATCH_NAMESPACE::kernels);
+}
@@ -0,0 +1,39 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#include <ostream>
+#include "maths/mat4.h"
+
+const Mat4 Mat4::zero       = Mat4(Vec4(0.0F), Vec4(0.0F), Vec4(0.0F), Vec4(0.0F));
+const Mat4 Mat4::identity   = Mat4();
+
+std::ostream& operator<<(std::ostream& os, const Mat4& m)
+{
+    os << m.data[0][0] << '\t' << m.data[0][1] << '\t' << m.data[0][2] << '\t' << m.data[0][3] << '\n';
+    os << m.data[1][0] << '\t' << m.data[1][1] << '\t' << m.data[1][2] << '\t' << m.data[1][3] << '\n';
+    os << m.data[2][0] << '\t' << m.data[2][1] << '\t' << m.data[2][2] << '\t' << m.data[2][3] << '\n';
+    os << m.data[3][0] << '\t' << m.data[3][1] << '\t' << m.data[3][2] << '\t' << m.data[3][3];
+    return (os);
+};
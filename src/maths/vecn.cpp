@@ -0,0 +1,47 @@
+/*
+ * MIT License
+ *
+ * Copyright(c) 2024 Mallory SCOTTON
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following coditions:
+ *
+ * The above copyright notice and this permission notice shall be included in all
+ * copies or substantial portions of the Software?
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+ * SOFTWARE.
+*/
+
+
+#include <ostream>
+#include "maths/vecn.h"
+
+template <typename T, int N>
+std::ostream& operator<<(std::ostream& os, const VecN<T, N>& v)
+{
+    os << '(' << v[0];
+    for (int i = 1; i < N; i++)
+        os << ", " << v[i];
+    os << ')';
+    return (os);
+};
+
+template std::ostream& operator<<(std::ostream& os, const Vec2& v);
+template std::ostream& operator<<(std::ostream& os, const Vec3& v);
+template std::ostream& operator<<(std::ostream& os, const Vec4& v);
+template std::ostream& operator<<(std::ostream& os, const Vec2i& v);
+template std::ostream& operator<<(std::ostream& os, const Vec3i& v);
+template std::ostream& operator<<(std::ostream& os, const Vec4i& v);
+template std::ostream& operator<<(std::ostream& os, const Vec2u& v);
+template std::ostream& operator<<(std::ostream& os, const Vec3u& v);
+template std::ostream& operator<<(std::ostream& os, const Vec4u& v);